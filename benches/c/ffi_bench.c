@@ -0,0 +1,286 @@
+/*
+ * C benchmark driver for libmemvid.
+ *
+ * Measures the FFI surface as a C caller sees it, including dynamic linking
+ * and the caller's own string handling, and prints one JSON report to stdout.
+ *
+ * Build and run (from the repository root):
+ *
+ *   cargo build --release
+ *   cc -O2 -std=c11 -Iinclude benches/c/ffi_bench.c -Ltarget/release -lmemvid -o target/ffi_bench
+ *   LD_LIBRARY_PATH=target/release ./target/ffi_bench [corpus sizes...]
+ *
+ * Corpus sizes default to 100 1000 5000.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "memvid.h"
+
+#define QUERY_ITERATIONS 200
+#define COMMIT_ROUNDS 20
+#define DOCS_PER_COMMIT 10
+#define WORDS_PER_DOC 64
+
+static const char *VOCABULARY[] = {
+    "memory", "frame", "index", "search", "commit", "vector", "lexical", "timeline", "snapshot",
+    "payload", "cursor", "query", "ranking", "segment", "journal", "archive", "shard", "token",
+    "context", "fragment", "citation", "metadata", "label", "tag", "document", "capsule",
+    "latency", "throughput", "buffer", "arena", "checksum", "manifest", "sketch", "embedding",
+};
+
+static const char *QUERIES[] = {
+    "memory index",
+    "vector search",
+    "timeline snapshot",
+    "commit journal",
+    "citation context fragment",
+    "latency throughput",
+};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+/* Latency samples for one benchmark at one corpus size. */
+typedef struct {
+    const char *name;
+    size_t corpus;
+    double *us;
+    size_t count;
+    size_t capacity;
+    uint64_t bytes;
+} Samples;
+
+static int first_result = 1;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static uint64_t rng_next(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Fill buf with WORDS_PER_DOC vocabulary words; returns the length. */
+static size_t make_document(uint64_t *rng, char *buf, size_t cap) {
+    size_t len = 0;
+    for (int i = 0; i < WORDS_PER_DOC; i++) {
+        const char *word = VOCABULARY[rng_next(rng) % COUNT(VOCABULARY)];
+        int n = snprintf(buf + len, cap - len, i ? " %s" : "%s", word);
+        if (n < 0 || (size_t)n >= cap - len) {
+            break;
+        }
+        len += (size_t)n;
+    }
+    return len;
+}
+
+static void samples_init(Samples *s, const char *name, size_t corpus) {
+    memset(s, 0, sizeof(*s));
+    s->name = name;
+    s->corpus = corpus;
+}
+
+static void samples_push(Samples *s, double us) {
+    if (s->count == s->capacity) {
+        s->capacity = s->capacity ? s->capacity * 2 : 64;
+        s->us = realloc(s->us, s->capacity * sizeof(double));
+        if (!s->us) {
+            abort();
+        }
+    }
+    s->us[s->count++] = us;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const Samples *s, double p) {
+    if (s->count == 0) {
+        return 0.0;
+    }
+    return s->us[(size_t)((double)(s->count - 1) * p + 0.5)];
+}
+
+/* Print and free one result object. */
+static void samples_report(Samples *s) {
+    double total = 0.0;
+    qsort(s->us, s->count, sizeof(double), compare_double);
+    for (size_t i = 0; i < s->count; i++) {
+        total += s->us[i];
+    }
+
+    printf("%s\n    {\"name\": \"%s\", \"corpus\": %zu, \"ops\": %zu, \"total_ms\": %.3f, "
+           "\"ops_per_sec\": %.1f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p99_us\": %.3f, "
+           "\"max_us\": %.3f",
+           first_result ? "" : ",", s->name, s->corpus, s->count, total / 1e3,
+           total > 0 ? (double)s->count * 1e6 / total : 0.0,
+           s->count ? total / (double)s->count : 0.0, percentile(s, 0.50), percentile(s, 0.99),
+           percentile(s, 1.0));
+    if (s->bytes && total > 0) {
+        printf(", \"bytes_per_sec\": %.1f", (double)s->bytes * 1e6 / total);
+    }
+    printf("}");
+    first_result = 0;
+    free(s->us);
+}
+
+static void check(MemvidError *error, const char *what) {
+    if (error->code != MemvidErrorCode_Ok) {
+        fprintf(stderr, "%s failed (%d): %s\n", what, (int)error->code,
+                error->message ? error->message : "");
+        exit(1);
+    }
+}
+
+static void bench_corpus(size_t corpus) {
+    char path[256];
+    char doc[WORDS_PER_DOC * 16];
+    char options[128];
+    char request[256];
+    MemvidError error = {MemvidErrorCode_Ok, NULL};
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    Samples s;
+    double t;
+
+    snprintf(path, sizeof(path), "/tmp/memvid_c_bench_%ld_%zu.mv2", (long)getpid(), corpus);
+    remove(path);
+
+    /* Plain puts, then one bulk commit */
+    MemvidHandle *handle = memvid_create(path, &error);
+    check(&error, "memvid_create");
+    samples_init(&s, "put_bytes", corpus);
+    for (size_t i = 0; i < corpus; i++) {
+        size_t len = make_document(&rng, doc, sizeof(doc));
+        t = now_us();
+        memvid_put_bytes(handle, (const uint8_t *)doc, len, &error);
+        samples_push(&s, now_us() - t);
+        s.bytes += len;
+        check(&error, "memvid_put_bytes");
+    }
+    samples_report(&s);
+
+    samples_init(&s, "commit_bulk", corpus);
+    t = now_us();
+    memvid_commit(handle, &error);
+    samples_push(&s, now_us() - t);
+    check(&error, "memvid_commit");
+    samples_report(&s);
+    memvid_close(handle);
+    remove(path);
+
+    /* Puts with options; the file is reused for the query benchmarks */
+    rng = 0x9E3779B97F4A7C15ULL;
+    handle = memvid_create(path, &error);
+    check(&error, "memvid_create");
+    samples_init(&s, "put_bytes_with_options", corpus);
+    for (size_t i = 0; i < corpus; i++) {
+        size_t len = make_document(&rng, doc, sizeof(doc));
+        snprintf(options, sizeof(options),
+                 "{\"uri\": \"bench://doc/%zu\", \"title\": \"Document %zu\", "
+                 "\"labels\": [\"bench\"]}",
+                 i, i);
+        t = now_us();
+        memvid_put_bytes_with_options(handle, (const uint8_t *)doc, len, options, &error);
+        samples_push(&s, now_us() - t);
+        s.bytes += len;
+        check(&error, "memvid_put_bytes_with_options");
+    }
+    samples_report(&s);
+    memvid_commit(handle, &error);
+    check(&error, "memvid_commit");
+
+    /* Small incremental commits */
+    samples_init(&s, "commit", corpus);
+    for (int round = 0; round < COMMIT_ROUNDS; round++) {
+        for (int i = 0; i < DOCS_PER_COMMIT; i++) {
+            size_t len = make_document(&rng, doc, sizeof(doc));
+            memvid_put_bytes(handle, (const uint8_t *)doc, len, &error);
+            check(&error, "memvid_put_bytes");
+        }
+        t = now_us();
+        memvid_commit(handle, &error);
+        samples_push(&s, now_us() - t);
+        check(&error, "memvid_commit");
+    }
+    samples_report(&s);
+
+    /* JSON search; the caller's strlen stands in for consuming the response */
+    samples_init(&s, "search", corpus);
+    for (int i = 0; i < QUERY_ITERATIONS; i++) {
+        snprintf(request, sizeof(request), "{\"query\": \"%s\", \"top_k\": 10}",
+                 QUERIES[i % COUNT(QUERIES)]);
+        t = now_us();
+        char *json = memvid_search(handle, request, &error);
+        size_t len = json ? strlen(json) : 0;
+        samples_push(&s, now_us() - t);
+        check(&error, "memvid_search");
+        s.bytes += len;
+        memvid_string_free(json);
+    }
+    samples_report(&s);
+
+    /* Binary search into caller buffers, no JSON on the response path */
+    MemvidSearchHit hits[10];
+    static uint8_t arena[64 * 1024];
+    MemvidSearchResult result;
+    samples_init(&s, "search_into", corpus);
+    for (int i = 0; i < QUERY_ITERATIONS; i++) {
+        snprintf(request, sizeof(request), "{\"query\": \"%s\", \"top_k\": 10}",
+                 QUERIES[i % COUNT(QUERIES)]);
+        t = now_us();
+        memvid_search_into(handle, request, hits, COUNT(hits), arena, sizeof(arena), &result,
+                           &error);
+        samples_push(&s, now_us() - t);
+        check(&error, "memvid_search_into");
+    }
+    samples_report(&s);
+
+    samples_init(&s, "ask", corpus);
+    for (int i = 0; i < QUERY_ITERATIONS; i++) {
+        snprintf(request, sizeof(request), "{\"question\": \"%s\", \"mode\": \"lex\"}",
+                 QUERIES[i % COUNT(QUERIES)]);
+        t = now_us();
+        char *json = memvid_ask(handle, request, &error);
+        size_t len = json ? strlen(json) : 0;
+        samples_push(&s, now_us() - t);
+        check(&error, "memvid_ask");
+        s.bytes += len;
+        memvid_string_free(json);
+    }
+    samples_report(&s);
+
+    memvid_close(handle);
+    remove(path);
+}
+
+int main(int argc, char **argv) {
+    size_t default_sizes[] = {100, 1000, 5000};
+
+    printf("{\n  \"suite\": \"memvid-ffi-c\",\n  \"version\": \"%s\",\n  \"features\": %u,\n"
+           "  \"iterations\": %d,\n  \"results\": [",
+           memvid_version(), memvid_features(), QUERY_ITERATIONS);
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            bench_corpus((size_t)strtoull(argv[i], NULL, 10));
+        }
+    } else {
+        for (size_t i = 0; i < COUNT(default_sizes); i++) {
+            bench_corpus(default_sizes[i]);
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
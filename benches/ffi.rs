@@ -0,0 +1,351 @@
+//! Benchmarks for the FFI surface.
+//!
+//! Run with `cargo bench --bench ffi`. The report is a single JSON document
+//! on stdout so results from different memvid-core revisions can be diffed.
+//!
+//! Environment:
+//! - `MEMVID_BENCH_SIZES`: comma-separated corpus sizes (default `100,1000,5000`)
+//! - `MEMVID_BENCH_QUERIES`: query iterations per corpus size (default `200`)
+
+use memvid::*;
+use serde_json::{json, Value};
+use std::ffi::CString;
+use std::path::PathBuf;
+use std::time::{Duration, Instant};
+
+#[rustfmt::skip]
+const VOCABULARY: &[&str] = &[
+    "memory", "frame", "index", "search", "commit", "vector", "lexical", "timeline", "snapshot",
+    "payload", "cursor", "query", "ranking", "segment", "journal", "archive", "shard", "token",
+    "context", "fragment", "citation", "metadata", "label", "tag", "document", "capsule",
+    "latency", "throughput", "buffer", "arena", "checksum", "manifest", "sketch", "embedding",
+];
+
+const QUERIES: &[&str] = &[
+    "memory index",
+    "vector search",
+    "timeline snapshot",
+    "commit journal",
+    "citation context fragment",
+    "latency throughput",
+];
+
+const COMMIT_ROUNDS: usize = 20;
+const DOCS_PER_COMMIT: usize = 10;
+
+/// Deterministic xorshift generator so every run indexes the same corpus.
+struct Rng(u64);
+
+impl Rng {
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        self.0
+    }
+
+    fn document(&mut self, words: usize) -> String {
+        let mut doc = String::with_capacity(words * 8);
+        for i in 0..words {
+            if i > 0 {
+                doc.push(' ');
+            }
+            doc.push_str(VOCABULARY[(self.next() % VOCABULARY.len() as u64) as usize]);
+        }
+        doc
+    }
+}
+
+/// Latency samples for one benchmark at one corpus size.
+struct Samples {
+    name: &'static str,
+    corpus: usize,
+    durations: Vec<Duration>,
+    bytes: u64,
+}
+
+impl Samples {
+    fn new(name: &'static str, corpus: usize) -> Self {
+        Self {
+            name,
+            corpus,
+            durations: Vec::new(),
+            bytes: 0,
+        }
+    }
+
+    fn time<T>(&mut self, f: impl FnOnce() -> T) -> T {
+        let start = Instant::now();
+        let out = f();
+        self.durations.push(start.elapsed());
+        out
+    }
+
+    fn percentile_us(sorted: &[Duration], p: f64) -> f64 {
+        if sorted.is_empty() {
+            return 0.0;
+        }
+        let rank = ((sorted.len() - 1) as f64 * p).round() as usize;
+        sorted[rank].as_secs_f64() * 1e6
+    }
+
+    fn report(mut self) -> Value {
+        self.durations.sort();
+        let total: Duration = self.durations.iter().sum();
+        let total_s = total.as_secs_f64();
+        let ops = self.durations.len();
+        let mut report = json!({
+            "name": self.name,
+            "corpus": self.corpus,
+            "ops": ops,
+            "total_ms": total_s * 1e3,
+            "ops_per_sec": if total_s > 0.0 { ops as f64 / total_s } else { 0.0 },
+            "mean_us": if ops > 0 { total_s * 1e6 / ops as f64 } else { 0.0 },
+            "p50_us": Self::percentile_us(&self.durations, 0.50),
+            "p99_us": Self::percentile_us(&self.durations, 0.99),
+            "max_us": Self::percentile_us(&self.durations, 1.0),
+        });
+        if self.bytes > 0 && total_s > 0.0 {
+            report["bytes_per_sec"] = json!(self.bytes as f64 / total_s);
+        }
+        report
+    }
+}
+
+/// Difference between FFI and direct core p50/p99 latencies.
+fn overhead(name: &'static str, ffi: &Value, core: &Value) -> Value {
+    let diff = |key: &str| ffi[key].as_f64().unwrap_or(0.0) - core[key].as_f64().unwrap_or(0.0);
+    json!({
+        "name": name,
+        "corpus": ffi["corpus"],
+        "p50_us": diff("p50_us"),
+        "p99_us": diff("p99_us"),
+    })
+}
+
+fn env_list(name: &str, default: &[usize]) -> Vec<usize> {
+    std::env::var(name)
+        .ok()
+        .map(|v| v.split(',').filter_map(|s| s.trim().parse().ok()).collect())
+        .filter(|v: &Vec<usize>| !v.is_empty())
+        .unwrap_or_else(|| default.to_vec())
+}
+
+fn bench_path(name: &str, corpus: usize) -> PathBuf {
+    let path = std::env::temp_dir().join(format!("memvid_bench_{name}_{corpus}.mv2"));
+    let _ = std::fs::remove_file(&path);
+    path
+}
+
+fn check(error: &MemvidError, what: &str) {
+    if error.code != MemvidErrorCode::Ok {
+        panic!("{what} failed with {:?}", error.code);
+    }
+}
+
+fn create(path: &PathBuf) -> *mut MemvidHandle {
+    let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+    let mut error = MemvidError::ok();
+    let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+    check(&error, "memvid_create");
+    handle
+}
+
+/// Put throughput with and without options, bulk and incremental commit latency.
+fn bench_put(corpus: usize, results: &mut Vec<Value>) -> PathBuf {
+    let mut rng = Rng(0x9E37_79B9_7F4A_7C15);
+    let docs: Vec<String> = (0..corpus).map(|_| rng.document(64)).collect();
+    let mut error = MemvidError::ok();
+
+    // Plain puts
+    let path = bench_path("put", corpus);
+    let handle = create(&path);
+    let mut put = Samples::new("put_bytes", corpus);
+    for doc in &docs {
+        put.bytes += doc.len() as u64;
+        put.time(|| unsafe { memvid_put_bytes(handle, doc.as_ptr(), doc.len(), &mut error) });
+        check(&error, "memvid_put_bytes");
+    }
+    let mut commit = Samples::new("commit_bulk", corpus);
+    commit.time(|| unsafe { memvid_commit(handle, &mut error) });
+    check(&error, "memvid_commit");
+    unsafe { memvid_close(handle) };
+    let _ = std::fs::remove_file(&path);
+    results.push(put.report());
+    results.push(commit.report());
+
+    // Puts with options; this file is kept for the query benchmarks
+    let path = bench_path("query", corpus);
+    let handle = create(&path);
+    let mut put = Samples::new("put_bytes_with_options", corpus);
+    for (i, doc) in docs.iter().enumerate() {
+        let options = CString::new(format!(
+            r#"{{"uri": "bench://doc/{i}", "title": "Document {i}", "labels": ["bench"]}}"#
+        ))
+        .unwrap();
+        put.bytes += doc.len() as u64;
+        put.time(|| unsafe {
+            memvid_put_bytes_with_options(
+                handle,
+                doc.as_ptr(),
+                doc.len(),
+                options.as_ptr(),
+                &mut error,
+            )
+        });
+        check(&error, "memvid_put_bytes_with_options");
+    }
+    unsafe { memvid_commit(handle, &mut error) };
+    check(&error, "memvid_commit");
+
+    // Small incremental commits on top of an existing corpus
+    let mut commit = Samples::new("commit", corpus);
+    for _ in 0..COMMIT_ROUNDS {
+        for _ in 0..DOCS_PER_COMMIT {
+            let doc = rng.document(64);
+            unsafe { memvid_put_bytes(handle, doc.as_ptr(), doc.len(), &mut error) };
+            check(&error, "memvid_put_bytes");
+        }
+        commit.time(|| unsafe { memvid_commit(handle, &mut error) });
+        check(&error, "memvid_commit");
+    }
+    unsafe { memvid_close(handle) };
+    results.push(put.report());
+    results.push(commit.report());
+
+    path
+}
+
+fn core_search_request(query: &str) -> memvid_core::SearchRequest {
+    memvid_core::SearchRequest {
+        query: query.to_string(),
+        top_k: 10,
+        snippet_chars: 200,
+        uri: None,
+        scope: None,
+        cursor: None,
+        #[cfg(feature = "temporal_track")]
+        temporal: None,
+        as_of_frame: None,
+        as_of_ts: None,
+        no_sketch: false,
+    }
+}
+
+fn core_ask_request(question: &str) -> memvid_core::AskRequest {
+    memvid_core::AskRequest {
+        question: question.to_string(),
+        top_k: 10,
+        snippet_chars: 200,
+        uri: None,
+        scope: None,
+        cursor: None,
+        start: None,
+        end: None,
+        context_only: true,
+        mode: memvid_core::AskMode::Lex,
+        as_of_frame: None,
+        as_of_ts: None,
+        adaptive: None,
+    }
+}
+
+/// Search and ask latency through the FFI and directly against memvid-core.
+fn bench_query(path: &PathBuf, corpus: usize, iterations: usize, results: &mut Vec<Value>) {
+    let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+    let mut error = MemvidError::ok();
+    let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+    check(&error, "memvid_open");
+
+    let search_requests: Vec<CString> = QUERIES
+        .iter()
+        .map(|q| CString::new(format!(r#"{{"query": "{q}", "top_k": 10}}"#)).unwrap())
+        .collect();
+    let ask_requests: Vec<CString> = QUERIES
+        .iter()
+        .map(|q| CString::new(format!(r#"{{"question": "{q}", "mode": "lex"}}"#)).unwrap())
+        .collect();
+
+    let mut search = Samples::new("search", corpus);
+    let mut search_into = Samples::new("search_into", corpus);
+    let mut search_core = Samples::new("search_core", corpus);
+    let mut ask = Samples::new("ask", corpus);
+    let mut ask_core = Samples::new("ask_core", corpus);
+
+    let mut hits = vec![MemvidSearchHit::default(); 10];
+    let mut arena = vec![0u8; 64 * 1024];
+    let mut result = MemvidSearchResult::default();
+
+    for i in 0..iterations {
+        let n = i % QUERIES.len();
+
+        let json = search
+            .time(|| unsafe { memvid_search(handle, search_requests[n].as_ptr(), &mut error) });
+        check(&error, "memvid_search");
+        unsafe { memvid_string_free(json) };
+
+        search_into.time(|| unsafe {
+            memvid_search_into(
+                handle,
+                search_requests[n].as_ptr(),
+                hits.as_mut_ptr(),
+                hits.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut result,
+                &mut error,
+            )
+        });
+        check(&error, "memvid_search_into");
+
+        let inner = unsafe { &mut *handle }.as_mut();
+        search_core
+            .time(|| inner.search(core_search_request(QUERIES[n])))
+            .expect("core search");
+
+        let json = ask.time(|| unsafe { memvid_ask(handle, ask_requests[n].as_ptr(), &mut error) });
+        check(&error, "memvid_ask");
+        unsafe { memvid_string_free(json) };
+
+        let inner = unsafe { &mut *handle }.as_mut();
+        ask_core
+            .time(|| {
+                inner.ask(
+                    core_ask_request(QUERIES[n]),
+                    None::<&dyn memvid_core::VecEmbedder>,
+                )
+            })
+            .expect("core ask");
+    }
+    unsafe { memvid_close(handle) };
+
+    let search = search.report();
+    let search_core = search_core.report();
+    let ask = ask.report();
+    let ask_core = ask_core.report();
+    results.push(overhead("search_json_overhead", &search, &search_core));
+    results.push(overhead("ask_json_overhead", &ask, &ask_core));
+    results.extend([search, search_into.report(), search_core, ask, ask_core]);
+}
+
+fn main() {
+    let sizes = env_list("MEMVID_BENCH_SIZES", &[100, 1000, 5000]);
+    let iterations = env_list("MEMVID_BENCH_QUERIES", &[200])[0];
+
+    let mut results = Vec::new();
+    for &corpus in &sizes {
+        let path = bench_put(corpus, &mut results);
+        bench_query(&path, corpus, iterations, &mut results);
+        let _ = std::fs::remove_file(&path);
+    }
+
+    let version = unsafe { std::ffi::CStr::from_ptr(memvid_version()) };
+    let report = json!({
+        "suite": "memvid-ffi",
+        "version": version.to_str().unwrap_or_default(),
+        "features": memvid_features(),
+        "iterations": iterations,
+        "results": results,
+    });
+    println!("{}", serde_json::to_string_pretty(&report).unwrap());
+}
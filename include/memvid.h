@@ -3,11 +3,13 @@
  * C FFI Bindings
  *
  * Thread Safety: MemvidHandle is NOT thread-safe. Use from a single thread
- * or provide external synchronization.
+ * or provide external synchronization. MemvidReaderPool is thread-safe and
+ * hands out read-only views, each used by one thread at a time.
  *
  * Memory Ownership:
  * - Handles: Caller owns, must call memvid_close()
  * - Returned strings: Caller owns, must call memvid_string_free()
+ * - Strings from *_arena functions: Arena owns, released by memvid_arena_reset()
  * - MemvidError.message: FFI owns, call memvid_error_free()
  */
 
@@ -136,6 +138,10 @@ typedef enum MemvidErrorCode {
     MemvidErrorCode_JsonParse = 102,
     /** Invalid handle (FFI-specific) */
     MemvidErrorCode_InvalidHandle = 103,
+    /** Caller-supplied buffer is too small (FFI-specific) */
+    MemvidErrorCode_BufferTooSmall = 104,
+    /** Call not allowed in the current state (FFI-specific) */
+    MemvidErrorCode_InvalidState = 105,
     /** Unknown error */
     MemvidErrorCode_Unknown = 255,
 } MemvidErrorCode;
@@ -147,6 +153,70 @@ typedef enum MemvidErrorCode {
  */
 typedef struct MemvidHandle MemvidHandle;
 
+/**
+ * Opaque streaming cursor over the timeline.
+ *
+ * The cursor must be freed with memvid_timeline_close().
+ */
+typedef struct MemvidTimelineCursor MemvidTimelineCursor;
+
+/**
+ * Opaque pool of read-only views over one memory file.
+ *
+ * The pool is thread-safe. The pool must be freed with memvid_reader_pool_close().
+ */
+typedef struct MemvidReaderPool MemvidReaderPool;
+
+/**
+ * Opaque set of memory files written and queried as one sharded memory.
+ *
+ * The set is NOT thread-safe. The set must be freed with memvid_shard_set_close().
+ */
+typedef struct MemvidShardSet MemvidShardSet;
+
+/**
+ * Bit position of the shard index in frame IDs returned by a shard set.
+ *
+ * shard = frame_id >> MEMVID_SHARD_ID_SHIFT;
+ * local = frame_id & ((1ULL << MEMVID_SHARD_ID_SHIFT) - 1);
+ */
+#define MEMVID_SHARD_ID_SHIFT 48
+
+/**
+ * Opaque document being written chunk by chunk.
+ *
+ * The stream is freed by memvid_put_end() or memvid_put_abort().
+ */
+typedef struct MemvidPutStream MemvidPutStream;
+
+/**
+ * Opaque multi-threaded ingest pipeline bound to one handle.
+ *
+ * The pipeline must be drained and freed with memvid_ingest_finish().
+ */
+typedef struct MemvidIngestPipeline MemvidIngestPipeline;
+
+/**
+ * Opaque bump allocator for response strings.
+ *
+ * Not thread-safe. The arena must be freed with memvid_arena_destroy().
+ */
+typedef struct MemvidArena MemvidArena;
+
+/**
+ * Opaque worker pool running blocking calls with completion notification.
+ *
+ * The executor is thread-safe. It must be freed with memvid_executor_close().
+ */
+typedef struct MemvidExecutor MemvidExecutor;
+
+/**
+ * Opaque search request parsed once for repeated execution.
+ *
+ * Not thread-safe. The query must be freed with memvid_prepared_free().
+ */
+typedef struct MemvidPreparedQuery MemvidPreparedQuery;
+
 /**
  * Error structure returned via out-parameter.
  *
@@ -210,6 +280,462 @@ typedef struct MemvidStats {
     uint64_t remaining_capacity_bytes;
 } MemvidStats;
 
+/** Version of the MemvidStatsExt layout written by this library. */
+#define MEMVID_STATS_EXT_VERSION 2
+
+/**
+ * Extended memory statistics (see memvid_stats_ext()).
+ *
+ * Set struct_size to sizeof(MemvidStatsExt) before the call; only fields
+ * that fit are written. New fields are only ever appended.
+ */
+typedef struct MemvidStatsExt {
+    /** Size of the caller's struct in bytes (set by the caller) */
+    uint32_t struct_size;
+    /** Layout version written (MEMVID_STATS_EXT_VERSION) */
+    uint32_t version;
+    /** Same values as memvid_stats() */
+    MemvidStats base;
+    /** Deleted frames as a fraction of all frames (0.0-1.0) */
+    double tombstone_ratio;
+    /** Frames put since the last commit */
+    uint64_t pending_frames;
+    /** Commits made through this handle */
+    uint64_t commit_count;
+    /** Duration of the last commit in microseconds (0 before the first) */
+    uint64_t last_commit_us;
+    /** Dedup puts checked against the content-hash filter (version 2) */
+    uint64_t dedup_checks;
+    /** Checks the filter answered as new content without a core lookup */
+    uint64_t dedup_filtered;
+    /** Checks the core confirmed as duplicates */
+    uint64_t dedup_duplicates;
+    /** Fraction of checks answered by the filter (0.0-1.0) */
+    double dedup_filter_hit_rate;
+    /** Fraction of new content the filter failed to rule out (0.0-1.0) */
+    double dedup_false_positive_rate;
+    /** Whether the filter covers every frame (0 when the memory has frames
+     *  but no usable .dedup sidecar) */
+    uint8_t dedup_filter_active;
+    /** Padding for alignment */
+    uint8_t _padding[7];
+} MemvidStatsExt;
+
+/**
+ * Query result cache counters (see memvid_cache_stats()).
+ */
+typedef struct MemvidCacheStats {
+    /** Lookups answered from the cache */
+    uint64_t hits;
+    /** Lookups that ran the query */
+    uint64_t misses;
+    /** Entries dropped to stay within the limits */
+    uint64_t evictions;
+    /** Entries currently cached */
+    uint64_t entries;
+    /** Bytes currently cached (requests and responses) */
+    uint64_t bytes;
+    /** Commit generation the cached entries belong to */
+    uint64_t generation;
+} MemvidCacheStats;
+
+/**
+ * Item descriptor for memvid_put_many().
+ */
+typedef struct MemvidPutItem {
+    /** Pointer to content bytes */
+    const uint8_t *data;
+    /** Length of content in bytes */
+    size_t len;
+    /** Per-item options JSON overriding the shared options (NULL to inherit) */
+    const char *options_json;
+} MemvidPutItem;
+
+/**
+ * Search hit in the binary result layout (see memvid_search_into()).
+ *
+ * String fields are stored in the caller's arena buffer and referenced by
+ * byte offset and length. Arena strings are UTF-8 and NOT null-terminated.
+ */
+typedef struct MemvidSearchHit {
+    /** Frame ID */
+    uint64_t frame_id;
+    /** Result rank (1-based) */
+    uint64_t rank;
+    /** Character range start in document */
+    uint64_t range_start;
+    /** Character range end in document */
+    uint64_t range_end;
+    /** Number of keyword matches */
+    uint64_t matches;
+    /** Relevance score (valid when has_score is 1) */
+    float score;
+    /** Whether score is set */
+    uint8_t has_score;
+    /** Whether the hit has a title (title_len may still be 0) */
+    uint8_t has_title;
+    /** Padding for alignment */
+    uint8_t _padding[2];
+    /** Arena offset of the document URI */
+    uint64_t uri_offset;
+    /** Length of the document URI in bytes */
+    uint64_t uri_len;
+    /** Arena offset of the document title */
+    uint64_t title_offset;
+    /** Length of the document title in bytes */
+    uint64_t title_len;
+    /** Arena offset of the snippet text */
+    uint64_t text_offset;
+    /** Length of the snippet text in bytes */
+    uint64_t text_len;
+} MemvidSearchHit;
+
+/**
+ * Summary of a binary search result.
+ *
+ * On a BufferTooSmall failure, hit_count and arena_bytes still report the
+ * capacities required to hold the full result.
+ */
+typedef struct MemvidSearchResult {
+    /** Number of hits returned (entries required in the hits array) */
+    uint64_t hit_count;
+    /** Total number of hits (may exceed returned hits due to pagination) */
+    uint64_t total_hits;
+    /** Execution time in milliseconds */
+    uint64_t elapsed_ms;
+    /** Bytes of string arena used (or required) */
+    uint64_t arena_bytes;
+    /** Whether a next-page cursor is present */
+    uint8_t has_next_cursor;
+    /** Whether the time budget ran out before the search finished */
+    uint8_t partial;
+    /** Padding for alignment */
+    uint8_t _padding[6];
+    /** Arena offset of the next-page cursor */
+    uint64_t next_cursor_offset;
+    /** Length of the next-page cursor in bytes */
+    uint64_t next_cursor_len;
+} MemvidSearchResult;
+
+/**
+ * Length-delimited UTF-8 string passed by reference in binary requests.
+ *
+ * A NULL ptr means the field is absent. The bytes need not be null-terminated.
+ */
+typedef struct MemvidStr {
+    /** Pointer to the string bytes (NULL if absent) */
+    const char *ptr;
+    /** Length in bytes */
+    size_t len;
+} MemvidStr;
+
+/**
+ * Binary search request for memvid_search_bin().
+ *
+ * Field-for-field equivalent of the memvid_search() request JSON. Strings are
+ * borrowed for the duration of the call; zero top_k and snippet_chars select
+ * the JSON defaults.
+ */
+typedef struct MemvidSearchQuery {
+    /** Search query string (must not be absent) */
+    MemvidStr query;
+    /** Maximum number of results (0 for the default of 10) */
+    uint64_t top_k;
+    /** Characters of context around matches (0 for the default of 200) */
+    uint64_t snippet_chars;
+    /** Filter to specific URI (absent for no filter) */
+    MemvidStr uri;
+    /** Filter to URI scope/prefix (absent for no filter) */
+    MemvidStr scope;
+    /** Pagination cursor (absent for the first page) */
+    MemvidStr cursor;
+    /** Drop hits scoring below this (valid when has_min_score is 1) */
+    float min_score;
+    /** Whether min_score is set */
+    uint8_t has_min_score;
+    /** Return ranks, frame IDs and scores only (1) or full hits (0) */
+    uint8_t ids_only;
+    /** Whether time_budget_us is set */
+    uint8_t has_time_budget;
+    /** Padding for alignment */
+    uint8_t _padding[1];
+    /** Time budget in microseconds (valid when has_time_budget is 1) */
+    uint64_t time_budget_us;
+    /** Maximum hits the engine is asked for, filter over-fetch included (0 for no cap) */
+    uint64_t max_candidates;
+} MemvidSearchQuery;
+
+/**
+ * Parameters bound to one memvid_execute_prepared() call.
+ *
+ * Absent strings, zero top_k and unset time bounds keep the template's
+ * values. Strings are borrowed for the duration of the call.
+ */
+typedef struct MemvidPreparedParams {
+    /** Search query string */
+    MemvidStr query;
+    /** Filter to specific URI */
+    MemvidStr uri;
+    /** Filter to URI scope/prefix */
+    MemvidStr scope;
+    /** Pagination cursor */
+    MemvidStr cursor;
+    /** Maximum number of results */
+    uint64_t top_k;
+    /** Timestamp lower bound, inclusive (valid when has_since is 1) */
+    int64_t since;
+    /** Timestamp upper bound, inclusive (valid when has_until is 1) */
+    int64_t until;
+    /** Whether since is set */
+    uint8_t has_since;
+    /** Whether until is set */
+    uint8_t has_until;
+    /** Padding for alignment */
+    uint8_t _padding[6];
+} MemvidPreparedParams;
+
+/** Option flag values in MemvidPutOptions. */
+#define MEMVID_FLAG_DEFAULT 0
+#define MEMVID_FLAG_OFF 1
+#define MEMVID_FLAG_ON 2
+
+/**
+ * Tag key-value pair in MemvidPutOptions.
+ */
+typedef struct MemvidTag {
+    MemvidStr key;
+    MemvidStr value;
+} MemvidTag;
+
+/**
+ * Binary put options for memvid_put_bytes_bin().
+ *
+ * Field-for-field equivalent of the PutOptions JSON. Absent strings and
+ * MEMVID_FLAG_DEFAULT flags leave the library default in place, so a
+ * zero-initialized struct is the same as NULL options.
+ */
+typedef struct MemvidPutOptions {
+    /** Document URI */
+    MemvidStr uri;
+    /** Document title */
+    MemvidStr title;
+    /** Track/collection name */
+    MemvidStr track;
+    /** Document kind/type */
+    MemvidStr kind;
+    /** Override search text */
+    MemvidStr search_text;
+    /** Tags (may be NULL when tag_count is 0) */
+    const MemvidTag *tags;
+    /** Number of entries in tags */
+    size_t tag_count;
+    /** Labels (may be NULL when label_count is 0) */
+    const MemvidStr *labels;
+    /** Number of entries in labels */
+    size_t label_count;
+    /** Unix timestamp in seconds (valid when has_timestamp is 1) */
+    int64_t timestamp;
+    /** Whether timestamp is set */
+    uint8_t has_timestamp;
+    /** Auto-tagging (MEMVID_FLAG_*) */
+    uint8_t auto_tag;
+    /** Date extraction (MEMVID_FLAG_*) */
+    uint8_t extract_dates;
+    /** Triplet extraction (MEMVID_FLAG_*) */
+    uint8_t extract_triplets;
+    /** Skip storing raw content (MEMVID_FLAG_*) */
+    uint8_t no_raw;
+    /** Deduplicate by hash (MEMVID_FLAG_*) */
+    uint8_t dedup;
+    /** Padding for alignment */
+    uint8_t _padding[2];
+} MemvidPutOptions;
+
+/**
+ * Binary timeline query for memvid_timeline_bin().
+ *
+ * Field-for-field equivalent of the memvid_timeline() query JSON.
+ */
+typedef struct MemvidTimelineQuery {
+    /** Maximum number of entries to return (0 for no limit) */
+    uint64_t limit;
+    /** Timestamp lower bound, inclusive (valid when has_since is 1) */
+    int64_t since;
+    /** Timestamp upper bound, inclusive (valid when has_until is 1) */
+    int64_t until;
+    /** Whether since is set */
+    uint8_t has_since;
+    /** Whether until is set */
+    uint8_t has_until;
+    /** Return in reverse chronological order */
+    uint8_t reverse;
+    /** Padding for alignment */
+    uint8_t _padding[5];
+} MemvidTimelineQuery;
+
+/**
+ * Timeline entry in the binary result layout (see memvid_timeline_bin()).
+ *
+ * String fields are stored in the caller's arena buffer and referenced by
+ * byte offset and length. Arena strings are UTF-8 and NOT null-terminated.
+ */
+typedef struct MemvidTimelineEntry {
+    /** Frame ID */
+    uint64_t frame_id;
+    /** Unix timestamp (seconds) */
+    int64_t timestamp;
+    /** Number of child frames (fetch them with memvid_timeline) */
+    uint64_t child_count;
+    /** Whether the entry has a URI */
+    uint8_t has_uri;
+    /** Padding for alignment */
+    uint8_t _padding[7];
+    /** Arena offset of the preview text */
+    uint64_t preview_offset;
+    /** Length of the preview text in bytes */
+    uint64_t preview_len;
+    /** Arena offset of the URI */
+    uint64_t uri_offset;
+    /** Length of the URI in bytes */
+    uint64_t uri_len;
+} MemvidTimelineEntry;
+
+/**
+ * Summary of a binary timeline result.
+ *
+ * On a BufferTooSmall failure, both fields still report the capacities
+ * required to hold the full result.
+ */
+typedef struct MemvidTimelineResult {
+    /** Number of entries returned (entries required in the entries array) */
+    uint64_t entry_count;
+    /** Bytes of string arena used (or required) */
+    uint64_t arena_bytes;
+} MemvidTimelineResult;
+
+/**
+ * Byte view returned by memvid_frame_payload_view().
+ *
+ * The bytes are NOT null-terminated and may contain interior NULs.
+ * Release with memvid_view_release().
+ */
+typedef struct MemvidView {
+    /** Pointer to the first byte (NULL for a released view) */
+    const uint8_t *data;
+    /** Number of bytes at data */
+    size_t len;
+    /** Allocated size of the buffer, used by memvid_view_release() (do not modify) */
+    size_t capacity;
+} MemvidView;
+
+/**
+ * Durability notification callback.
+ *
+ * Invoked on the committing thread with the caller's context pointer and the
+ * highest sequence number that is now durable.
+ */
+typedef void (*MemvidDurabilityCallback)(void *ctx, uint64_t durable_seq);
+
+/**
+ * Allocation hook: returns size bytes or NULL.
+ */
+typedef void *(*MemvidMallocFn)(void *ctx, size_t size);
+
+/**
+ * Deallocation hook for memory returned by the matching MemvidMallocFn.
+ */
+typedef void (*MemvidFreeFn)(void *ctx, void *ptr);
+
+/** Per-file status values passed to MemvidVerifyProgressFn. */
+#define MEMVID_VERIFY_PASSED 0
+#define MEMVID_VERIFY_FAILED 1
+#define MEMVID_VERIFY_SKIPPED 2
+#define MEMVID_VERIFY_ERROR 3
+
+/**
+ * Verification progress callback (see memvid_verify_many()).
+ *
+ * Invoked on the calling thread once per file with the caller's context
+ * pointer, the file path, files finished so far, the total, and a
+ * MEMVID_VERIFY_* status. Return non-zero to cancel files not yet started.
+ */
+typedef int32_t (*MemvidVerifyProgressFn)(void *ctx,
+                                          const char *path,
+                                          size_t done,
+                                          size_t total,
+                                          int32_t status);
+
+/** Event kinds passed to MemvidAskStreamFn. */
+#define MEMVID_ASK_FRAGMENT 0
+#define MEMVID_ASK_CITATION 1
+#define MEMVID_ASK_DONE 2
+
+/**
+ * Ask stream callback (see memvid_ask_stream()).
+ *
+ * Invoked on the calling thread once per event with the caller's context
+ * pointer, a MEMVID_ASK_* kind, and the event JSON (null-terminated, len
+ * bytes without the terminator, valid only during the call). Return
+ * non-zero to stop the stream.
+ */
+typedef int32_t (*MemvidAskStreamFn)(void *ctx, int32_t kind, const char *json, size_t len);
+
+/** Task operations accepted by memvid_executor_submit(). */
+#define MEMVID_TASK_SEARCH 0
+#define MEMVID_TASK_ASK 1
+#define MEMVID_TASK_COMMIT 2
+#define MEMVID_TASK_VERIFY 3
+
+/** Completion status values in MemvidCompletion.status. */
+#define MEMVID_TASK_DONE 0
+#define MEMVID_TASK_FAILED 1
+#define MEMVID_TASK_CANCELLED 2
+
+/**
+ * Result of a task run by a MemvidExecutor.
+ *
+ * result holds the JSON the blocking call would have returned (NULL for
+ * commits and for failed or cancelled tasks); error is set when status is
+ * MEMVID_TASK_FAILED.
+ */
+typedef struct MemvidCompletion {
+    /** ID returned by memvid_executor_submit() */
+    uint64_t task_id;
+    /** MEMVID_TASK_* operation */
+    int32_t op;
+    /** MEMVID_TASK_DONE, MEMVID_TASK_FAILED or MEMVID_TASK_CANCELLED */
+    int32_t status;
+    /** Error for failed tasks (code MemvidErrorCode_Ok otherwise) */
+    MemvidError error;
+    /** Result JSON, or NULL */
+    char *result;
+} MemvidCompletion;
+
+/**
+ * Task completion callback (see memvid_executor_submit()).
+ *
+ * Invoked on a worker thread with the caller's context pointer and the
+ * completion. The completion and its strings are freed when the callback
+ * returns; copy anything that must outlive it.
+ */
+typedef void (*MemvidCompletionFn)(void *ctx, const MemvidCompletion *completion);
+
+/**
+ * Snapshot writer callback (see memvid_snapshot_stream()).
+ *
+ * Invoked on the calling thread with the next bytes of the stream.
+ * Return non-zero to abort the stream.
+ */
+typedef int32_t (*MemvidSnapshotWriteFn)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Snapshot reader callback (see memvid_apply_stream()).
+ *
+ * Invoked on the calling thread to fill up to cap bytes of buf. Return the
+ * number of bytes read, 0 at the end of the stream, or negative on error.
+ */
+typedef int64_t (*MemvidSnapshotReadFn)(void *ctx, uint8_t *buf, size_t cap);
+
 /* ============================================================================
  * Version and Feature Functions
  * ============================================================================ */
@@ -258,6 +784,33 @@ MemvidHandle *memvid_create(const char *path, MemvidError *error);
  */
 MemvidHandle *memvid_open(const char *path, MemvidError *error);
 
+/**
+ * Open an existing Memvid memory with options.
+ *
+ * Read-only handles skip writer setup and allow searches and reads only;
+ * mutations fail with a core error. "readahead" warms the page cache so the
+ * first queries against a large file do not fault pages in one at a time.
+ *
+ * @param path          Filesystem path to existing memory (UTF-8 encoded, null-terminated)
+ * @param options_json  JSON string with open options (NULL for defaults, same as memvid_open)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Handle on success, NULL on failure.
+ *         Caller owns the returned handle. Must call memvid_close() to free.
+ *
+ * Options JSON Schema:
+ * {
+ *   "read_only": false,
+ *   "readahead": "none"
+ * }
+ *
+ * Readahead values: "none", "async" (kernel readahead in the background),
+ * "populate" (read the whole file into the page cache before returning)
+ */
+MemvidHandle *memvid_open_with_options(const char *path,
+                                       const char *options_json,
+                                       MemvidError *error);
+
 /**
  * Close and free a Memvid handle.
  *
@@ -267,6 +820,201 @@ MemvidHandle *memvid_open(const char *path, MemvidError *error);
  */
 void memvid_close(MemvidHandle *handle);
 
+/* ============================================================================
+ * Reader Pool Functions
+ * ============================================================================ */
+
+/**
+ * Open a pool of read-only views over an existing memory.
+ *
+ * One reader is opened immediately to validate the file; the rest are opened
+ * on demand, up to max_readers. Views observe the file as of the last commit
+ * before they were opened.
+ *
+ * @param path         Filesystem path to existing memory (UTF-8 encoded, null-terminated)
+ * @param max_readers  Maximum concurrent views (0 for the number of CPUs)
+ * @param error        Out-parameter for error information (may be NULL)
+ *
+ * @return Pool on success, NULL on failure.
+ *         Caller owns the returned pool. Must call memvid_reader_pool_close() to free.
+ */
+MemvidReaderPool *memvid_reader_pool_open(const char *path,
+                                          uint32_t max_readers,
+                                          MemvidError *error);
+
+/**
+ * Check out a read-only view from the pool.
+ *
+ * Blocks while all max_readers views are checked out. The view can be passed
+ * to any read function (memvid_search, memvid_frame_by_id, memvid_timeline,
+ * memvid_ask, ...); mutations fail with a core error.
+ *
+ * @param pool   Valid reader pool
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return Read-only handle on success, NULL on failure.
+ *         Return it with memvid_reader_pool_release(); never memvid_close() it.
+ */
+MemvidHandle *memvid_reader_pool_acquire(MemvidReaderPool *pool, MemvidError *error);
+
+/**
+ * Return a view to the pool.
+ *
+ * @param pool   Valid reader pool
+ * @param view   View from memvid_reader_pool_acquire() on this pool
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 if view was not checked out from this pool.
+ */
+int memvid_reader_pool_release(MemvidReaderPool *pool,
+                               MemvidHandle *view,
+                               MemvidError *error);
+
+/**
+ * Advance the pool to the latest committed snapshot.
+ *
+ * Views checked out afterwards observe all commits made before this call.
+ * Views currently checked out keep their snapshot until released.
+ *
+ * @param pool   Valid reader pool
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return The new snapshot generation (starting at 1), 0 on failure.
+ */
+uint64_t memvid_reader_pool_refresh(MemvidReaderPool *pool, MemvidError *error);
+
+/**
+ * Close a reader pool and all of its idle views.
+ *
+ * All views must have been released before this call.
+ *
+ * @param pool  Pool to close (safe to pass NULL)
+ */
+void memvid_reader_pool_close(MemvidReaderPool *pool);
+
+/* ============================================================================
+ * Shard Set Functions
+ * ============================================================================ */
+
+/**
+ * Open a set of memory files as one sharded memory.
+ *
+ * Puts are routed by a stable hash of the URI (or track); puts without the
+ * key are spread round-robin. Queries run on all shards in parallel. The
+ * path order defines shard indexes and must not change between opens.
+ *
+ * @param paths         Array of count shard paths (null-terminated UTF-8)
+ * @param count         Number of shards (1 to 65536)
+ * @param options_json  JSON string with options (NULL for defaults):
+ *                      {"create": false, "route": "uri" | "track"}
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Shard set on success, NULL on failure.
+ *         Caller owns the returned set. Must call memvid_shard_set_close() to free.
+ */
+MemvidShardSet *memvid_shard_set_open(const char *const *paths,
+                                      size_t count,
+                                      const char *options_json,
+                                      MemvidError *error);
+
+/**
+ * Borrow the handle of one shard.
+ *
+ * Use it with any per-handle function, e.g. memvid_frame_by_id() with the
+ * shard-local part of a frame ID.
+ *
+ * @param set    Valid shard set
+ * @param index  Shard index (position of its path at open)
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return Shard handle on success, NULL on failure.
+ *         The handle belongs to the set; never memvid_close() it.
+ */
+MemvidHandle *memvid_shard_set_shard(MemvidShardSet *set, uint32_t index, MemvidError *error);
+
+/**
+ * Add content to the shard chosen by the routing key.
+ *
+ * @param set           Valid shard set
+ * @param data          Pointer to content bytes
+ * @param len           Length of content in bytes
+ * @param options_json  JSON string with PutOptions (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Namespaced frame ID on success, 0 on failure.
+ */
+uint64_t memvid_shard_set_put(MemvidShardSet *set,
+                              const uint8_t *data,
+                              size_t len,
+                              const char *options_json,
+                              MemvidError *error);
+
+/**
+ * Commit every shard, in parallel.
+ *
+ * Shards commit independently; on failure the first error is reported.
+ *
+ * @param set    Valid shard set
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int32_t memvid_shard_set_commit(MemvidShardSet *set, MemvidError *error);
+
+/**
+ * Search every shard and merge a global top_k by score.
+ *
+ * Same request and response schema as memvid_search(), with namespaced
+ * frame IDs. Pagination cursors are rejected.
+ *
+ * @param set           Valid shard set
+ * @param request_json  JSON string with SearchRequest
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with SearchResponse on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_shard_set_search(MemvidShardSet *set, const char *request_json, MemvidError *error);
+
+/**
+ * Ask every shard and merge the retrieved context by score.
+ *
+ * Same request and response schema as memvid_ask(), with namespaced frame
+ * IDs. An answer and its citations come from the shard with the best hit.
+ *
+ * @param set           Valid shard set
+ * @param request_json  JSON string with ask parameters
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with ask response on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_shard_set_ask(MemvidShardSet *set, const char *request_json, MemvidError *error);
+
+/**
+ * Query every shard's timeline and merge the entries by timestamp.
+ *
+ * Same query and response schema as memvid_timeline(), with namespaced
+ * frame IDs.
+ *
+ * @param set         Valid shard set
+ * @param query_json  JSON string with query parameters (NULL for defaults)
+ * @param error       Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with timeline entries on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_shard_set_timeline(MemvidShardSet *set, const char *query_json, MemvidError *error);
+
+/**
+ * Close a shard set and all of its shard handles.
+ *
+ * Uncommitted puts are discarded; call memvid_shard_set_commit() first.
+ *
+ * @param set  Set to close (safe to pass NULL)
+ */
+void memvid_shard_set_close(MemvidShardSet *set);
+
 /* ============================================================================
  * Mutation Functions
  * ============================================================================ */
@@ -313,6 +1061,9 @@ uint64_t memvid_put_bytes(MemvidHandle *handle,
  *   "no_raw": false,
  *   "dedup": false
  * }
+ *
+ * With "dedup": true, a bloom filter of stored content hashes (saved as
+ * <file>.dedup on commit) skips the duplicate lookup for new content.
  */
 uint64_t memvid_put_bytes_with_options(MemvidHandle *handle,
                                        const uint8_t *data,
@@ -321,15 +1072,307 @@ uint64_t memvid_put_bytes_with_options(MemvidHandle *handle,
                                        MemvidError *error);
 
 /**
- * Commit pending changes to disk.
+ * Add content with binary options.
  *
- * @param handle  Valid Memvid handle
- * @param error   Out-parameter for error information (may be NULL)
+ * Binary counterpart of memvid_put_bytes_with_options(): options are read
+ * from a MemvidPutOptions struct, so no JSON is encoded or parsed.
+ *
+ * @param handle   Valid Memvid handle
+ * @param data     Pointer to content bytes
+ * @param len      Length of content in bytes
+ * @param options  Binary put options (NULL for defaults)
+ * @param error    Out-parameter for error information (may be NULL)
+ *
+ * @return Frame ID on success, 0 on failure.
+ */
+uint64_t memvid_put_bytes_bin(MemvidHandle *handle,
+                              const uint8_t *data,
+                              size_t len,
+                              const MemvidPutOptions *options,
+                              MemvidError *error);
+
+/**
+ * Add a batch of documents in a single call.
+ *
+ * Shared options are parsed once for the whole batch; per-item options_json
+ * fields override them (tags/labels are replaced, not merged). A failing item
+ * does not abort the batch: its frame ID is set to 0 and its code recorded.
+ *
+ * @param handle              Valid Memvid handle
+ * @param items               Array of count item descriptors
+ * @param count               Number of items
+ * @param shared_options_json JSON string with PutOptions for every item (NULL for defaults)
+ * @param frame_ids           Out-array of count frame IDs (must not be NULL if count > 0)
+ * @param codes               Out-array of count per-item error codes (may be NULL)
+ * @param error               Out-parameter for batch-level errors (may be NULL)
+ *
+ * @return Number of items stored successfully. On a batch-level failure
+ *         (invalid handle, NULL arrays, malformed shared options) nothing is
+ *         stored and 0 is returned with error set.
+ */
+size_t memvid_put_many(MemvidHandle *handle,
+                       const MemvidPutItem *items,
+                       size_t count,
+                       const char *shared_options_json,
+                       uint64_t *frame_ids,
+                       MemvidErrorCode *codes,
+                       MemvidError *error);
+
+/**
+ * Begin a streaming put.
+ *
+ * Chunks written with memvid_put_write() are spooled to an unlinked temporary
+ * file and memory-mapped by memvid_put_end(), so memory use stays at the
+ * caller's chunk size rather than the document size.
+ *
+ * @param options_json  JSON string with PutOptions (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Stream on success, NULL on failure.
+ *         Freed by memvid_put_end() or memvid_put_abort().
+ */
+MemvidPutStream *memvid_put_begin(const char *options_json, MemvidError *error);
+
+/**
+ * Append a chunk to a streaming put.
+ *
+ * @param stream  Stream from memvid_put_begin()
+ * @param data    Pointer to chunk bytes
+ * @param len     Length of chunk in bytes
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int memvid_put_write(MemvidPutStream *stream,
+                     const uint8_t *data,
+                     size_t len,
+                     MemvidError *error);
+
+/**
+ * Finish a streaming put and add the document to the memory.
+ *
+ * The stream is freed whether or not the put succeeds.
+ *
+ * @param handle  Valid Memvid handle
+ * @param stream  Stream from memvid_put_begin()
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return Frame ID on success, 0 on failure (check error->code).
+ */
+uint64_t memvid_put_end(MemvidHandle *handle, MemvidPutStream *stream, MemvidError *error);
+
+/**
+ * Discard a streaming put.
+ *
+ * @param stream  Stream to discard (safe to pass NULL)
+ */
+void memvid_put_abort(MemvidPutStream *stream);
+
+/**
+ * Add the contents of a file to the memory.
+ *
+ * The file is copied into an unlinked spool file, which is memory-mapped
+ * rather than read into a buffer. The file may be appended to or truncated
+ * during the call; the document is then whatever the copy read.
+ *
+ * @param handle        Valid Memvid handle
+ * @param path          Path of the file to ingest (null-terminated UTF-8 string)
+ * @param options_json  JSON string with PutOptions (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Frame ID on success, 0 on failure (check error->code).
+ */
+uint64_t memvid_put_path(MemvidHandle *handle,
+                         const char *path,
+                         const char *options_json,
+                         MemvidError *error);
+
+/**
+ * Add the contents of an open file descriptor to the memory (POSIX only).
+ *
+ * Regular files are copied in full into a spool file from offset 0,
+ * regardless of the descriptor's position, which is left unchanged. Pipes
+ * and sockets are read to EOF into a spool file. The spool is then
+ * memory-mapped, so the source may change during the call without harm.
+ * The descriptor is not closed.
+ *
+ * @param handle        Valid Memvid handle
+ * @param fd            Open, readable file descriptor
+ * @param options_json  JSON string with PutOptions (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Frame ID on success, 0 on failure (check error->code).
+ */
+uint64_t memvid_put_fd(MemvidHandle *handle,
+                       int fd,
+                       const char *options_json,
+                       MemvidError *error);
+
+/**
+ * Open a parallel ingest pipeline on a handle.
+ *
+ * Submitted documents pass through a prepare stage on a worker pool (option
+ * parsing and merging, and content hashing for the dedup filter) and a write
+ * stage on a writer thread that appends frames in submission order. The
+ * stages overlap: documents are written while the caller submits more and
+ * the workers prepare them.
+ *
+ * memvid-core runs content analysis (auto_tag, extract_dates,
+ * extract_triplets) and indexing inside its put and cannot run them apart
+ * from it, so that work is serialized in the write stage and bounds the
+ * pipeline's throughput.
+ *
+ * The handle is lent to the writer thread until memvid_ingest_finish()
+ * returns; do not use it in the meantime.
+ *
+ * @param handle              Valid Memvid handle
+ * @param workers             Prepare-stage threads (0 for the number of CPUs)
+ * @param queue_depth         Maximum documents in flight across all stages (0 for 64)
+ * @param shared_options_json JSON string with PutOptions for every document (NULL for defaults)
+ * @param error               Out-parameter for error information (may be NULL)
+ *
+ * @return Pipeline on success, NULL on failure.
+ *         Caller must drain and free it with memvid_ingest_finish().
+ */
+MemvidIngestPipeline *memvid_ingest_open(MemvidHandle *handle,
+                                         uint32_t workers,
+                                         uint32_t queue_depth,
+                                         const char *shared_options_json,
+                                         MemvidError *error);
+
+/**
+ * Submit a document to an ingest pipeline.
+ *
+ * The payload is copied, so data may be reused as soon as this returns.
+ * While queue_depth documents are in flight, this waits until the writer
+ * thread frees a slot.
+ *
+ * @param pipeline      Pipeline from memvid_ingest_open()
+ * @param data          Pointer to content bytes
+ * @param len           Length of content in bytes
+ * @param options_json  Per-document PutOptions overriding the shared ones (NULL to inherit)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Submission ticket (starting at 1) on success, 0 on failure.
+ *         Per-document outcomes are reported by memvid_ingest_finish().
+ */
+uint64_t memvid_ingest_submit(MemvidIngestPipeline *pipeline,
+                              const uint8_t *data,
+                              size_t len,
+                              const char *options_json,
+                              MemvidError *error);
+
+/**
+ * Get live ingest pipeline stats.
+ *
+ * @param pipeline  Pipeline from memvid_ingest_open()
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with per-stage stats, or NULL on failure.
+ *         Caller must free with memvid_string_free().
+ *
+ * Stats JSON: { "elapsed_ms", "workers", "queue_depth", "in_flight",
+ *               "submit_blocked_ms", "submit": {...}, "prepare": {...}, "write": {...} }
+ * where each stage reports items, bytes, busy_ms, items_per_sec and bytes_per_sec.
+ */
+char *memvid_ingest_stats(MemvidIngestPipeline *pipeline, MemvidError *error);
+
+/**
+ * Drain an ingest pipeline, free it, and return the handle to the caller.
+ *
+ * Frames are not committed; call memvid_commit() afterwards.
+ *
+ * @param pipeline  Pipeline from memvid_ingest_open() (freed by this call)
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with per-document outcomes in submission order and
+ *         final stats, or NULL on failure. Caller must free with memvid_string_free().
+ *
+ * Result JSON: { "submitted": 2, "stored": 1,
+ *                "results": [ { "ticket": 1, "frame_id": 0, "code": 0 },
+ *                             { "ticket": 2, "frame_id": 0, "code": 102, "message": "..." } ],
+ *                "stats": {...} }
+ */
+char *memvid_ingest_finish(MemvidIngestPipeline *pipeline, MemvidError *error);
+
+/**
+ * Commit pending changes to disk.
+ *
+ * @param handle  Valid Memvid handle
+ * @param error   Out-parameter for error information (may be NULL)
  *
  * @return 1 on success, 0 on failure.
  */
 int memvid_commit(MemvidHandle *handle, MemvidError *error);
 
+/**
+ * Configure group commit for memvid_commit_async().
+ *
+ * @param handle             Valid Memvid handle
+ * @param window_ms          Maximum time a commit request may wait to be coalesced
+ *                           with later ones (0 commits on every request, the default)
+ * @param max_pending_bytes  Put bytes that force a commit regardless of the window
+ *                           (0 disables the threshold)
+ * @param error              Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int memvid_set_commit_policy(MemvidHandle *handle,
+                             uint64_t window_ms,
+                             uint64_t max_pending_bytes,
+                             MemvidError *error);
+
+/**
+ * Register a callback invoked whenever commits make requests durable.
+ *
+ * @param handle    Valid Memvid handle
+ * @param callback  Function called with ctx and the new durable sequence (NULL to clear)
+ * @param ctx       Caller context passed back to callback
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int memvid_set_durability_callback(MemvidHandle *handle,
+                                   MemvidDurabilityCallback callback,
+                                   void *ctx,
+                                   MemvidError *error);
+
+/**
+ * Request a commit that may be coalesced with later requests.
+ *
+ * Pending requests are flushed with a single commit once the oldest has
+ * waited window_ms or the pending put bytes reach max_pending_bytes. The
+ * check runs on this call and on memvid_commit_poll(); memvid_commit_flush()
+ * and memvid_commit() flush unconditionally.
+ *
+ * @param handle  Valid Memvid handle
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return The request's sequence number (starting at 1), 0 on failure.
+ *         On a failed flush the request stays pending and is retried.
+ */
+uint64_t memvid_commit_async(MemvidHandle *handle, MemvidError *error);
+
+/**
+ * Get the highest durable sequence number, flushing if the window elapsed.
+ *
+ * @param handle  Valid Memvid handle
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return Highest durable sequence number (0 if none yet).
+ */
+uint64_t memvid_commit_poll(MemvidHandle *handle, MemvidError *error);
+
+/**
+ * Flush all pending commit requests now.
+ *
+ * @param handle  Valid Memvid handle
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return Highest durable sequence number on success, 0 on failure.
+ */
+uint64_t memvid_commit_flush(MemvidHandle *handle, MemvidError *error);
+
 /* ============================================================================
  * Search Functions
  * ============================================================================ */
@@ -350,9 +1393,30 @@ int memvid_commit(MemvidHandle *handle, MemvidError *error);
  *   "top_k": 10,
  *   "offset": 0,
  *   "track": "optional-track",
- *   "mode": "lex|vec|hybrid"
+ *   "mode": "lex|vec|hybrid",
+ *   "min_score": null,
+ *   "ids_only": false,
+ *   "max_candidates": null,
+ *   "time_budget_us": null,
+ *   "filters": {"tags": [], "labels": [], "kind": null,
+ *               "since": null, "until": null}
  * }
  *
+ * min_score drops lower-scoring hits and trims total_hits and context to
+ * the hits that clear it. ids_only skips snippets and context.
+ * max_candidates caps the hits the engine is asked for, including the
+ * over-fetch for filters, so a filtered search may return fewer than top_k
+ * hits. time_budget_us counts from the start of the call. The engine search
+ * itself is not interrupted and its hits are always returned; once the
+ * budget runs out, further filter over-fetches, per-URI lookups and the
+ * rebuilt context are skipped and "partial" is true.
+ * filters keeps hits whose frame has all tags, any label, the kind and a
+ * timestamp in since..until (inclusive); filtered results are one page.
+ * Filters are resolved against posting lists saved as <file>.mindex on
+ * commit. When at most 32 frames match and the request sets no uri or
+ * scope, each of their URIs is searched on its own instead of over-fetching
+ * the whole ranking, and total_hits counts the matching frames ranked.
+ *
  * Response JSON Schema:
  * {
  *   "hits": [
@@ -364,13 +1428,173 @@ int memvid_commit(MemvidHandle *handle, MemvidError *error);
  *       "title": "optional-title"
  *     }
  *   ],
- *   "total": 100
+ *   "total": 100,
+ *   "partial": false
  * }
  */
 char *memvid_search(MemvidHandle *handle,
                     const char *request_json,
                     MemvidError *error);
 
+/**
+ * Search the memory, allocating the response in an arena.
+ *
+ * Same as memvid_search(), but the response string is bump-allocated in arena.
+ *
+ * @param handle        Valid Memvid handle
+ * @param request_json  JSON string with search parameters (see memvid_search)
+ * @param arena         Arena that owns the response
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with search results on success, NULL on failure.
+ *         Valid until memvid_arena_reset() or memvid_arena_destroy();
+ *         never pass it to memvid_string_free().
+ */
+const char *memvid_search_arena(MemvidHandle *handle,
+                                const char *request_json,
+                                MemvidArena *arena,
+                                MemvidError *error);
+
+/**
+ * Search the memory, writing results into caller-owned buffers.
+ *
+ * Allocation-free counterpart of memvid_search(): hits are written as
+ * MemvidSearchHit records and their strings are packed into one arena buffer,
+ * so no JSON is produced or parsed on the response path. With ids_only every
+ * hit string is empty (length 0). The time budget works as for
+ * memvid_search(); result->partial reports whether it cut the search short.
+ *
+ * @param handle          Valid Memvid handle
+ * @param request_json    JSON string with search parameters (same as memvid_search)
+ * @param hits            Out-array for hit records (may be NULL if hits_capacity is 0)
+ * @param hits_capacity   Number of entries available in hits
+ * @param arena           Out-buffer for hit strings (may be NULL if arena_capacity is 0)
+ * @param arena_capacity  Size of arena in bytes
+ * @param result          Out-parameter for the result summary (must not be NULL)
+ * @param error           Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure. If either buffer is too small the error
+ *         code is MemvidErrorCode_BufferTooSmall, nothing is written to hits or
+ *         arena, and result->hit_count / result->arena_bytes hold the required
+ *         sizes.
+ */
+int memvid_search_into(MemvidHandle *handle,
+                       const char *request_json,
+                       MemvidSearchHit *hits,
+                       size_t hits_capacity,
+                       uint8_t *arena,
+                       size_t arena_capacity,
+                       MemvidSearchResult *result,
+                       MemvidError *error);
+
+/**
+ * Search the memory with a binary request and binary result.
+ *
+ * Takes a MemvidSearchQuery instead of request JSON and writes the same
+ * layout as memvid_search_into(), so neither direction is encoded or parsed.
+ *
+ * @param handle          Valid Memvid handle
+ * @param query           Binary search request (must not be NULL)
+ * @param hits            Out-array for hit records (may be NULL if hits_capacity is 0)
+ * @param hits_capacity   Number of entries available in hits
+ * @param arena           Out-buffer for hit strings (may be NULL if arena_capacity is 0)
+ * @param arena_capacity  Size of arena in bytes
+ * @param result          Out-parameter for the result summary (must not be NULL)
+ * @param error           Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure, with the same BufferTooSmall sizing
+ *         behaviour as memvid_search_into().
+ */
+int memvid_search_bin(MemvidHandle *handle,
+                      const MemvidSearchQuery *query,
+                      MemvidSearchHit *hits,
+                      size_t hits_capacity,
+                      uint8_t *arena,
+                      size_t arena_capacity,
+                      MemvidSearchResult *result,
+                      MemvidError *error);
+
+/**
+ * Run several searches against one handle.
+ *
+ * Requests are parsed up front and run back to back against the same open
+ * index. Use memvid_reader_pool_search_batch() to spread a batch across cores.
+ *
+ * @param handle         Valid Memvid handle
+ * @param requests_json  JSON array of search requests (same schema as memvid_search)
+ * @param error          Out-parameter for error information (may be NULL)
+ *
+ * @return JSON array of search responses in request order, or NULL on failure.
+ *         The whole batch fails if any request fails.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_search_batch(MemvidHandle *handle,
+                          const char *requests_json,
+                          MemvidError *error);
+
+/**
+ * Run several searches in parallel across a reader pool.
+ *
+ * Checks out one view plus as many idle views as are available (up to one per
+ * request) without blocking, all at the same snapshot generation, and runs
+ * requests on them in parallel. Every response observes the same commit.
+ *
+ * @param pool           Valid reader pool
+ * @param requests_json  JSON array of search requests (same schema as memvid_search)
+ * @param error          Out-parameter for error information (may be NULL)
+ *
+ * @return JSON array of search responses in request order, or NULL on failure.
+ *         The whole batch fails if any request fails.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_reader_pool_search_batch(MemvidReaderPool *pool,
+                                      const char *requests_json,
+                                      MemvidError *error);
+
+/**
+ * Prepare a search request for repeated execution.
+ *
+ * The template is parsed once and the matching set of its tag, label and
+ * kind filters is resolved against handle right away.
+ *
+ * @param handle         Valid Memvid handle
+ * @param template_json  SearchRequest JSON (see memvid_search())
+ * @param error          Out-parameter for error information (may be NULL)
+ *
+ * @return Prepared query on success, NULL on failure.
+ *         Caller must free with memvid_prepared_free().
+ */
+MemvidPreparedQuery *memvid_prepare_search(MemvidHandle *handle,
+                                           const char *template_json,
+                                           MemvidError *error);
+
+/**
+ * Execute a prepared query with bound parameters.
+ *
+ * Behaves like memvid_search() with the template and the bound parameters,
+ * including the result cache, but nothing is parsed. The filter's matching
+ * set is reused and extended only with frames appended since the last run.
+ *
+ * @param handle    Valid Memvid handle
+ * @param prepared  Prepared query from memvid_prepare_search()
+ * @param params    Bound parameters (NULL to run the template as is)
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return JSON SearchResponse on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_execute_prepared(MemvidHandle *handle,
+                              MemvidPreparedQuery *prepared,
+                              const MemvidPreparedParams *params,
+                              MemvidError *error);
+
+/**
+ * Free a prepared query.
+ *
+ * @param prepared  Prepared query to free (safe to pass NULL)
+ */
+void memvid_prepared_free(MemvidPreparedQuery *prepared);
+
 /**
  * Free a string returned by memvid functions.
  *
@@ -385,6 +1609,10 @@ void memvid_string_free(char *str);
 /**
  * Get memory statistics.
  *
+ * Statistics are computed at most once per commit or delete; puts in
+ * between update frame_count and active_frame_count only, so byte counts
+ * reflect the last commit.
+ *
  * @param handle  Valid Memvid handle
  * @param stats   Out-parameter for statistics (must not be NULL)
  * @param error   Out-parameter for error information (may be NULL)
@@ -393,6 +1621,18 @@ void memvid_string_free(char *str);
  */
 int memvid_stats(MemvidHandle *handle, MemvidStats *stats, MemvidError *error);
 
+/**
+ * Get extended memory statistics.
+ *
+ * @param handle  Valid Memvid handle
+ * @param stats   Out-parameter with struct_size set by the caller
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure (MemvidErrorCode_BufferTooSmall if
+ *         struct_size does not cover the base fields).
+ */
+int memvid_stats_ext(MemvidHandle *handle, MemvidStatsExt *stats, MemvidError *error);
+
 /**
  * Get the number of frames in the memory.
  *
@@ -420,6 +1660,25 @@ uint64_t memvid_frame_count(MemvidHandle *handle, MemvidError *error);
  */
 char *memvid_frame_by_id(MemvidHandle *handle, uint64_t frame_id, MemvidError *error);
 
+/**
+ * Get frame metadata by ID, allocating the response in an arena.
+ *
+ * Same as memvid_frame_by_id(), but the JSON string is bump-allocated in arena.
+ *
+ * @param handle    Valid Memvid handle
+ * @param frame_id  Frame identifier
+ * @param arena     Arena that owns the response
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with frame metadata on success, NULL on failure.
+ *         Valid until memvid_arena_reset() or memvid_arena_destroy();
+ *         never pass it to memvid_string_free().
+ */
+const char *memvid_frame_by_id_arena(MemvidHandle *handle,
+                                     uint64_t frame_id,
+                                     MemvidArena *arena,
+                                     MemvidError *error);
+
 /**
  * Get frame metadata by URI.
  *
@@ -432,6 +1691,46 @@ char *memvid_frame_by_id(MemvidHandle *handle, uint64_t frame_id, MemvidError *e
  */
 char *memvid_frame_by_uri(MemvidHandle *handle, const char *uri, MemvidError *error);
 
+/**
+ * Get metadata for many frames by ID in one call.
+ *
+ * IDs are resolved in ascending order so frame-table reads are sequential;
+ * results are returned in input order.
+ *
+ * @param handle  Valid Memvid handle
+ * @param ids     Array of count frame identifiers (may be NULL if count is 0)
+ * @param count   Number of IDs
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return JSON array with one entry per input ID (same schema as
+ *         memvid_frame_by_id(), or null when the frame does not exist),
+ *         NULL on failure. Any error other than a missing frame fails the
+ *         whole call. Caller must free with memvid_string_free().
+ */
+char *memvid_frames_by_ids(MemvidHandle *handle,
+                           const uint64_t *ids,
+                           size_t count,
+                           MemvidError *error);
+
+/**
+ * Get metadata for many frames by URI in one call.
+ *
+ * @param handle  Valid Memvid handle
+ * @param uris    Array of count URIs (null-terminated UTF-8 strings, entries may be NULL)
+ * @param count   Number of URIs
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return JSON array with one entry per input URI (same schema as
+ *         memvid_frame_by_id(), or null when no frame matches or the entry
+ *         is NULL), NULL on failure. Invalid UTF-8 and any error other than
+ *         a missing frame fail the whole call. Caller must free with
+ *         memvid_string_free().
+ */
+char *memvid_frames_by_uris(MemvidHandle *handle,
+                            const char *const *uris,
+                            size_t count,
+                            MemvidError *error);
+
 /**
  * Get frame text content by ID.
  *
@@ -444,6 +1743,36 @@ char *memvid_frame_by_uri(MemvidHandle *handle, const char *uri, MemvidError *er
  */
 char *memvid_frame_content(MemvidHandle *handle, uint64_t frame_id, MemvidError *error);
 
+/**
+ * Get frame content by ID as a pointer/length view.
+ *
+ * Returns the frame's raw payload bytes, which need not be UTF-8. Unlike
+ * memvid_frame_content(), the content is not copied into a C string, so
+ * payloads with interior NUL bytes are returned intact and no strlen is
+ * needed. The view owns its buffer independently of the handle.
+ *
+ * @param handle    Valid Memvid handle
+ * @param frame_id  Frame identifier (0-indexed)
+ * @param view      Out-parameter for the content view (must not be NULL)
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure (view is set to NULL/0/0).
+ *         Caller must release the view with memvid_view_release().
+ */
+int memvid_frame_payload_view(MemvidHandle *handle,
+                              uint64_t frame_id,
+                              MemvidView *view,
+                              MemvidError *error);
+
+/**
+ * Release a view returned by memvid_frame_payload_view().
+ *
+ * After this call, view->data is NULL and view->len and view->capacity are 0.
+ *
+ * @param view  View to release (safe to pass NULL or an already released view)
+ */
+void memvid_view_release(MemvidView *view);
+
 /**
  * Soft-delete a frame.
  *
@@ -462,6 +1791,13 @@ uint64_t memvid_delete_frame(MemvidHandle *handle, uint64_t frame_id, MemvidErro
 /**
  * Query the timeline (chronological frame list).
  *
+ * The handle keeps frame timestamps in partitions with their min/max
+ * timestamps, saved as <file>.tindex on commit; only partitions overlapping
+ * since/until are read, and the bounds are narrowed to reach at most
+ * `limit` entries before the query runs. Memories without a usable
+ * .tindex file are queried without narrowing. The same applies to
+ * memvid_timeline_bin() and memvid_timeline_next().
+ *
  * @param handle      Valid Memvid handle
  * @param query_json  JSON string with query parameters (NULL for defaults)
  * @param error       Out-parameter for error information (may be NULL)
@@ -479,6 +1815,85 @@ uint64_t memvid_delete_frame(MemvidHandle *handle, uint64_t frame_id, MemvidErro
  */
 char *memvid_timeline(MemvidHandle *handle, const char *query_json, MemvidError *error);
 
+/**
+ * Query the timeline with a binary query and binary result.
+ *
+ * Binary counterpart of memvid_timeline(): entries are written as
+ * MemvidTimelineEntry records with their strings packed into one arena
+ * buffer, so no JSON is produced or parsed.
+ *
+ * @param handle            Valid Memvid handle
+ * @param query             Binary timeline query (NULL for defaults)
+ * @param entries           Out-array for entry records (may be NULL if entries_capacity is 0)
+ * @param entries_capacity  Number of entries available in entries
+ * @param arena             Out-buffer for entry strings (may be NULL if arena_capacity is 0)
+ * @param arena_capacity    Size of arena in bytes
+ * @param result            Out-parameter for the result summary (must not be NULL)
+ * @param error             Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure. If either buffer is too small the error
+ *         code is MemvidErrorCode_BufferTooSmall, nothing is written to entries
+ *         or arena, and result holds the required sizes.
+ */
+int memvid_timeline_bin(MemvidHandle *handle,
+                        const MemvidTimelineQuery *query,
+                        MemvidTimelineEntry *entries,
+                        size_t entries_capacity,
+                        uint8_t *arena,
+                        size_t arena_capacity,
+                        MemvidTimelineResult *result,
+                        MemvidError *error);
+
+/**
+ * Open a streaming cursor over the timeline.
+ *
+ * The cursor walks the time index lazily; each memvid_timeline_next() call
+ * reads only the next batch, so memory stays bounded by the batch size.
+ *
+ * @param query_json  JSON string with query parameters (NULL for defaults,
+ *                    same schema as memvid_timeline; limit caps the total)
+ * @param error       Out-parameter for error information (may be NULL)
+ *
+ * @return Cursor on success, NULL on failure.
+ *         Caller owns the cursor. Must call memvid_timeline_close() to free.
+ */
+MemvidTimelineCursor *memvid_timeline_open(const char *query_json, MemvidError *error);
+
+/**
+ * Fetch the next batch of timeline entries from a cursor.
+ *
+ * @param handle      Valid Memvid handle the cursor is iterating over
+ * @param cursor      Valid timeline cursor
+ * @param batch_size  Maximum entries to return (0 for the default of 100)
+ * @param error       Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with the batch on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ *
+ * Response JSON Schema:
+ * {
+ *   "entries": [ ... same entry schema as memvid_timeline ... ],
+ *   "count": 100,
+ *   "done": false
+ * }
+ *
+ * done is true once the cursor is exhausted; further calls return an empty batch.
+ * A batch reads at most 4096 entries beyond batch_size, to skip the entries
+ * already emitted at its starting timestamp; a cursor positioned inside a
+ * longer run of equal timestamps fails with MemvidErrorCode_InvalidCursor.
+ */
+char *memvid_timeline_next(MemvidHandle *handle,
+                           MemvidTimelineCursor *cursor,
+                           uint64_t batch_size,
+                           MemvidError *error);
+
+/**
+ * Close and free a timeline cursor.
+ *
+ * @param cursor  Cursor to close (safe to pass NULL)
+ */
+void memvid_timeline_close(MemvidTimelineCursor *cursor);
+
 /* ============================================================================
  * Verification Functions
  * ============================================================================ */
@@ -495,6 +1910,35 @@ char *memvid_timeline(MemvidHandle *handle, const char *query_json, MemvidError
  */
 char *memvid_verify(const char *path, int deep, MemvidError *error);
 
+/**
+ * Verify several files in parallel, skipping files unchanged since a checkpoint.
+ *
+ * Files are verified on worker threads. A file whose size and modification
+ * time match a checkpoint entry (verified at least as deeply) is reported as
+ * "skipped" without being opened. The report carries a new checkpoint for
+ * the next run, so a cancelled run resumes with the files it had not
+ * finished and a periodic run re-verifies only files written since.
+ *
+ * @param paths         Array of count paths to .mv2 files
+ * @param count         Number of paths
+ * @param options_json  JSON string with options (NULL for defaults):
+ *                      {"deep": false, "threads": 0, "checkpoint": {...}}
+ * @param progress      Progress callback (may be NULL)
+ * @param ctx           Context pointer passed to progress (may be NULL)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with per-file results, totals and the new checkpoint on
+ *         success, NULL on failure. Files that fail verification or cannot be
+ *         read are reported per file and do not fail the call.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_verify_many(const char *const *paths,
+                         size_t count,
+                         const char *options_json,
+                         MemvidVerifyProgressFn progress,
+                         void *ctx,
+                         MemvidError *error);
+
 /* ============================================================================
  * RAG/Ask Functions
  * ============================================================================ */
@@ -541,6 +1985,155 @@ char *memvid_verify(const char *path, int deep, MemvidError *error);
  */
 char *memvid_ask(MemvidHandle *handle, const char *request_json, MemvidError *error);
 
+/**
+ * Ask a question, allocating the response in an arena.
+ *
+ * Same as memvid_ask(), but the response string is bump-allocated in arena.
+ *
+ * @param handle        Valid Memvid handle
+ * @param request_json  JSON string with ask parameters (see memvid_ask)
+ * @param arena         Arena that owns the response
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with ask response on success, NULL on failure.
+ *         Valid until memvid_arena_reset() or memvid_arena_destroy();
+ *         never pass it to memvid_string_free().
+ */
+const char *memvid_ask_arena(MemvidHandle *handle,
+                             const char *request_json,
+                             MemvidArena *arena,
+                             MemvidError *error);
+
+/**
+ * Ask a question and stream the context one event at a time.
+ *
+ * Runs the same retrieval as memvid_ask(), then calls callback on the
+ * calling thread with each context fragment (MEMVID_ASK_FRAGMENT) in rank
+ * order, each citation (MEMVID_ASK_CITATION), and a final summary
+ * (MEMVID_ASK_DONE) with the stats:
+ * {"question", "mode", "retriever", "context_only", "answer", "total_hits",
+ *  "fragments", "citations", "stats"}
+ * The query cache is not used.
+ *
+ * @param handle        Valid Memvid handle
+ * @param request_json  JSON string with ask parameters (see memvid_ask())
+ * @param callback      Event callback (must not be NULL)
+ * @param ctx           Context pointer passed through to callback
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success (including when callback stops the stream), 0 on failure.
+ */
+int32_t memvid_ask_stream(MemvidHandle *handle,
+                          const char *request_json,
+                          MemvidAskStreamFn callback,
+                          void *ctx,
+                          MemvidError *error);
+
+/* ============================================================================
+ * Vector Search Functions
+ *
+ * Require the "vec" feature (see memvid_features()); otherwise they fail with
+ * MemvidErrorCode_VecNotEnabled. Embeddings are computed by the caller.
+ * ============================================================================ */
+
+/**
+ * Add content with a pre-computed embedding.
+ *
+ * The embedding is stored in the vector index as-is, so it must come from the
+ * same model (and dimension) as the other embeddings in the file.
+ *
+ * @param handle        Valid Memvid handle
+ * @param data          Pointer to content bytes
+ * @param len           Length of content in bytes
+ * @param embedding     Pointer to dim embedding components (must not be NULL)
+ * @param dim           Number of components in embedding
+ * @param options_json  JSON string with PutOptions (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Frame ID on success, 0 on failure.
+ */
+uint64_t memvid_put_bytes_with_embedding(MemvidHandle *handle,
+                                         const uint8_t *data,
+                                         size_t len,
+                                         const float *embedding,
+                                         size_t dim,
+                                         const char *options_json,
+                                         MemvidError *error);
+
+/**
+ * Search by a pre-computed query embedding.
+ *
+ * The vector must have the dimension of the stored embeddings; a mismatch
+ * fails with MemvidErrorCode_VecDimensionMismatch. In "hybrid" mode, vector
+ * hits are fused with lexical matches for "text".
+ *
+ * @param handle        Valid Memvid handle
+ * @param query         Pointer to dim query vector components (must not be NULL)
+ * @param dim           Number of components in query
+ * @param top_k         Maximum number of hits
+ * @param filters_json  JSON string with filters (NULL for defaults)
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with the ask response (see memvid_ask) on success, NULL
+ *         on failure. Hits are in "retrieval.hits".
+ *         Caller must free with memvid_string_free().
+ *
+ * Filters JSON Schema:
+ * {
+ *   "mode": "sem",
+ *   "text": "lexical query for hybrid mode",
+ *   "snippet_chars": 200,
+ *   "uri": null,
+ *   "scope": null,
+ *   "start": null,
+ *   "end": null
+ * }
+ *
+ * Mode values: "sem", "hybrid" (default: "sem")
+ */
+char *memvid_search_vec(MemvidHandle *handle,
+                        const float *query,
+                        size_t dim,
+                        size_t top_k,
+                        const char *filters_json,
+                        MemvidError *error);
+
+/* ============================================================================
+ * Query Cache Functions
+ * ============================================================================ */
+
+/**
+ * Configure the result cache for memvid_search() and memvid_ask().
+ *
+ * Requests that normalize to the same JSON (ignoring whitespace, field order
+ * and omitted defaults) are answered with the stored response string, without
+ * searching or serializing again; cached responses are byte-identical to the
+ * original, including elapsed_ms. The cache is flushed by memvid_commit(),
+ * the group-commit functions and memvid_delete_frame().
+ *
+ * @param handle       Valid Memvid handle
+ * @param max_entries  Maximum cached responses (0 disables and clears the cache, the default)
+ * @param max_bytes    Maximum cached bytes for requests and responses (0 for no byte limit)
+ * @param error        Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int memvid_cache_configure(MemvidHandle *handle,
+                           uint64_t max_entries,
+                           uint64_t max_bytes,
+                           MemvidError *error);
+
+/**
+ * Get result cache counters.
+ *
+ * @param handle  Valid Memvid handle
+ * @param stats   Out-parameter for cache counters (must not be NULL)
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int memvid_cache_stats(MemvidHandle *handle, MemvidCacheStats *stats, MemvidError *error);
+
 /* ============================================================================
  * Doctor (File Repair) Functions
  * ============================================================================ */
@@ -588,6 +2181,278 @@ char *memvid_doctor_plan(const char *path, const char *options_json, MemvidError
  */
 char *memvid_doctor_apply(const char *path, const char *plan_json, MemvidError *error);
 
+/**
+ * Reclaim the space held by deleted frames without closing the handle.
+ *
+ * Pending writes are committed; the committed file is copied (throttled to
+ * io_bytes_per_sec), vacuumed and re-indexed on a worker thread, then renamed
+ * over the original and reopened in place. If the handle was written to while
+ * the copy was built the result is "stale" and discarded, with a "hint" on
+ * how to retry, so a background compaction cannot finish under a steady write
+ * stream. With catch_up set, a stale copy is instead rebuilt unthrottled when
+ * it is finished, blocking the handle's writes for one copy, and the status
+ * reports "caught_up": true. Reader pool views keep their snapshot until
+ * memvid_reader_pool_refresh(). Frame IDs are reassigned by the vacuum.
+ *
+ * @param handle        Valid Memvid handle opened for writing
+ * @param options_json  JSON string with options (NULL for defaults):
+ *                      {"min_tombstone_ratio": 0.2, "io_bytes_per_sec": 0,
+ *                       "background": false, "catch_up": false}
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON status on success, NULL on failure. state is "skipped",
+ *         "running" (background), "done" or "stale".
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_compact(MemvidHandle *handle, const char *options_json, MemvidError *error);
+
+/**
+ * Check on a background compaction, finishing it if the copy is ready.
+ *
+ * @param handle  Valid Memvid handle
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return JSON status (same schema as memvid_compact, state "idle" when none
+ *         is in progress) on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_compact_poll(MemvidHandle *handle, MemvidError *error);
+
+/* ============================================================================
+ * Snapshot Streaming Functions
+ * ============================================================================ */
+
+/**
+ * Stream a point-in-time snapshot of a memory for replication or backup.
+ *
+ * Pending writes are committed, then the committed file is streamed in
+ * 64 KiB blocks. If since is a position returned by one of the handle's last
+ * 8 streams, only blocks changed since then are sent; otherwise (including
+ * since = 0) the whole file is sent. Either way the whole file is read and
+ * hashed once, in the same pass that sends it, and writes on the handle
+ * wait until the stream ends.
+ *
+ * @param handle  Valid Memvid handle opened from a file
+ * @param since   Position from an earlier stream, or 0 for a full snapshot
+ * @param writer  Callback receiving the stream bytes in order
+ * @param ctx     Context pointer passed back to writer
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return Position of this snapshot (non-zero) to pass as since next time,
+ *         0 on failure or if writer aborted.
+ */
+uint64_t memvid_snapshot_stream(MemvidHandle *handle,
+                                uint64_t since,
+                                MemvidSnapshotWriteFn writer,
+                                void *ctx,
+                                MemvidError *error);
+
+/**
+ * Apply a snapshot stream to a replica.
+ *
+ * The file is rebuilt next to the replica's file and checked against the
+ * stream's digests before it is renamed over it and the handle reopened.
+ * On failure the replica is unchanged. Incremental streams fail unless the
+ * replica is at the stream's base position. Uncommitted writes on the
+ * replica are discarded.
+ *
+ * @param handle  Replica handle opened from a file
+ * @param reader  Callback supplying the stream bytes in order
+ * @param ctx     Context pointer passed back to reader
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return Position of the applied snapshot, 0 on failure.
+ */
+uint64_t memvid_apply_stream(MemvidHandle *handle,
+                             MemvidSnapshotReadFn reader,
+                             void *ctx,
+                             MemvidError *error);
+
+/* ============================================================================
+ * Warmup Functions
+ * ============================================================================ */
+
+/**
+ * Pre-fault a memory file and chosen frames into the page cache.
+ *
+ * The whole file gets the "file" readahead ("async", "populate" or "none");
+ * index segments are warmed as part of the file. Frames listed by ID, URI or
+ * exported hot set are read on worker threads through read-only views, so
+ * only committed frames are found.
+ *
+ * @param handle        Valid Memvid handle opened from a file
+ * @param options_json  JSON string with options (NULL for defaults):
+ *                      {"file": "async", "frame_ids": [], "uris": [],
+ *                       "hot_set": null, "threads": 0, "wait": true}
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return JSON report on success, NULL on failure:
+ *         {"file_bytes", "frames_requested", "frames_warmed", "frame_bytes",
+ *          "frames_missing", "pending", "elapsed_ms"}
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_warmup(MemvidHandle *handle, const char *options_json, MemvidError *error);
+
+/**
+ * Start, resize or stop hot-set tracking on a handle.
+ *
+ * While enabled, frames returned by searches and memvid_frame_by_id() are
+ * counted in a bounded set. Cached responses are not counted. When the set is
+ * full, a newly seen frame replaces the least-hit one, so one-off hits never
+ * evict hot frames.
+ *
+ * @param handle    Valid Memvid handle
+ * @param capacity  Maximum frames tracked (0 disables tracking and clears it)
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int32_t memvid_hot_set_configure(MemvidHandle *handle, size_t capacity, MemvidError *error);
+
+/**
+ * Export the hottest frames seen on a handle.
+ *
+ * @param handle  Valid Memvid handle
+ * @param limit   Maximum frames to export (0 for all)
+ * @param error   Out-parameter for error information (may be NULL)
+ *
+ * @return JSON {"frames": [{"frame_id", "hits"}]} by descending hits on
+ *         success, NULL on failure. Pass it as the "hot_set" option of
+ *         memvid_warmup(). Caller must free with memvid_string_free().
+ */
+char *memvid_hot_set_export(MemvidHandle *handle, size_t limit, MemvidError *error);
+
+/* ============================================================================
+ * Executor Functions
+ * ============================================================================ */
+
+/**
+ * Start an executor for running blocking calls off the caller's thread.
+ *
+ * Tasks on the same handle run one at a time in submission order; tasks on
+ * different handles (for example reader pool views) run in parallel.
+ *
+ * @param threads  Worker threads (0 for one per core)
+ * @param error    Out-parameter for error information (may be NULL)
+ *
+ * @return Executor on success, NULL on failure.
+ *         Caller must free with memvid_executor_close().
+ */
+MemvidExecutor *memvid_executor_open(uint32_t threads, MemvidError *error);
+
+/**
+ * Submit a blocking call to run on the executor.
+ *
+ * The request is copied. The handle is lent to the executor: do not use it
+ * elsewhere, or close it, until the task's completion has been delivered.
+ *
+ * @param executor      Valid executor
+ * @param handle        Handle the call runs on (may be NULL for MEMVID_TASK_VERIFY)
+ * @param op            MEMVID_TASK_* operation
+ * @param request_json  SearchRequest (SEARCH), AskRequest (ASK), NULL (COMMIT)
+ *                      or {"path": "...", "deep": false} (VERIFY)
+ * @param callback      Completion callback, or NULL to queue the completion
+ *                      for memvid_executor_poll()
+ * @param ctx           Context pointer passed back to callback
+ * @param error         Out-parameter for error information (may be NULL)
+ *
+ * @return Task ID (non-zero) on success, 0 on failure.
+ */
+uint64_t memvid_executor_submit(MemvidExecutor *executor,
+                                MemvidHandle *handle,
+                                int32_t op,
+                                const char *request_json,
+                                MemvidCompletionFn callback,
+                                void *ctx,
+                                MemvidError *error);
+
+/**
+ * Cancel a submitted task.
+ *
+ * A task that has not started is never run; a running task finishes but its
+ * result is discarded. The task still completes, as MEMVID_TASK_CANCELLED.
+ *
+ * @param executor  Valid executor
+ * @param task_id   ID from memvid_executor_submit()
+ *
+ * @return 1 if the task was pending or running, 0 if it already completed.
+ */
+int32_t memvid_executor_cancel(MemvidExecutor *executor, uint64_t task_id);
+
+/**
+ * Eventfd that becomes readable when completions are queued (Linux only).
+ *
+ * Read it to reset the count, then drain with memvid_executor_poll(). The
+ * descriptor is closed by memvid_executor_close().
+ *
+ * @param executor  Valid executor
+ *
+ * @return The descriptor, or -1 if unavailable on this platform.
+ */
+int32_t memvid_executor_fd(MemvidExecutor *executor);
+
+/**
+ * Drain queued completions without blocking.
+ *
+ * @param executor  Valid executor
+ * @param out       Array receiving up to max completions
+ * @param max       Capacity of out
+ * @param error     Out-parameter for error information (may be NULL)
+ *
+ * @return Number of completions written. Caller owns each completion's
+ *         result (free with memvid_string_free()) and error (free with
+ *         memvid_error_free()).
+ */
+size_t memvid_executor_poll(MemvidExecutor *executor,
+                            MemvidCompletion *out,
+                            size_t max,
+                            MemvidError *error);
+
+/**
+ * Close an executor.
+ *
+ * Tasks not yet started complete as cancelled, running tasks are waited
+ * for, and unpolled completions are freed.
+ *
+ * @param executor  Executor to close (safe to pass NULL)
+ */
+void memvid_executor_close(MemvidExecutor *executor);
+
+/* ============================================================================
+ * Metrics Functions
+ * ============================================================================ */
+
+/**
+ * Turn per-call latency and byte recording on or off.
+ *
+ * Recording is off by default; while off, instrumented calls do not read
+ * the clock. Error counts are always kept.
+ *
+ * @param enabled  Non-zero to enable recording, 0 to disable
+ *
+ * @return 1 if recording was previously enabled, 0 otherwise.
+ */
+int32_t memvid_metrics_enable(int32_t enabled);
+
+/**
+ * Clear all histograms, byte counters and error counts.
+ */
+void memvid_metrics_reset(void);
+
+/**
+ * Get process-wide call metrics.
+ *
+ * Each instrumented entry point reports call count, bytes in and out, and
+ * latency histograms for the whole call and for the parse, core, serialize
+ * and copy phases. Errors are counted per MemvidErrorCode.
+ *
+ * @param error  Out-parameter for error information (may be NULL)
+ *
+ * @return JSON string with metrics on success, NULL on failure.
+ *         Caller must free with memvid_string_free().
+ */
+char *memvid_metrics_snapshot(MemvidError *error);
+
 /* ============================================================================
  * Memory Management Functions
  * ============================================================================ */
@@ -601,6 +2466,58 @@ char *memvid_doctor_apply(const char *path, const char *plan_json, MemvidError *
  */
 void memvid_error_free(MemvidError *error);
 
+/**
+ * Route returned strings through a caller allocator.
+ *
+ * Every string later freed with memvid_string_free(), and every arena chunk,
+ * is allocated with malloc_fn and released with free_fn. Error messages are
+ * unaffected. Hooks can be installed once per process, before any function
+ * has returned a string; later calls fail with MemvidErrorCode_InvalidState.
+ *
+ * @param malloc_fn  Allocation function (must not be NULL)
+ * @param free_fn    Deallocation function (must not be NULL)
+ * @param ctx        Context pointer passed to both hooks (may be NULL)
+ * @param error      Out-parameter for error information (may be NULL)
+ *
+ * @return 1 on success, 0 on failure.
+ */
+int32_t memvid_set_allocator(MemvidMallocFn malloc_fn,
+                             MemvidFreeFn free_fn,
+                             void *ctx,
+                             MemvidError *error);
+
+/**
+ * Create a response arena for the *_arena functions.
+ *
+ * @param initial_capacity  Size of the first chunk in bytes (0 for 64 KiB)
+ * @param error             Out-parameter for error information (may be NULL)
+ *
+ * @return Arena on success, NULL on failure.
+ *         Caller owns the returned arena. Must call memvid_arena_destroy() to free.
+ */
+MemvidArena *memvid_arena_create(size_t initial_capacity, MemvidError *error);
+
+/**
+ * Release every string allocated in the arena, keeping its memory for reuse.
+ *
+ * @param arena  Arena to reset (safe to pass NULL)
+ */
+void memvid_arena_reset(MemvidArena *arena);
+
+/**
+ * Get the arena's total capacity in bytes.
+ *
+ * @param arena  Valid arena (NULL returns 0)
+ */
+size_t memvid_arena_capacity(const MemvidArena *arena);
+
+/**
+ * Free an arena and every string allocated in it.
+ *
+ * @param arena  Arena to free (safe to pass NULL)
+ */
+void memvid_arena_destroy(MemvidArena *arena);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,458 @@
+//! Response memory: allocator hooks and per-request arenas.
+//!
+//! By default every returned string is a separate heap allocation freed with
+//! `memvid_string_free`. Callers can route those allocations through their
+//! own allocator with `memvid_set_allocator`, or have search, ask and frame
+//! responses bump-allocated in a `MemvidArena` and release them all at once
+//! with `memvid_arena_reset`.
+
+use crate::error::MemvidError;
+use crate::metrics::{Phase, Span};
+use crate::util::{set_error, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
+use serde::Serialize;
+use std::alloc::Layout;
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_void};
+use std::ptr::NonNull;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::OnceLock;
+
+/// Allocation hook: returns `size` bytes or NULL.
+pub type MemvidMallocFn =
+    Option<unsafe extern "C" fn(ctx: *mut c_void, size: size_t) -> *mut c_void>;
+
+/// Deallocation hook for memory returned by the matching `MemvidMallocFn`.
+pub type MemvidFreeFn = Option<unsafe extern "C" fn(ctx: *mut c_void, ptr: *mut c_void)>;
+
+/// Caller allocator installed with `memvid_set_allocator`.
+struct Hooks {
+    malloc: unsafe extern "C" fn(ctx: *mut c_void, size: size_t) -> *mut c_void,
+    free: unsafe extern "C" fn(ctx: *mut c_void, ptr: *mut c_void),
+    ctx: *mut c_void,
+}
+
+// The context is only handed back to the caller's hooks, which must be thread-safe.
+unsafe impl Send for Hooks {}
+unsafe impl Sync for Hooks {}
+
+static HOOKS: OnceLock<Hooks> = OnceLock::new();
+
+/// Set once a returned string has been allocated without hooks; from then
+/// on hooks can no longer be installed without mismatching frees.
+static HEAP_STRINGS_ISSUED: AtomicBool = AtomicBool::new(false);
+
+/// Copy `bytes` into a caller-owned C string.
+///
+/// Uses the installed allocator hooks; without hooks, returns `None` so the
+/// caller can fall back to a `CString`.
+pub(crate) fn hooked_cstr(bytes: &[u8]) -> Option<*mut c_char> {
+    let Some(hooks) = HOOKS.get() else {
+        HEAP_STRINGS_ISSUED.store(true, Ordering::Relaxed);
+        return None;
+    };
+    if bytes.contains(&0) {
+        return Some(std::ptr::null_mut());
+    }
+    let ptr = unsafe { (hooks.malloc)(hooks.ctx, bytes.len() + 1) } as *mut u8;
+    if !ptr.is_null() {
+        unsafe {
+            std::ptr::copy_nonoverlapping(bytes.as_ptr(), ptr, bytes.len());
+            *ptr.add(bytes.len()) = 0;
+        }
+    }
+    Some(ptr as *mut c_char)
+}
+
+/// Free a string returned by `string_to_cstr` or `hooked_cstr`.
+///
+/// # Safety
+///
+/// `ptr` must be a non-null string returned by this layer and not yet freed.
+pub(crate) unsafe fn free_cstr(ptr: *mut c_char) {
+    match HOOKS.get() {
+        Some(hooks) => unsafe { (hooks.free)(hooks.ctx, ptr as *mut c_void) },
+        None => unsafe { drop(std::ffi::CString::from_raw(ptr)) },
+    }
+}
+
+/// Allocate arena chunk memory, through the hooks when installed.
+fn alloc_chunk(cap: usize) -> Option<Chunk> {
+    let (ptr, hooked) = match HOOKS.get() {
+        Some(hooks) => (unsafe { (hooks.malloc)(hooks.ctx, cap) } as *mut u8, true),
+        None => {
+            let layout = Layout::from_size_align(cap, 1).ok()?;
+            (unsafe { std::alloc::alloc(layout) }, false)
+        }
+    };
+    Some(Chunk {
+        ptr: NonNull::new(ptr)?,
+        cap,
+        hooked,
+    })
+}
+
+/// One contiguous arena block.
+struct Chunk {
+    ptr: NonNull<u8>,
+    cap: usize,
+    /// Allocated with the caller's hooks rather than the Rust allocator
+    hooked: bool,
+}
+
+impl Drop for Chunk {
+    fn drop(&mut self) {
+        if self.hooked {
+            if let Some(hooks) = HOOKS.get() {
+                unsafe { (hooks.free)(hooks.ctx, self.ptr.as_ptr() as *mut c_void) };
+            }
+        } else {
+            let layout = Layout::from_size_align(self.cap, 1).expect("chunk layout");
+            unsafe { std::alloc::dealloc(self.ptr.as_ptr(), layout) };
+        }
+    }
+}
+
+/// Default size of the first arena chunk.
+const DEFAULT_ARENA_CAPACITY: usize = 64 * 1024;
+
+/// Bump allocator for response strings.
+///
+/// Strings are appended to the newest chunk; when a response does not fit, a
+/// chunk at least twice as large is added. Resetting merges all chunks into
+/// one of the combined size, so a reused arena stops allocating once it has
+/// grown to its working set.
+///
+/// # Thread Safety
+///
+/// An arena must not be used from several threads at once.
+pub struct MemvidArena {
+    chunks: Vec<Chunk>,
+    /// Bytes used in the newest chunk
+    used: usize,
+    initial_capacity: usize,
+}
+
+impl MemvidArena {
+    /// Convert a raw pointer to a mutable reference.
+    ///
+    /// # Safety
+    ///
+    /// The pointer must be valid or null.
+    pub(crate) unsafe fn from_ptr_mut<'a>(ptr: *mut MemvidArena) -> Option<&'a mut Self> {
+        unsafe { ptr.as_mut() }
+    }
+
+    fn capacity(&self) -> usize {
+        self.chunks.iter().map(|c| c.cap).sum()
+    }
+
+    /// Make room for `additional` bytes after the open allocation at `start`,
+    /// moving it to a new chunk if needed. Returns the (possibly new) start.
+    fn reserve(&mut self, start: usize, additional: usize) -> std::io::Result<usize> {
+        if let Some(chunk) = self.chunks.last() {
+            if additional <= chunk.cap - self.used {
+                return Ok(start);
+            }
+        }
+
+        let partial = self.used - start;
+        let needed = partial + additional;
+        let next = self
+            .chunks
+            .last()
+            .map_or(self.initial_capacity, |c| c.cap.saturating_mul(2));
+        let chunk = alloc_chunk(next.max(needed))
+            .ok_or_else(|| std::io::Error::from(std::io::ErrorKind::OutOfMemory))?;
+        if let Some(old) = self.chunks.last() {
+            unsafe {
+                std::ptr::copy_nonoverlapping(
+                    old.ptr.as_ptr().add(start),
+                    chunk.ptr.as_ptr(),
+                    partial,
+                )
+            };
+        }
+        self.chunks.push(chunk);
+        self.used = partial;
+        Ok(0)
+    }
+
+    /// Append bytes to the open allocation at `start`.
+    fn append(&mut self, start: usize, bytes: &[u8]) -> std::io::Result<usize> {
+        let start = self.reserve(start, bytes.len())?;
+        let chunk = self.chunks.last().expect("reserved chunk");
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                bytes.as_ptr(),
+                chunk.ptr.as_ptr().add(self.used),
+                bytes.len(),
+            )
+        };
+        self.used += bytes.len();
+        Ok(start)
+    }
+
+    /// Terminate the open allocation at `start` and return it as a C string.
+    fn finish(&mut self, start: usize) -> std::io::Result<*mut c_char> {
+        let start = self.append(start, &[0])?;
+        let chunk = self.chunks.last().expect("reserved chunk");
+        Ok(unsafe { chunk.ptr.as_ptr().add(start) } as *mut c_char)
+    }
+
+    /// Serialize `value` as JSON directly into the arena.
+    ///
+    /// Returns the string and its length without the terminator.
+    pub(crate) fn write_json<T: Serialize>(
+        &mut self,
+        value: &T,
+    ) -> Result<(*mut c_char, usize), MemvidError> {
+        let mut writer = ArenaWriter {
+            start: self.used,
+            arena: self,
+        };
+        serde_json::to_writer(&mut writer, value).map_err(MemvidError::json_serialize)?;
+        let ArenaWriter { start, arena } = writer;
+        let len = arena.used - start;
+        let ptr = arena.finish(start).map_err(MemvidError::io)?;
+        Ok((ptr, len))
+    }
+
+    /// Copy a C string into the arena.
+    pub(crate) fn copy_cstr(&mut self, s: &CStr) -> Result<*mut c_char, MemvidError> {
+        let start = self
+            .append(self.used, s.to_bytes())
+            .map_err(MemvidError::io)?;
+        self.finish(start).map_err(MemvidError::io)
+    }
+
+    /// Release every string, keeping the combined capacity as one chunk.
+    fn reset(&mut self) {
+        self.used = 0;
+        if self.chunks.len() > 1 {
+            let capacity = self.capacity();
+            self.chunks.clear();
+            if let Some(chunk) = alloc_chunk(capacity) {
+                self.chunks.push(chunk);
+            }
+        }
+    }
+}
+
+/// `io::Write` adapter appending to an open arena allocation.
+struct ArenaWriter<'a> {
+    arena: &'a mut MemvidArena,
+    start: usize,
+}
+
+impl std::io::Write for ArenaWriter<'_> {
+    fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+        self.start = self.arena.append(self.start, buf)?;
+        Ok(buf.len())
+    }
+
+    fn flush(&mut self) -> std::io::Result<()> {
+        Ok(())
+    }
+}
+
+/// Where a response string is written.
+pub(crate) enum Output<'a> {
+    /// Caller-owned string freed with `memvid_string_free`
+    Heap,
+    /// Arena-owned string released by `memvid_arena_reset`
+    Arena(&'a mut MemvidArena),
+}
+
+impl Output<'_> {
+    /// Serialize `value` as a JSON response string, timing the serialize and
+    /// copy phases on `span`.
+    pub(crate) fn json<T: Serialize>(
+        &mut self,
+        value: &T,
+        span: &mut Span,
+    ) -> Result<*mut c_char, MemvidError> {
+        match self {
+            Output::Heap => {
+                let json = serde_json::to_string(value).map_err(MemvidError::json_serialize)?;
+                span.phase(Phase::Serialize);
+                span.bytes_out(json.len());
+                let ptr = string_to_cstr(json);
+                span.phase(Phase::Copy);
+                Ok(ptr)
+            }
+            Output::Arena(arena) => {
+                // Serialization writes straight into the arena; there is no copy
+                let (ptr, len) = arena.write_json(value)?;
+                span.phase(Phase::Serialize);
+                span.bytes_out(len);
+                Ok(ptr)
+            }
+        }
+    }
+
+    /// Copy an already serialized response string.
+    pub(crate) fn copy(&mut self, s: &CStr, span: &mut Span) -> Result<*mut c_char, MemvidError> {
+        let ptr = match self {
+            Output::Heap => crate::util::cstr_copy(s),
+            Output::Arena(arena) => arena.copy_cstr(s)?,
+        };
+        span.phase(Phase::Copy);
+        span.bytes_out(s.to_bytes().len());
+        Ok(ptr)
+    }
+}
+
+/// Route returned strings through a caller allocator.
+///
+/// Every string later freed with `memvid_string_free`, and every arena chunk,
+/// is allocated with `malloc_fn` and released with `free_fn`. Error messages
+/// are unaffected and are still freed with `memvid_error_free`.
+///
+/// Hooks can be installed once per process, before any function has returned
+/// a string; later calls fail with `MemvidErrorCode_InvalidState`.
+///
+/// # Parameters
+///
+/// - `malloc_fn`: Allocation function (must not be NULL)
+/// - `free_fn`: Deallocation function (must not be NULL)
+/// - `ctx`: Context pointer passed to both hooks (may be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - The hooks must be callable from any thread for the life of the process
+/// - `free_fn` must accept any pointer returned by `malloc_fn`
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_set_allocator(
+    malloc_fn: MemvidMallocFn,
+    free_fn: MemvidFreeFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> i32 {
+    let Some(malloc) = malloc_fn else {
+        return unsafe { set_error(error, MemvidError::null_pointer("malloc_fn")) };
+    };
+    let Some(free) = free_fn else {
+        return unsafe { set_error(error, MemvidError::null_pointer("free_fn")) };
+    };
+
+    if HEAP_STRINGS_ISSUED.load(Ordering::Relaxed) {
+        return unsafe {
+            set_error(
+                error,
+                MemvidError::invalid_state("allocator must be set before any string is returned"),
+            )
+        };
+    }
+    if HOOKS.set(Hooks { malloc, free, ctx }).is_err() {
+        return unsafe { set_error(error, MemvidError::invalid_state("allocator already set")) };
+    }
+
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Create a response arena.
+///
+/// # Parameters
+///
+/// - `initial_capacity`: Size of the first chunk in bytes (0 for 64 KiB)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Arena on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned arena. Must call `memvid_arena_destroy()` to free.
+///
+/// # Safety
+///
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_arena_create(
+    initial_capacity: size_t,
+    error: *mut MemvidError,
+) -> *mut MemvidArena {
+    let initial_capacity = if initial_capacity == 0 {
+        DEFAULT_ARENA_CAPACITY
+    } else {
+        initial_capacity
+    };
+    let Some(chunk) = alloc_chunk(initial_capacity) else {
+        return unsafe {
+            set_error_null(
+                error,
+                MemvidError::io(std::io::Error::from(std::io::ErrorKind::OutOfMemory)),
+            )
+        };
+    };
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(MemvidArena {
+        chunks: vec![chunk],
+        used: 0,
+        initial_capacity,
+    }))
+}
+
+/// Release every string allocated in the arena.
+///
+/// Strings returned by `*_arena` functions become invalid. The arena keeps
+/// its memory for reuse.
+///
+/// # Parameters
+///
+/// - `arena`: Arena to reset (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `arena` must be a valid arena or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_arena_reset(arena: *mut MemvidArena) {
+    if let Some(arena) = unsafe { MemvidArena::from_ptr_mut(arena) } {
+        arena.reset();
+    }
+}
+
+/// Get the arena's total capacity in bytes.
+///
+/// # Parameters
+///
+/// - `arena`: Valid arena (NULL returns 0)
+///
+/// # Safety
+///
+/// - `arena` must be a valid arena or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_arena_capacity(arena: *const MemvidArena) -> size_t {
+    match unsafe { arena.as_ref() } {
+        Some(arena) => arena.capacity(),
+        None => 0,
+    }
+}
+
+/// Free an arena and every string allocated in it.
+///
+/// # Parameters
+///
+/// - `arena`: Arena to free (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `arena` must be a valid arena or NULL
+/// - The arena and its strings must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_arena_destroy(arena: *mut MemvidArena) {
+    if arena.is_null() {
+        return;
+    }
+    unsafe { drop(Box::from_raw(arena)) };
+}
@@ -1,16 +1,21 @@
 //! RAG/Ask query functions.
 
+use crate::arena::{MemvidArena, Output};
+use crate::cache::QueryKind;
 use crate::error::MemvidError;
 use crate::handle::MemvidHandle;
-use crate::util::{cstr_to_string, set_error_null, set_ok, string_to_cstr};
+use crate::metrics::{Op, Phase, Span};
+use crate::util::{cstr_to_str, set_error, set_error_null, set_ok};
+use libc::size_t;
 use memvid_core::types::{AskContextFragment, AskContextFragmentKind};
 use serde::{Deserialize, Serialize};
+use std::ffi::{c_void, CStr};
 use std::os::raw::c_char;
 
 /// Ask mode for JSON serialization.
-#[derive(Debug, Default, Deserialize, Serialize)]
+#[derive(Debug, Default, Clone, Deserialize, Serialize)]
 #[serde(rename_all = "lowercase")]
-enum AskModeJson {
+pub(crate) enum AskModeJson {
     Lex,
     Sem,
     #[default]
@@ -40,7 +45,7 @@ impl From<&memvid_core::AskMode> for AskModeJson {
 /// Ask retriever for JSON serialization.
 #[derive(Debug, Serialize)]
 #[serde(rename_all = "snake_case")]
-enum AskRetrieverJson {
+pub(crate) enum AskRetrieverJson {
     Lex,
     Semantic,
     Hybrid,
@@ -61,31 +66,31 @@ impl From<&memvid_core::AskRetriever> for AskRetrieverJson {
 }
 
 /// Ask request from JSON.
-#[derive(Debug, Default, Deserialize)]
-struct AskRequestJson {
-    question: String,
+#[derive(Debug, Default, Clone, Deserialize, Serialize)]
+pub(crate) struct AskRequestJson {
+    pub(crate) question: String,
     #[serde(default = "default_top_k")]
-    top_k: usize,
+    pub(crate) top_k: usize,
     #[serde(default = "default_snippet_chars")]
-    snippet_chars: usize,
+    pub(crate) snippet_chars: usize,
     #[serde(default)]
-    uri: Option<String>,
+    pub(crate) uri: Option<String>,
     #[serde(default)]
-    scope: Option<String>,
+    pub(crate) scope: Option<String>,
     #[serde(default)]
-    cursor: Option<String>,
+    pub(crate) cursor: Option<String>,
     #[serde(default)]
-    start: Option<i64>,
+    pub(crate) start: Option<i64>,
     #[serde(default)]
-    end: Option<i64>,
+    pub(crate) end: Option<i64>,
     #[serde(default = "default_context_only")]
-    context_only: bool,
+    pub(crate) context_only: bool,
     #[serde(default)]
-    mode: AskModeJson,
+    pub(crate) mode: AskModeJson,
     #[serde(default)]
-    as_of_frame: Option<u64>,
+    pub(crate) as_of_frame: Option<u64>,
     #[serde(default)]
-    as_of_ts: Option<i64>,
+    pub(crate) as_of_ts: Option<i64>,
 }
 
 fn default_top_k() -> usize {
@@ -102,7 +107,7 @@ fn default_context_only() -> bool {
 }
 
 impl AskRequestJson {
-    fn into_request(self) -> memvid_core::AskRequest {
+    pub(crate) fn into_request(self) -> memvid_core::AskRequest {
         memvid_core::AskRequest {
             question: self.question,
             top_k: self.top_k,
@@ -123,10 +128,10 @@ impl AskRequestJson {
 
 /// Ask stats for JSON serialization.
 #[derive(Debug, Serialize)]
-struct AskStatsJson {
-    retrieval_ms: u128,
-    synthesis_ms: u128,
-    latency_ms: u128,
+pub(crate) struct AskStatsJson {
+    pub(crate) retrieval_ms: u128,
+    pub(crate) synthesis_ms: u128,
+    pub(crate) latency_ms: u128,
 }
 
 impl From<&memvid_core::AskStats> for AskStatsJson {
@@ -141,12 +146,12 @@ impl From<&memvid_core::AskStats> for AskStatsJson {
 
 /// Ask citation for JSON serialization.
 #[derive(Debug, Serialize)]
-struct AskCitationJson {
-    index: usize,
-    frame_id: u64,
-    uri: String,
-    chunk_range: Option<(usize, usize)>,
-    score: Option<f32>,
+pub(crate) struct AskCitationJson {
+    pub(crate) index: usize,
+    pub(crate) frame_id: u64,
+    pub(crate) uri: String,
+    pub(crate) chunk_range: Option<(usize, usize)>,
+    pub(crate) score: Option<f32>,
 }
 
 impl From<&memvid_core::AskCitation> for AskCitationJson {
@@ -164,7 +169,7 @@ impl From<&memvid_core::AskCitation> for AskCitationJson {
 /// Context fragment kind for JSON serialization.
 #[derive(Debug, Serialize)]
 #[serde(rename_all = "lowercase")]
-enum AskContextFragmentKindJson {
+pub(crate) enum AskContextFragmentKindJson {
     Full,
     Summary,
 }
@@ -180,17 +185,17 @@ impl From<&AskContextFragmentKind> for AskContextFragmentKindJson {
 
 /// Context fragment for JSON serialization.
 #[derive(Debug, Serialize)]
-struct AskContextFragmentJson {
-    rank: usize,
-    frame_id: u64,
-    uri: String,
-    title: Option<String>,
-    score: Option<f32>,
-    matches: usize,
-    range: Option<(usize, usize)>,
-    chunk_range: Option<(usize, usize)>,
-    text: String,
-    kind: Option<AskContextFragmentKindJson>,
+pub(crate) struct AskContextFragmentJson {
+    pub(crate) rank: usize,
+    pub(crate) frame_id: u64,
+    pub(crate) uri: String,
+    pub(crate) title: Option<String>,
+    pub(crate) score: Option<f32>,
+    pub(crate) matches: usize,
+    pub(crate) range: Option<(usize, usize)>,
+    pub(crate) chunk_range: Option<(usize, usize)>,
+    pub(crate) text: String,
+    pub(crate) kind: Option<AskContextFragmentKindJson>,
 }
 
 impl From<&AskContextFragment> for AskContextFragmentJson {
@@ -212,17 +217,17 @@ impl From<&AskContextFragment> for AskContextFragmentJson {
 
 /// Search hit for JSON serialization (nested in response).
 #[derive(Debug, Serialize)]
-struct SearchHitJson {
-    rank: usize,
-    frame_id: u64,
-    uri: String,
-    title: Option<String>,
-    range: (usize, usize),
-    text: String,
-    matches: usize,
-    chunk_range: Option<(usize, usize)>,
-    chunk_text: Option<String>,
-    score: Option<f32>,
+pub(crate) struct SearchHitJson {
+    pub(crate) rank: usize,
+    pub(crate) frame_id: u64,
+    pub(crate) uri: String,
+    pub(crate) title: Option<String>,
+    pub(crate) range: (usize, usize),
+    pub(crate) text: String,
+    pub(crate) matches: usize,
+    pub(crate) chunk_range: Option<(usize, usize)>,
+    pub(crate) chunk_text: Option<String>,
+    pub(crate) score: Option<f32>,
 }
 
 impl From<&memvid_core::SearchHit> for SearchHitJson {
@@ -244,13 +249,13 @@ impl From<&memvid_core::SearchHit> for SearchHitJson {
 
 /// Search response for JSON serialization (nested in ask response).
 #[derive(Debug, Serialize)]
-struct SearchResponseJson {
-    query: String,
-    elapsed_ms: u128,
-    total_hits: usize,
-    hits: Vec<SearchHitJson>,
-    context: String,
-    next_cursor: Option<String>,
+pub(crate) struct SearchResponseJson {
+    pub(crate) query: String,
+    pub(crate) elapsed_ms: u128,
+    pub(crate) total_hits: usize,
+    pub(crate) hits: Vec<SearchHitJson>,
+    pub(crate) context: String,
+    pub(crate) next_cursor: Option<String>,
 }
 
 impl From<&memvid_core::SearchResponse> for SearchResponseJson {
@@ -268,16 +273,16 @@ impl From<&memvid_core::SearchResponse> for SearchResponseJson {
 
 /// Ask response for JSON serialization.
 #[derive(Debug, Serialize)]
-struct AskResponseJson {
-    question: String,
-    mode: AskModeJson,
-    retriever: AskRetrieverJson,
-    context_only: bool,
-    retrieval: SearchResponseJson,
-    answer: Option<String>,
-    citations: Vec<AskCitationJson>,
-    context_fragments: Vec<AskContextFragmentJson>,
-    stats: AskStatsJson,
+pub(crate) struct AskResponseJson {
+    pub(crate) question: String,
+    pub(crate) mode: AskModeJson,
+    pub(crate) retriever: AskRetrieverJson,
+    pub(crate) context_only: bool,
+    pub(crate) retrieval: SearchResponseJson,
+    pub(crate) answer: Option<String>,
+    pub(crate) citations: Vec<AskCitationJson>,
+    pub(crate) context_fragments: Vec<AskContextFragmentJson>,
+    pub(crate) stats: AskStatsJson,
 }
 
 impl From<&memvid_core::AskResponse> for AskResponseJson {
@@ -376,35 +381,303 @@ pub unsafe extern "C" fn memvid_ask(
     request_json: *const c_char,
     error: *mut MemvidError,
 ) -> *mut c_char {
+    unsafe { ask_to(handle, request_json, Output::Heap, error) }
+}
+
+/// Ask a question, allocating the response in an arena.
+///
+/// Same as `memvid_ask`, but the response string is bump-allocated in `arena`
+/// instead of the heap.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `request_json`: JSON string with ask parameters (see `memvid_ask`)
+/// - `arena`: Arena that owns the response
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with ask response on success, NULL on failure.
+///
+/// # Ownership
+///
+/// The string belongs to `arena` and is valid until `memvid_arena_reset()` or
+/// `memvid_arena_destroy()`. Do not pass it to `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `request_json` must be a valid null-terminated UTF-8 string
+/// - `arena` must be a valid arena
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ask_arena(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    arena: *mut MemvidArena,
+    error: *mut MemvidError,
+) -> *const c_char {
+    let arena = match unsafe { MemvidArena::from_ptr_mut(arena) } {
+        Some(a) => a,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("arena")) },
+    };
+    unsafe { ask_to(handle, request_json, Output::Arena(arena), error) }
+}
+
+/// Run `memvid_ask`, writing the response to `out`.
+///
+/// # Safety
+///
+/// Same requirements as `memvid_ask`.
+unsafe fn ask_to(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    mut out: Output,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::Ask);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
     };
 
-    let json_str = match unsafe { cstr_to_string(request_json, "request_json") } {
+    let json_str = match unsafe { cstr_to_str(request_json, "request_json") } {
         Ok(s) => s,
         Err(e) => return unsafe { set_error_null(error, e) },
     };
+    span.bytes_in(json_str.len());
 
-    let request_json: AskRequestJson = match serde_json::from_str(&json_str) {
+    let request_json: AskRequestJson = match serde_json::from_str(json_str) {
         Ok(r) => r,
         Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
     };
+    span.phase(Phase::Parse);
+
+    // Serve exact repeats from the result cache
+    let cache_key = handle.cache.key(QueryKind::Ask, &request_json);
+    if let Some(cached) = cache_key.as_ref().and_then(|k| handle.cache.get(k)) {
+        return match out.copy(cached, &mut span) {
+            Ok(ptr) => {
+                unsafe { set_ok(error) };
+                ptr
+            }
+            Err(e) => unsafe { set_error_null(error, e) },
+        };
+    }
 
     let request = request_json.into_request();
 
     // Call ask without an embedder (context_only mode or lex-only)
-    match handle.as_mut().ask(request, None::<&dyn memvid_core::VecEmbedder>) {
-        Ok(response) => {
-            let json_response = AskResponseJson::from(&response);
-            match serde_json::to_string(&json_response) {
-                Ok(json) => {
-                    unsafe { set_ok(error) };
-                    string_to_cstr(json)
+    let result = handle
+        .as_mut()
+        .ask(request, None::<&dyn memvid_core::VecEmbedder>);
+    span.phase(Phase::Core);
+    match result {
+        Ok(response) => match out.json(&AskResponseJson::from(&response), &mut span) {
+            Ok(ptr) => {
+                if let (Some(key), false) = (cache_key, ptr.is_null()) {
+                    handle.cache.store(key, unsafe { CStr::from_ptr(ptr) });
                 }
-                Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+                unsafe { set_ok(error) };
+                ptr
             }
-        }
+            Err(e) => unsafe { set_error_null(error, e) },
+        },
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
 }
+
+/// Event kinds passed to `MemvidAskStreamFn`.
+pub const MEMVID_ASK_FRAGMENT: i32 = 0;
+pub const MEMVID_ASK_CITATION: i32 = 1;
+pub const MEMVID_ASK_DONE: i32 = 2;
+
+/// Ask stream callback.
+///
+/// Invoked on the calling thread once per event with the caller's context
+/// pointer, a `MEMVID_ASK_*` kind, and the event JSON (null-terminated,
+/// `len` bytes without the terminator). The JSON is only valid during the
+/// call. Returning non-zero stops the stream.
+pub type MemvidAskStreamFn = Option<
+    unsafe extern "C" fn(ctx: *mut c_void, kind: i32, json: *const c_char, len: size_t) -> i32,
+>;
+
+/// Final `memvid_ask_stream` event.
+#[derive(Debug, Serialize)]
+struct AskStreamDoneJson<'a> {
+    question: &'a str,
+    mode: AskModeJson,
+    retriever: AskRetrieverJson,
+    context_only: bool,
+    answer: Option<&'a str>,
+    total_hits: usize,
+    fragments: usize,
+    citations: usize,
+    stats: AskStatsJson,
+}
+
+/// Serialize one event into `buf` and deliver it; returns true to stop.
+///
+/// # Safety
+///
+/// `callback` must be safe to call with `ctx`.
+unsafe fn emit<T: Serialize>(
+    callback: unsafe extern "C" fn(*mut c_void, i32, *const c_char, size_t) -> i32,
+    ctx: *mut c_void,
+    buf: &mut Vec<u8>,
+    kind: i32,
+    event: &T,
+    span: &mut Span,
+) -> Result<bool, MemvidError> {
+    buf.clear();
+    serde_json::to_writer(&mut *buf, event).map_err(MemvidError::json_serialize)?;
+    let len = buf.len();
+    span.bytes_out(len);
+    buf.push(0);
+    Ok(unsafe { callback(ctx, kind, buf.as_ptr().cast(), len) } != 0)
+}
+
+/// Deliver every fragment, citation and the final summary of `response`.
+///
+/// # Safety
+///
+/// `callback` must be safe to call with `ctx`.
+unsafe fn stream_events(
+    response: &memvid_core::AskResponse,
+    callback: unsafe extern "C" fn(*mut c_void, i32, *const c_char, size_t) -> i32,
+    ctx: *mut c_void,
+    span: &mut Span,
+) -> Result<(), MemvidError> {
+    // One buffer is reused for every event
+    let mut buf = Vec::new();
+    for fragment in &response.context_fragments {
+        let event = AskContextFragmentJson::from(fragment);
+        if unsafe { emit(callback, ctx, &mut buf, MEMVID_ASK_FRAGMENT, &event, span) }? {
+            return Ok(());
+        }
+    }
+    for citation in &response.citations {
+        let event = AskCitationJson::from(citation);
+        if unsafe { emit(callback, ctx, &mut buf, MEMVID_ASK_CITATION, &event, span) }? {
+            return Ok(());
+        }
+    }
+    let done = AskStreamDoneJson {
+        question: &response.question,
+        mode: AskModeJson::from(&response.mode),
+        retriever: AskRetrieverJson::from(&response.retriever),
+        context_only: response.context_only,
+        answer: response.answer.as_deref(),
+        total_hits: response.retrieval.total_hits,
+        fragments: response.context_fragments.len(),
+        citations: response.citations.len(),
+        stats: AskStatsJson::from(&response.stats),
+    };
+    unsafe { emit(callback, ctx, &mut buf, MEMVID_ASK_DONE, &done, span) }.map(|_| ())
+}
+
+/// Ask a question and stream the context one fragment at a time.
+///
+/// Runs the same retrieval as `memvid_ask`, then delivers each context
+/// fragment in rank order, each citation, and finally a summary with the
+/// stats, through `callback` on the calling thread. Only one event is
+/// serialized at a time, so the first fragment reaches the caller without
+/// waiting for the whole response to be built. memvid-core retrieval is a
+/// single call, so it completes before the first event. Responses are not
+/// served from or stored in the query cache.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `request_json`: JSON string with ask parameters (see `memvid_ask`)
+/// - `callback`: Event callback (must not be NULL)
+/// - `ctx`: Context pointer passed through to `callback`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success (including when the callback stops the stream), 0 on failure.
+///
+/// # Event JSON Schema
+///
+/// `MEMVID_ASK_FRAGMENT` events are context fragments and
+/// `MEMVID_ASK_CITATION` events are citations, as in the `memvid_ask`
+/// response. The last event is `MEMVID_ASK_DONE`:
+///
+/// ```json
+/// {
+///   "question": "What is the capital of France?",
+///   "mode": "hybrid",
+///   "retriever": "lex",
+///   "context_only": true,
+///   "answer": null,
+///   "total_hits": 3,
+///   "fragments": 3,
+///   "citations": 0,
+///   "stats": {
+///     "retrieval_ms": 5,
+///     "synthesis_ms": 0,
+///     "latency_ms": 5
+///   }
+/// }
+/// ```
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `request_json` must be a valid null-terminated UTF-8 string
+/// - `callback` must be safe to call with `ctx` from the calling thread
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ask_stream(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    callback: MemvidAskStreamFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> i32 {
+    let mut span = Span::start(Op::AskStream);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let Some(callback) = callback else {
+        return unsafe { set_error(error, MemvidError::null_pointer("callback")) };
+    };
+
+    let json_str = match unsafe { cstr_to_str(request_json, "request_json") } {
+        Ok(s) => s,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+    span.bytes_in(json_str.len());
+
+    let request: AskRequestJson = match serde_json::from_str(json_str) {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error(error, MemvidError::json_parse(e)) },
+    };
+    span.phase(Phase::Parse);
+
+    let result = handle.as_mut().ask(
+        request.into_request(),
+        None::<&dyn memvid_core::VecEmbedder>,
+    );
+    span.phase(Phase::Core);
+    let mut response = match result {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    };
+    response.context_fragments.sort_by_key(|f| f.rank);
+
+    let streamed = unsafe { stream_events(&response, callback, ctx, &mut span) };
+    span.phase(Phase::Serialize);
+
+    match streamed {
+        Ok(()) => {
+            unsafe { set_ok(error) };
+            1
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
@@ -0,0 +1,272 @@
+//! Per-handle query result cache.
+
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::util::{set_error, set_ok};
+use serde::Serialize;
+use std::collections::{BTreeMap, HashMap};
+use std::ffi::{CStr, CString};
+
+/// Entry point that produced a cached response.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub(crate) enum QueryKind {
+    Search,
+    Ask,
+}
+
+/// Cache key: entry point, commit generation and normalized request JSON.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub(crate) struct CacheKey {
+    kind: QueryKind,
+    generation: u64,
+    request: String,
+}
+
+struct CacheEntry {
+    response: CString,
+    last_used: u64,
+}
+
+impl CacheEntry {
+    fn bytes(&self, key: &CacheKey) -> usize {
+        key.request.len() + self.response.as_bytes_with_nul().len()
+    }
+}
+
+/// LRU cache of serialized query responses, bounded by entries and bytes.
+///
+/// Disabled (`max_entries == 0`) by default. Every commit or delete through
+/// the handle bumps the generation and drops all entries, so a cached
+/// response never outlives the state it was computed from.
+#[derive(Default)]
+pub(crate) struct QueryCache {
+    max_entries: usize,
+    /// Byte budget for keys and responses (0 for no byte limit)
+    max_bytes: usize,
+    entries: HashMap<CacheKey, CacheEntry>,
+    /// Recency order: last-used tick -> key
+    lru: BTreeMap<u64, CacheKey>,
+    tick: u64,
+    bytes: usize,
+    generation: u64,
+    hits: u64,
+    misses: u64,
+    evictions: u64,
+}
+
+impl QueryCache {
+    /// Build the lookup key for a request, or `None` when caching is off.
+    ///
+    /// Re-serializing the parsed request normalizes whitespace, field order
+    /// and omitted defaults, so equivalent requests share an entry.
+    pub(crate) fn key<T: Serialize>(&self, kind: QueryKind, request: &T) -> Option<CacheKey> {
+        if self.max_entries == 0 {
+            return None;
+        }
+        let request = serde_json::to_string(request).ok()?;
+        Some(CacheKey {
+            kind,
+            generation: self.generation,
+            request,
+        })
+    }
+
+    /// Look up a response, counting the hit or miss.
+    pub(crate) fn get(&mut self, key: &CacheKey) -> Option<&CStr> {
+        self.tick += 1;
+        match self.entries.get_mut(key) {
+            Some(entry) => {
+                self.lru.remove(&entry.last_used);
+                entry.last_used = self.tick;
+                self.lru.insert(self.tick, key.clone());
+                self.hits += 1;
+                Some(entry.response.as_c_str())
+            }
+            None => {
+                self.misses += 1;
+                None
+            }
+        }
+    }
+
+    /// Keep a copy of a response under `key`.
+    pub(crate) fn store(&mut self, key: CacheKey, response: &CStr) {
+        self.insert(key, response.to_owned());
+    }
+
+    /// Store a response, evicting least recently used entries to fit.
+    fn insert(&mut self, key: CacheKey, response: CString) {
+        if self.max_entries == 0 || key.generation != self.generation {
+            return;
+        }
+        self.tick += 1;
+        let entry = CacheEntry {
+            response,
+            last_used: self.tick,
+        };
+        let size = entry.bytes(&key);
+        if self.max_bytes != 0 && size > self.max_bytes {
+            return;
+        }
+
+        if let Some(old) = self.entries.remove(&key) {
+            self.lru.remove(&old.last_used);
+            self.bytes -= old.bytes(&key);
+        }
+        let room = (self.max_bytes != 0).then(|| self.max_bytes - size);
+        self.evict_to(self.max_entries - 1, room);
+        self.bytes += size;
+        self.lru.insert(entry.last_used, key.clone());
+        self.entries.insert(key, entry);
+    }
+
+    /// Evict least recently used entries until within `max_len` and `max_bytes`.
+    fn evict_to(&mut self, max_len: usize, max_bytes: Option<usize>) {
+        while self.entries.len() > max_len || max_bytes.is_some_and(|m| self.bytes > m) {
+            let Some((_, key)) = self.lru.pop_first() else {
+                break;
+            };
+            if let Some(old) = self.entries.remove(&key) {
+                self.bytes -= old.bytes(&key);
+                self.evictions += 1;
+            }
+        }
+    }
+
+    /// Commit generation the cached entries belong to.
+    pub(crate) fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Drop every entry and advance the generation.
+    pub(crate) fn invalidate(&mut self) {
+        self.generation += 1;
+        self.entries.clear();
+        self.lru.clear();
+        self.bytes = 0;
+    }
+
+    fn configure(&mut self, max_entries: usize, max_bytes: usize) {
+        self.max_entries = max_entries;
+        self.max_bytes = max_bytes;
+        if max_entries == 0 {
+            self.entries.clear();
+            self.lru.clear();
+            self.bytes = 0;
+            return;
+        }
+        self.evict_to(max_entries, (max_bytes != 0).then_some(max_bytes));
+    }
+}
+
+/// Query cache counters.
+///
+/// All fields are value types that can be safely copied.
+#[repr(C)]
+#[derive(Debug, Default)]
+pub struct MemvidCacheStats {
+    /// Lookups answered from the cache
+    pub hits: u64,
+    /// Lookups that ran the query
+    pub misses: u64,
+    /// Entries dropped to stay within the limits
+    pub evictions: u64,
+    /// Entries currently cached
+    pub entries: u64,
+    /// Bytes currently cached (keys and responses)
+    pub bytes: u64,
+    /// Commit generation the cached entries belong to
+    pub generation: u64,
+}
+
+impl From<&QueryCache> for MemvidCacheStats {
+    fn from(c: &QueryCache) -> Self {
+        Self {
+            hits: c.hits,
+            misses: c.misses,
+            evictions: c.evictions,
+            entries: c.entries.len() as u64,
+            bytes: c.bytes as u64,
+            generation: c.generation,
+        }
+    }
+}
+
+/// Configure the query result cache for `memvid_search` and `memvid_ask`.
+///
+/// Repeated requests that normalize to the same JSON are answered with the
+/// stored response string, without searching or serializing again. Cached
+/// responses are byte-identical to the original, including `elapsed_ms`.
+/// The cache is flushed by `memvid_commit` (and the group-commit calls) and
+/// `memvid_delete_frame`.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `max_entries`: Maximum cached responses (0 disables and clears the cache)
+/// - `max_bytes`: Maximum cached bytes for requests and responses (0 for no byte limit)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_cache_configure(
+    handle: *mut MemvidHandle,
+    max_entries: u64,
+    max_bytes: u64,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let max_entries = usize::try_from(max_entries).unwrap_or(usize::MAX);
+    let max_bytes = usize::try_from(max_bytes).unwrap_or(usize::MAX);
+    handle.cache.configure(max_entries, max_bytes);
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Get query cache counters.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `stats`: Out-parameter for cache counters (must not be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `stats` must be a valid pointer
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_cache_stats(
+    handle: *mut MemvidHandle,
+    stats: *mut MemvidCacheStats,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if stats.is_null() {
+        return unsafe { set_error(error, MemvidError::null_pointer("stats")) };
+    }
+
+    unsafe { *stats = MemvidCacheStats::from(&handle.cache) };
+    unsafe { set_ok(error) };
+    1
+}
@@ -0,0 +1,503 @@
+//! Online compaction of deleted frames.
+//!
+//! `memvid_delete_frame` only tombstones frames, so deleted payloads and
+//! their index entries stay in the file until it is vacuumed. Compaction
+//! does that without closing the handle: a worker thread copies the
+//! committed file to a scratch file next to it (throttled to an I/O budget),
+//! vacuums and re-indexes the copy with the memvid-core doctor, and the
+//! handle then renames the copy over the original and reopens it. The
+//! handle keeps serving reads and writes while the worker runs; if anything
+//! was written in the meantime the copy is stale. A stale copy is discarded,
+//! so under a steady write stream a background compaction never finishes
+//! unless `catch_up` is set: the copy is then rebuilt on the caller's thread,
+//! where no write can interleave, before the swap.
+
+use crate::dedup;
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::util::{cstr_to_option_str, set_error_null, set_ok, string_to_cstr};
+use serde::{Deserialize, Serialize};
+use std::io::{Read, Write};
+use std::os::raw::c_char;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::Arc;
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
+
+/// Copy chunk size for the throttled file copy.
+const COPY_CHUNK: usize = 1 << 20;
+
+/// Options for `memvid_compact` from JSON.
+#[derive(Debug, Default, Deserialize)]
+struct CompactOptionsJson {
+    /// Only compact when deleted frames exceed this fraction of all frames
+    #[serde(default)]
+    min_tombstone_ratio: f64,
+    /// Read budget for the file copy in bytes per second (0 for unthrottled)
+    #[serde(default)]
+    io_bytes_per_sec: u64,
+    /// Return immediately and finish from `memvid_compact_poll`
+    #[serde(default)]
+    background: bool,
+    /// Rebuild a stale copy while blocking writes instead of discarding it
+    #[serde(default)]
+    catch_up: bool,
+}
+
+/// Why a compaction worker stopped.
+enum BuildError {
+    Io(std::io::Error),
+    Core(memvid_core::MemvidError),
+    Cancelled,
+}
+
+impl From<BuildError> for MemvidError {
+    fn from(e: BuildError) -> Self {
+        match e {
+            BuildError::Io(e) => MemvidError::io(e),
+            BuildError::Core(e) => MemvidError::from_core_error(e),
+            BuildError::Cancelled => MemvidError::invalid_state("compaction cancelled"),
+        }
+    }
+}
+
+/// Status hint for a copy discarded as stale.
+const STALE_HINT: &str = "retry when writes pause, or set catch_up to finish under writes";
+
+/// Frame and size counters used for the policy and the stale check.
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Counts {
+    frames: u64,
+    active: u64,
+    size_bytes: u64,
+}
+
+impl Counts {
+    fn of(handle: &MemvidHandle) -> Result<Self, MemvidError> {
+        let stats = handle
+            .as_ref()
+            .stats()
+            .map_err(MemvidError::from_core_error)?;
+        Ok(Self {
+            frames: stats.frame_count,
+            active: stats.active_frame_count,
+            size_bytes: stats.size_bytes,
+        })
+    }
+
+    fn tombstone_ratio(&self) -> f64 {
+        if self.frames == 0 {
+            0.0
+        } else {
+            (self.frames - self.active) as f64 / self.frames as f64
+        }
+    }
+}
+
+/// Compaction in progress on a handle.
+pub(crate) struct Compaction {
+    worker: Option<JoinHandle<Result<(), BuildError>>>,
+    cancel: Arc<AtomicBool>,
+    copied: Arc<AtomicU64>,
+    scratch: PathBuf,
+    /// Cache generation (commit count) when the copy was taken
+    generation: u64,
+    before: Counts,
+    started: Instant,
+    /// Rebuild the copy in the foreground if it goes stale
+    catch_up: bool,
+}
+
+impl Drop for Compaction {
+    fn drop(&mut self) {
+        self.cancel.store(true, Ordering::Relaxed);
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
+        }
+        let _ = std::fs::remove_file(&self.scratch);
+    }
+}
+
+/// Compaction status for JSON serialization.
+#[derive(Debug, Serialize)]
+struct CompactStatusJson {
+    state: &'static str,
+    tombstone_ratio: f64,
+    frames_before: u64,
+    frames_after: Option<u64>,
+    bytes_before: u64,
+    bytes_after: Option<u64>,
+    bytes_copied: u64,
+    elapsed_ms: u128,
+    /// Whether a stale copy was rebuilt with writes blocked
+    caught_up: bool,
+    /// What to do about a "stale" result
+    hint: Option<&'static str>,
+}
+
+impl CompactStatusJson {
+    fn new(state: &'static str, before: Counts) -> Self {
+        Self {
+            state,
+            tombstone_ratio: before.tombstone_ratio(),
+            frames_before: before.frames,
+            frames_after: None,
+            bytes_before: before.size_bytes,
+            bytes_after: None,
+            bytes_copied: 0,
+            elapsed_ms: 0,
+            caught_up: false,
+            hint: None,
+        }
+    }
+}
+
+/// Scratch file for the compacted copy, on the same filesystem as `path`.
+fn scratch_path(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".compact.tmp");
+    path.with_file_name(name)
+}
+
+/// Copy `from` to `to`, reading at most `budget` bytes per second.
+fn throttled_copy(
+    from: &Path,
+    to: &Path,
+    budget: u64,
+    cancel: &AtomicBool,
+    copied: &AtomicU64,
+) -> std::io::Result<bool> {
+    let mut src = std::fs::File::open(from)?;
+    let mut dst = std::fs::File::create(to)?;
+    let mut buf = vec![0u8; COPY_CHUNK];
+    let started = Instant::now();
+    let mut total = 0u64;
+    loop {
+        if cancel.load(Ordering::Relaxed) {
+            return Ok(false);
+        }
+        let n = src.read(&mut buf)?;
+        if n == 0 {
+            break;
+        }
+        dst.write_all(&buf[..n])?;
+        total += n as u64;
+        copied.store(total, Ordering::Relaxed);
+
+        if budget > 0 {
+            let due = Duration::from_secs_f64(total as f64 / budget as f64);
+            if let Some(wait) = due.checked_sub(started.elapsed()) {
+                std::thread::sleep(wait);
+            }
+        }
+    }
+    dst.sync_all()?;
+    Ok(true)
+}
+
+/// Worker body: copy, then vacuum and re-index the copy.
+fn build(
+    path: PathBuf,
+    scratch: PathBuf,
+    budget: u64,
+    doctor: memvid_core::DoctorOptions,
+    cancel: Arc<AtomicBool>,
+    copied: Arc<AtomicU64>,
+) -> Result<(), BuildError> {
+    if !throttled_copy(&path, &scratch, budget, &cancel, &copied).map_err(BuildError::Io)? {
+        return Err(BuildError::Cancelled);
+    }
+    memvid_core::Memvid::doctor(&scratch, doctor).map_err(BuildError::Core)?;
+    Ok(())
+}
+
+/// Path of a handle that may be compacted.
+fn writable_path(handle: &MemvidHandle) -> Result<PathBuf, MemvidError> {
+    match (&handle.path, handle.writable) {
+        (Some(path), true) => Ok(path.clone()),
+        _ => Err(MemvidError::invalid_state(
+            "handle was not opened for writing",
+        )),
+    }
+}
+
+/// Commit pending writes and snapshot the counts and doctor options.
+fn prepare(handle: &mut MemvidHandle) -> Result<(Counts, memvid_core::DoctorOptions), MemvidError> {
+    crate::mutation::commit_handle(handle).map_err(MemvidError::from_core_error)?;
+    let before = Counts::of(handle)?;
+    let stats = handle
+        .as_ref()
+        .stats()
+        .map_err(MemvidError::from_core_error)?;
+    let doctor = memvid_core::DoctorOptions {
+        rebuild_time_index: stats.has_time_index,
+        rebuild_lex_index: stats.has_lex_index,
+        rebuild_vec_index: stats.has_vec_index,
+        vacuum: true,
+        quiet: true,
+        ..Default::default()
+    };
+    Ok((before, doctor))
+}
+
+/// Start a compaction worker for `handle`, committing pending writes first.
+fn start(handle: &mut MemvidHandle, options: &CompactOptionsJson) -> Result<(), MemvidError> {
+    let path = writable_path(handle)?;
+    let (before, doctor) = prepare(handle)?;
+
+    let scratch = scratch_path(&path);
+    let cancel = Arc::new(AtomicBool::new(false));
+    let copied = Arc::new(AtomicU64::new(0));
+    let worker = {
+        let (scratch, cancel, copied) = (scratch.clone(), cancel.clone(), copied.clone());
+        let budget = options.io_bytes_per_sec;
+        std::thread::Builder::new()
+            .name("memvid-compact".into())
+            .spawn(move || build(path, scratch, budget, doctor, cancel, copied))
+            .map_err(MemvidError::io)?
+    };
+
+    handle.compaction = Some(Compaction {
+        worker: Some(worker),
+        cancel,
+        copied,
+        scratch,
+        generation: handle.cache.generation(),
+        before,
+        started: Instant::now(),
+        catch_up: options.catch_up,
+    });
+    Ok(())
+}
+
+/// Finish a compaction whose worker has exited, swapping the copy in.
+fn finish(
+    handle: &mut MemvidHandle,
+    mut compaction: Compaction,
+) -> Result<CompactStatusJson, MemvidError> {
+    let joined = compaction.worker.take().map(JoinHandle::join);
+    let mut status = CompactStatusJson::new("done", compaction.before);
+    status.bytes_copied = compaction.copied.load(Ordering::Relaxed);
+    status.elapsed_ms = compaction.started.elapsed().as_millis();
+    match joined {
+        Some(Ok(Ok(()))) => {}
+        Some(Ok(Err(e))) => return Err(e.into()),
+        Some(Err(_)) | None => {
+            return Err(MemvidError::invalid_state("compaction worker panicked"))
+        }
+    }
+
+    // Anything written since the copy was taken would be lost by the swap
+    let unchanged = handle.cache.generation() == compaction.generation
+        && handle.group_commit.pending_bytes == 0
+        && Counts::of(handle)? == compaction.before;
+    let path = writable_path(handle)?;
+    if !unchanged {
+        if !compaction.catch_up {
+            status.state = "stale";
+            status.hint = Some(STALE_HINT);
+            return Ok(status);
+        }
+        // Writes wait while this thread holds the handle, so the unthrottled
+        // rebuild of the latest committed file cannot go stale
+        let (before, doctor) = prepare(handle)?;
+        let scratch = compaction.scratch.clone();
+        let (cancel, copied) = (compaction.cancel.clone(), compaction.copied.clone());
+        build(path.clone(), scratch, 0, doctor, cancel, copied).map_err(MemvidError::from)?;
+        status = CompactStatusJson::new("done", before);
+        status.bytes_copied = compaction.copied.load(Ordering::Relaxed);
+        status.elapsed_ms = compaction.started.elapsed().as_millis();
+        status.caught_up = true;
+    }
+
+    std::fs::rename(&compaction.scratch, &path).map_err(MemvidError::io)?;
+    let reopened = memvid_core::Memvid::open(&path).map_err(MemvidError::from_core_error)?;
+    drop(handle.replace_inner(reopened));
+    handle.cache.invalidate();
+    dedup::save(handle);
+    handle.save_indexes();
+
+    let after = Counts::of(handle)?;
+    status.frames_after = Some(after.frames);
+    status.bytes_after = Some(after.size_bytes);
+    Ok(status)
+}
+
+/// Poll the handle's compaction, finishing it if the worker is done.
+fn poll(handle: &mut MemvidHandle) -> Result<CompactStatusJson, MemvidError> {
+    let Some(compaction) = handle.compaction.as_ref() else {
+        return Ok(CompactStatusJson::new("idle", Counts::of(handle)?));
+    };
+    if !compaction
+        .worker
+        .as_ref()
+        .is_some_and(JoinHandle::is_finished)
+    {
+        let mut status = CompactStatusJson::new("running", compaction.before);
+        status.bytes_copied = compaction.copied.load(Ordering::Relaxed);
+        status.elapsed_ms = compaction.started.elapsed().as_millis();
+        return Ok(status);
+    }
+    let compaction = handle.compaction.take().expect("checked above");
+    finish(handle, compaction)
+}
+
+fn compact(
+    handle: &mut MemvidHandle,
+    options: CompactOptionsJson,
+) -> Result<CompactStatusJson, MemvidError> {
+    if handle.compaction.is_some() {
+        return poll(handle);
+    }
+
+    let before = Counts::of(handle)?;
+    if before.frames == before.active || before.tombstone_ratio() < options.min_tombstone_ratio {
+        return Ok(CompactStatusJson::new("skipped", before));
+    }
+
+    start(handle, &options)?;
+    if options.background {
+        return poll(handle);
+    }
+    // Joining the worker in finish() waits for the copy
+    let compaction = handle.compaction.take().expect("just started");
+    finish(handle, compaction)
+}
+
+fn status_to_cstr(
+    result: Result<CompactStatusJson, MemvidError>,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    match result {
+        Ok(status) => match serde_json::to_string(&status) {
+            Ok(json) => {
+                unsafe { set_ok(error) };
+                string_to_cstr(json)
+            }
+            Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+        },
+        Err(e) => unsafe { set_error_null(error, e) },
+    }
+}
+
+/// Reclaim the space held by deleted frames without closing the handle.
+///
+/// Pending writes are committed, then the committed file is copied, vacuumed
+/// and re-indexed on a worker thread, and the compacted file is renamed over
+/// the original and reopened in place. Reader pool views keep the snapshot
+/// they opened; call `memvid_reader_pool_refresh` to move them to the
+/// compacted file. Frame IDs are reassigned by the vacuum.
+///
+/// Use `min_tombstone_ratio` to make the call a cheap no-op until enough
+/// frames have been deleted, e.g. after each batch of deletes.
+///
+/// A background copy goes stale if the handle is written to before it is
+/// swapped in, so it cannot finish under a steady write stream. With
+/// `catch_up` set, a stale copy is instead rebuilt unthrottled when it is
+/// finished, blocking the handle's writes for the length of one copy.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle opened for writing
+/// - `options_json`: JSON string with options (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the compaction status on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Options JSON Schema
+///
+/// ```json
+/// {
+///   "min_tombstone_ratio": 0.2,
+///   "io_bytes_per_sec": 0,
+///   "background": false,
+///   "catch_up": false
+/// }
+/// ```
+///
+/// With `background` set the call returns a "running" status straight away;
+/// the handle stays usable and `memvid_compact_poll` finishes the swap.
+///
+/// # Response JSON Schema
+///
+/// ```json
+/// {
+///   "state": "done",
+///   "tombstone_ratio": 0.25,
+///   "frames_before": 4,
+///   "frames_after": 3,
+///   "bytes_before": 8192,
+///   "bytes_after": 6144,
+///   "bytes_copied": 8192,
+///   "elapsed_ms": 12,
+///   "caught_up": false,
+///   "hint": null
+/// }
+/// ```
+///
+/// State values: "skipped" (below the tombstone ratio or nothing deleted),
+/// "running", "done", "stale" (the handle was written to while the copy was
+/// built, so it was discarded; `hint` says how to retry)
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `options_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_compact(
+    handle: *mut MemvidHandle,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let options = match unsafe { cstr_to_option_str(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<CompactOptionsJson>(json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => CompactOptionsJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    status_to_cstr(compact(handle, options), error)
+}
+
+/// Check on a background compaction, finishing it if the copy is ready.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the compaction status (same schema as `memvid_compact`,
+/// state "idle" when none is in progress) on success, NULL on failure. A
+/// failed compaction is reported once and leaves the original file in use.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_compact_poll(
+    handle: *mut MemvidHandle,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    status_to_cstr(poll(handle), error)
+}
@@ -0,0 +1,364 @@
+//! Content-hash filter for deduplicating puts.
+//!
+//! With `dedup: true`, memvid-core looks every put up against the stored
+//! frames, although most content in a re-crawl is new. Each writable handle
+//! therefore keeps a bloom filter of the content hashes of all its frames.
+//! When the filter rules a hash out, the put goes to the core with dedup
+//! off; only possible duplicates pay for the core lookup.
+//!
+//! The filter is only consulted while it covers every frame in the file. It
+//! is saved next to the file on commit, as `<file>.dedup`, together with the
+//! frame count and file length it describes, and ignored at open if either
+//! no longer matches. A file with frames but no usable sidecar falls back to
+//! the core lookup for every dedup put on that handle.
+//!
+//! Deleted frames stay in the filter. A superset of the stored content only
+//! costs false positives, so compaction keeps the filter as it is.
+
+use crate::handle::MemvidHandle;
+use crate::util::{sidecar_path, write_sidecar};
+use memvid_core::Memvid;
+use std::io::Read;
+use std::path::Path;
+
+/// Sidecar file suffix.
+const SIDECAR: &str = ".dedup";
+
+/// Sidecar file magic, including the format version.
+const MAGIC: &[u8; 8] = b"MVDEDUP1";
+
+/// Items the first filter layer is sized for; each later layer doubles.
+const FIRST_CAPACITY: u64 = 4096;
+
+/// Bits per item, for a false-positive rate below 1% in each layer.
+const BITS_PER_ITEM: u64 = 10;
+
+/// Bit probes per item.
+const PROBES: u64 = 7;
+
+/// Batches of at least this many items are hashed on several threads.
+const PARALLEL_BATCH: usize = 64;
+
+/// 128-bit content hash, split for double hashing.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) struct ContentHash(u64, u64);
+
+impl ContentHash {
+    /// First half of the hash, for the 64-bit digests of snapshot streams.
+    pub(crate) fn to_u64(self) -> u64 {
+        self.0
+    }
+}
+
+/// Finalizer from splitmix64.
+fn mix(mut x: u64) -> u64 {
+    x = (x ^ (x >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+    x = (x ^ (x >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+    x ^ (x >> 31)
+}
+
+/// Hash content a word at a time.
+///
+/// The hash is stored in sidecar files, so it must not change between
+/// builds; `std::hash` gives no such guarantee.
+pub(crate) fn content_hash(data: &[u8]) -> ContentHash {
+    let mut a = 0x243f_6a88_85a3_08d3 ^ data.len() as u64;
+    let mut b = 0x1319_8a2e_0370_7344u64;
+    let mut word = |w: u64| {
+        a = (a ^ w).wrapping_mul(0x9e37_79b9_7f4a_7c15).rotate_left(31);
+        b = (b.rotate_left(23) ^ w).wrapping_mul(0xff51_afd7_ed55_8ccd);
+    };
+    let chunks = data.chunks_exact(8);
+    let tail = chunks.remainder();
+    for chunk in chunks {
+        word(u64::from_le_bytes(chunk.try_into().expect("8-byte chunk")));
+    }
+    if !tail.is_empty() {
+        let mut last = [0u8; 8];
+        last[..tail.len()].copy_from_slice(tail);
+        word(u64::from_le_bytes(last));
+    }
+    // An odd step reaches every bit position of a power-of-two layer
+    ContentHash(mix(a ^ b.rotate_left(17)), mix(b.wrapping_add(a)) | 1)
+}
+
+/// Hash a batch of contents, on several threads for large batches.
+pub(crate) fn content_hashes(contents: &[&[u8]]) -> Vec<ContentHash> {
+    let workers = std::thread::available_parallelism().map_or(1, |n| n.get());
+    if contents.len() < PARALLEL_BATCH || workers == 1 {
+        return contents.iter().map(|data| content_hash(data)).collect();
+    }
+
+    let mut hashes = vec![ContentHash(0, 0); contents.len()];
+    let chunk = contents.len().div_ceil(workers);
+    std::thread::scope(|scope| {
+        for (contents, hashes) in contents.chunks(chunk).zip(hashes.chunks_mut(chunk)) {
+            scope.spawn(move || {
+                for (data, hash) in contents.iter().zip(hashes) {
+                    *hash = content_hash(data);
+                }
+            });
+        }
+    });
+    hashes
+}
+
+/// One fixed-size bloom filter of a growing chain.
+struct Layer {
+    /// Items the layer is sized for
+    capacity: u64,
+    /// Items inserted
+    count: u64,
+    /// Bit array; its length in bits is a power of two
+    words: Vec<u64>,
+}
+
+impl Layer {
+    fn with_capacity(capacity: u64) -> Self {
+        let bits = (capacity * BITS_PER_ITEM).next_power_of_two().max(64);
+        Self {
+            capacity,
+            count: 0,
+            words: vec![0; (bits / 64) as usize],
+        }
+    }
+
+    fn positions(&self, hash: ContentHash) -> impl Iterator<Item = u64> {
+        let mask = self.words.len() as u64 * 64 - 1;
+        (0..PROBES).map(move |i| hash.0.wrapping_add(i.wrapping_mul(hash.1)) & mask)
+    }
+
+    fn contains(&self, hash: ContentHash) -> bool {
+        self.positions(hash)
+            .all(|bit| self.words[(bit / 64) as usize] & (1 << (bit % 64)) != 0)
+    }
+
+    fn insert(&mut self, hash: ContentHash) {
+        let positions: Vec<u64> = self.positions(hash).collect();
+        for bit in positions {
+            self.words[(bit / 64) as usize] |= 1 << (bit % 64);
+        }
+        self.count += 1;
+    }
+}
+
+/// Dedup check counters, reported by `memvid_stats_ext`.
+#[derive(Debug, Default, Clone, Copy)]
+pub(crate) struct DedupCounters {
+    /// Dedup puts made while the filter was usable
+    pub(crate) checks: u64,
+    /// Checks the filter answered without a core lookup
+    pub(crate) filtered: u64,
+    /// Checks the core confirmed as duplicates
+    pub(crate) duplicates: u64,
+    /// Checks the filter passed on that turned out to be new content
+    pub(crate) false_positives: u64,
+}
+
+/// Bloom filter of every frame's content hash, kept on each handle.
+///
+/// Layers are added as frames are stored, so the false-positive rate stays
+/// bounded without knowing the final size up front.
+pub(crate) struct DedupFilter {
+    layers: Vec<Layer>,
+    /// Frame count the filter covers; `None` once frames of unknown
+    /// content exist
+    covered: Option<u64>,
+    /// Changed since it was last saved
+    dirty: bool,
+    pub(crate) counters: DedupCounters,
+}
+
+impl DedupFilter {
+    /// Empty filter, usable if the memory has no frames yet.
+    pub(crate) fn new(frames: usize) -> Self {
+        Self {
+            layers: Vec::new(),
+            covered: (frames == 0).then_some(0),
+            dirty: false,
+            counters: DedupCounters::default(),
+        }
+    }
+
+    /// Load the sidecar of `path` if it still describes the file.
+    pub(crate) fn load(path: &Path, frames: usize) -> Self {
+        let loaded = Self::read_sidecar(path).filter(|(covered, len, _)| {
+            *covered == frames as u64 && std::fs::metadata(path).is_ok_and(|m| m.len() == *len)
+        });
+        match loaded {
+            Some((covered, _, layers)) => Self {
+                layers,
+                covered: Some(covered),
+                ..Self::new(frames)
+            },
+            None => Self::new(frames),
+        }
+    }
+
+    /// Whether the filter covers all `frames` frames.
+    pub(crate) fn is_usable(&self, frames: usize) -> bool {
+        self.covered == Some(frames as u64)
+    }
+
+    /// Whether content with `hash` may already be stored.
+    fn may_contain(&self, hash: ContentHash) -> bool {
+        self.layers.iter().any(|layer| layer.contains(hash))
+    }
+
+    fn insert(&mut self, hash: ContentHash) {
+        let full = self.layers.last().is_none_or(|l| l.count >= l.capacity);
+        if full {
+            let capacity = self
+                .layers
+                .last()
+                .map_or(FIRST_CAPACITY, |l| l.capacity * 2);
+            self.layers.push(Layer::with_capacity(capacity));
+        }
+        self.layers
+            .last_mut()
+            .expect("layer added above")
+            .insert(hash);
+        self.dirty = true;
+    }
+
+    /// Keep the filter across a file swap that only dropped frames.
+    pub(crate) fn rebase(&mut self, frames: usize) {
+        if self.covered.is_some() {
+            self.covered = Some(frames as u64);
+            self.dirty = true;
+        }
+    }
+
+    /// Forget every hash after the file was replaced by other content.
+    pub(crate) fn clear(&mut self, frames: usize) {
+        *self = Self {
+            counters: self.counters,
+            dirty: true,
+            ..Self::new(frames)
+        };
+    }
+
+    /// Write the sidecar of `path`, or remove it if the filter is unusable.
+    ///
+    /// The sidecar only saves work, so failing to write it is not an error;
+    /// an outdated file is ignored at the next open.
+    pub(crate) fn save(&mut self, path: &Path) {
+        if !self.dirty {
+            return;
+        }
+        self.dirty = false;
+        let sidecar = sidecar_path(path, SIDECAR);
+        let Some(covered) = self.covered else {
+            let _ = std::fs::remove_file(&sidecar);
+            return;
+        };
+        let Ok(len) = std::fs::metadata(path).map(|m| m.len()) else {
+            return;
+        };
+
+        let mut out = Vec::new();
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&covered.to_le_bytes());
+        out.extend_from_slice(&len.to_le_bytes());
+        out.extend_from_slice(&(self.layers.len() as u64).to_le_bytes());
+        for layer in &self.layers {
+            out.extend_from_slice(&layer.capacity.to_le_bytes());
+            out.extend_from_slice(&layer.count.to_le_bytes());
+            out.extend_from_slice(&(layer.words.len() as u64).to_le_bytes());
+            for word in &layer.words {
+                out.extend_from_slice(&word.to_le_bytes());
+            }
+        }
+
+        write_sidecar(&sidecar, &out);
+    }
+
+    /// Parse the sidecar of `path` into (covered, file length, layers).
+    fn read_sidecar(path: &Path) -> Option<(u64, u64, Vec<Layer>)> {
+        let mut bytes = Vec::new();
+        std::fs::File::open(sidecar_path(path, SIDECAR))
+            .and_then(|mut file| file.read_to_end(&mut bytes))
+            .ok()?;
+        let (magic, mut rest) = bytes.split_first_chunk::<8>()?;
+        if magic != MAGIC {
+            return None;
+        }
+        let mut next = || {
+            let (word, tail) = rest.split_first_chunk::<8>()?;
+            rest = tail;
+            Some(u64::from_le_bytes(*word))
+        };
+
+        let covered = next()?;
+        let len = next()?;
+        let layer_count = next()?;
+        let mut layers = Vec::new();
+        for _ in 0..layer_count {
+            let capacity = next()?;
+            let count = next()?;
+            let word_count = next()?;
+            if word_count == 0 || !word_count.is_power_of_two() {
+                return None;
+            }
+            let words = (0..word_count)
+                .map(|_| next())
+                .collect::<Option<Vec<_>>>()?;
+            layers.push(Layer {
+                capacity,
+                count,
+                words,
+            });
+        }
+        next().is_none().then_some((covered, len, layers))
+    }
+}
+
+/// Save the handle's filter next to its file, if it has one.
+pub(crate) fn save(handle: &mut MemvidHandle) {
+    if let (true, Some(path)) = (handle.writable, &handle.path) {
+        handle.dedup.save(path);
+    }
+}
+
+/// Put `data`, letting the filter skip the core's duplicate lookup.
+///
+/// `put` stores the content, asking the core to deduplicate when its flag
+/// is set. `dedup` is whether the caller requested deduplication, and
+/// `hash` the content hash if already computed.
+pub(crate) fn put_checked(
+    handle: &mut MemvidHandle,
+    data: &[u8],
+    hash: Option<ContentHash>,
+    dedup: bool,
+    put: impl FnOnce(&mut Memvid, bool) -> Result<u64, memvid_core::MemvidError>,
+) -> Result<u64, memvid_core::MemvidError> {
+    let before = handle.as_ref().frame_count();
+    let filter = &mut handle.dedup;
+    if !filter.is_usable(before) {
+        return put(handle.as_mut(), dedup);
+    }
+
+    let hash = hash.unwrap_or_else(|| content_hash(data));
+    let lookup = dedup && filter.may_contain(hash);
+    if dedup {
+        filter.counters.checks += 1;
+        if !lookup {
+            filter.counters.filtered += 1;
+        }
+    }
+    let result = put(handle.as_mut(), lookup);
+
+    let after = handle.as_ref().frame_count();
+    let filter = &mut handle.dedup;
+    if after > before {
+        // Chunked content adds several frames for one hash
+        filter.insert(hash);
+        filter.covered = Some(after as u64);
+        if lookup {
+            filter.counters.false_positives += 1;
+        }
+    } else if lookup && result.is_ok() {
+        filter.counters.duplicates += 1;
+    }
+    result
+}
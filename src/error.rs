@@ -137,6 +137,10 @@ pub enum MemvidErrorCode {
     JsonParse = 102,
     /// Invalid handle
     InvalidHandle = 103,
+    /// Caller-supplied buffer is too small
+    BufferTooSmall = 104,
+    /// Call not allowed in the current state
+    InvalidState = 105,
     /// Unknown error
     Unknown = 255,
 }
@@ -217,6 +221,38 @@ impl MemvidError {
         }
     }
 
+    /// Create an I/O error.
+    pub fn io(e: std::io::Error) -> Self {
+        let msg = format!("I/O error: {e}");
+        Self {
+            code: MemvidErrorCode::Io,
+            message: CString::new(msg)
+                .map(CString::into_raw)
+                .unwrap_or(std::ptr::null_mut()),
+        }
+    }
+
+    /// Create a buffer too small error.
+    pub fn buffer_too_small(param: &str, needed: usize) -> Self {
+        let msg = format!("buffer too small for parameter: {param} (needs {needed})");
+        Self {
+            code: MemvidErrorCode::BufferTooSmall,
+            message: CString::new(msg)
+                .map(CString::into_raw)
+                .unwrap_or(std::ptr::null_mut()),
+        }
+    }
+
+    /// Create an invalid state error.
+    pub fn invalid_state(reason: &str) -> Self {
+        Self {
+            code: MemvidErrorCode::InvalidState,
+            message: CString::new(reason)
+                .map(CString::into_raw)
+                .unwrap_or(std::ptr::null_mut()),
+        }
+    }
+
     /// Create an invalid handle error.
     pub fn invalid_handle() -> Self {
         Self {
@@ -229,7 +265,7 @@ impl MemvidError {
 }
 
 /// Convert a memvid-core error to an FFI error code.
-fn error_code_from_core(e: &memvid_core::MemvidError) -> MemvidErrorCode {
+pub(crate) fn error_code_from_core(e: &memvid_core::MemvidError) -> MemvidErrorCode {
     use memvid_core::MemvidError::*;
 
     match e {
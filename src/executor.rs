@@ -0,0 +1,576 @@
+//! Completion-based execution of blocking calls for event-loop hosts.
+//!
+//! A `MemvidExecutor` owns a fixed set of worker threads. Submitting a task
+//! copies its request and returns a task ID at once; a worker then runs the
+//! ordinary blocking entry point (`memvid_search`, `memvid_ask`,
+//! `memvid_commit`, `memvid_verify`) and reports the result either through a
+//! completion callback or on a completion queue the host drains with
+//! `memvid_executor_poll`. On Linux the queue is paired with an eventfd so it
+//! can be registered with epoll or io_uring.
+//!
+//! Handles are not thread-safe, so tasks on the same handle run one at a
+//! time in submission order; tasks on different handles (for example
+//! several reader pool views) run in parallel.
+
+use crate::error::{MemvidError, MemvidErrorCode};
+use crate::handle::MemvidHandle;
+use crate::util::{set_error, set_error_null, set_ok};
+use serde::Deserialize;
+use std::collections::{HashMap, HashSet, VecDeque};
+use std::ffi::{CStr, CString};
+use std::os::raw::{c_char, c_void};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard};
+use std::thread::JoinHandle;
+
+/// Task operations accepted by `memvid_executor_submit`.
+pub const MEMVID_TASK_SEARCH: i32 = 0;
+pub const MEMVID_TASK_ASK: i32 = 1;
+pub const MEMVID_TASK_COMMIT: i32 = 2;
+pub const MEMVID_TASK_VERIFY: i32 = 3;
+
+/// Completion status values in `MemvidCompletion::status`.
+pub const MEMVID_TASK_DONE: i32 = 0;
+pub const MEMVID_TASK_FAILED: i32 = 1;
+pub const MEMVID_TASK_CANCELLED: i32 = 2;
+
+/// Result of a finished task.
+///
+/// `result` holds the JSON the blocking entry point would have returned
+/// (NULL for commits and for failed or cancelled tasks); `error` is set when
+/// `status` is `MEMVID_TASK_FAILED`.
+#[repr(C)]
+pub struct MemvidCompletion {
+    /// ID returned by `memvid_executor_submit`
+    pub task_id: u64,
+    /// MEMVID_TASK_* operation
+    pub op: i32,
+    /// MEMVID_TASK_DONE, MEMVID_TASK_FAILED or MEMVID_TASK_CANCELLED
+    pub status: i32,
+    /// Error for failed tasks (code Ok otherwise)
+    pub error: MemvidError,
+    /// Result JSON, or NULL
+    pub result: *mut c_char,
+}
+
+// Completions own their strings; they are only moved between threads.
+unsafe impl Send for MemvidCompletion {}
+
+impl Default for MemvidCompletion {
+    fn default() -> Self {
+        Self {
+            task_id: 0,
+            op: 0,
+            status: MEMVID_TASK_DONE,
+            error: MemvidError::ok(),
+            result: std::ptr::null_mut(),
+        }
+    }
+}
+
+impl MemvidCompletion {
+    /// Release the result string and error message.
+    fn free(&mut self) {
+        unsafe {
+            crate::memvid_string_free(self.result);
+            crate::memvid_error_free(&mut self.error);
+        }
+        self.result = std::ptr::null_mut();
+    }
+}
+
+/// Task completion callback.
+///
+/// Invoked on a worker thread with the caller's context pointer and the
+/// completion. The completion and its strings are freed when the callback
+/// returns; copy anything that must outlive it.
+pub type MemvidCompletionFn =
+    Option<unsafe extern "C" fn(ctx: *mut c_void, completion: *const MemvidCompletion)>;
+
+/// Pointers a task carries onto its worker thread.
+struct TaskPtrs {
+    handle: *mut MemvidHandle,
+    ctx: *mut c_void,
+}
+
+// The caller lends the handle to the executor until the task completes, and
+// the context is only handed back to the caller.
+unsafe impl Send for TaskPtrs {}
+
+/// Submitted task waiting for or running on a worker.
+struct Task {
+    id: u64,
+    op: i32,
+    request: Option<CString>,
+    ptrs: TaskPtrs,
+    callback: MemvidCompletionFn,
+    cancel: Arc<AtomicBool>,
+}
+
+impl Task {
+    /// Handle the task must hold exclusively while it runs.
+    fn exclusive(&self) -> Option<usize> {
+        let cancelled = self.cancel.load(Ordering::Relaxed);
+        (!cancelled && !self.ptrs.handle.is_null()).then_some(self.ptrs.handle as usize)
+    }
+}
+
+/// Request body for `MEMVID_TASK_VERIFY`.
+#[derive(Debug, Deserialize)]
+struct VerifyTaskJson {
+    path: String,
+    #[serde(default)]
+    deep: bool,
+}
+
+/// Mutable executor state, guarded by `Shared::state`.
+#[derive(Default)]
+struct State {
+    queue: VecDeque<Task>,
+    /// Handles with a task running on some worker
+    busy: HashSet<usize>,
+    /// Cancellation flags of queued and running tasks by ID
+    live: HashMap<u64, Arc<AtomicBool>>,
+    completions: VecDeque<MemvidCompletion>,
+    next_id: u64,
+    shutdown: bool,
+}
+
+impl State {
+    /// Take the oldest task that may start now.
+    ///
+    /// Cancelled tasks are taken regardless of their handle since they only
+    /// report their cancellation.
+    fn take_runnable(&mut self) -> Option<Task> {
+        let index = self
+            .queue
+            .iter()
+            .position(|task| task.exclusive().is_none_or(|h| !self.busy.contains(&h)))?;
+        self.queue.remove(index)
+    }
+}
+
+/// State shared with the worker threads.
+struct Shared {
+    state: Mutex<State>,
+    /// Signalled when a task is queued, a handle frees up, or on shutdown
+    work: Condvar,
+    /// Counts queued completions; -1 when unavailable
+    event_fd: i32,
+}
+
+impl Shared {
+    fn lock(&self) -> MutexGuard<'_, State> {
+        // Workers never panic while holding the lock
+        self.state.lock().unwrap_or_else(|e| e.into_inner())
+    }
+
+    fn notify_fd(&self) {
+        #[cfg(target_os = "linux")]
+        if self.event_fd >= 0 {
+            let one = 1u64;
+            unsafe { libc::write(self.event_fd, (&one as *const u64).cast(), 8) };
+        }
+    }
+}
+
+/// Thread pool running blocking calls with completion notification.
+///
+/// The executor itself is thread-safe.
+pub struct MemvidExecutor {
+    shared: Arc<Shared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+impl MemvidExecutor {
+    /// Convert a raw pointer to a shared reference.
+    ///
+    /// Entry points may run on several threads at once, so they only ever
+    /// borrow the executor shared; its state lives behind `Shared`'s lock.
+    ///
+    /// # Safety
+    ///
+    /// The pointer must be valid or null.
+    unsafe fn from_ptr<'a>(ptr: *mut MemvidExecutor) -> Option<&'a Self> {
+        unsafe { ptr.as_ref() }
+    }
+}
+
+impl Drop for MemvidExecutor {
+    fn drop(&mut self) {
+        {
+            let mut state = self.shared.lock();
+            state.shutdown = true;
+            for task in &state.queue {
+                task.cancel.store(true, Ordering::Relaxed);
+            }
+        }
+        self.shared.work.notify_all();
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+        for mut completion in self.shared.lock().completions.drain(..) {
+            completion.free();
+        }
+        #[cfg(target_os = "linux")]
+        if self.shared.event_fd >= 0 {
+            unsafe { libc::close(self.shared.event_fd) };
+        }
+    }
+}
+
+/// Run one task's blocking call, filling in `completion`.
+fn run(task: &Task, completion: &mut MemvidCompletion) {
+    let request = task
+        .request
+        .as_deref()
+        .map_or(std::ptr::null(), CStr::as_ptr);
+    let error = &mut completion.error;
+    completion.result = unsafe {
+        match task.op {
+            MEMVID_TASK_SEARCH => crate::memvid_search(task.ptrs.handle, request, error),
+            MEMVID_TASK_ASK => crate::memvid_ask(task.ptrs.handle, request, error),
+            MEMVID_TASK_COMMIT => {
+                crate::memvid_commit(task.ptrs.handle, error);
+                std::ptr::null_mut()
+            }
+            _ => {
+                let parsed = task
+                    .request
+                    .as_deref()
+                    .map(|r| serde_json::from_slice::<VerifyTaskJson>(r.to_bytes()));
+                match parsed {
+                    Some(Ok(verify)) => match CString::new(verify.path) {
+                        Ok(path) => crate::memvid_verify(path.as_ptr(), verify.deep as i32, error),
+                        Err(_) => set_error_null(error, MemvidError::invalid_utf8("path")),
+                    },
+                    Some(Err(e)) => set_error_null(error, MemvidError::json_parse(e)),
+                    None => set_error_null(error, MemvidError::null_pointer("request_json")),
+                }
+            }
+        }
+    };
+    if completion.error.code != MemvidErrorCode::Ok {
+        completion.status = MEMVID_TASK_FAILED;
+    }
+}
+
+/// Worker loop: take runnable tasks until shutdown drains the queue.
+fn work(shared: &Shared) {
+    let mut state = shared.lock();
+    loop {
+        let Some(task) = state.take_runnable() else {
+            if state.shutdown && state.queue.is_empty() {
+                return;
+            }
+            state = shared.work.wait(state).unwrap_or_else(|e| e.into_inner());
+            continue;
+        };
+
+        let exclusive = task.exclusive();
+        let cancelled = task.cancel.load(Ordering::Relaxed);
+        if let Some(handle) = exclusive {
+            state.busy.insert(handle);
+        }
+        drop(state);
+
+        let mut completion = MemvidCompletion {
+            task_id: task.id,
+            op: task.op,
+            ..Default::default()
+        };
+        if !cancelled {
+            run(&task, &mut completion);
+        }
+        // A task cancelled while running completes, but its result is dropped
+        if task.cancel.load(Ordering::Relaxed) {
+            completion.free();
+            completion.error = MemvidError::ok();
+            completion.status = MEMVID_TASK_CANCELLED;
+        }
+
+        state = shared.lock();
+        state.live.remove(&task.id);
+        if let Some(handle) = exclusive {
+            state.busy.remove(&handle);
+            // Another worker may be waiting on this handle
+            shared.work.notify_all();
+        }
+        match task.callback {
+            Some(callback) => {
+                drop(state);
+                unsafe { callback(task.ptrs.ctx, &completion) };
+                completion.free();
+                state = shared.lock();
+            }
+            None => {
+                state.completions.push_back(completion);
+                shared.notify_fd();
+            }
+        }
+    }
+}
+
+/// Start an executor with its worker threads.
+///
+/// # Parameters
+///
+/// - `threads`: Worker threads (0 for one per core)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Executor on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned executor. Must call `memvid_executor_close()` to free.
+///
+/// # Safety
+///
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_open(
+    threads: u32,
+    error: *mut MemvidError,
+) -> *mut MemvidExecutor {
+    let threads = if threads == 0 {
+        std::thread::available_parallelism().map_or(1, |n| n.get())
+    } else {
+        threads as usize
+    };
+
+    #[cfg(target_os = "linux")]
+    let event_fd = unsafe { libc::eventfd(0, libc::EFD_NONBLOCK | libc::EFD_CLOEXEC) };
+    #[cfg(not(target_os = "linux"))]
+    let event_fd = -1;
+
+    let shared = Arc::new(Shared {
+        state: Mutex::new(State {
+            next_id: 1,
+            ..Default::default()
+        }),
+        work: Condvar::new(),
+        event_fd,
+    });
+    let mut executor = MemvidExecutor {
+        shared,
+        workers: Vec::with_capacity(threads),
+    };
+    for i in 0..threads {
+        let shared = executor.shared.clone();
+        match std::thread::Builder::new()
+            .name(format!("memvid-exec-{i}"))
+            .spawn(move || work(&shared))
+        {
+            Ok(worker) => executor.workers.push(worker),
+            Err(e) => return unsafe { set_error_null(error, MemvidError::io(e)) },
+        }
+    }
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(executor))
+}
+
+/// Submit a blocking call to run on the executor.
+///
+/// The request is copied, so it may be freed once this returns. The handle
+/// is lent to the executor: do not use it from any other thread, or close
+/// it, until the task's completion has been delivered.
+///
+/// # Parameters
+///
+/// - `executor`: Valid executor
+/// - `handle`: Handle the call runs on (ignored for `MEMVID_TASK_VERIFY`)
+/// - `op`: MEMVID_TASK_* operation
+/// - `request_json`: Request for the operation, as for the blocking call:
+///   a SearchRequest for `MEMVID_TASK_SEARCH`, an AskRequest for
+///   `MEMVID_TASK_ASK`, NULL for `MEMVID_TASK_COMMIT`, and
+///   `{"path": "...", "deep": false}` for `MEMVID_TASK_VERIFY`
+/// - `callback`: Completion callback, or NULL to queue the completion for
+///   `memvid_executor_poll()`
+/// - `ctx`: Context pointer passed back to `callback`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Task ID (non-zero) on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `executor` and `handle` must be valid
+/// - `request_json` must be a valid UTF-8 string or NULL
+/// - `callback` must be safe to call with `ctx` from any thread
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_submit(
+    executor: *mut MemvidExecutor,
+    handle: *mut MemvidHandle,
+    op: i32,
+    request_json: *const c_char,
+    callback: MemvidCompletionFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> u64 {
+    let executor = match unsafe { MemvidExecutor::from_ptr(executor) } {
+        Some(e) => e,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("executor")) },
+    };
+    if !(MEMVID_TASK_SEARCH..=MEMVID_TASK_VERIFY).contains(&op) {
+        return unsafe { set_error(error, MemvidError::invalid_state("unknown task operation")) };
+    }
+    if handle.is_null() && op != MEMVID_TASK_VERIFY {
+        return unsafe { set_error(error, MemvidError::invalid_handle()) };
+    }
+    let request =
+        (!request_json.is_null()).then(|| unsafe { CStr::from_ptr(request_json) }.to_owned());
+
+    let mut state = executor.shared.lock();
+    let id = state.next_id;
+    state.next_id += 1;
+    let cancel = Arc::new(AtomicBool::new(false));
+    state.live.insert(id, cancel.clone());
+    state.queue.push_back(Task {
+        id,
+        op,
+        request,
+        ptrs: TaskPtrs { handle, ctx },
+        callback,
+        cancel,
+    });
+    drop(state);
+    executor.shared.work.notify_one();
+
+    unsafe { set_ok(error) };
+    id
+}
+
+/// Cancel a submitted task.
+///
+/// A task that has not started is never run. A running task finishes its
+/// blocking call, but its result is discarded. Either way the task still
+/// completes, with status `MEMVID_TASK_CANCELLED`.
+///
+/// # Parameters
+///
+/// - `executor`: Valid executor
+/// - `task_id`: ID from `memvid_executor_submit()`
+///
+/// # Returns
+///
+/// 1 if the task was pending or running, 0 if it has already completed.
+///
+/// # Safety
+///
+/// - `executor` must be a valid executor or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_cancel(
+    executor: *mut MemvidExecutor,
+    task_id: u64,
+) -> i32 {
+    let Some(executor) = (unsafe { MemvidExecutor::from_ptr(executor) }) else {
+        return 0;
+    };
+    let state = executor.shared.lock();
+    let Some(cancel) = state.live.get(&task_id) else {
+        return 0;
+    };
+    cancel.store(true, Ordering::Relaxed);
+    drop(state);
+    // A cancelled task no longer waits for its handle
+    executor.shared.work.notify_all();
+    1
+}
+
+/// File descriptor that becomes readable when completions are queued.
+///
+/// The descriptor is an eventfd counting queued completions (Linux only);
+/// read it to reset it before draining with `memvid_executor_poll()`. It is
+/// owned by the executor and closed by `memvid_executor_close()`.
+///
+/// # Parameters
+///
+/// - `executor`: Valid executor
+///
+/// # Returns
+///
+/// The descriptor, or -1 if unavailable on this platform.
+///
+/// # Safety
+///
+/// - `executor` must be a valid executor or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_fd(executor: *mut MemvidExecutor) -> i32 {
+    unsafe { MemvidExecutor::from_ptr(executor) }.map_or(-1, |e| e.shared.event_fd)
+}
+
+/// Drain queued completions without blocking.
+///
+/// # Parameters
+///
+/// - `executor`: Valid executor
+/// - `out`: Array receiving up to `max` completions
+/// - `max`: Capacity of `out`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Number of completions written.
+///
+/// # Ownership
+///
+/// Caller owns each written completion's `result` (free with
+/// `memvid_string_free()`) and `error` (free with `memvid_error_free()`).
+///
+/// # Safety
+///
+/// - `executor` must be a valid executor
+/// - `out` must point to `max` writable `MemvidCompletion` values
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_poll(
+    executor: *mut MemvidExecutor,
+    out: *mut MemvidCompletion,
+    max: usize,
+    error: *mut MemvidError,
+) -> usize {
+    let executor = match unsafe { MemvidExecutor::from_ptr(executor) } {
+        Some(e) => e,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("executor")) },
+    };
+    if out.is_null() && max > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("out")) };
+    }
+
+    let mut state = executor.shared.lock();
+    let count = max.min(state.completions.len());
+    for (i, completion) in state.completions.drain(..count).enumerate() {
+        unsafe { out.add(i).write(completion) };
+    }
+    unsafe { set_ok(error) };
+    count
+}
+
+/// Close an executor.
+///
+/// Tasks that have not started are completed as cancelled, running tasks
+/// are waited for, and completions never polled are freed.
+///
+/// # Parameters
+///
+/// - `executor`: Executor to close (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `executor` must be a valid executor returned by `memvid_executor_open`, or NULL
+/// - The executor must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_executor_close(executor: *mut MemvidExecutor) {
+    if executor.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(executor));
+    }
+}
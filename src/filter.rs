@@ -0,0 +1,436 @@
+//! Metadata posting sets for filtered search.
+//!
+//! memvid-core search filters only on URI and scope, so each handle keeps
+//! an inverted index of frame metadata: for every tag, label and kind, the
+//! sorted list of frame IDs carrying it, plus frame IDs by timestamp. The
+//! index is built incrementally from `frame_by_id`; frames are append-only,
+//! so only frames added since the last refresh are read.
+//!
+//! The posting lists are saved next to the file on commit, as
+//! `<file>.mindex`, together with the frame count and file length they
+//! describe, and ignored at open if either no longer matches. Once a handle
+//! has an index, loaded or built by its first filtered search, each commit
+//! extends it with the committed frames and saves it again. When compaction
+//! or a snapshot apply renumbers frames, the index is rebuilt at the swap.
+//!
+//! A filter is resolved to a matching set by intersecting posting lists,
+//! smallest first, so its cost follows the most selective condition rather
+//! than the size of the memory. Search hits are then kept only if their
+//! frame is in the set.
+
+use crate::util::{sidecar_path, write_sidecar};
+use serde::{Deserialize, Serialize};
+use std::borrow::Cow;
+use std::collections::{BTreeMap, HashMap};
+use std::path::Path;
+
+/// Sidecar file suffix.
+const SIDECAR: &str = ".mindex";
+
+/// Sidecar file magic, including the format version.
+const MAGIC: &[u8; 8] = b"MVMIDX01";
+
+/// Structured search filters from JSON.
+///
+/// Every condition that is set must hold.
+#[derive(Debug, Clone, Default, Deserialize, Serialize)]
+pub(crate) struct SearchFiltersJson {
+    /// Tags the frame must all carry, as listed in the frame's `tags`
+    #[serde(default)]
+    tags: Vec<String>,
+    /// Labels of which the frame must carry at least one
+    #[serde(default)]
+    labels: Vec<String>,
+    /// Frame kind
+    #[serde(default)]
+    kind: Option<String>,
+    /// Timestamp lower bound (inclusive)
+    #[serde(default)]
+    since: Option<i64>,
+    /// Timestamp upper bound (inclusive)
+    #[serde(default)]
+    until: Option<i64>,
+}
+
+impl SearchFiltersJson {
+    /// True when no condition is set.
+    pub(crate) fn is_empty(&self) -> bool {
+        self.tags.is_empty()
+            && self.labels.is_empty()
+            && self.kind.is_none()
+            && self.since.is_none()
+            && self.until.is_none()
+    }
+
+    /// The conditions other than the timestamp bounds.
+    pub(crate) fn without_time(&self) -> Self {
+        self.with_time(None, None)
+    }
+
+    /// Timestamp bounds only.
+    pub(crate) fn time(since: Option<i64>, until: Option<i64>) -> Self {
+        Self {
+            since,
+            until,
+            ..Self::default()
+        }
+    }
+
+    /// These conditions with the timestamp bounds replaced.
+    pub(crate) fn with_time(&self, since: Option<i64>, until: Option<i64>) -> Self {
+        Self {
+            since,
+            until,
+            ..self.clone()
+        }
+    }
+
+    pub(crate) fn since(&self) -> Option<i64> {
+        self.since
+    }
+
+    pub(crate) fn until(&self) -> Option<i64> {
+        self.until
+    }
+}
+
+/// Frame IDs in ascending order.
+type Postings = Vec<u64>;
+
+/// Sorted set of frames matching a filter.
+#[derive(Debug, Clone)]
+pub(crate) struct FrameSet(Postings);
+
+impl FrameSet {
+    pub(crate) fn contains(&self, frame_id: u64) -> bool {
+        self.0.binary_search(&frame_id).is_ok()
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        self.0.len()
+    }
+
+    pub(crate) fn is_empty(&self) -> bool {
+        self.0.is_empty()
+    }
+
+    /// Frame IDs in ascending order.
+    pub(crate) fn ids(&self) -> &[u64] {
+        &self.0
+    }
+
+    /// Frames in both sets.
+    pub(crate) fn intersect(&self, other: &FrameSet) -> FrameSet {
+        let (small, large) = if self.len() <= other.len() {
+            (self, other)
+        } else {
+            (other, self)
+        };
+        FrameSet(
+            small
+                .0
+                .iter()
+                .copied()
+                .filter(|&id| large.contains(id))
+                .collect(),
+        )
+    }
+}
+
+/// Inverted index of frame metadata, kept on each handle.
+#[derive(Default)]
+pub(crate) struct MetadataIndex {
+    /// Bumped by `reset`, so resolved filters can tell IDs were reassigned
+    epoch: u64,
+    /// Frames with an ID below this have been indexed
+    indexed: u64,
+    tags: HashMap<String, Postings>,
+    labels: HashMap<String, Postings>,
+    kinds: HashMap<String, Postings>,
+    timestamps: BTreeMap<i64, Postings>,
+    /// Extended and saved on commit; set once the index is loaded or built,
+    /// so commits never pay for a first build
+    maintained: bool,
+    /// Changed since it was last saved
+    dirty: bool,
+    /// File length recorded in the sidecar last written or loaded
+    saved_len: Option<u64>,
+}
+
+impl MetadataIndex {
+    /// Empty index, maintained from the start if the memory has no frames.
+    pub(crate) fn new(frames: usize) -> Self {
+        Self {
+            maintained: frames == 0,
+            ..Self::default()
+        }
+    }
+
+    /// Load the posting lists saved next to `path` if they still describe
+    /// the file.
+    pub(crate) fn load(path: &Path, frames: usize) -> Self {
+        Self::read_sidecar(path, frames as u64).unwrap_or_else(|| Self::new(frames))
+    }
+
+    /// Drop everything indexed, for when frame IDs are reassigned.
+    ///
+    /// A maintained index stays maintained, so it is rebuilt at the next
+    /// save.
+    pub(crate) fn reset(&mut self) {
+        *self = Self {
+            epoch: self.epoch + 1,
+            maintained: self.maintained,
+            dirty: true,
+            ..Self::default()
+        };
+    }
+
+    /// Index the frames added since the last refresh.
+    ///
+    /// IDs are visited in ascending order, so every posting list stays
+    /// sorted by appending.
+    pub(crate) fn refresh(&mut self, memvid: &mut memvid_core::Memvid) {
+        self.maintained = true;
+        let count = memvid.frame_count() as u64;
+        while self.indexed < count {
+            let id = self.indexed;
+            self.indexed += 1;
+            self.dirty = true;
+            let Ok(frame) = memvid.frame_by_id(id) else {
+                continue;
+            };
+            for tag in frame.tags {
+                self.tags.entry(tag).or_default().push(id);
+            }
+            for label in frame.labels {
+                self.labels.entry(label).or_default().push(id);
+            }
+            if let Some(kind) = frame.kind {
+                self.kinds.entry(kind).or_default().push(id);
+            }
+            self.timestamps.entry(frame.timestamp).or_default().push(id);
+        }
+    }
+
+    /// Frames indexed so far.
+    pub(crate) fn frames(&self) -> u64 {
+        self.indexed
+    }
+
+    /// Extend a maintained index and write the sidecar of `path`.
+    ///
+    /// Reads only the frames added since the last save, but rewrites every
+    /// posting list; the sidecar is only rewritten when frames were added
+    /// or the file length changed. It only saves work, so failing to write
+    /// it is not an error; an outdated file is ignored at the next open.
+    pub(crate) fn save(&mut self, memvid: &mut memvid_core::Memvid, path: &Path) {
+        if !self.maintained {
+            return;
+        }
+        self.refresh(memvid);
+        let Ok(len) = std::fs::metadata(path).map(|m| m.len()) else {
+            return;
+        };
+        if !self.dirty && self.saved_len == Some(len) {
+            return;
+        }
+        self.dirty = false;
+        self.saved_len = Some(len);
+
+        let mut out = Vec::new();
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&self.indexed.to_le_bytes());
+        out.extend_from_slice(&len.to_le_bytes());
+        let put_ids = |out: &mut Vec<u8>, ids: &Postings| {
+            out.extend_from_slice(&(ids.len() as u64).to_le_bytes());
+            for id in ids {
+                out.extend_from_slice(&id.to_le_bytes());
+            }
+        };
+        for map in [&self.tags, &self.labels, &self.kinds] {
+            out.extend_from_slice(&(map.len() as u64).to_le_bytes());
+            for (key, ids) in map {
+                out.extend_from_slice(&(key.len() as u64).to_le_bytes());
+                out.extend_from_slice(key.as_bytes());
+                put_ids(&mut out, ids);
+            }
+        }
+        out.extend_from_slice(&(self.timestamps.len() as u64).to_le_bytes());
+        for (timestamp, ids) in &self.timestamps {
+            out.extend_from_slice(&timestamp.to_le_bytes());
+            put_ids(&mut out, ids);
+        }
+
+        write_sidecar(&sidecar_path(path, SIDECAR), &out);
+    }
+
+    /// Parse the sidecar of `path` if it covers `frames` frames of the file
+    /// at its current length.
+    fn read_sidecar(path: &Path, frames: u64) -> Option<Self> {
+        let bytes = std::fs::read(sidecar_path(path, SIDECAR)).ok()?;
+        let (magic, mut rest) = bytes.split_first_chunk::<8>()?;
+        if magic != MAGIC {
+            return None;
+        }
+        let mut take = |n: u64| {
+            let (head, tail) = rest.split_at_checked(usize::try_from(n).ok()?)?;
+            rest = tail;
+            Some(head)
+        };
+        let word = |bytes: &[u8]| u64::from_le_bytes(bytes.try_into().unwrap());
+
+        let indexed = word(take(8)?);
+        let len = word(take(8)?);
+        let current = std::fs::metadata(path).ok()?.len();
+        if indexed != frames || len != current {
+            return None;
+        }
+        let mut index = Self {
+            indexed,
+            maintained: true,
+            saved_len: Some(len),
+            ..Self::default()
+        };
+        for map in [&mut index.tags, &mut index.labels, &mut index.kinds] {
+            let count = word(take(8)?);
+            for _ in 0..count {
+                let key_len = word(take(8)?);
+                let key = String::from_utf8(take(key_len)?.to_vec()).ok()?;
+                let count = word(take(8)?);
+                map.insert(key, Self::postings(take(count.checked_mul(8)?)?, indexed)?);
+            }
+        }
+        let count = word(take(8)?);
+        for _ in 0..count {
+            let timestamp = i64::from_le_bytes(take(8)?.try_into().ok()?);
+            let count = word(take(8)?);
+            let ids = Self::postings(take(count.checked_mul(8)?)?, indexed)?;
+            index.timestamps.insert(timestamp, ids);
+        }
+        take(1).is_none().then_some(index)
+    }
+
+    /// Posting list stored as `bytes`, if sorted and below `indexed`.
+    ///
+    /// Counts are checked against the bytes left before anything is
+    /// allocated, so a corrupt sidecar cannot ask for more than its size.
+    fn postings(bytes: &[u8], indexed: u64) -> Option<Postings> {
+        let ids: Postings = bytes
+            .chunks_exact(8)
+            .map(|id| u64::from_le_bytes(id.try_into().unwrap()))
+            .collect();
+        (ids.is_sorted() && ids.last().is_none_or(|&id| id < indexed)).then_some(ids)
+    }
+
+    /// Frames matching every condition in `filters`.
+    pub(crate) fn matching(&self, filters: &SearchFiltersJson) -> FrameSet {
+        self.matching_from(filters, 0)
+    }
+
+    /// Frames with an ID of at least `from` matching every condition.
+    fn matching_from<'a>(&'a self, filters: &SearchFiltersJson, from: u64) -> FrameSet {
+        let lookup = |map: &'a HashMap<String, Postings>, key: &str| -> Cow<'a, [u64]> {
+            let ids = map.get(key).map_or(&[][..], Vec::as_slice);
+            Cow::Borrowed(&ids[ids.partition_point(|&id| id < from)..])
+        };
+
+        let mut sets: Vec<Cow<'a, [u64]>> = filters
+            .tags
+            .iter()
+            .map(|tag| lookup(&self.tags, tag))
+            .collect();
+        if !filters.labels.is_empty() {
+            let mut any: Postings = filters
+                .labels
+                .iter()
+                .filter_map(|label| self.labels.get(label))
+                .flatten()
+                .copied()
+                .filter(|&id| id >= from)
+                .collect();
+            any.sort_unstable();
+            any.dedup();
+            sets.push(Cow::Owned(any));
+        }
+        if let Some(kind) = &filters.kind {
+            sets.push(lookup(&self.kinds, kind));
+        }
+        if filters.since.is_some() || filters.until.is_some() {
+            let since = filters.since.unwrap_or(i64::MIN);
+            let until = filters.until.unwrap_or(i64::MAX);
+            let mut in_range: Postings = if since <= until {
+                self.timestamps
+                    .range(since..=until)
+                    .flat_map(|(_, ids)| ids)
+                    .copied()
+                    .filter(|&id| id >= from)
+                    .collect()
+            } else {
+                Vec::new()
+            };
+            in_range.sort_unstable();
+            sets.push(Cow::Owned(in_range));
+        }
+
+        // Intersect from the most selective set, probing the larger ones
+        sets.sort_by_key(|set| set.len());
+        let mut sets = sets.into_iter();
+        let mut matching = sets.next().map(Cow::into_owned).unwrap_or_default();
+        for set in sets {
+            if matching.is_empty() {
+                break;
+            }
+            matching.retain(|id| set.binary_search(id).is_ok());
+        }
+        FrameSet(matching)
+    }
+}
+
+/// Filter conditions resolved once and extended as frames are appended.
+///
+/// Used by prepared queries: re-running `matching` on every execution would
+/// repeat the posting-list intersection, so only frames indexed since the
+/// last resolution are matched and appended. The set is rebuilt when the
+/// handle changes or its frame IDs are reassigned.
+pub(crate) struct ResolvedFilter {
+    filters: SearchFiltersJson,
+    /// ID of the handle the set was resolved on
+    owner: u64,
+    epoch: u64,
+    /// Frames below this ID have been resolved
+    upto: u64,
+    matching: FrameSet,
+}
+
+impl ResolvedFilter {
+    pub(crate) fn new(filters: SearchFiltersJson) -> Self {
+        Self {
+            filters,
+            owner: 0,
+            epoch: 0,
+            upto: 0,
+            matching: FrameSet(Vec::new()),
+        }
+    }
+
+    /// Whether any condition is set.
+    pub(crate) fn is_active(&self) -> bool {
+        !self.filters.is_empty()
+    }
+
+    /// The resolved set, brought up to date with `index` on `owner`.
+    pub(crate) fn refresh(&mut self, owner: u64, index: &MetadataIndex) -> &FrameSet {
+        if owner != self.owner || index.epoch != self.epoch || index.indexed < self.upto {
+            self.owner = owner;
+            self.epoch = index.epoch;
+            self.upto = 0;
+            self.matching.0.clear();
+        }
+        if self.upto < index.indexed {
+            let added = index.matching_from(&self.filters, self.upto);
+            self.matching.0.extend(added.0);
+            self.upto = index.indexed;
+        }
+        &self.matching
+    }
+}
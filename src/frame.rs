@@ -1,15 +1,33 @@
 //! Frame retrieval and content functions.
 
+use crate::arena::{MemvidArena, Output};
 use crate::error::MemvidError;
 use crate::handle::MemvidHandle;
+use crate::metrics::{Op, Phase, Span};
 use crate::util::{set_error, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
 use serde::Serialize;
 use std::os::raw::c_char;
 
+/// Borrowed byte view returned by `memvid_frame_payload_view`.
+///
+/// The bytes are NOT null-terminated and may contain interior NULs.
+/// Release with `memvid_view_release()`.
+#[repr(C)]
+#[derive(Debug)]
+pub struct MemvidView {
+    /// Pointer to the first byte (NULL for a released view)
+    pub data: *const u8,
+    /// Number of bytes at `data`
+    pub len: size_t,
+    /// Allocated size of the buffer, used by `memvid_view_release` (do not modify)
+    pub capacity: size_t,
+}
+
 /// Frame data serialized for FFI.
 ///
 /// This mirrors the core Frame struct but with FFI-friendly types.
-#[derive(Debug, Serialize)]
+#[derive(Debug, Clone, Serialize)]
 struct FrameJson {
     id: u64,
     timestamp: i64,
@@ -86,22 +104,80 @@ pub unsafe extern "C" fn memvid_frame_by_id(
     frame_id: u64,
     error: *mut MemvidError,
 ) -> *mut c_char {
+    unsafe { frame_by_id_to(handle, frame_id, Output::Heap, error) }
+}
+
+/// Get frame metadata by ID, allocating the response in an arena.
+///
+/// Same as `memvid_frame_by_id`, but the JSON string is bump-allocated in
+/// `arena` instead of the heap.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `frame_id`: Frame identifier
+/// - `arena`: Arena that owns the response
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with frame metadata on success, NULL on failure.
+///
+/// # Ownership
+///
+/// The string belongs to `arena` and is valid until `memvid_arena_reset()` or
+/// `memvid_arena_destroy()`. Do not pass it to `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `arena` must be a valid arena
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_frame_by_id_arena(
+    handle: *mut MemvidHandle,
+    frame_id: u64,
+    arena: *mut MemvidArena,
+    error: *mut MemvidError,
+) -> *const c_char {
+    let arena = match unsafe { MemvidArena::from_ptr_mut(arena) } {
+        Some(a) => a,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("arena")) },
+    };
+    unsafe { frame_by_id_to(handle, frame_id, Output::Arena(arena), error) }
+}
+
+/// Run `memvid_frame_by_id`, writing the response to `out`.
+///
+/// # Safety
+///
+/// Same requirements as `memvid_frame_by_id`.
+unsafe fn frame_by_id_to(
+    handle: *mut MemvidHandle,
+    frame_id: u64,
+    mut out: Output,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::FrameById);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
     };
+    span.phase(Phase::Parse);
 
-    match handle.as_mut().frame_by_id(frame_id) {
-        Ok(frame) => {
-            let json_frame = FrameJson::from(&frame);
-            match serde_json::to_string(&json_frame) {
-                Ok(json) => {
-                    unsafe { set_ok(error) };
-                    string_to_cstr(json)
-                }
-                Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    let result = handle.as_mut().frame_by_id(frame_id);
+    span.phase(Phase::Core);
+    if let Ok(frame) = &result {
+        handle.hot_set.record(frame.id);
+    }
+    match result {
+        Ok(frame) => match out.json(&FrameJson::from(&frame), &mut span) {
+            Ok(ptr) => {
+                unsafe { set_ok(error) };
+                ptr
             }
-        }
+            Err(e) => unsafe { set_error_null(error, e) },
+        },
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
 }
@@ -155,6 +231,153 @@ pub unsafe extern "C" fn memvid_frame_by_uri(
     }
 }
 
+/// Get metadata for many frames by ID in one call.
+///
+/// IDs are resolved in ascending order so frame-table reads are sequential;
+/// results are returned in input order.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `ids`: Array of `count` frame identifiers
+/// - `count`: Number of IDs
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON array with one entry per input ID (same schema as
+/// `memvid_frame_by_id`, or `null` when the frame does not exist), NULL on
+/// failure. Any error other than a missing frame fails the whole call.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `ids` must point to `count` values, or be NULL if `count` is 0
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_frames_by_ids(
+    handle: *mut MemvidHandle,
+    ids: *const u64,
+    count: size_t,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    if ids.is_null() && count > 0 {
+        return unsafe { set_error_null(error, MemvidError::null_pointer("ids")) };
+    }
+
+    let ids = if count == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(ids, count) }
+    };
+
+    // Visit IDs in sorted order, resolving repeated IDs only once
+    let mut order: Vec<usize> = (0..ids.len()).collect();
+    order.sort_unstable_by_key(|&i| ids[i]);
+
+    let memvid = handle.as_mut();
+    let mut frames: Vec<Option<FrameJson>> = vec![None; ids.len()];
+    let mut previous: Option<usize> = None;
+    for i in order {
+        frames[i] = match previous {
+            Some(p) if ids[p] == ids[i] => frames[p].clone(),
+            _ => match memvid.frame_by_id(ids[i]) {
+                Ok(frame) => Some(FrameJson::from(&frame)),
+                Err(memvid_core::MemvidError::FrameNotFound { .. }) => None,
+                Err(e) => {
+                    return unsafe { set_error_null(error, MemvidError::from_core_error(e)) };
+                }
+            },
+        };
+        previous = Some(i);
+    }
+
+    match serde_json::to_string(&frames) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
+
+/// Get metadata for many frames by URI in one call.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `uris`: Array of `count` URIs (null-terminated UTF-8 strings)
+/// - `count`: Number of URIs
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON array with one entry per input URI (same schema as
+/// `memvid_frame_by_id`, or `null` when no frame matches or the entry is
+/// NULL), NULL on failure. Invalid UTF-8 and any error other than a missing
+/// frame fail the whole call. Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `uris` must point to `count` string pointers (each valid or NULL),
+///   or be NULL if `count` is 0
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_frames_by_uris(
+    handle: *mut MemvidHandle,
+    uris: *const *const c_char,
+    count: size_t,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    if uris.is_null() && count > 0 {
+        return unsafe { set_error_null(error, MemvidError::null_pointer("uris")) };
+    }
+
+    let uris = if count == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(uris, count) }
+    };
+
+    let memvid = handle.as_mut();
+    let mut frames: Vec<Option<FrameJson>> = Vec::with_capacity(uris.len());
+    for &uri in uris {
+        let uri = match unsafe { crate::util::cstr_to_option_string(uri, "uris") } {
+            Ok(Some(uri)) => uri,
+            Ok(None) => {
+                frames.push(None);
+                continue;
+            }
+            Err(e) => return unsafe { set_error_null(error, e) },
+        };
+        frames.push(match memvid.frame_by_uri(&uri) {
+            Ok(frame) => Some(FrameJson::from(&frame)),
+            Err(memvid_core::MemvidError::FrameNotFoundByUri { .. }) => None,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+        });
+    }
+
+    match serde_json::to_string(&frames) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
+
 /// Get frame text content by ID.
 ///
 /// # Parameters
@@ -192,6 +415,100 @@ pub unsafe extern "C" fn memvid_frame_content(
     }
 }
 
+/// Get frame content by ID as a pointer/length view.
+///
+/// Returns the frame's raw payload bytes, which need not be UTF-8. Unlike
+/// `memvid_frame_content`, the buffer read from the core is handed over
+/// as is, without a second copy into a C string, so payloads with interior
+/// NUL bytes are returned intact and callers do not need to `strlen` large
+/// frames.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `frame_id`: Frame identifier
+/// - `view`: Out-parameter for the content view (must not be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure (`view` is set to NULL/0/0).
+///
+/// # Ownership
+///
+/// The view owns its buffer independently of the handle. Must call
+/// `memvid_view_release()` to free it.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `view` must be a valid pointer
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_frame_payload_view(
+    handle: *mut MemvidHandle,
+    frame_id: u64,
+    view: *mut MemvidView,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let view = match unsafe { view.as_mut() } {
+        Some(v) => v,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("view")) },
+    };
+    view.data = std::ptr::null();
+    view.len = 0;
+    view.capacity = 0;
+
+    match handle.as_mut().frame_canonical_payload(frame_id) {
+        Ok(bytes) => {
+            // Released by memvid_view_release with the same length and capacity
+            let mut bytes = std::mem::ManuallyDrop::new(bytes);
+            view.data = bytes.as_mut_ptr();
+            view.len = bytes.len();
+            view.capacity = bytes.capacity();
+            unsafe { set_ok(error) };
+            1
+        }
+        Err(e) => unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    }
+}
+
+/// Release a view returned by `memvid_frame_payload_view`.
+///
+/// After this call, `view->data` is NULL and `view->len` and
+/// `view->capacity` are 0.
+///
+/// # Parameters
+///
+/// - `view`: View to release (safe to pass NULL, or an already released view)
+///
+/// # Safety
+///
+/// - `view` must be a view filled by `memvid_frame_payload_view`, or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_view_release(view: *mut MemvidView) {
+    let Some(view) = (unsafe { view.as_mut() }) else {
+        return;
+    };
+    if !view.data.is_null() {
+        unsafe {
+            drop(Vec::from_raw_parts(
+                view.data as *mut u8,
+                view.len,
+                view.capacity,
+            ))
+        };
+    }
+    view.data = std::ptr::null();
+    view.len = 0;
+    view.capacity = 0;
+}
+
 /// Soft-delete a frame.
 ///
 /// Creates a tombstone entry; the frame data is not immediately removed.
@@ -223,6 +540,8 @@ pub unsafe extern "C" fn memvid_delete_frame(
 
     match handle.as_mut().delete_frame(frame_id) {
         Ok(seq) => {
+            handle.cache.invalidate();
+            handle.time_index.forget(frame_id);
             unsafe { set_ok(error) };
             seq
         }
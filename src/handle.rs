@@ -1,6 +1,20 @@
 //! Opaque handle wrapper for Memvid instances.
 
+use crate::cache::QueryCache;
+use crate::compact::Compaction;
+use crate::dedup::DedupFilter;
+use crate::filter::MetadataIndex;
+use crate::mutation::GroupCommit;
+use crate::snapshot::Snapshots;
+use crate::state::{MemvidStats, StatsCache};
+use crate::timeindex::{Bounds, TimeIndex};
+use crate::warmup::HotSet;
 use memvid_core::Memvid;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Source of handle IDs; 0 is never issued.
+static NEXT_ID: AtomicU64 = AtomicU64::new(1);
 
 /// Opaque handle to a Memvid instance.
 ///
@@ -11,14 +25,120 @@ use memvid_core::Memvid;
 ///
 /// `MemvidHandle` is NOT thread-safe. All operations on a handle must occur
 /// from the same thread that created it, or external synchronization must be used.
+/// Use `MemvidReaderPool` to run read-only queries from several threads.
 pub struct MemvidHandle {
     inner: Memvid,
+    /// Process-unique ID; unlike the address, never reused after close
+    pub(crate) id: u64,
+    /// Group-commit state for `memvid_commit_async`
+    pub(crate) group_commit: GroupCommit,
+    /// Result cache for `memvid_search` and `memvid_ask`
+    pub(crate) cache: QueryCache,
+    /// File the handle was opened from
+    pub(crate) path: Option<PathBuf>,
+    /// Whether the handle was opened for writing
+    pub(crate) writable: bool,
+    /// Background compaction started by `memvid_compact`
+    pub(crate) compaction: Option<Compaction>,
+    /// Frame hit counts for `memvid_hot_set_export`
+    pub(crate) hot_set: HotSet,
+    /// Metadata posting sets for filtered search
+    metadata: MetadataIndex,
+    /// Block manifests of recent `memvid_snapshot_stream` positions
+    pub(crate) snapshots: Snapshots,
+    /// Statistics as of the last commit, plus commit counters
+    pub(crate) stats_cache: StatsCache,
+    /// Content hashes of stored frames for dedup puts
+    pub(crate) dedup: DedupFilter,
+    /// Timestamp partitions for narrowing timeline queries
+    pub(crate) time_index: TimeIndex,
 }
 
 impl MemvidHandle {
     /// Create a new handle wrapping a Memvid instance.
     pub fn new(memvid: Memvid) -> Box<Self> {
-        Box::new(Self { inner: memvid })
+        Box::new(Self {
+            stats_cache: StatsCache::new(memvid.frame_count()),
+            dedup: DedupFilter::new(memvid.frame_count()),
+            time_index: TimeIndex::new(),
+            metadata: MetadataIndex::new(memvid.frame_count()),
+            inner: memvid,
+            id: NEXT_ID.fetch_add(1, Ordering::Relaxed),
+            group_commit: GroupCommit::default(),
+            cache: QueryCache::default(),
+            path: None,
+            writable: false,
+            compaction: None,
+            hot_set: HotSet::default(),
+            snapshots: Snapshots::default(),
+        })
+    }
+
+    /// Create a handle for a Memvid opened for writing at `path`.
+    pub(crate) fn writable(memvid: Memvid, path: PathBuf) -> Box<Self> {
+        let dedup = DedupFilter::load(&path, memvid.frame_count());
+        let mut handle = Self::read_only(memvid, path);
+        handle.writable = true;
+        handle.dedup = dedup;
+        handle
+    }
+
+    /// Create a handle for a Memvid opened read-only at `path`.
+    pub(crate) fn read_only(memvid: Memvid, path: PathBuf) -> Box<Self> {
+        let time_index = TimeIndex::load(&path, memvid.frame_count());
+        let metadata = MetadataIndex::load(&path, memvid.frame_count());
+        let mut handle = Self::new(memvid);
+        handle.time_index = time_index;
+        handle.metadata = metadata;
+        handle.path = Some(path);
+        handle
+    }
+
+    /// Swap in a reopened Memvid, returning the previous one.
+    ///
+    /// The metadata and time indexes and statistics are rebuilt on next use,
+    /// or by the next `save_indexes`, since frame IDs may have been
+    /// reassigned. The dedup filter is kept,
+    /// as for compaction; callers that swap in other content must clear it.
+    pub(crate) fn replace_inner(&mut self, memvid: Memvid) -> Memvid {
+        self.metadata.reset();
+        self.time_index.reset();
+        self.stats_cache.rebase(memvid.frame_count());
+        self.dedup.rebase(memvid.frame_count());
+        std::mem::replace(&mut self.inner, memvid)
+    }
+
+    /// Metadata index, brought up to date with the frames added so far.
+    pub(crate) fn metadata_index(&mut self) -> &MetadataIndex {
+        self.metadata.refresh(&mut self.inner);
+        &self.metadata
+    }
+
+    /// Timeline bounds narrowed with the time index, or `None` if no frame
+    /// can match.
+    pub(crate) fn narrow_timeline(
+        &mut self,
+        bounds: Bounds,
+        reverse: bool,
+        limit: Option<u64>,
+    ) -> Option<Bounds> {
+        let committed = self.stats_cache.committed_frames();
+        self.time_index
+            .narrow(&mut self.inner, committed, bounds, reverse, limit)
+    }
+
+    /// Extend the time and metadata indexes and save them next to the
+    /// file, if writable.
+    pub(crate) fn save_indexes(&mut self) {
+        if let (true, Some(path)) = (self.writable, &self.path) {
+            self.time_index.save(&mut self.inner, path);
+            self.metadata.save(&mut self.inner, path);
+        }
+    }
+
+    /// Statistics, recomputed by the core only after a commit or delete.
+    pub(crate) fn stats(&mut self) -> Result<MemvidStats, memvid_core::MemvidError> {
+        self.stats_cache.get(self.cache.generation(), &self.inner)
     }
 
     /// Get a reference to the inner Memvid.
@@ -0,0 +1,619 @@
+//! Parallel ingest pipeline.
+//!
+//! Documents submitted to a pipeline flow through three stages:
+//!
+//! 1. **submit** (caller thread): copies the payload, which the caller may
+//!    reuse as soon as submit returns
+//! 2. **prepare** (worker pool): parses per-item options, merges them with
+//!    the shared options and hashes the content for the dedup filter
+//! 3. **write** (writer thread): appends prepared frames to the handle
+//!    strictly in submission order
+//!
+//! The caller lends the handle to the pipeline until `memvid_ingest_finish`,
+//! as it does to executor tasks, and only the writer thread uses it in the
+//! meantime. The three stages therefore overlap: while a document is being
+//! written, the caller submits the next ones and the workers prepare them.
+//! Submit blocks only while the bounded in-flight window is full.
+//!
+//! memvid-core cannot analyze a document apart from appending it: text
+//! extraction, indexing and the analysis requested through `auto_tag`,
+//! `extract_dates` and `extract_triplets` all run inside its put, which
+//! needs the handle exclusively. That work stays in the single write stage
+//! and bounds the pipeline's throughput; the workers take only what can be
+//! split off. Per-stage stats show where the time goes.
+
+use crate::dedup::{content_hash, ContentHash};
+use crate::error::{error_code_from_core, MemvidError, MemvidErrorCode};
+use crate::handle::MemvidHandle;
+use crate::mutation::{put_slice_hashed, PutOptionsJson};
+use crate::util::{cstr_to_option_string, set_error, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
+use memvid_core::PutOptions;
+use serde::Serialize;
+use std::collections::BTreeMap;
+use std::os::raw::c_char;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::mpsc::{Receiver, SyncSender, TrySendError};
+use std::sync::{Arc, Mutex};
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
+
+/// Default bound on documents in flight across all stages.
+const DEFAULT_QUEUE_DEPTH: usize = 64;
+
+/// Submitted document awaiting preparation.
+struct Job {
+    ticket: u64,
+    data: Vec<u8>,
+    options_json: Option<String>,
+}
+
+/// Prepared document awaiting the write stage.
+struct Prepared {
+    ticket: u64,
+    data: Vec<u8>,
+    /// Content hash, when the handle's dedup filter will use it
+    hash: Option<ContentHash>,
+    options: Result<PutOptions, (MemvidErrorCode, String)>,
+}
+
+/// Handle lent to the writer thread.
+struct LentHandle(*mut MemvidHandle);
+
+// The caller lends the handle to the pipeline until `memvid_ingest_finish`
+// returns, and only the writer thread uses it in the meantime.
+unsafe impl Send for LentHandle {}
+
+/// Outcome of one submitted document.
+#[derive(Debug, Serialize)]
+struct OutcomeJson {
+    ticket: u64,
+    frame_id: u64,
+    code: i32,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    message: Option<String>,
+}
+
+/// Counters for one pipeline stage.
+#[derive(Default)]
+struct StageStats {
+    items: AtomicU64,
+    bytes: AtomicU64,
+    busy_ns: AtomicU64,
+}
+
+impl StageStats {
+    fn record(&self, bytes: usize, busy: Duration) {
+        self.items.fetch_add(1, Ordering::Relaxed);
+        self.bytes.fetch_add(bytes as u64, Ordering::Relaxed);
+        self.busy_ns
+            .fetch_add(busy.as_nanos() as u64, Ordering::Relaxed);
+    }
+
+    fn to_json(&self, elapsed: Duration) -> StageJson {
+        let items = self.items.load(Ordering::Relaxed);
+        let bytes = self.bytes.load(Ordering::Relaxed);
+        let secs = elapsed.as_secs_f64();
+        StageJson {
+            items,
+            bytes,
+            busy_ms: self.busy_ns.load(Ordering::Relaxed) as f64 / 1e6,
+            items_per_sec: if secs > 0.0 { items as f64 / secs } else { 0.0 },
+            bytes_per_sec: if secs > 0.0 { bytes as f64 / secs } else { 0.0 },
+        }
+    }
+}
+
+/// Counters shared by every stage of a pipeline.
+struct PipelineStats {
+    started: Instant,
+    submit: StageStats,
+    /// Time callers spent waiting for a slot in a full in-flight window
+    submit_blocked_ns: AtomicU64,
+    prepare: StageStats,
+    write: StageStats,
+}
+
+/// Stage counters for JSON serialization.
+#[derive(Debug, Serialize)]
+struct StageJson {
+    items: u64,
+    bytes: u64,
+    /// Time spent doing stage work (summed across workers)
+    busy_ms: f64,
+    /// Items completed per wall-clock second since the pipeline opened
+    items_per_sec: f64,
+    bytes_per_sec: f64,
+}
+
+/// Pipeline stats for JSON serialization.
+#[derive(Debug, Serialize)]
+struct IngestStatsJson {
+    elapsed_ms: f64,
+    workers: usize,
+    queue_depth: usize,
+    in_flight: usize,
+    submit_blocked_ms: f64,
+    submit: StageJson,
+    prepare: StageJson,
+    write: StageJson,
+}
+
+/// Final pipeline report for JSON serialization.
+#[derive(Debug, Serialize)]
+struct IngestResultJson {
+    submitted: u64,
+    stored: u64,
+    results: Vec<OutcomeJson>,
+    stats: IngestStatsJson,
+}
+
+/// Multi-threaded ingest pipeline bound to one handle.
+///
+/// The handle is lent to the pipeline's writer thread; the caller does not
+/// use it until `memvid_ingest_finish` returns.
+pub struct MemvidIngestPipeline {
+    jobs: Option<SyncSender<Job>>,
+    /// Holds one token per document in flight; the writer takes a token
+    /// back for each document it writes
+    slots: SyncSender<()>,
+    workers: Vec<JoinHandle<()>>,
+    writer: Option<JoinHandle<Vec<OutcomeJson>>>,
+    stats: Arc<PipelineStats>,
+    queue_depth: usize,
+    next_ticket: u64,
+}
+
+impl MemvidIngestPipeline {
+    /// Documents submitted but not written yet.
+    fn in_flight(&self) -> usize {
+        let written = self.stats.write.items.load(Ordering::Relaxed);
+        (self.next_ticket - 1).saturating_sub(written) as usize
+    }
+
+    /// Take a slot in the in-flight window, waiting while it is full.
+    /// Returns false if the writer stopped.
+    fn take_slot(&self) -> bool {
+        match self.slots.try_send(()) {
+            Ok(()) => true,
+            Err(TrySendError::Full(())) => {
+                let blocked = Instant::now();
+                let sent = self.slots.send(()).is_ok();
+                self.stats
+                    .submit_blocked_ns
+                    .fetch_add(blocked.elapsed().as_nanos() as u64, Ordering::Relaxed);
+                sent
+            }
+            Err(TrySendError::Disconnected(())) => false,
+        }
+    }
+
+    fn stats_json(&self) -> IngestStatsJson {
+        let stats = &self.stats;
+        let elapsed = stats.started.elapsed();
+        IngestStatsJson {
+            elapsed_ms: elapsed.as_secs_f64() * 1e3,
+            workers: self.workers.len(),
+            queue_depth: self.queue_depth,
+            in_flight: self.in_flight(),
+            submit_blocked_ms: stats.submit_blocked_ns.load(Ordering::Relaxed) as f64 / 1e6,
+            submit: stats.submit.to_json(elapsed),
+            prepare: stats.prepare.to_json(elapsed),
+            write: stats.write.to_json(elapsed),
+        }
+    }
+}
+
+/// Write stage: append prepared documents in submission order.
+///
+/// Runs until every worker has stopped, and returns the outcomes of the
+/// documents written.
+fn run_writer(
+    handle: LentHandle,
+    prepared: Receiver<Prepared>,
+    slots: Receiver<()>,
+    stats: Arc<PipelineStats>,
+) -> Vec<OutcomeJson> {
+    // SAFETY: the handle is lent to this thread alone, see `LentHandle`
+    let handle = unsafe { &mut *handle.0 };
+    // Prepared documents that arrived ahead of an earlier ticket
+    let mut pending = BTreeMap::new();
+    let mut outcomes = Vec::new();
+    let mut next_write = 1;
+    for item in prepared {
+        pending.insert(item.ticket, item);
+        while let Some(item) = pending.remove(&next_write) {
+            let start = Instant::now();
+            let (frame_id, code, message) = match item.options {
+                Ok(options) => match put_slice_hashed(handle, &item.data, item.hash, options) {
+                    Ok(frame_id) => (frame_id, MemvidErrorCode::Ok, None),
+                    Err(e) => (0, error_code_from_core(&e), Some(e.to_string())),
+                },
+                Err((code, message)) => (0, code, Some(message)),
+            };
+            stats.write.record(item.data.len(), start.elapsed());
+            outcomes.push(OutcomeJson {
+                ticket: item.ticket,
+                frame_id,
+                code: code as i32,
+                message,
+            });
+            next_write += 1;
+            // Submit took this document's slot before sending it
+            let _ = slots.try_recv();
+        }
+    }
+    outcomes
+}
+
+/// Prepare stage: resolve each document's options and hash its content.
+fn run_worker(
+    jobs: Arc<Mutex<Receiver<Job>>>,
+    prepared: SyncSender<Prepared>,
+    shared: Arc<Option<PutOptionsJson>>,
+    stats: Arc<PipelineStats>,
+    hash_content: bool,
+) {
+    loop {
+        let job = match jobs.lock().unwrap_or_else(|e| e.into_inner()).recv() {
+            Ok(job) => job,
+            Err(_) => return,
+        };
+
+        let start = Instant::now();
+        let options = match job.options_json.as_deref() {
+            Some(json) => serde_json::from_str::<PutOptionsJson>(json)
+                .map(|overrides| match &*shared {
+                    Some(base) => base.merged(overrides).into_put_options(),
+                    None => overrides.into_put_options(),
+                })
+                .map_err(|e| (MemvidErrorCode::JsonParse, format!("JSON parse error: {e}"))),
+            None => Ok((*shared)
+                .clone()
+                .map(PutOptionsJson::into_put_options)
+                .unwrap_or_default()),
+        };
+        let hash = (hash_content && options.is_ok()).then(|| content_hash(&job.data));
+        stats.prepare.record(job.data.len(), start.elapsed());
+
+        let item = Prepared {
+            ticket: job.ticket,
+            hash,
+            data: job.data,
+            options,
+        };
+        if prepared.send(item).is_err() {
+            return;
+        }
+    }
+}
+
+/// Open a parallel ingest pipeline on a handle.
+///
+/// Documents are prepared on `workers` threads and appended by one writer
+/// thread, overlapping with the caller's submits. memvid-core performs
+/// content analysis (`auto_tag`, `extract_dates`, `extract_triplets`) and
+/// indexing inside its put and offers no way to run them apart from it, so
+/// that work is serialized on the writer thread; the workers only parse
+/// options and hash content.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle; lent to the pipeline's writer thread until
+///   `memvid_ingest_finish()`
+/// - `workers`: Prepare-stage threads (0 for the number of CPUs)
+/// - `queue_depth`: Maximum documents in flight across all stages (0 for 64);
+///   `memvid_ingest_submit` waits while the window is full
+/// - `shared_options_json`: JSON string with PutOptions applied to every document
+///   (NULL for defaults; per-document options override it as in `memvid_put_many`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Pipeline on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned pipeline. Must call `memvid_ingest_finish()` to free.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle and must not be used by the caller until
+///   `memvid_ingest_finish()` returns
+/// - `shared_options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ingest_open(
+    handle: *mut MemvidHandle,
+    workers: u32,
+    queue_depth: u32,
+    shared_options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidIngestPipeline {
+    let hash_content = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h.dedup.is_usable(h.as_ref().frame_count()),
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let shared_json = unsafe { cstr_to_option_string(shared_options_json, "shared_options_json") };
+    let shared = match shared_json {
+        Ok(Some(json_str)) => match serde_json::from_str::<PutOptionsJson>(&json_str) {
+            Ok(opts) => Some(opts),
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => None,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let worker_count = if workers == 0 {
+        std::thread::available_parallelism().map_or(1, |n| n.get())
+    } else {
+        workers as usize
+    };
+    let queue_depth = if queue_depth == 0 {
+        DEFAULT_QUEUE_DEPTH
+    } else {
+        queue_depth as usize
+    };
+
+    let stats = Arc::new(PipelineStats {
+        started: Instant::now(),
+        submit: StageStats::default(),
+        submit_blocked_ns: AtomicU64::new(0),
+        prepare: StageStats::default(),
+        write: StageStats::default(),
+    });
+    // Submit takes a slot before sending each document, so no more than
+    // queue_depth are in flight and neither stage channel blocks a sender;
+    // they are bounded for the same capacity.
+    let (slots_tx, slots_rx) = std::sync::mpsc::sync_channel(queue_depth);
+    let (job_tx, job_rx) = std::sync::mpsc::sync_channel(queue_depth);
+    let (prepared_tx, prepared_rx) = std::sync::mpsc::sync_channel(queue_depth);
+    let job_rx = Arc::new(Mutex::new(job_rx));
+    let shared = Arc::new(shared);
+
+    let workers = (0..worker_count)
+        .map(|_| {
+            let (jobs, prepared) = (Arc::clone(&job_rx), prepared_tx.clone());
+            let (shared, stats) = (Arc::clone(&shared), Arc::clone(&stats));
+            std::thread::spawn(move || run_worker(jobs, prepared, shared, stats, hash_content))
+        })
+        .collect();
+    drop(prepared_tx);
+    let lent = LentHandle(handle);
+    let writer_stats = Arc::clone(&stats);
+    let writer = std::thread::spawn(move || run_writer(lent, prepared_rx, slots_rx, writer_stats));
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(MemvidIngestPipeline {
+        jobs: Some(job_tx),
+        slots: slots_tx,
+        workers,
+        writer: Some(writer),
+        stats,
+        queue_depth,
+        next_ticket: 1,
+    }))
+}
+
+/// Submit a document to an ingest pipeline.
+///
+/// The payload is copied, so `data` may be reused as soon as this returns;
+/// the copy is the only work done on the caller's thread. While
+/// `queue_depth` documents are in flight, this waits until the writer
+/// thread frees a slot.
+///
+/// # Parameters
+///
+/// - `pipeline`: Pipeline from `memvid_ingest_open()`
+/// - `data`: Pointer to content bytes
+/// - `len`: Length of content in bytes
+/// - `options_json`: JSON string with per-document PutOptions (NULL to use the shared options)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Submission ticket (starting at 1, in submission order) on success, 0 on
+/// failure. Per-document outcomes are reported by `memvid_ingest_finish()`.
+///
+/// # Safety
+///
+/// - `pipeline` must be a valid pipeline
+/// - `data` must point to at least `len` bytes, or be NULL if `len` is 0
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ingest_submit(
+    pipeline: *mut MemvidIngestPipeline,
+    data: *const u8,
+    len: size_t,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> u64 {
+    let pipeline = match unsafe { pipeline.as_mut() } {
+        Some(p) => p,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("pipeline")) },
+    };
+
+    if data.is_null() && len > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("data")) };
+    }
+
+    let options_json = match unsafe { cstr_to_option_string(options_json, "options_json") } {
+        Ok(o) => o,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    if !pipeline.take_slot() {
+        let e = MemvidError::io(std::io::Error::other("ingest pipeline has shut down"));
+        return unsafe { set_error(error, e) };
+    }
+
+    let start = Instant::now();
+    let data = if len == 0 {
+        Vec::new()
+    } else {
+        unsafe { std::slice::from_raw_parts(data, len) }.to_vec()
+    };
+    let ticket = pipeline.next_ticket;
+    let job = Job {
+        ticket,
+        data,
+        options_json,
+    };
+    let sent = pipeline
+        .jobs
+        .as_ref()
+        .is_some_and(|jobs| jobs.send(job).is_ok());
+    if !sent {
+        let e = MemvidError::io(std::io::Error::other("ingest pipeline has shut down"));
+        return unsafe { set_error(error, e) };
+    }
+    pipeline.stats.submit.record(len, start.elapsed());
+    pipeline.next_ticket += 1;
+
+    unsafe { set_ok(error) };
+    ticket
+}
+
+/// Get live pipeline stats.
+///
+/// # Parameters
+///
+/// - `pipeline`: Pipeline from `memvid_ingest_open()`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with per-stage stats, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned string. Must call `memvid_string_free()`.
+///
+/// # Stats JSON Schema
+///
+/// ```json
+/// {
+///   "elapsed_ms": 812.5,
+///   "workers": 8,
+///   "queue_depth": 64,
+///   "in_flight": 12,
+///   "submit_blocked_ms": 40.1,
+///   "submit":  {"items": 1000, "bytes": 52000000, "busy_ms": 30.2,
+///               "items_per_sec": 1230.7, "bytes_per_sec": 64000000.0},
+///   "prepare": {...},
+///   "write":   {...}
+/// }
+/// ```
+///
+/// `busy_ms` is time spent doing stage work (summed over prepare workers);
+/// throughput is per wall-clock second since the pipeline opened.
+///
+/// # Safety
+///
+/// - `pipeline` must be a valid pipeline
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ingest_stats(
+    pipeline: *mut MemvidIngestPipeline,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let pipeline = match unsafe { pipeline.as_ref() } {
+        Some(p) => p,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("pipeline")) },
+    };
+
+    match serde_json::to_string(&pipeline.stats_json()) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
+
+/// Drain an ingest pipeline and free it.
+///
+/// Waits for every submitted document to be written, stops the worker and
+/// writer threads, and returns the handle to the caller. Frames are not
+/// committed; call `memvid_commit()` afterwards.
+///
+/// # Parameters
+///
+/// - `pipeline`: Pipeline from `memvid_ingest_open()`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with per-document outcomes in submission order and final
+/// stats, NULL on failure. The pipeline is freed either way.
+///
+/// # Ownership
+///
+/// Caller owns the returned string. Must call `memvid_string_free()`.
+///
+/// # Result JSON Schema
+///
+/// ```json
+/// {
+///   "submitted": 2,
+///   "stored": 1,
+///   "results": [
+///     {"ticket": 1, "frame_id": 0, "code": 0},
+///     {"ticket": 2, "frame_id": 0, "code": 102, "message": "JSON parse error: ..."}
+///   ],
+///   "stats": {...}
+/// }
+/// ```
+///
+/// # Safety
+///
+/// - `pipeline` must be a valid pipeline and must not be used after this call
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_ingest_finish(
+    pipeline: *mut MemvidIngestPipeline,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    if pipeline.is_null() {
+        return unsafe { set_error_null(error, MemvidError::null_pointer("pipeline")) };
+    }
+    let mut pipeline = unsafe { Box::from_raw(pipeline) };
+
+    // Closing the job queue lets the workers run dry and exit, and the
+    // writer stops once they have
+    drop(pipeline.jobs.take());
+    let worker_count = pipeline.workers.len();
+    let workers_ok = pipeline
+        .workers
+        .drain(..)
+        .fold(true, |ok, worker| worker.join().is_ok() && ok);
+    let written = pipeline.writer.take().map(JoinHandle::join);
+    let results = match written {
+        Some(Ok(results)) if workers_ok => results,
+        _ => {
+            let e = MemvidError::io(std::io::Error::other("ingest thread panicked"));
+            return unsafe { set_error_null(error, e) };
+        }
+    };
+
+    let mut stats = pipeline.stats_json();
+    stats.workers = worker_count;
+    let report = IngestResultJson {
+        submitted: pipeline.next_ticket - 1,
+        stored: results
+            .iter()
+            .filter(|r| r.code == MemvidErrorCode::Ok as i32)
+            .count() as u64,
+        results,
+        stats,
+    };
+    match serde_json::to_string(&report) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
@@ -9,6 +9,10 @@
 //! occur from the same thread that created it, or external synchronization
 //! must be provided.
 //!
+//! For concurrent queries, `MemvidReaderPool` hands out read-only views over
+//! one file; each view is used by one thread at a time while the pool itself
+//! may be shared freely.
+//!
 //! # Memory Management
 //!
 //! - Handles returned by `memvid_create`/`memvid_open` must be freed with `memvid_close`
@@ -22,35 +26,121 @@
 //! - `lex` (default): Lexical/full-text search via Tantivy
 //! - `vec`: Vector similarity search via HNSW
 //! - `clip`: CLIP visual embeddings (requires `vec`)
+//! - `temporal_track`: Temporal track metadata on search requests and errors
 //! - `full`: All features enabled
 
 #![allow(clippy::missing_safety_doc)]
 
+mod arena;
 mod ask;
+mod cache;
+mod compact;
+mod dedup;
 mod doctor;
 mod error;
+mod executor;
+mod filter;
 mod frame;
 mod handle;
+mod ingest;
 mod lifecycle;
+mod metrics;
 mod mutation;
+mod pool;
+mod prepared;
 mod search;
+mod shard;
+mod snapshot;
 mod state;
+mod stream;
+mod timeindex;
 mod timeline;
 mod util;
+mod vector;
 mod verify;
+mod warmup;
 
 // Re-export all public FFI types and functions
-pub use ask::memvid_ask;
+pub use arena::{
+    memvid_arena_capacity, memvid_arena_create, memvid_arena_destroy, memvid_arena_reset,
+    memvid_set_allocator, MemvidArena, MemvidFreeFn, MemvidMallocFn,
+};
+pub use ask::{
+    memvid_ask, memvid_ask_arena, memvid_ask_stream, MemvidAskStreamFn, MEMVID_ASK_CITATION,
+    MEMVID_ASK_DONE, MEMVID_ASK_FRAGMENT,
+};
+pub use cache::{memvid_cache_configure, memvid_cache_stats, MemvidCacheStats};
+pub use compact::{memvid_compact, memvid_compact_poll};
 pub use doctor::{memvid_doctor, memvid_doctor_apply, memvid_doctor_plan};
 pub use error::{memvid_error_free, MemvidError, MemvidErrorCode};
-pub use frame::{memvid_delete_frame, memvid_frame_by_id, memvid_frame_by_uri, memvid_frame_content};
+pub use executor::{
+    memvid_executor_cancel, memvid_executor_close, memvid_executor_fd, memvid_executor_open,
+    memvid_executor_poll, memvid_executor_submit, MemvidCompletion, MemvidCompletionFn,
+    MemvidExecutor, MEMVID_TASK_ASK, MEMVID_TASK_CANCELLED, MEMVID_TASK_COMMIT, MEMVID_TASK_DONE,
+    MEMVID_TASK_FAILED, MEMVID_TASK_SEARCH, MEMVID_TASK_VERIFY,
+};
+pub use frame::{
+    memvid_delete_frame, memvid_frame_by_id, memvid_frame_by_id_arena, memvid_frame_by_uri,
+    memvid_frame_content, memvid_frame_payload_view, memvid_frames_by_ids, memvid_frames_by_uris,
+    memvid_view_release, MemvidView,
+};
 pub use handle::MemvidHandle;
-pub use lifecycle::{memvid_close, memvid_create, memvid_open};
-pub use mutation::{memvid_commit, memvid_put_bytes, memvid_put_bytes_with_options};
-pub use search::{memvid_search, memvid_string_free};
-pub use state::{memvid_frame_count, memvid_stats, MemvidStats};
-pub use timeline::memvid_timeline;
-pub use verify::memvid_verify;
+pub use ingest::{
+    memvid_ingest_finish, memvid_ingest_open, memvid_ingest_stats, memvid_ingest_submit,
+    MemvidIngestPipeline,
+};
+pub use lifecycle::{memvid_close, memvid_create, memvid_open, memvid_open_with_options};
+pub use metrics::{memvid_metrics_enable, memvid_metrics_reset, memvid_metrics_snapshot};
+pub use mutation::{
+    memvid_commit, memvid_commit_async, memvid_commit_flush, memvid_commit_poll, memvid_put_bytes,
+    memvid_put_bytes_bin, memvid_put_bytes_with_options, memvid_put_many,
+    memvid_set_commit_policy, memvid_set_durability_callback, MemvidDurabilityCallback,
+    MemvidPutItem, MemvidPutOptions, MemvidTag, MEMVID_FLAG_DEFAULT, MEMVID_FLAG_OFF,
+    MEMVID_FLAG_ON,
+};
+pub use pool::{
+    memvid_reader_pool_acquire, memvid_reader_pool_close, memvid_reader_pool_open,
+    memvid_reader_pool_refresh, memvid_reader_pool_release, MemvidReaderPool,
+};
+pub use prepared::{
+    memvid_execute_prepared, memvid_prepare_search, memvid_prepared_free, MemvidPreparedParams,
+    MemvidPreparedQuery,
+};
+pub use search::{
+    memvid_reader_pool_search_batch, memvid_search, memvid_search_arena, memvid_search_batch,
+    memvid_search_bin, memvid_search_into, memvid_string_free, MemvidSearchHit,
+    MemvidSearchQuery, MemvidSearchResult,
+};
+pub use shard::{
+    memvid_shard_set_ask, memvid_shard_set_close, memvid_shard_set_commit, memvid_shard_set_open,
+    memvid_shard_set_put, memvid_shard_set_search, memvid_shard_set_shard,
+    memvid_shard_set_timeline, MemvidShardSet, MEMVID_SHARD_ID_SHIFT,
+};
+pub use snapshot::{
+    memvid_apply_stream, memvid_snapshot_stream, MemvidSnapshotReadFn, MemvidSnapshotWriteFn,
+};
+pub use state::{
+    memvid_frame_count, memvid_stats, memvid_stats_ext, MemvidStats, MemvidStatsExt,
+    MEMVID_STATS_EXT_VERSION,
+};
+#[cfg(unix)]
+pub use stream::memvid_put_fd;
+pub use stream::{
+    memvid_put_abort, memvid_put_begin, memvid_put_end, memvid_put_path, memvid_put_write,
+    MemvidPutStream,
+};
+pub use timeline::{
+    memvid_timeline, memvid_timeline_bin, memvid_timeline_close, memvid_timeline_next,
+    memvid_timeline_open, MemvidTimelineCursor, MemvidTimelineEntry, MemvidTimelineQuery,
+    MemvidTimelineResult,
+};
+pub use util::MemvidStr;
+pub use vector::{memvid_put_bytes_with_embedding, memvid_search_vec};
+pub use verify::{
+    memvid_verify, memvid_verify_many, MemvidVerifyProgressFn, MEMVID_VERIFY_ERROR,
+    MEMVID_VERIFY_FAILED, MEMVID_VERIFY_PASSED, MEMVID_VERIFY_SKIPPED,
+};
+pub use warmup::{memvid_hot_set_configure, memvid_hot_set_export, memvid_warmup};
 
 use std::os::raw::c_char;
 
@@ -189,303 +279,2292 @@ mod tests {
     }
 
     #[test]
-    fn test_open() {
+    fn test_search_into() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_open.mv2");
+        let path = temp_dir.join("test_ffi_search_into.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
-
-        // Create and close a memory file
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
-        let content = b"Test content for open test.";
-        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+
+        let content = b"Binary search results avoid JSON marshalling.";
+        let options = CString::new(r#"{"uri": "test://binary", "title": "Binary"}"#).unwrap();
+        unsafe {
+            memvid_put_bytes_with_options(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                options.as_ptr(),
+                &mut error,
+            )
+        };
         unsafe { memvid_commit(handle, &mut error) };
-        unsafe { memvid_close(handle) };
 
-        // Reopen it
-        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
-        assert!(!handle.is_null());
+        let search_json = CString::new(r#"{"query": "marshalling", "top_k": 5}"#).unwrap();
+        let mut result = MemvidSearchResult::default();
+
+        // Sizing call with no buffers reports the required capacities
+        let ok = unsafe {
+            memvid_search_into(
+                handle,
+                search_json.as_ptr(),
+                std::ptr::null_mut(),
+                0,
+                std::ptr::null_mut(),
+                0,
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 0);
+        assert_eq!(error.code, MemvidErrorCode::BufferTooSmall);
+        assert_eq!(result.hit_count, 1);
+        assert!(result.arena_bytes > 0);
+        unsafe { memvid_error_free(&mut error) };
+
+        // Second call with adequately sized buffers
+        let mut hits = vec![MemvidSearchHit::default(); result.hit_count as usize];
+        let mut arena = vec![0u8; result.arena_bytes as usize];
+        let ok = unsafe {
+            memvid_search_into(
+                handle,
+                search_json.as_ptr(),
+                hits.as_mut_ptr(),
+                hits.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
         assert_eq!(error.code, MemvidErrorCode::Ok);
 
-        // Verify content persisted
-        let count = unsafe { memvid_frame_count(handle, &mut error) };
-        assert_eq!(count, 1);
+        let hit = &hits[0];
+        let slice = |offset: u64, len: u64| {
+            std::str::from_utf8(&arena[offset as usize..(offset + len) as usize]).unwrap()
+        };
+        assert_eq!(hit.rank, 1);
+        assert_eq!(slice(hit.uri_offset, hit.uri_len), "test://binary");
+        assert_eq!(hit.has_title, 1);
+        assert_eq!(slice(hit.title_offset, hit.title_len), "Binary");
+        assert!(slice(hit.text_offset, hit.text_len).contains("marshalling"));
 
         unsafe { memvid_close(handle) };
-
-        // Cleanup
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_put_bytes_with_options() {
+    fn test_search_limits() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_put_options.mv2");
+        let path = temp_dir.join("test_ffi_search_limits.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
+        for content in [
+            "apple apple pie",
+            "apple tart",
+            "apple apple cake",
+            "plain bread",
+        ] {
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
 
-        // Put with options
-        let content = b"Document with metadata.";
-        let options = CString::new(r#"{"title": "Test Doc", "uri": "test://doc1"}"#).unwrap();
-        let frame_id = unsafe {
-            memvid_put_bytes_with_options(
-                handle,
-                content.as_ptr(),
-                content.len(),
-                options.as_ptr(),
-                &mut error,
-            )
+        let search = |request: &str, error: &mut MemvidError| {
+            let request = CString::new(request).unwrap();
+            let ptr = unsafe { memvid_search(handle, request.as_ptr(), error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            serde_json::from_str::<serde_json::Value>(&json).unwrap()
         };
-        assert!(frame_id > 0);
-        assert_eq!(error.code, MemvidErrorCode::Ok);
 
-        unsafe { memvid_commit(handle, &mut error) };
-        unsafe { memvid_close(handle) };
+        let response = search(r#"{"query": "apple"}"#, &mut error);
+        assert_eq!(response["hits"].as_array().unwrap().len(), 3);
+        assert_eq!(response["partial"], false);
+
+        // Only the double matches clear the cutoff
+        let response = search(r#"{"query": "apple", "min_score": 1.5}"#, &mut error);
+        let hits = response["hits"].as_array().unwrap();
+        assert_eq!(hits.len(), 2);
+        assert!(hits.iter().all(|h| h["score"].as_f64().unwrap() >= 1.5));
+        assert_eq!(response["total_hits"], 2);
+        assert!(!response["context"].as_str().unwrap().contains("tart"));
+
+        let response = search(r#"{"query": "apple", "ids_only": true}"#, &mut error);
+        let hits = response["hits"].as_array().unwrap();
+        assert_eq!(hits.len(), 3);
+        assert!(hits
+            .iter()
+            .all(|h| h["text"] == "" && h["frame_id"].is_u64()));
+        assert_eq!(response["context"], "");
+
+        let response = search(r#"{"query": "apple", "max_candidates": 1}"#, &mut error);
+        assert_eq!(response["hits"].as_array().unwrap().len(), 1);
+        assert_eq!(response["total_hits"], 3);
+
+        // An exhausted budget keeps the engine's hits but skips the rebuilt
+        // context; the partial response is not cached
+        unsafe { memvid_cache_configure(handle, 16, 1 << 20, &mut error) };
+        let exhausted = r#"{"query": "apple", "min_score": 1.5, "time_budget_us": 0}"#;
+        let response = search(exhausted, &mut error);
+        assert_eq!(response["partial"], true);
+        assert_eq!(response["hits"].as_array().unwrap().len(), 2);
+        assert_eq!(response["context"], "");
+        search(exhausted, &mut error);
+        let mut stats = MemvidCacheStats::default();
+        unsafe { memvid_cache_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.hits, 0);
+
+        let response = search(
+            r#"{"query": "apple", "time_budget_us": 10000000}"#,
+            &mut error,
+        );
+        assert_eq!(response["partial"], false);
+        assert_eq!(response["hits"].as_array().unwrap().len(), 3);
+
+        // Nothing is skipped when the engine's response is already final
+        let response = search(r#"{"query": "apple", "time_budget_us": 0}"#, &mut error);
+        assert_eq!(response["partial"], false);
+        assert_eq!(response["hits"].as_array().unwrap().len(), 3);
 
-        // Cleanup
+        unsafe { memvid_close(handle) };
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_frame_count() {
+    fn test_search_filters() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_frame_count.mv2");
+        let path = temp_dir.join("test_ffi_search_filters.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
-
-        // Initially empty
-        let count = unsafe { memvid_frame_count(handle, &mut error) };
-        assert_eq!(count, 0);
-        assert_eq!(error.code, MemvidErrorCode::Ok);
-
-        // Add frames
-        let content1 = b"First document.";
-        let content2 = b"Second document.";
-        let content3 = b"Third document.";
-        unsafe { memvid_put_bytes(handle, content1.as_ptr(), content1.len(), &mut error) };
-        unsafe { memvid_put_bytes(handle, content2.as_ptr(), content2.len(), &mut error) };
-        unsafe { memvid_put_bytes(handle, content3.as_ptr(), content3.len(), &mut error) };
+        for (content, options) in [
+            (
+                "apple report",
+                r#"{"tags": {"team": "a"}, "labels": ["notes"], "kind": "text", "timestamp": 100}"#,
+            ),
+            (
+                "apple memo",
+                r#"{"tags": {"team": "b"}, "labels": ["email"], "kind": "text", "timestamp": 200}"#,
+            ),
+            (
+                "apple slides",
+                r#"{"tags": {"team": "a"}, "labels": ["deck"], "kind": "pdf", "timestamp": 300}"#,
+            ),
+            (
+                "apple notes",
+                r#"{"tags": {"team": "a"}, "labels": ["notes"], "kind": "text", "timestamp": 400}"#,
+            ),
+        ] {
+            let options = CString::new(options).unwrap();
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+        }
         unsafe { memvid_commit(handle, &mut error) };
 
-        // Should have 3 frames
-        let count = unsafe { memvid_frame_count(handle, &mut error) };
-        assert_eq!(count, 3);
+        let search = |filters: &str| {
+            let request = format!(r#"{{"query": "apple", "top_k": 1, "filters": {filters}}}"#);
+            let request = CString::new(request).unwrap();
+            let mut error = MemvidError::ok();
+            let ptr = unsafe { memvid_search(handle, request.as_ptr(), &mut error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            let response: serde_json::Value = serde_json::from_str(&json).unwrap();
+            let ids: Vec<u64> = response["hits"]
+                .as_array()
+                .unwrap()
+                .iter()
+                .map(|h| h["frame_id"].as_u64().unwrap())
+                .collect();
+            (ids, response)
+        };
 
+        // top_k is filled from matching frames even past the engine's first hit
+        let (ids, response) = search(r#"{"tags": ["team=b"]}"#);
+        assert_eq!(ids, vec![1]);
+        assert_eq!(response["hits"][0]["rank"], 1);
+        assert_eq!(response["next_cursor"], serde_json::Value::Null);
+
+        let (ids, _) = search(r#"{"tags": ["team=a"], "kind": "text", "since": 300}"#);
+        assert_eq!(ids, vec![3]);
+        let (ids, _) = search(r#"{"labels": ["deck", "email"], "until": 250}"#);
+        assert_eq!(ids, vec![1]);
+        let (ids, response) = search(r#"{"tags": ["team=c"]}"#);
+        assert!(ids.is_empty());
+        assert_eq!(response["total_hits"], 0);
+
+        // Empty filters behave like an unfiltered search
+        let (ids, _) = search("{}");
+        assert_eq!(ids, vec![0]);
+
+        // A selective filter is looked up through its frames' URIs, so
+        // max_candidates no longer hides the team b frame...
+        let run = |handle: *mut MemvidHandle, request: &str| {
+            let request: search::SearchRequestJson = serde_json::from_str(request).unwrap();
+            request.run(unsafe { &mut *handle }).unwrap().0
+        };
+        let response = run(
+            handle,
+            r#"{"query": "apple", "top_k": 1, "max_candidates": 1,
+                "filters": {"tags": ["team=b"]}}"#,
+        );
+        assert_eq!(response.hits.len(), 1);
+        assert_eq!(response.hits[0].frame_id, 1);
+        assert_eq!(response.total_hits, 1);
+        // ...but still caps the over-fetch when the request restricts URIs
+        let response = run(
+            handle,
+            r#"{"query": "apple", "top_k": 1, "max_candidates": 1,
+                "scope": "mv2://", "filters": {"tags": ["team=b"]}}"#,
+        );
+        assert!(response.hits.is_empty());
+
+        // The posting lists are saved on commit and loaded at open
+        let sidecar = temp_dir.join("test_ffi_search_filters.mv2.mindex");
+        assert!(sidecar.exists());
         unsafe { memvid_close(handle) };
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let response = run(
+            handle,
+            r#"{"query": "apple", "top_k": 2,
+                "filters": {"tags": ["team=a"], "kind": "text"}}"#,
+        );
+        let ids: Vec<u64> = response.hits.iter().map(|h| h.frame_id).collect();
+        assert_eq!(ids, vec![0, 3]);
 
-        // Cleanup
+        unsafe { memvid_close(handle) };
         let _ = std::fs::remove_file(&path);
+        let _ = std::fs::remove_file(&sidecar);
     }
 
     #[test]
-    fn test_error_free() {
-        let mut error = MemvidError::ok();
-
-        // error_free should handle null message gracefully
-        unsafe { memvid_error_free(&mut error) };
-        assert!(error.message.is_null());
-
-        // Trigger an actual error (null path)
-        let handle = unsafe { memvid_create(std::ptr::null(), &mut error) };
-        assert!(handle.is_null());
-        assert_eq!(error.code, MemvidErrorCode::NullPointer);
-        assert!(!error.message.is_null());
-
-        // Free the error message
-        unsafe { memvid_error_free(&mut error) };
-        assert!(error.message.is_null());
-    }
-
-    #[test]
-    fn test_frame_by_id() {
+    fn test_prepared_search() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_frame_by_id.mv2");
+        let path = temp_dir.join("test_ffi_prepared_search.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
-
-        // Put content with options
-        let content = b"Test document for frame_by_id.";
-        let options = CString::new(r#"{"title": "Test Title", "uri": "test://frame1"}"#).unwrap();
-        let _seq = unsafe {
-            memvid_put_bytes_with_options(
-                handle,
-                content.as_ptr(),
-                content.len(),
-                options.as_ptr(),
-                &mut error,
-            )
+        let put = |content: &str, options: &str| {
+            let options = CString::new(options).unwrap();
+            let mut error = MemvidError::ok();
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                );
+                memvid_commit(handle, &mut error);
+            }
+        };
+        put(
+            "alpha report",
+            r#"{"tags": {"team": "a"}, "timestamp": 100}"#,
+        );
+        put("alpha memo", r#"{"tags": {"team": "b"}, "timestamp": 200}"#);
+        put(
+            "beta report",
+            r#"{"tags": {"team": "a"}, "timestamp": 300}"#,
+        );
+
+        let template =
+            CString::new(r#"{"query": "report", "filters": {"tags": ["team=a"]}}"#).unwrap();
+        let prepared = unsafe { memvid_prepare_search(handle, template.as_ptr(), &mut error) };
+        assert!(!prepared.is_null());
+
+        let execute = |params: Option<&MemvidPreparedParams>| {
+            let params = params.map_or(std::ptr::null(), |p| p as *const _);
+            let mut error = MemvidError::ok();
+            let ptr = unsafe { memvid_execute_prepared(handle, prepared, params, &mut error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            let response: serde_json::Value = serde_json::from_str(&json).unwrap();
+            let mut ids: Vec<u64> = response["hits"]
+                .as_array()
+                .unwrap()
+                .iter()
+                .map(|h| h["frame_id"].as_u64().unwrap())
+                .collect();
+            ids.sort_unstable();
+            ids
         };
-        unsafe { memvid_commit(handle, &mut error) };
-        unsafe { memvid_close(handle) };
 
-        // Reopen and get frame by ID (frame IDs are 0-indexed)
-        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
-        assert!(!handle.is_null());
+        assert_eq!(execute(None), vec![0, 2]);
 
-        // First frame has id=0
-        let frame_json = unsafe { memvid_frame_by_id(handle, 0, &mut error) };
-        if frame_json.is_null() {
-            let msg = if !error.message.is_null() {
-                unsafe { std::ffi::CStr::from_ptr(error.message) }
-                    .to_str()
-                    .unwrap_or("unknown")
-            } else {
-                "no message"
-            };
-            panic!("frame_by_id failed: {:?} - {}", error.code, msg);
-        }
-        assert_eq!(error.code, MemvidErrorCode::Ok);
+        // Frames appended after preparing are matched incrementally
+        put(
+            "gamma report",
+            r#"{"tags": {"team": "a"}, "timestamp": 400}"#,
+        );
+        assert_eq!(execute(None), vec![0, 2, 3]);
 
-        let frame_str = unsafe { std::ffi::CStr::from_ptr(frame_json) };
-        let json = frame_str.to_str().unwrap();
-        assert!(json.contains("\"id\""));
-        assert!(json.contains("\"title\":\"Test Title\""));
-        assert!(json.contains("\"uri\":\"test://frame1\""));
+        let mut params = MemvidPreparedParams {
+            since: 250,
+            has_since: 1,
+            ..Default::default()
+        };
+        assert_eq!(execute(Some(&params)), vec![2, 3]);
+        params.query = MemvidStr {
+            ptr: b"gamma".as_ptr().cast(),
+            len: 5,
+        };
+        assert_eq!(execute(Some(&params)), vec![3]);
+        params.query = MemvidStr {
+            ptr: b"memo".as_ptr().cast(),
+            len: 4,
+        };
+        params.has_since = 0;
+        assert!(execute(Some(&params)).is_empty());
 
-        unsafe { memvid_string_free(frame_json) };
+        unsafe { memvid_prepared_free(prepared) };
         unsafe { memvid_close(handle) };
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_frame_by_uri() {
+    fn test_stats_ext() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_frame_by_uri.mv2");
+        let path = temp_dir.join("test_ffi_stats_ext.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
-
-        // Put content with URI
-        let content = b"Document with unique URI.";
-        let options = CString::new(r#"{"uri": "test://unique-doc"}"#).unwrap();
-        unsafe {
-            memvid_put_bytes_with_options(
-                handle,
-                content.as_ptr(),
-                content.len(),
-                options.as_ptr(),
-                &mut error,
-            )
+        let read = || {
+            let mut error = MemvidError::ok();
+            let mut stats = MemvidStatsExt {
+                struct_size: std::mem::size_of::<MemvidStatsExt>() as u32,
+                ..Default::default()
+            };
+            assert_eq!(
+                unsafe { memvid_stats_ext(handle, &mut stats, &mut error) },
+                1
+            );
+            stats
         };
+
+        for content in ["one", "two"] {
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
         unsafe { memvid_commit(handle, &mut error) };
+        let content = "three";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
 
-        // Get frame by URI
-        let uri = CString::new("test://unique-doc").unwrap();
-        let frame_json = unsafe { memvid_frame_by_uri(handle, uri.as_ptr(), &mut error) };
-        assert!(!frame_json.is_null());
-        assert_eq!(error.code, MemvidErrorCode::Ok);
+        let stats = read();
+        assert_eq!(stats.version, MEMVID_STATS_EXT_VERSION);
+        assert_eq!(stats.base.frame_count, 3);
+        assert_eq!(stats.pending_frames, 1);
+        assert_eq!(stats.commit_count, 1);
+        assert_eq!(stats.tombstone_ratio, 0.0);
 
-        let frame_str = unsafe { std::ffi::CStr::from_ptr(frame_json) };
-        let json = frame_str.to_str().unwrap();
-        assert!(json.contains("\"uri\":\"test://unique-doc\""));
+        unsafe { memvid_delete_frame(handle, 0, &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        let stats = read();
+        assert_eq!(stats.pending_frames, 0);
+        assert_eq!(stats.commit_count, 2);
+        assert_eq!(stats.base.active_frame_count, 2);
+        assert!((stats.tombstone_ratio - 1.0 / 3.0).abs() < 1e-9);
+
+        // Callers built against the base layout only get the base fields
+        let base_size = std::mem::offset_of!(MemvidStatsExt, tombstone_ratio);
+        let mut short = MemvidStatsExt {
+            struct_size: base_size as u32,
+            pending_frames: 42,
+            ..Default::default()
+        };
+        assert_eq!(
+            unsafe { memvid_stats_ext(handle, &mut short, &mut error) },
+            1
+        );
+        assert_eq!(short.struct_size as usize, base_size);
+        assert_eq!(short.base.frame_count, 3);
+        assert_eq!(short.pending_frames, 42);
+
+        short.struct_size = 4;
+        assert_eq!(
+            unsafe { memvid_stats_ext(handle, &mut short, &mut error) },
+            0
+        );
+        assert_eq!(error.code, MemvidErrorCode::BufferTooSmall);
 
-        unsafe { memvid_string_free(frame_json) };
+        unsafe { memvid_error_free(&mut error) };
         unsafe { memvid_close(handle) };
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_frame_content() {
+    fn test_dedup_filter() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_frame_content.mv2");
+        let path = temp_dir.join("test_ffi_dedup_filter.mv2");
+        let sidecar = temp_dir.join("test_ffi_dedup_filter.mv2.dedup");
+        let _ = std::fs::remove_file(&sidecar);
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+        let stats = |handle| {
+            let mut error = MemvidError::ok();
+            let mut stats = MemvidStatsExt {
+                struct_size: std::mem::size_of::<MemvidStatsExt>() as u32,
+                ..Default::default()
+            };
+            assert_eq!(
+                unsafe { memvid_stats_ext(handle, &mut stats, &mut error) },
+                1
+            );
+            stats
+        };
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
 
-        // Put content
-        let content = b"This is the full content of the frame.";
-        let _seq =
-            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        let contents = ["first page", "second page", "third page", "first page"];
+        let items: Vec<MemvidPutItem> = contents
+            .iter()
+            .map(|c| MemvidPutItem {
+                data: c.as_ptr(),
+                len: c.len(),
+                options_json: std::ptr::null(),
+            })
+            .collect();
+        let shared = CString::new(r#"{"dedup": true}"#).unwrap();
+        let mut frame_ids = [0u64; 4];
+        let stored = unsafe {
+            memvid_put_many(
+                handle,
+                items.as_ptr(),
+                items.len(),
+                shared.as_ptr(),
+                frame_ids.as_mut_ptr(),
+                std::ptr::null_mut(),
+                &mut error,
+            )
+        };
+        assert_eq!(stored, 4);
+        assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 3);
+
+        let s = stats(handle);
+        assert_eq!(s.dedup_filter_active, 1);
+        assert_eq!(s.dedup_checks, 4);
+        assert_eq!(s.dedup_filtered, 3);
+        assert_eq!(s.dedup_duplicates, 1);
+        assert!((s.dedup_filter_hit_rate - 0.75).abs() < 1e-9);
+
         unsafe { memvid_commit(handle, &mut error) };
         unsafe { memvid_close(handle) };
+        assert!(sidecar.exists());
 
-        // Reopen and get content (frame IDs are 0-indexed)
+        // The saved filter still covers the file after reopening
         let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
+        assert_eq!(stats(handle).dedup_filter_active, 1);
+        let options = CString::new(r#"{"dedup": true}"#).unwrap();
+        for content in ["second page", "fourth page"] {
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+        }
+        assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 4);
+        let s = stats(handle);
+        assert_eq!(s.dedup_checks, 2);
+        assert_eq!(s.dedup_duplicates, 1);
+        unsafe { memvid_close(handle) };
 
-        // First frame has id=0
-        let content_ptr = unsafe { memvid_frame_content(handle, 0, &mut error) };
-        assert!(!content_ptr.is_null());
-        assert_eq!(error.code, MemvidErrorCode::Ok);
-
-        let content_str = unsafe { std::ffi::CStr::from_ptr(content_ptr) };
-        // Content includes auto-extracted metadata, so just check it starts with our text
-        assert!(content_str
-            .to_str()
-            .unwrap()
-            .starts_with("This is the full content of the frame."));
-
-        unsafe { memvid_string_free(content_ptr) };
+        // A sidecar that no longer matches the file is ignored
+        std::fs::write(&sidecar, b"MVDEDUP1").unwrap();
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert_eq!(stats(handle).dedup_filter_active, 0);
         unsafe { memvid_close(handle) };
+
+        let _ = std::fs::remove_file(&sidecar);
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_delete_frame() {
+    fn test_time_index() {
         let temp_dir = std::env::temp_dir();
-        let path = temp_dir.join("test_ffi_delete_frame.mv2");
+        let path = temp_dir.join("test_ffi_time_index.mv2");
+        let sidecar = temp_dir.join("test_ffi_time_index.mv2.tindex");
+        let _ = std::fs::remove_file(&sidecar);
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
 
         let mut error = MemvidError::ok();
         let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
+        let put = |timestamp: i64| {
+            let options = CString::new(format!(r#"{{"timestamp": {timestamp}}}"#)).unwrap();
+            let mut error = MemvidError::ok();
+            let content = format!("entry at {timestamp}");
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+        };
+        // Enough frames to span two partitions
+        for i in 0..5000 {
+            put(1000 + i);
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let timeline = |query: &str| {
+            let query = CString::new(query).unwrap();
+            let mut error = MemvidError::ok();
+            let ptr = unsafe { memvid_timeline(handle, query.as_ptr(), &mut error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            let response: serde_json::Value = serde_json::from_str(&json).unwrap();
+            response["entries"]
+                .as_array()
+                .unwrap()
+                .iter()
+                .map(|e| e["frame_id"].as_u64().unwrap())
+                .collect::<Vec<_>>()
+        };
+
+        assert_eq!(
+            timeline(r#"{"since": 5500, "until": 5510}"#),
+            (4500..=4510).collect::<Vec<_>>()
+        );
+        assert_eq!(
+            timeline(r#"{"since": 1100, "limit": 5}"#),
+            vec![100, 101, 102, 103, 104]
+        );
+        assert_eq!(
+            timeline(r#"{"reverse": true, "limit": 3}"#),
+            vec![4999, 4998, 4997]
+        );
+        assert!(timeline(r#"{"until": 10}"#).is_empty());
+
+        // Deleted and uncommitted frames must not shift the narrowed bound
+        unsafe { memvid_delete_frame(handle, 101, &mut error) };
+        put(1102);
+        assert_eq!(
+            timeline(r#"{"since": 1100, "limit": 5}"#),
+            vec![100, 102, 5000, 103, 104]
+        );
+
+        let query = CString::new(r#"{"since": 5995}"#).unwrap();
+        let cursor = unsafe { memvid_timeline_open(query.as_ptr(), &mut error) };
+        assert!(!cursor.is_null());
+        let ptr = unsafe { memvid_timeline_next(handle, cursor, 10, &mut error) };
+        let json = unsafe { std::ffi::CStr::from_ptr(ptr) }.to_str().unwrap();
+        let batch: serde_json::Value = serde_json::from_str(json).unwrap();
+        assert_eq!(batch["count"], 5);
+        assert_eq!(batch["done"], true);
+        unsafe { memvid_string_free(ptr) };
+        unsafe { memvid_timeline_close(cursor) };
 
-        // Put content
-        let content = b"Document to be deleted.";
-        let _seq =
-            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
         unsafe { memvid_commit(handle, &mut error) };
         unsafe { memvid_close(handle) };
+        assert!(sidecar.exists());
 
-        // Reopen
+        // Reopening picks up the saved partition bounds
         let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
         assert!(!handle.is_null());
+        assert_eq!(
+            unsafe { &mut *handle }.narrow_timeline((None, Some(10)), false, None),
+            None
+        );
+        assert_eq!(
+            unsafe { &mut *handle }.narrow_timeline((Some(1100), None), false, Some(5)),
+            Some((Some(1100), Some(1104)))
+        );
+        unsafe { memvid_close(handle) };
 
-        // Verify we have 1 frame
-        let mut stats = MemvidStats::default();
-        unsafe { memvid_stats(handle, &mut stats, &mut error) };
-        assert_eq!(stats.active_frame_count, 1);
-
-        // Delete frame (frame IDs are 0-indexed, first frame has id=0)
-        let seq = unsafe { memvid_delete_frame(handle, 0, &mut error) };
-        if seq == 0 && error.code != MemvidErrorCode::Ok {
-            let msg = if !error.message.is_null() {
-                unsafe { std::ffi::CStr::from_ptr(error.message) }
-                    .to_str()
-                    .unwrap_or("unknown")
-            } else {
-                "no message"
-            };
-            panic!("delete_frame failed: {:?} - {}", error.code, msg);
-        }
-        assert!(seq > 0);
+        // Without a sidecar the index is built again and saved on commit
+        std::fs::remove_file(&sidecar).unwrap();
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert_eq!(
+            unsafe { &mut *handle }.narrow_timeline((Some(1100), None), false, Some(5)),
+            Some((Some(1100), Some(1104)))
+        );
         unsafe { memvid_commit(handle, &mut error) };
-
-        // Verify active count is now 0
-        unsafe { memvid_stats(handle, &mut stats, &mut error) };
-        assert_eq!(stats.active_frame_count, 0);
-
+        assert!(sidecar.exists());
         unsafe { memvid_close(handle) };
+
+        let _ = std::fs::remove_file(&sidecar);
         let _ = std::fs::remove_file(&path);
     }
 
     #[test]
-    fn test_timeline() {
+    fn test_binary_requests() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_binary_requests.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        let view = |s: &str| MemvidStr {
+            ptr: s.as_ptr().cast(),
+            len: s.len(),
+        };
+        let labels = [view("binary")];
+        let tags = [MemvidTag {
+            key: view("codec"),
+            value: view("struct"),
+        }];
+        let options = MemvidPutOptions {
+            uri: view("test://bin"),
+            title: view("Binary options"),
+            track: MemvidStr::default(),
+            kind: MemvidStr::default(),
+            search_text: MemvidStr::default(),
+            tags: tags.as_ptr(),
+            tag_count: tags.len(),
+            labels: labels.as_ptr(),
+            label_count: labels.len(),
+            timestamp: 1_700_000_000,
+            has_timestamp: 1,
+            auto_tag: MEMVID_FLAG_OFF,
+            extract_dates: MEMVID_FLAG_DEFAULT,
+            extract_triplets: MEMVID_FLAG_DEFAULT,
+            no_raw: MEMVID_FLAG_DEFAULT,
+            dedup: MEMVID_FLAG_ON,
+            _padding: [0; 2],
+        };
+        let content = b"Structs cross the boundary without an encoder.";
+        unsafe {
+            memvid_put_bytes_bin(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                &options,
+                &mut error,
+            )
+        };
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let query = MemvidSearchQuery {
+            query: view("encoder"),
+            ..Default::default()
+        };
+        let mut hits = vec![MemvidSearchHit::default(); 4];
+        let mut arena = vec![0u8; 4096];
+        let mut result = MemvidSearchResult::default();
+        let ok = unsafe {
+            memvid_search_bin(
+                handle,
+                &query,
+                hits.as_mut_ptr(),
+                hits.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!(result.hit_count, 1);
+        let slice = |arena: &[u8], offset: u64, len: u64| {
+            std::str::from_utf8(&arena[offset as usize..(offset + len) as usize])
+                .unwrap()
+                .to_string()
+        };
+        assert_eq!(
+            slice(&arena, hits[0].uri_offset, hits[0].uri_len),
+            "test://bin"
+        );
+        assert_eq!(
+            slice(&arena, hits[0].title_offset, hits[0].title_len),
+            "Binary options"
+        );
+        assert_eq!(result.partial, 0);
+
+        // Result limits apply to binary results too; ids need no arena
+        let ids_only = MemvidSearchQuery {
+            query: view("encoder"),
+            ids_only: 1,
+            ..Default::default()
+        };
+        let ok = unsafe {
+            memvid_search_bin(
+                handle,
+                &ids_only,
+                hits.as_mut_ptr(),
+                hits.len(),
+                std::ptr::null_mut(),
+                0,
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!(result.hit_count, 1);
+        assert_eq!(
+            (hits[0].uri_len, hits[0].has_title, hits[0].text_len),
+            (0, 0, 0)
+        );
+
+        // The engine's hits survive an exhausted budget
+        let exhausted = MemvidSearchQuery {
+            query: view("encoder"),
+            has_time_budget: 1,
+            ..Default::default()
+        };
+        let ok = unsafe {
+            memvid_search_bin(
+                handle,
+                &exhausted,
+                hits.as_mut_ptr(),
+                hits.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!((result.hit_count, result.partial), (1, 0));
+
+        // An absent query string is rejected
+        let empty = MemvidSearchQuery::default();
+        let ok = unsafe {
+            memvid_search_bin(
+                handle,
+                &empty,
+                hits.as_mut_ptr(),
+                hits.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut result,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 0);
+        assert_eq!(error.code, MemvidErrorCode::NullPointer);
+        unsafe { memvid_error_free(&mut error) };
+
+        let timeline_query = MemvidTimelineQuery {
+            limit: 10,
+            ..Default::default()
+        };
+        let mut entries = vec![MemvidTimelineEntry::default(); 4];
+        let mut timeline = MemvidTimelineResult::default();
+        let ok = unsafe {
+            memvid_timeline_bin(
+                handle,
+                &timeline_query,
+                entries.as_mut_ptr(),
+                entries.len(),
+                arena.as_mut_ptr(),
+                arena.len(),
+                &mut timeline,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!(timeline.entry_count, 1);
+        let entry = &entries[0];
+        assert_eq!(entry.timestamp, 1_700_000_000);
+        assert_eq!(entry.has_uri, 1);
+        assert_eq!(slice(&arena, entry.uri_offset, entry.uri_len), "test://bin");
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_reader_pool() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_reader_pool.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let content = b"Shared readers search concurrently.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        let pool = unsafe { memvid_reader_pool_open(path_cstr.as_ptr(), 4, &mut error) };
+        assert!(!pool.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Search from several threads at once, one view per thread
+        let pool_addr = pool as usize;
+        let threads: Vec<_> = (0..8)
+            .map(|_| {
+                std::thread::spawn(move || {
+                    let pool = pool_addr as *mut MemvidReaderPool;
+                    let mut error = MemvidError::ok();
+                    let view = unsafe { memvid_reader_pool_acquire(pool, &mut error) };
+                    assert!(!view.is_null());
+
+                    let search_json = CString::new(r#"{"query": "concurrently"}"#).unwrap();
+                    let result_ptr =
+                        unsafe { memvid_search(view, search_json.as_ptr(), &mut error) };
+                    assert!(!result_ptr.is_null());
+                    unsafe { memvid_string_free(result_ptr) };
+
+                    let released = unsafe { memvid_reader_pool_release(pool, view, &mut error) };
+                    assert_eq!(released, 1);
+                })
+            })
+            .collect();
+        for t in threads {
+            t.join().unwrap();
+        }
+
+        // New commits become visible after a refresh
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        let content = b"A second committed document.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        assert_eq!(unsafe { memvid_reader_pool_refresh(pool, &mut error) }, 1);
+        let view = unsafe { memvid_reader_pool_acquire(pool, &mut error) };
+        assert_eq!(unsafe { memvid_frame_count(view, &mut error) }, 2);
+
+        // Releasing a view twice is rejected
+        let released = unsafe { memvid_reader_pool_release(pool, view, &mut error) };
+        assert_eq!(released, 1);
+        let released = unsafe { memvid_reader_pool_release(pool, view, &mut error) };
+        assert_eq!(released, 0);
+        assert_eq!(error.code, MemvidErrorCode::InvalidHandle);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_reader_pool_close(pool) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_search_batch() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_search_batch.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let contents: [&[u8]; 2] = [b"Alpha expands the query.", b"Beta reranks candidates."];
+        for content in contents {
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let batch_json = CString::new(
+            r#"[{"query": "alpha"}, {"query": "beta"}, {"query": "alpha"}, {"query": "gamma"}]"#,
+        )
+        .unwrap();
+
+        let result_ptr = unsafe { memvid_search_batch(handle, batch_json.as_ptr(), &mut error) };
+        assert!(!result_ptr.is_null());
+        let sequential = unsafe { std::ffi::CStr::from_ptr(result_ptr) }
+            .to_str()
+            .unwrap()
+            .to_owned();
+        unsafe { memvid_string_free(result_ptr) };
+        unsafe { memvid_close(handle) };
+
+        let parsed: serde_json::Value = serde_json::from_str(&sequential).unwrap();
+        let queries: Vec<_> = parsed
+            .as_array()
+            .unwrap()
+            .iter()
+            .map(|r| r["query"].as_str().unwrap())
+            .collect();
+        assert_eq!(queries, ["alpha", "beta", "alpha", "gamma"]);
+        assert_eq!(parsed[3]["hits"].as_array().unwrap().len(), 0);
+
+        // The pooled batch returns the same responses in the same order
+        let pool = unsafe { memvid_reader_pool_open(path_cstr.as_ptr(), 3, &mut error) };
+        assert!(!pool.is_null());
+        let result_ptr =
+            unsafe { memvid_reader_pool_search_batch(pool, batch_json.as_ptr(), &mut error) };
+        assert!(!result_ptr.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        let pooled_str = unsafe { std::ffi::CStr::from_ptr(result_ptr) }
+            .to_str()
+            .unwrap();
+        let pooled: serde_json::Value = serde_json::from_str(pooled_str).unwrap();
+        unsafe { memvid_string_free(result_ptr) };
+        let (pooled, parsed) = (pooled.as_array().unwrap(), parsed.as_array().unwrap());
+        for (a, b) in pooled.iter().zip(parsed) {
+            assert_eq!(a["query"], b["query"]);
+            assert_eq!(a["hits"], b["hits"]);
+        }
+
+        // Every view was returned to the pool
+        let views: Vec<_> = (0..3)
+            .map(|_| unsafe { memvid_reader_pool_acquire(pool, &mut error) })
+            .collect();
+        for view in views {
+            let released = unsafe { memvid_reader_pool_release(pool, view, &mut error) };
+            assert_eq!(released, 1);
+        }
+
+        unsafe { memvid_reader_pool_close(pool) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_query_cache() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_query_cache.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let content = b"Skewed traffic repeats the same query.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let ok = unsafe { memvid_cache_configure(handle, 2, 0, &mut error) };
+        assert_eq!(ok, 1);
+
+        // Equivalent requests normalize to the same key
+        let first = CString::new(r#"{"query": "traffic"}"#).unwrap();
+        let repeat = CString::new(r#"{ "top_k": 10, "query": "traffic" }"#).unwrap();
+        let mut responses = Vec::new();
+        for request in [&first, &repeat] {
+            let result_ptr = unsafe { memvid_search(handle, request.as_ptr(), &mut error) };
+            assert!(!result_ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(result_ptr) }.to_owned();
+            unsafe { memvid_string_free(result_ptr) };
+            responses.push(json);
+        }
+        assert_eq!(responses[0], responses[1]);
+
+        let mut stats = MemvidCacheStats::default();
+        let ok = unsafe { memvid_cache_stats(handle, &mut stats, &mut error) };
+        assert_eq!(ok, 1);
+        assert_eq!((stats.hits, stats.misses, stats.entries), (1, 1, 1));
+
+        // Search and ask entries are distinct; a third entry evicts the oldest
+        let ask_json = CString::new(r#"{"question": "traffic"}"#).unwrap();
+        let other = CString::new(r#"{"query": "repeats"}"#).unwrap();
+        let result_ptr = unsafe { memvid_ask(handle, ask_json.as_ptr(), &mut error) };
+        assert!(!result_ptr.is_null());
+        unsafe { memvid_string_free(result_ptr) };
+        let result_ptr = unsafe { memvid_search(handle, other.as_ptr(), &mut error) };
+        unsafe { memvid_string_free(result_ptr) };
+        unsafe { memvid_cache_stats(handle, &mut stats, &mut error) };
+        assert_eq!((stats.misses, stats.entries, stats.evictions), (3, 2, 1));
+
+        // A commit flushes the cache
+        let generation = stats.generation;
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_cache_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.entries, 0);
+        assert_eq!(stats.bytes, 0);
+        assert_eq!(stats.generation, generation + 1);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_open() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_open.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+
+        // Create and close a memory file
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let content = b"Test content for open test.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        // Reopen it
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Verify content persisted
+        let count = unsafe { memvid_frame_count(handle, &mut error) };
+        assert_eq!(count, 1);
+
+        unsafe { memvid_close(handle) };
+
+        // Cleanup
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_put_bytes_with_options() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_put_options.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Put with options
+        let content = b"Document with metadata.";
+        let options = CString::new(r#"{"title": "Test Doc", "uri": "test://doc1"}"#).unwrap();
+        let frame_id = unsafe {
+            memvid_put_bytes_with_options(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                options.as_ptr(),
+                &mut error,
+            )
+        };
+        assert!(frame_id > 0);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        // Cleanup
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_put_many() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_put_many.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Two items inherit the shared options, one overrides the URI,
+        // and one is invalid (NULL data with non-zero length)
+        let content1 = b"First batched document.";
+        let content2 = b"Second batched document.";
+        let content3 = b"Third batched document.";
+        let override_opts = CString::new(r#"{"uri": "test://batch/override"}"#).unwrap();
+        let items = [
+            MemvidPutItem {
+                data: content1.as_ptr(),
+                len: content1.len(),
+                options_json: std::ptr::null(),
+            },
+            MemvidPutItem {
+                data: content2.as_ptr(),
+                len: content2.len(),
+                options_json: override_opts.as_ptr(),
+            },
+            MemvidPutItem {
+                data: std::ptr::null(),
+                len: 8,
+                options_json: std::ptr::null(),
+            },
+            MemvidPutItem {
+                data: content3.as_ptr(),
+                len: content3.len(),
+                options_json: std::ptr::null(),
+            },
+        ];
+        let shared = CString::new(r#"{"title": "Batch"}"#).unwrap();
+        let mut frame_ids = [0u64; 4];
+        let mut codes = [MemvidErrorCode::Unknown; 4];
+
+        let stored = unsafe {
+            memvid_put_many(
+                handle,
+                items.as_ptr(),
+                items.len(),
+                shared.as_ptr(),
+                frame_ids.as_mut_ptr(),
+                codes.as_mut_ptr(),
+                &mut error,
+            )
+        };
+        assert_eq!(stored, 3);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_eq!(codes[0], MemvidErrorCode::Ok);
+        assert_eq!(codes[1], MemvidErrorCode::Ok);
+        assert_eq!(codes[2], MemvidErrorCode::NullPointer);
+        assert_eq!(codes[3], MemvidErrorCode::Ok);
+        assert!(frame_ids[0] > 0);
+        assert_eq!(frame_ids[2], 0);
+
+        unsafe { memvid_commit(handle, &mut error) };
+        let count = unsafe { memvid_frame_count(handle, &mut error) };
+        assert_eq!(count, 3);
+
+        // The override applies on top of the shared title
+        let uri = CString::new("test://batch/override").unwrap();
+        let frame_json = unsafe { memvid_frame_by_uri(handle, uri.as_ptr(), &mut error) };
+        assert!(!frame_json.is_null());
+        let json = unsafe { std::ffi::CStr::from_ptr(frame_json) }.to_str().unwrap();
+        assert!(json.contains("\"title\":\"Batch\""));
+        unsafe { memvid_string_free(frame_json) };
+
+        // Malformed shared options fail the whole batch
+        let bad = CString::new("{not json").unwrap();
+        let stored = unsafe {
+            memvid_put_many(
+                handle,
+                items.as_ptr(),
+                items.len(),
+                bad.as_ptr(),
+                frame_ids.as_mut_ptr(),
+                codes.as_mut_ptr(),
+                &mut error,
+            )
+        };
+        assert_eq!(stored, 0);
+        assert_eq!(error.code, MemvidErrorCode::JsonParse);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_commit_async() {
+        unsafe extern "C" fn on_durable(ctx: *mut std::os::raw::c_void, durable_seq: u64) {
+            unsafe { *(ctx as *mut u64) = durable_seq };
+        }
+
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_commit_async.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        let mut notified = 0u64;
+        let ctx = &mut notified as *mut u64 as *mut std::os::raw::c_void;
+        unsafe { memvid_set_durability_callback(handle, Some(on_durable), ctx, &mut error) };
+
+        // Long window: requests are coalesced until flushed
+        assert_eq!(unsafe { memvid_set_commit_policy(handle, 60_000, 0, &mut error) }, 1);
+        let content = b"Coalesced commit document.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        assert_eq!(unsafe { memvid_commit_async(handle, &mut error) }, 1);
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        assert_eq!(unsafe { memvid_commit_async(handle, &mut error) }, 2);
+        assert_eq!(unsafe { memvid_commit_poll(handle, &mut error) }, 0);
+        assert_eq!(notified, 0);
+
+        assert_eq!(unsafe { memvid_commit_flush(handle, &mut error) }, 2);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_eq!(notified, 2);
+
+        // Byte threshold forces the commit on the request itself
+        unsafe { memvid_set_commit_policy(handle, 60_000, 16, &mut error) };
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        assert_eq!(unsafe { memvid_commit_async(handle, &mut error) }, 3);
+        assert_eq!(unsafe { memvid_commit_poll(handle, &mut error) }, 3);
+        assert_eq!(notified, 3);
+
+        unsafe { memvid_close(handle) };
+
+        // Flushed data is on disk
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 3);
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_frame_count() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frame_count.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Initially empty
+        let count = unsafe { memvid_frame_count(handle, &mut error) };
+        assert_eq!(count, 0);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Add frames
+        let content1 = b"First document.";
+        let content2 = b"Second document.";
+        let content3 = b"Third document.";
+        unsafe { memvid_put_bytes(handle, content1.as_ptr(), content1.len(), &mut error) };
+        unsafe { memvid_put_bytes(handle, content2.as_ptr(), content2.len(), &mut error) };
+        unsafe { memvid_put_bytes(handle, content3.as_ptr(), content3.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // Should have 3 frames
+        let count = unsafe { memvid_frame_count(handle, &mut error) };
+        assert_eq!(count, 3);
+
+        unsafe { memvid_close(handle) };
+
+        // Cleanup
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_error_free() {
+        let mut error = MemvidError::ok();
+
+        // error_free should handle null message gracefully
+        unsafe { memvid_error_free(&mut error) };
+        assert!(error.message.is_null());
+
+        // Trigger an actual error (null path)
+        let handle = unsafe { memvid_create(std::ptr::null(), &mut error) };
+        assert!(handle.is_null());
+        assert_eq!(error.code, MemvidErrorCode::NullPointer);
+        assert!(!error.message.is_null());
+
+        // Free the error message
+        unsafe { memvid_error_free(&mut error) };
+        assert!(error.message.is_null());
+    }
+
+    #[test]
+    fn test_frame_by_id() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frame_by_id.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Put content with options
+        let content = b"Test document for frame_by_id.";
+        let options = CString::new(r#"{"title": "Test Title", "uri": "test://frame1"}"#).unwrap();
+        let _seq = unsafe {
+            memvid_put_bytes_with_options(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                options.as_ptr(),
+                &mut error,
+            )
+        };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        // Reopen and get frame by ID (frame IDs are 0-indexed)
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // First frame has id=0
+        let frame_json = unsafe { memvid_frame_by_id(handle, 0, &mut error) };
+        if frame_json.is_null() {
+            let msg = if !error.message.is_null() {
+                unsafe { std::ffi::CStr::from_ptr(error.message) }
+                    .to_str()
+                    .unwrap_or("unknown")
+            } else {
+                "no message"
+            };
+            panic!("frame_by_id failed: {:?} - {}", error.code, msg);
+        }
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        let frame_str = unsafe { std::ffi::CStr::from_ptr(frame_json) };
+        let json = frame_str.to_str().unwrap();
+        assert!(json.contains("\"id\""));
+        assert!(json.contains("\"title\":\"Test Title\""));
+        assert!(json.contains("\"uri\":\"test://frame1\""));
+
+        unsafe { memvid_string_free(frame_json) };
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_frame_by_uri() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frame_by_uri.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Put content with URI
+        let content = b"Document with unique URI.";
+        let options = CString::new(r#"{"uri": "test://unique-doc"}"#).unwrap();
+        unsafe {
+            memvid_put_bytes_with_options(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                options.as_ptr(),
+                &mut error,
+            )
+        };
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // Get frame by URI
+        let uri = CString::new("test://unique-doc").unwrap();
+        let frame_json = unsafe { memvid_frame_by_uri(handle, uri.as_ptr(), &mut error) };
+        assert!(!frame_json.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        let frame_str = unsafe { std::ffi::CStr::from_ptr(frame_json) };
+        let json = frame_str.to_str().unwrap();
+        assert!(json.contains("\"uri\":\"test://unique-doc\""));
+
+        unsafe { memvid_string_free(frame_json) };
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_frames_by_ids_and_uris() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frames_bulk.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        for i in 0..3 {
+            let content = format!("Bulk document {i}.");
+            let options = CString::new(format!(r#"{{"uri": "test://bulk/{i}"}}"#)).unwrap();
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // Unsorted, repeated and missing IDs come back in input order
+        let ids = [2u64, 0, 999, 2];
+        let result_ptr =
+            unsafe { memvid_frames_by_ids(handle, ids.as_ptr(), ids.len(), &mut error) };
+        assert!(!result_ptr.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        let json = unsafe { std::ffi::CStr::from_ptr(result_ptr) }.to_str().unwrap();
+        let frames: Vec<serde_json::Value> = serde_json::from_str(json).unwrap();
+        assert_eq!(frames.len(), 4);
+        assert_eq!(frames[0]["id"], 2);
+        assert_eq!(frames[1]["id"], 0);
+        assert!(frames[2].is_null());
+        assert_eq!(frames[3]["id"], 2);
+        unsafe { memvid_string_free(result_ptr) };
+
+        let uri1 = CString::new("test://bulk/1").unwrap();
+        let missing = CString::new("test://bulk/missing").unwrap();
+        let uris = [uri1.as_ptr(), missing.as_ptr(), std::ptr::null()];
+        let result_ptr =
+            unsafe { memvid_frames_by_uris(handle, uris.as_ptr(), uris.len(), &mut error) };
+        assert!(!result_ptr.is_null());
+
+        let json = unsafe { std::ffi::CStr::from_ptr(result_ptr) }.to_str().unwrap();
+        let frames: Vec<serde_json::Value> = serde_json::from_str(json).unwrap();
+        assert_eq!(frames.len(), 3);
+        assert_eq!(frames[0]["uri"], "test://bulk/1");
+        assert!(frames[1].is_null());
+        assert!(frames[2].is_null());
+        unsafe { memvid_string_free(result_ptr) };
+
+        // Errors other than a missing frame fail the whole call
+        let invalid = [0xffu8, 0];
+        let uris = [uri1.as_ptr(), invalid.as_ptr().cast()];
+        let result_ptr =
+            unsafe { memvid_frames_by_uris(handle, uris.as_ptr(), uris.len(), &mut error) };
+        assert!(result_ptr.is_null());
+        assert_eq!(error.code, MemvidErrorCode::InvalidUtf8);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_frame_content() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frame_content.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Put content
+        let content = b"This is the full content of the frame.";
+        let _seq =
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        // Reopen and get content (frame IDs are 0-indexed)
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // First frame has id=0
+        let content_ptr = unsafe { memvid_frame_content(handle, 0, &mut error) };
+        assert!(!content_ptr.is_null());
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        let content_str = unsafe { std::ffi::CStr::from_ptr(content_ptr) };
+        // Content includes auto-extracted metadata, so just check it starts with our text
+        assert!(content_str
+            .to_str()
+            .unwrap()
+            .starts_with("This is the full content of the frame."));
+
+        unsafe { memvid_string_free(content_ptr) };
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    #[cfg(unix)]
+    fn test_put_streaming() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_put_streaming.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+        let source = temp_dir.join("test_ffi_put_streaming.txt");
+        std::fs::write(&source, b"Ingested straight from disk.").unwrap();
+        let source_cstr = CString::new(source.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Chunked writer
+        let options = CString::new(r#"{"uri": "test://streamed"}"#).unwrap();
+        let stream = unsafe { memvid_put_begin(options.as_ptr(), &mut error) };
+        assert!(!stream.is_null());
+        for chunk in [&b"Written "[..], b"in three ", b"chunks."] {
+            let ok = unsafe { memvid_put_write(stream, chunk.as_ptr(), chunk.len(), &mut error) };
+            assert_eq!(ok, 1);
+        }
+        unsafe { memvid_put_end(handle, stream, &mut error) };
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Mapped file
+        unsafe { memvid_put_path(handle, source_cstr.as_ptr(), std::ptr::null(), &mut error) };
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Non-seekable descriptor is spooled before mapping
+        let mut fds = [0; 2];
+        assert_eq!(unsafe { libc::pipe(fds.as_mut_ptr()) }, 0);
+        let piped = b"Piped through a descriptor.";
+        unsafe { libc::write(fds[1], piped.as_ptr().cast(), piped.len()) };
+        unsafe { libc::close(fds[1]) };
+        unsafe { memvid_put_fd(handle, fds[0], std::ptr::null(), &mut error) };
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        unsafe { libc::close(fds[0]) };
+
+        unsafe { memvid_commit(handle, &mut error) };
+        let expected = [
+            "Written in three chunks.",
+            "Ingested straight from disk.",
+            "Piped through a descriptor.",
+        ];
+        for (frame_id, text) in expected.iter().enumerate() {
+            let content = unsafe { memvid_frame_content(handle, frame_id as u64, &mut error) };
+            assert!(!content.is_null());
+            let content_str = unsafe { std::ffi::CStr::from_ptr(content) };
+            assert!(content_str.to_str().unwrap().starts_with(text));
+            unsafe { memvid_string_free(content) };
+        }
+
+        // Aborting discards the stream
+        let stream = unsafe { memvid_put_begin(std::ptr::null(), &mut error) };
+        unsafe { memvid_put_abort(stream) };
+        assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 3);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+        let _ = std::fs::remove_file(&source);
+    }
+
+    #[test]
+    fn test_ingest_pipeline() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_ingest_pipeline.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        let shared = CString::new(r#"{"labels": ["ingested"]}"#).unwrap();
+        let pipeline = unsafe { memvid_ingest_open(handle, 4, 4, shared.as_ptr(), &mut error) };
+        assert!(!pipeline.is_null());
+
+        let bad_options = CString::new("{not json").unwrap();
+        for i in 0..20u64 {
+            let content = format!("Pipelined document number {i}.");
+            let uri = CString::new(format!(r#"{{"uri": "test://ingest/{i}"}}"#)).unwrap();
+            let options = if i == 7 { &bad_options } else { &uri };
+            let ticket = unsafe {
+                memvid_ingest_submit(
+                    pipeline,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+            assert_eq!(ticket, i + 1);
+        }
+
+        let stats_ptr = unsafe { memvid_ingest_stats(pipeline, &mut error) };
+        assert!(!stats_ptr.is_null());
+        unsafe { memvid_string_free(stats_ptr) };
+
+        let report_ptr = unsafe { memvid_ingest_finish(pipeline, &mut error) };
+        assert!(!report_ptr.is_null());
+        let report_str = unsafe { std::ffi::CStr::from_ptr(report_ptr) }
+            .to_str()
+            .unwrap();
+        let report: serde_json::Value = serde_json::from_str(report_str).unwrap();
+        unsafe { memvid_string_free(report_ptr) };
+
+        assert_eq!(report["submitted"], 20);
+        assert_eq!(report["stored"], 19);
+        let results = report["results"].as_array().unwrap();
+        let tickets: Vec<u64> = results
+            .iter()
+            .map(|r| r["ticket"].as_u64().unwrap())
+            .collect();
+        assert_eq!(tickets, (1..=20).collect::<Vec<_>>());
+        assert_eq!(results[7]["code"], MemvidErrorCode::JsonParse as i32);
+        assert_eq!(report["stats"]["write"]["items"], 20);
+        // Hashes from the workers kept the dedup filter covering every frame
+        assert!(unsafe { &*handle }.dedup.is_usable(19));
+
+        // Frames were appended in submission order
+        unsafe { memvid_commit(handle, &mut error) };
+        assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 19);
+        let uri = CString::new("test://ingest/8").unwrap();
+        let frame_ptr = unsafe { memvid_frame_by_uri(handle, uri.as_ptr(), &mut error) };
+        assert!(!frame_ptr.is_null());
+        let frame_str = unsafe { std::ffi::CStr::from_ptr(frame_ptr) }
+            .to_str()
+            .unwrap();
+        let frame: serde_json::Value = serde_json::from_str(frame_str).unwrap();
+        assert_eq!(frame["id"], 7);
+        unsafe { memvid_string_free(frame_ptr) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_vector_search() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_vector_search.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        let content = b"Vector indexed document about rust.";
+        let embedding = [0.25f32, 0.5, 0.75, 1.0];
+        let frame_id = unsafe {
+            memvid_put_bytes_with_embedding(
+                handle,
+                content.as_ptr(),
+                content.len(),
+                embedding.as_ptr(),
+                embedding.len(),
+                std::ptr::null(),
+                &mut error,
+            )
+        };
+
+        let filters = CString::new(r#"{"mode": "hybrid", "text": "rust"}"#).unwrap();
+        if cfg!(feature = "vec") {
+            assert_eq!(error.code, MemvidErrorCode::Ok);
+            assert_eq!(frame_id, 1);
+            unsafe { memvid_commit(handle, &mut error) };
+
+            let result_ptr = unsafe {
+                memvid_search_vec(
+                    handle,
+                    embedding.as_ptr(),
+                    embedding.len(),
+                    5,
+                    filters.as_ptr(),
+                    &mut error,
+                )
+            };
+            assert!(!result_ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(result_ptr) }
+                .to_str()
+                .unwrap();
+            assert!(json.contains("\"mode\":\"hybrid\""));
+            unsafe { memvid_string_free(result_ptr) };
+        } else {
+            assert_eq!(frame_id, 0);
+            assert_eq!(error.code, MemvidErrorCode::VecNotEnabled);
+            unsafe { memvid_error_free(&mut error) };
+        }
+
+        // A missing query vector is rejected before reaching the index
+        let result_ptr = unsafe {
+            memvid_search_vec(handle, std::ptr::null(), 4, 5, std::ptr::null(), &mut error)
+        };
+        assert!(result_ptr.is_null());
+        assert_eq!(error.code, MemvidErrorCode::NullPointer);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_open_with_options() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_open_with_options.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        let content = b"Warm page cache content";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        for readahead in ["none", "async", "populate"] {
+            let options = CString::new(format!(
+                r#"{{"read_only": true, "readahead": "{readahead}"}}"#
+            ))
+            .unwrap();
+            let handle = unsafe {
+                memvid_open_with_options(path_cstr.as_ptr(), options.as_ptr(), &mut error)
+            };
+            assert!(!handle.is_null());
+            assert_eq!(error.code, MemvidErrorCode::Ok);
+            assert_eq!(unsafe { memvid_frame_count(handle, &mut error) }, 1);
+
+            // Read-only handles reject mutations
+            let frame_id =
+                unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+            assert_eq!(frame_id, 0);
+            assert_ne!(error.code, MemvidErrorCode::Ok);
+            unsafe { memvid_error_free(&mut error) };
+            unsafe { memvid_close(handle) };
+        }
+
+        let bad = CString::new(r#"{"readahead": "eager"}"#).unwrap();
+        let handle =
+            unsafe { memvid_open_with_options(path_cstr.as_ptr(), bad.as_ptr(), &mut error) };
+        assert!(handle.is_null());
+        assert_eq!(error.code, MemvidErrorCode::JsonParse);
+        unsafe { memvid_error_free(&mut error) };
+
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_response_arena() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_response_arena.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        for i in 0..10 {
+            let content = format!("Arena document {i} about bump allocation.");
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // A tiny first chunk forces the arena to grow mid-response
+        let arena = unsafe { memvid_arena_create(64, &mut error) };
+        assert!(!arena.is_null());
+        assert_eq!(unsafe { memvid_arena_capacity(arena) }, 64);
+
+        let search = CString::new(r#"{"query": "arena", "top_k": 10}"#).unwrap();
+        let ask = CString::new(r#"{"question": "bump allocation", "mode": "lex"}"#).unwrap();
+        let heap_ptr = unsafe { memvid_search(handle, search.as_ptr(), &mut error) };
+        let heap = unsafe { std::ffi::CStr::from_ptr(heap_ptr) }
+            .to_str()
+            .unwrap()
+            .to_string();
+        unsafe { memvid_string_free(heap_ptr) };
+
+        for _ in 0..3 {
+            let search_ptr =
+                unsafe { memvid_search_arena(handle, search.as_ptr(), arena, &mut error) };
+            assert!(!search_ptr.is_null());
+            let ask_ptr = unsafe { memvid_ask_arena(handle, ask.as_ptr(), arena, &mut error) };
+            assert!(!ask_ptr.is_null());
+            let frame_ptr = unsafe { memvid_frame_by_id_arena(handle, 3, arena, &mut error) };
+            assert!(!frame_ptr.is_null());
+
+            // Earlier strings stay valid while later ones are added
+            let search_json = unsafe { std::ffi::CStr::from_ptr(search_ptr) }
+                .to_str()
+                .unwrap();
+            let search_value: serde_json::Value = serde_json::from_str(search_json).unwrap();
+            let heap_value: serde_json::Value = serde_json::from_str(&heap).unwrap();
+            assert_eq!(search_value["hits"], heap_value["hits"]);
+            let ask_json = unsafe { std::ffi::CStr::from_ptr(ask_ptr) }
+                .to_str()
+                .unwrap();
+            assert!(ask_json.contains("\"question\":\"bump allocation\""));
+            let frame_json = unsafe { std::ffi::CStr::from_ptr(frame_ptr) }
+                .to_str()
+                .unwrap();
+            let frame: serde_json::Value = serde_json::from_str(frame_json).unwrap();
+            assert_eq!(frame["id"], 3);
+
+            unsafe { memvid_arena_reset(arena) };
+        }
+        let capacity = unsafe { memvid_arena_capacity(arena) };
+        assert!(capacity > 64);
+
+        let missing = unsafe { memvid_frame_by_id_arena(handle, 999, arena, &mut error) };
+        assert!(missing.is_null());
+        assert_ne!(error.code, MemvidErrorCode::Ok);
+        unsafe { memvid_error_free(&mut error) };
+
+        // Hooks cannot be installed once heap strings have been handed out
+        let ok = unsafe { memvid_set_allocator(None, None, std::ptr::null_mut(), &mut error) };
+        assert_eq!(ok, 0);
+        assert_eq!(error.code, MemvidErrorCode::NullPointer);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe extern "C" fn test_malloc(
+            _ctx: *mut std::ffi::c_void,
+            size: usize,
+        ) -> *mut std::ffi::c_void {
+            unsafe { libc::malloc(size) }
+        }
+        unsafe extern "C" fn test_free(_ctx: *mut std::ffi::c_void, ptr: *mut std::ffi::c_void) {
+            unsafe { libc::free(ptr) }
+        }
+        let ok = unsafe {
+            memvid_set_allocator(
+                Some(test_malloc),
+                Some(test_free),
+                std::ptr::null_mut(),
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 0);
+        assert_eq!(error.code, MemvidErrorCode::InvalidState);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_arena_destroy(arena) };
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_metrics_snapshot() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_metrics_snapshot.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        let was_enabled = memvid_metrics_enable(1);
+
+        let content = b"Instrumented content";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        let search = CString::new(r#"{"query": "instrumented"}"#).unwrap();
+        for _ in 0..5 {
+            let result_ptr = unsafe { memvid_search(handle, search.as_ptr(), &mut error) };
+            assert!(!result_ptr.is_null());
+            unsafe { memvid_string_free(result_ptr) };
+        }
+        let bad = CString::new("{not json").unwrap();
+        let result_ptr = unsafe { memvid_search(handle, bad.as_ptr(), &mut error) };
+        assert!(result_ptr.is_null());
+        unsafe { memvid_error_free(&mut error) };
+
+        let snapshot_ptr = unsafe { memvid_metrics_snapshot(&mut error) };
+        memvid_metrics_enable(was_enabled);
+        assert!(!snapshot_ptr.is_null());
+        let snapshot_str = unsafe { std::ffi::CStr::from_ptr(snapshot_ptr) }
+            .to_str()
+            .unwrap();
+        let snapshot: serde_json::Value = serde_json::from_str(snapshot_str).unwrap();
+        unsafe { memvid_string_free(snapshot_ptr) };
+
+        let ops = snapshot["operations"].as_array().unwrap();
+        let op = |name: &str| ops.iter().find(|o| o["name"] == name).unwrap().clone();
+        let search_op = op("memvid_search");
+        assert!(search_op["calls"].as_u64().unwrap() >= 6);
+        assert!(search_op["core"]["count"].as_u64().unwrap() >= 5);
+        assert!(search_op["serialize"]["count"].as_u64().unwrap() >= 5);
+        assert!(search_op["bytes_out"].as_u64().unwrap() > 0);
+        let total = &search_op["total"];
+        assert!(total["p50_ns"].as_u64().unwrap() <= total["p99_ns"].as_u64().unwrap());
+        assert!(total["p99_ns"].as_u64().unwrap() <= total["max_ns"].as_u64().unwrap());
+        assert!(op("memvid_put_bytes")["bytes_in"].as_u64().unwrap() >= content.len() as u64);
+        assert!(op("memvid_commit")["calls"].as_u64().unwrap() >= 1);
+
+        let errors = snapshot["errors"].as_array().unwrap();
+        let parse_errors = errors
+            .iter()
+            .find(|e| e["code"] == MemvidErrorCode::JsonParse as i32)
+            .unwrap();
+        assert!(parse_errors["count"].as_u64().unwrap() >= 1);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_frame_payload_view() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_frame_payload_view.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Interior NUL would make memvid_frame_content return NULL, and the
+        // payload is not UTF-8 either
+        let content = b"before\0after\xff";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let mut view = MemvidView {
+            data: std::ptr::null(),
+            len: 0,
+            capacity: 0,
+        };
+        let ok = unsafe { memvid_frame_payload_view(handle, 0, &mut view, &mut error) };
+        assert_eq!(ok, 1);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert!(!view.data.is_null());
+
+        let bytes = unsafe { std::slice::from_raw_parts(view.data, view.len) };
+        assert_eq!(bytes, content);
+
+        unsafe { memvid_view_release(&mut view) };
+        assert!(view.data.is_null());
+        assert_eq!(view.len, 0);
+
+        // Releasing twice is a no-op
+        unsafe { memvid_view_release(&mut view) };
+
+        // Missing frame leaves an empty view
+        let ok = unsafe { memvid_frame_payload_view(handle, 999, &mut view, &mut error) };
+        assert_eq!(ok, 0);
+        assert!(view.data.is_null());
+        assert_ne!(error.code, MemvidErrorCode::Ok);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_delete_frame() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_delete_frame.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Put content
+        let content = b"Document to be deleted.";
+        let _seq =
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_close(handle) };
+
+        // Reopen
+        let handle = unsafe { memvid_open(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Verify we have 1 frame
+        let mut stats = MemvidStats::default();
+        unsafe { memvid_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.active_frame_count, 1);
+
+        // Delete frame (frame IDs are 0-indexed, first frame has id=0)
+        let seq = unsafe { memvid_delete_frame(handle, 0, &mut error) };
+        if seq == 0 && error.code != MemvidErrorCode::Ok {
+            let msg = if !error.message.is_null() {
+                unsafe { std::ffi::CStr::from_ptr(error.message) }
+                    .to_str()
+                    .unwrap_or("unknown")
+            } else {
+                "no message"
+            };
+            panic!("delete_frame failed: {:?} - {}", error.code, msg);
+        }
+        assert!(seq > 0);
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // Verify active count is now 0
+        unsafe { memvid_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.active_frame_count, 0);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_compact() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_compact.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        for i in 0..4 {
+            let content = format!("Compaction document number {i}.");
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+        unsafe { memvid_delete_frame(handle, 0, &mut error) };
+
+        let compact = |options: &str, error: &mut MemvidError| {
+            let options = CString::new(options).unwrap();
+            let ptr = unsafe { memvid_compact(handle, options.as_ptr(), error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            serde_json::from_str::<serde_json::Value>(&json).unwrap()
+        };
+        let poll = |error: &mut MemvidError| loop {
+            let ptr = unsafe { memvid_compact_poll(handle, error) };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            let status = serde_json::from_str::<serde_json::Value>(&json).unwrap();
+            if status["state"] != "running" {
+                return status;
+            }
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        };
+
+        // One tombstone in four frames is below a 50% policy
+        let status = compact(r#"{"min_tombstone_ratio": 0.5}"#, &mut error);
+        assert_eq!(status["state"], "skipped");
+        assert_eq!(status["tombstone_ratio"], 0.25);
+
+        // Blocking compaction drops the deleted frame and keeps the handle usable
+        let status = compact(r#"{"io_bytes_per_sec": 1048576}"#, &mut error);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_eq!(status["state"], "done");
+        assert_eq!(status["frames_before"], 4);
+        assert_eq!(status["frames_after"], 3);
+        let mut stats = MemvidStats::default();
+        unsafe { memvid_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.frame_count, 3);
+        assert_eq!(stats.active_frame_count, 3);
+        assert!(!temp_dir.join("test_ffi_compact.mv2.compact.tmp").exists());
+
+        // A write during a background compaction makes the copy stale
+        unsafe { memvid_delete_frame(handle, 0, &mut error) };
+        let status = compact(r#"{"background": true}"#, &mut error);
+        assert!(status["state"] == "running" || status["state"] == "done");
+        if status["state"] == "running" {
+            let content = b"Written while compacting.";
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+            let status = poll(&mut error);
+            assert_eq!(status["state"], "stale");
+            assert!(status["hint"].is_string());
+            unsafe { memvid_commit(handle, &mut error) };
+        }
+
+        // Retrying in the background finishes through poll
+        let status = compact(r#"{"background": true}"#, &mut error);
+        assert_ne!(status["state"], "skipped");
+        let status = if status["state"] == "running" {
+            poll(&mut error)
+        } else {
+            status
+        };
+        assert_eq!(status["state"], "done");
+        assert_eq!(poll(&mut error)["state"], "idle");
+
+        // With catch_up, a stale copy is rebuilt and keeps the concurrent write
+        unsafe { memvid_delete_frame(handle, 0, &mut error) };
+        let status = compact(r#"{"background": true, "catch_up": true}"#, &mut error);
+        if status["state"] == "running" {
+            let content = b"Also written while compacting.";
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+            let status = poll(&mut error);
+            assert_eq!(status["state"], "done");
+            assert_eq!(status["caught_up"], true);
+            assert_eq!(
+                status["frames_after"],
+                status["frames_before"].as_u64().unwrap() - 1
+            );
+        }
+        unsafe { memvid_stats(handle, &mut stats, &mut error) };
+        assert_eq!(stats.frame_count, stats.active_frame_count);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_warmup() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_warmup.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        for i in 0..3 {
+            let content = format!("Warmup document number {i}.");
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let take_json = |ptr: *mut c_char| {
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            serde_json::from_str::<serde_json::Value>(&json).unwrap()
+        };
+
+        // Hot set is empty until tracking is enabled
+        let search = CString::new(r#"{"query": "warmup", "top_k": 10}"#).unwrap();
+        let ptr = unsafe { memvid_search(handle, search.as_ptr(), &mut error) };
+        unsafe { memvid_string_free(ptr) };
+        let hot = take_json(unsafe { memvid_hot_set_export(handle, 0, &mut error) });
+        assert_eq!(hot["frames"].as_array().unwrap().len(), 0);
+
+        assert_eq!(
+            unsafe { memvid_hot_set_configure(handle, 16, &mut error) },
+            1
+        );
+        let ptr = unsafe { memvid_search(handle, search.as_ptr(), &mut error) };
+        unsafe { memvid_string_free(ptr) };
+        let ptr = unsafe { memvid_frame_by_id(handle, 1, &mut error) };
+        unsafe { memvid_string_free(ptr) };
+        let hot = take_json(unsafe { memvid_hot_set_export(handle, 0, &mut error) });
+        let frames = hot["frames"].as_array().unwrap();
+        assert!(!frames.is_empty());
+        assert_eq!(frames[0]["frame_id"], 1);
+        assert_eq!(frames[0]["hits"], 2);
+        let top = take_json(unsafe { memvid_hot_set_export(handle, 1, &mut error) });
+        assert_eq!(top["frames"].as_array().unwrap().len(), 1);
+
+        // One-off hits on a full set displace only the coldest frame
+        unsafe { memvid_hot_set_configure(handle, 2, &mut error) };
+        for frame_id in [1, 1, 1, 1, 0, 2, 0, 2] {
+            let ptr = unsafe { memvid_frame_by_id(handle, frame_id, &mut error) };
+            unsafe { memvid_string_free(ptr) };
+        }
+        let small = take_json(unsafe { memvid_hot_set_export(handle, 0, &mut error) });
+        let tracked = small["frames"].as_array().unwrap();
+        assert_eq!(tracked.len(), 2);
+        assert_eq!(tracked[0]["frame_id"], 1);
+        assert_eq!(tracked[0]["hits"], 6);
+        unsafe { memvid_hot_set_configure(handle, 16, &mut error) };
+
+        // Warm the file and the exported hot set, plus one missing frame
+        let options = serde_json::json!({
+            "file": "populate",
+            "frame_ids": [999],
+            "hot_set": hot,
+            "threads": 2
+        })
+        .to_string();
+        let options = CString::new(options).unwrap();
+        let report = take_json(unsafe { memvid_warmup(handle, options.as_ptr(), &mut error) });
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_eq!(report["pending"], false);
+        assert_eq!(
+            report["file_bytes"],
+            std::fs::metadata(&path).unwrap().len()
+        );
+        assert_eq!(report["frames_requested"], frames.len() + 1);
+        assert_eq!(report["frames_warmed"], frames.len());
+        assert_eq!(report["frames_missing"], 1);
+        assert!(report["frame_bytes"].as_u64().unwrap() > 0);
+
+        // Defaults hint the file without waiting on frames
+        let report = take_json(unsafe { memvid_warmup(handle, std::ptr::null(), &mut error) });
+        assert_eq!(report["frames_requested"], 0);
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_shard_set() {
+        let temp_dir = std::env::temp_dir();
+        let paths: Vec<_> = (0..3)
+            .map(|i| temp_dir.join(format!("test_ffi_shard_{i}.mv2")))
+            .collect();
+        for path in &paths {
+            let _ = std::fs::remove_file(path);
+        }
+        let path_cstrs: Vec<_> = paths
+            .iter()
+            .map(|p| CString::new(p.to_str().unwrap()).unwrap())
+            .collect();
+        let path_ptrs: Vec<_> = path_cstrs.iter().map(|p| p.as_ptr()).collect();
+
+        let take_json = |ptr: *mut c_char| {
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            serde_json::from_str::<serde_json::Value>(&json).unwrap()
+        };
+
+        // Missing files fail unless the set may create them
+        let mut error = MemvidError::ok();
+        let set =
+            unsafe { memvid_shard_set_open(path_ptrs.as_ptr(), 3, std::ptr::null(), &mut error) };
+        assert!(set.is_null());
+        unsafe { memvid_error_free(&mut error) };
+        let options = CString::new(r#"{"create": true}"#).unwrap();
+        let set =
+            unsafe { memvid_shard_set_open(path_ptrs.as_ptr(), 3, options.as_ptr(), &mut error) };
+        assert!(!set.is_null());
+
+        // The same URI always routes to the same shard
+        let mut shards = Vec::new();
+        for i in 0..9 {
+            let content = format!("Sharded document number {i}.");
+            let options = CString::new(format!(
+                r#"{{"uri": "mv2://shard/{}", "timestamp": {}}}"#,
+                i % 3,
+                1_700_000_000 + i
+            ))
+            .unwrap();
+            let frame_id = unsafe {
+                memvid_shard_set_put(
+                    set,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+            assert_eq!(error.code, MemvidErrorCode::Ok);
+            shards.push(frame_id >> MEMVID_SHARD_ID_SHIFT);
+        }
+        assert_eq!(shards[0], shards[3]);
+        assert_eq!(shards[1], shards[7]);
+        assert_eq!(unsafe { memvid_shard_set_commit(set, &mut error) }, 1);
+
+        let mut total = 0;
+        for index in 0..3 {
+            let shard = unsafe { memvid_shard_set_shard(set, index, &mut error) };
+            assert!(!shard.is_null());
+            total += unsafe { memvid_frame_count(shard, &mut error) };
+        }
+        assert_eq!(total, 9);
+        assert!(unsafe { memvid_shard_set_shard(set, 3, &mut error) }.is_null());
+
+        // Search merges a global top-k with namespaced frame IDs
+        let request = CString::new(r#"{"query": "sharded", "top_k": 4}"#).unwrap();
+        let response =
+            take_json(unsafe { memvid_shard_set_search(set, request.as_ptr(), &mut error) });
+        let hits = response["hits"].as_array().unwrap();
+        assert_eq!(hits.len(), 4);
+        assert_eq!(response["total_hits"], 9);
+        for (i, hit) in hits.iter().enumerate() {
+            assert_eq!(hit["rank"], i + 1);
+            let shard = hit["frame_id"].as_u64().unwrap() >> MEMVID_SHARD_ID_SHIFT;
+            assert!(shard < 3);
+        }
+        let cursor = CString::new(r#"{"query": "sharded", "cursor": "x"}"#).unwrap();
+        assert!(unsafe { memvid_shard_set_search(set, cursor.as_ptr(), &mut error) }.is_null());
+        assert_eq!(error.code, MemvidErrorCode::InvalidState);
+        unsafe { memvid_error_free(&mut error) };
+
+        let request = CString::new(r#"{"question": "sharded", "top_k": 5}"#).unwrap();
+        let response =
+            take_json(unsafe { memvid_shard_set_ask(set, request.as_ptr(), &mut error) });
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert!(response["retrieval"]["hits"].as_array().unwrap().len() <= 5);
+
+        // Timeline entries from all shards come back in timestamp order
+        let query = CString::new(r#"{"limit": 5, "reverse": true}"#).unwrap();
+        let response =
+            take_json(unsafe { memvid_shard_set_timeline(set, query.as_ptr(), &mut error) });
+        let entries = response["entries"].as_array().unwrap();
+        assert_eq!(entries.len(), 5);
+        let timestamps: Vec<_> = entries
+            .iter()
+            .map(|e| e["timestamp"].as_i64().unwrap())
+            .collect();
+        assert_eq!(
+            timestamps,
+            (1_700_000_004..=1_700_000_008).rev().collect::<Vec<_>>()
+        );
+
+        unsafe { memvid_shard_set_close(set) };
+        for path in &paths {
+            let _ = std::fs::remove_file(path);
+        }
+    }
+
+    #[test]
+    fn test_timeline() {
         let temp_dir = std::env::temp_dir();
         let path = temp_dir.join("test_ffi_timeline.mv2");
         let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
@@ -529,6 +2608,85 @@ mod tests {
         let _ = std::fs::remove_file(&path);
     }
 
+    #[test]
+    fn test_timeline_cursor() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_timeline_cursor.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+
+        // Several frames share a timestamp to exercise batch boundaries
+        for i in 0..7 {
+            let content = format!("Cursor document {i}.");
+            let options = CString::new(format!(r#"{{"timestamp": {}}}"#, 1000 + i / 3)).unwrap();
+            unsafe {
+                memvid_put_bytes_with_options(
+                    handle,
+                    content.as_ptr(),
+                    content.len(),
+                    options.as_ptr(),
+                    &mut error,
+                )
+            };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        let cursor = unsafe { memvid_timeline_open(std::ptr::null(), &mut error) };
+        assert!(!cursor.is_null());
+
+        let mut frame_ids = Vec::new();
+        loop {
+            let batch_ptr = unsafe { memvid_timeline_next(handle, cursor, 2, &mut error) };
+            assert!(!batch_ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(batch_ptr) }.to_str().unwrap();
+            let batch: serde_json::Value = serde_json::from_str(json).unwrap();
+            unsafe { memvid_string_free(batch_ptr) };
+
+            let entries = batch["entries"].as_array().unwrap();
+            assert!(entries.len() <= 2);
+            frame_ids.extend(entries.iter().map(|e| e["frame_id"].as_u64().unwrap()));
+            if batch["done"].as_bool().unwrap() {
+                break;
+            }
+        }
+        assert_eq!(frame_ids, (0..7).collect::<Vec<u64>>());
+        unsafe { memvid_timeline_close(cursor) };
+
+        // Reverse batches resume strictly before the last (timestamp, frame)
+        let query = CString::new(r#"{"reverse": true}"#).unwrap();
+        let cursor = unsafe { memvid_timeline_open(query.as_ptr(), &mut error) };
+        let mut frame_ids = Vec::new();
+        loop {
+            let batch_ptr = unsafe { memvid_timeline_next(handle, cursor, 2, &mut error) };
+            let json = unsafe { std::ffi::CStr::from_ptr(batch_ptr) }.to_str().unwrap();
+            let batch: serde_json::Value = serde_json::from_str(json).unwrap();
+            unsafe { memvid_string_free(batch_ptr) };
+            let entries = batch["entries"].as_array().unwrap();
+            frame_ids.extend(entries.iter().map(|e| e["frame_id"].as_u64().unwrap()));
+            if batch["done"].as_bool().unwrap() {
+                break;
+            }
+        }
+        assert_eq!(frame_ids, (0..7).rev().collect::<Vec<u64>>());
+        unsafe { memvid_timeline_close(cursor) };
+
+        // Overall limit caps the stream
+        let query = CString::new(r#"{"limit": 3, "reverse": true}"#).unwrap();
+        let cursor = unsafe { memvid_timeline_open(query.as_ptr(), &mut error) };
+        let batch_ptr = unsafe { memvid_timeline_next(handle, cursor, 10, &mut error) };
+        let json = unsafe { std::ffi::CStr::from_ptr(batch_ptr) }.to_str().unwrap();
+        assert!(json.contains("\"count\":3"));
+        assert!(json.contains("\"done\":true"));
+        unsafe { memvid_string_free(batch_ptr) };
+        unsafe { memvid_timeline_close(cursor) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
     #[test]
     fn test_verify() {
         let temp_dir = std::env::temp_dir();
@@ -569,6 +2727,92 @@ mod tests {
         let _ = std::fs::remove_file(&path);
     }
 
+    #[test]
+    fn test_verify_many() {
+        let temp_dir = std::env::temp_dir();
+        let paths: Vec<_> = (0..3)
+            .map(|i| temp_dir.join(format!("test_ffi_verify_many_{i}.mv2")))
+            .collect();
+        let mut error = MemvidError::ok();
+        for path in &paths {
+            let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+            let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+            assert!(!handle.is_null());
+            let content = b"Verified in parallel.";
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+            unsafe { memvid_commit(handle, &mut error) };
+            unsafe { memvid_close(handle) };
+        }
+        let mut cstrs: Vec<_> = paths
+            .iter()
+            .map(|p| CString::new(p.to_str().unwrap()).unwrap())
+            .collect();
+        cstrs.push(CString::new("/nonexistent/path/to/file.mv2").unwrap());
+        let ptrs: Vec<_> = cstrs.iter().map(|c| c.as_ptr()).collect();
+
+        unsafe extern "C" fn on_progress(
+            ctx: *mut std::os::raw::c_void,
+            _path: *const std::os::raw::c_char,
+            done: usize,
+            total: usize,
+            _status: i32,
+        ) -> i32 {
+            let calls = unsafe { &mut *(ctx as *mut Vec<(usize, usize)>) };
+            calls.push((done, total));
+            0
+        }
+
+        let run = |options: &str, calls: &mut Vec<(usize, usize)>, error: &mut MemvidError| {
+            let options = CString::new(options).unwrap();
+            let ptr = unsafe {
+                memvid_verify_many(
+                    ptrs.as_ptr(),
+                    ptrs.len(),
+                    options.as_ptr(),
+                    Some(on_progress),
+                    calls as *mut _ as *mut std::os::raw::c_void,
+                    error,
+                )
+            };
+            assert!(!ptr.is_null());
+            let json = unsafe { std::ffi::CStr::from_ptr(ptr) }
+                .to_str()
+                .unwrap()
+                .to_string();
+            unsafe { memvid_string_free(ptr) };
+            serde_json::from_str::<serde_json::Value>(&json).unwrap()
+        };
+
+        // First run verifies every file; the missing one is a per-file error
+        let mut calls = Vec::new();
+        let report = run(r#"{"threads": 2}"#, &mut calls, &mut error);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_eq!(report["passed"], 3);
+        assert_eq!(report["errors"], 1);
+        assert_eq!(report["files"][3]["status"], "error");
+        assert_eq!(calls.len(), 4);
+        assert_eq!(calls.last(), Some(&(4, 4)));
+        assert_eq!(report["checkpoint"]["files"].as_array().unwrap().len(), 3);
+
+        // Re-running with the checkpoint skips the unchanged files
+        let options = serde_json::json!({ "checkpoint": report["checkpoint"] }).to_string();
+        let mut calls = Vec::new();
+        let report = run(&options, &mut calls, &mut error);
+        assert_eq!(report["skipped"], 3);
+        assert_eq!(report["passed"], 0);
+        assert_eq!(report["checkpoint"]["files"].as_array().unwrap().len(), 3);
+
+        // A deep run is not covered by a shallow checkpoint
+        let options =
+            serde_json::json!({ "deep": true, "checkpoint": report["checkpoint"] }).to_string();
+        let report = run(&options, &mut Vec::new(), &mut error);
+        assert_eq!(report["passed"], 3);
+
+        for path in &paths {
+            let _ = std::fs::remove_file(path);
+        }
+    }
+
     #[test]
     fn test_ask() {
         let temp_dir = std::env::temp_dir();
@@ -620,6 +2864,315 @@ mod tests {
         let _ = std::fs::remove_file(&path);
     }
 
+    #[test]
+    fn test_ask_stream() {
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_ask_stream.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        for content in [
+            "The capital of France is Paris.",
+            "Berlin is the capital of Germany.",
+            "Tokyo is the capital of Japan.",
+        ] {
+            unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        }
+        unsafe { memvid_commit(handle, &mut error) };
+
+        struct Events {
+            events: Vec<(i32, serde_json::Value)>,
+            stop_after: usize,
+        }
+        unsafe extern "C" fn on_event(
+            ctx: *mut std::ffi::c_void,
+            kind: i32,
+            json: *const c_char,
+            len: usize,
+        ) -> i32 {
+            let events = unsafe { &mut *(ctx as *mut Events) };
+            let json = unsafe { std::ffi::CStr::from_ptr(json) }.to_str().unwrap();
+            assert_eq!(json.len(), len);
+            events
+                .events
+                .push((kind, serde_json::from_str(json).unwrap()));
+            (events.events.len() >= events.stop_after) as i32
+        }
+
+        let request = CString::new(r#"{"question": "capital", "top_k": 5}"#).unwrap();
+        let mut events = Events {
+            events: Vec::new(),
+            stop_after: usize::MAX,
+        };
+        let ok = unsafe {
+            memvid_ask_stream(
+                handle,
+                request.as_ptr(),
+                Some(on_event),
+                &mut events as *mut Events as *mut std::ffi::c_void,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+
+        // Fragments arrive in rank order, then the summary
+        let (done_kind, done) = events.events.last().unwrap();
+        assert_eq!(*done_kind, MEMVID_ASK_DONE);
+        assert_eq!(done["question"], "capital");
+        assert!(done["stats"].is_object());
+        let fragments: Vec<_> = events
+            .events
+            .iter()
+            .filter(|(kind, _)| *kind == MEMVID_ASK_FRAGMENT)
+            .map(|(_, f)| f["rank"].as_u64().unwrap())
+            .collect();
+        assert_eq!(fragments.len() as u64, done["fragments"].as_u64().unwrap());
+        assert!(!fragments.is_empty());
+        assert!(fragments.windows(2).all(|w| w[0] <= w[1]));
+
+        // A non-zero return stops the stream early without an error
+        let mut events = Events {
+            events: Vec::new(),
+            stop_after: 1,
+        };
+        let ok = unsafe {
+            memvid_ask_stream(
+                handle,
+                request.as_ptr(),
+                Some(on_event),
+                &mut events as *mut Events as *mut std::ffi::c_void,
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 1);
+        assert_eq!(events.events.len(), 1);
+
+        let ok = unsafe {
+            memvid_ask_stream(
+                handle,
+                request.as_ptr(),
+                None,
+                std::ptr::null_mut(),
+                &mut error,
+            )
+        };
+        assert_eq!(ok, 0);
+        assert_eq!(error.code, MemvidErrorCode::NullPointer);
+        unsafe { memvid_error_free(&mut error) };
+
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_executor() {
+        use std::os::raw::c_void;
+        use std::sync::mpsc;
+
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_executor.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let handle = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        assert!(!handle.is_null());
+        let content = b"Completion queues suit event loops.";
+        unsafe { memvid_put_bytes(handle, content.as_ptr(), content.len(), &mut error) };
+        unsafe { memvid_commit(handle, &mut error) };
+
+        // One worker, parked in the first task's callback until released
+        unsafe extern "C" fn park(ctx: *mut c_void, completion: *const MemvidCompletion) {
+            let gate = unsafe { &*(ctx as *const mpsc::Receiver<()>) };
+            assert_eq!(unsafe { (*completion).status }, MEMVID_TASK_DONE);
+            gate.recv().unwrap();
+        }
+        let (release, gate) = mpsc::channel::<()>();
+        let executor = unsafe { memvid_executor_open(1, &mut error) };
+        assert!(!executor.is_null());
+
+        let search = CString::new(r#"{"query": "event"}"#).unwrap();
+        let gate_ptr = &gate as *const _ as *mut c_void;
+        let submit = |op, request: *const c_char, callback, ctx, error: &mut MemvidError| unsafe {
+            memvid_executor_submit(executor, handle, op, request, callback, ctx, error)
+        };
+        let parked = submit(
+            MEMVID_TASK_SEARCH,
+            search.as_ptr(),
+            Some(park),
+            gate_ptr,
+            &mut error,
+        );
+        assert_ne!(parked, 0);
+        let queued = submit(
+            MEMVID_TASK_SEARCH,
+            search.as_ptr(),
+            None,
+            std::ptr::null_mut(),
+            &mut error,
+        );
+        let cancelled = submit(
+            MEMVID_TASK_COMMIT,
+            std::ptr::null(),
+            None,
+            std::ptr::null_mut(),
+            &mut error,
+        );
+        assert_eq!(unsafe { memvid_executor_cancel(executor, cancelled) }, 1);
+        let bad = submit(7, std::ptr::null(), None, std::ptr::null_mut(), &mut error);
+        assert_eq!(bad, 0);
+        assert_eq!(error.code, MemvidErrorCode::InvalidState);
+        unsafe { memvid_error_free(&mut error) };
+        release.send(()).unwrap();
+
+        let mut done = Vec::new();
+        let mut out: [MemvidCompletion; 4] = Default::default();
+        for _ in 0..1000 {
+            let n = unsafe { memvid_executor_poll(executor, out.as_mut_ptr(), 4, &mut error) };
+            for completion in &mut out[..n] {
+                done.push((completion.task_id, completion.status, completion.result));
+            }
+            if done.len() == 2 {
+                break;
+            }
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+        assert_eq!(done.len(), 2);
+        assert!(done.contains(&(cancelled, MEMVID_TASK_CANCELLED, std::ptr::null_mut())));
+        let (_, status, result) = done.iter().find(|d| d.0 == queued).copied().unwrap();
+        assert_eq!(status, MEMVID_TASK_DONE);
+        let json = unsafe { std::ffi::CStr::from_ptr(result) }
+            .to_str()
+            .unwrap();
+        let response: serde_json::Value = serde_json::from_str(json).unwrap();
+        assert_eq!(response["hits"].as_array().unwrap().len(), 1);
+        unsafe { memvid_string_free(result) };
+        assert_eq!(unsafe { memvid_executor_cancel(executor, queued) }, 0);
+
+        #[cfg(target_os = "linux")]
+        {
+            let fd = unsafe { memvid_executor_fd(executor) };
+            assert!(fd >= 0);
+            let mut count = 0u64;
+            unsafe { libc::read(fd, (&mut count as *mut u64).cast(), 8) };
+            assert_eq!(count, 2);
+        }
+
+        // Failed verification surfaces the core error on the completion
+        let verify = CString::new(r#"{"path": "/nonexistent/file.mv2"}"#).unwrap();
+        let task = unsafe {
+            memvid_executor_submit(
+                executor,
+                std::ptr::null_mut(),
+                MEMVID_TASK_VERIFY,
+                verify.as_ptr(),
+                None,
+                std::ptr::null_mut(),
+                &mut error,
+            )
+        };
+        let mut completion = MemvidCompletion::default();
+        while unsafe { memvid_executor_poll(executor, &mut completion, 1, &mut error) } == 0 {
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+        assert_eq!(completion.task_id, task);
+        assert_eq!(completion.status, MEMVID_TASK_FAILED);
+        assert_ne!(completion.error.code, MemvidErrorCode::Ok);
+        unsafe { memvid_error_free(&mut completion.error) };
+
+        unsafe { memvid_executor_close(executor) };
+        drop(gate);
+        unsafe { memvid_close(handle) };
+        let _ = std::fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_snapshot_stream() {
+        use std::os::raw::c_void;
+
+        let temp_dir = std::env::temp_dir();
+        let path = temp_dir.join("test_ffi_snapshot_primary.mv2");
+        let replica_path = temp_dir.join("test_ffi_snapshot_replica.mv2");
+        let path_cstr = CString::new(path.to_str().unwrap()).unwrap();
+        let replica_cstr = CString::new(replica_path.to_str().unwrap()).unwrap();
+
+        let mut error = MemvidError::ok();
+        let primary = unsafe { memvid_create(path_cstr.as_ptr(), &mut error) };
+        let replica = unsafe { memvid_create(replica_cstr.as_ptr(), &mut error) };
+        assert!(!primary.is_null() && !replica.is_null());
+        // Large enough to span several blocks
+        let bulk = vec![b'x'; 100_000];
+        unsafe { memvid_put_bytes(primary, bulk.as_ptr(), bulk.len(), &mut error) };
+
+        unsafe extern "C" fn collect(ctx: *mut c_void, data: *const u8, len: usize) -> i32 {
+            let out = unsafe { &mut *(ctx as *mut Vec<u8>) };
+            out.extend_from_slice(unsafe { std::slice::from_raw_parts(data, len) });
+            0
+        }
+        unsafe extern "C" fn replay(ctx: *mut c_void, buf: *mut u8, cap: usize) -> i64 {
+            let input = unsafe { &mut *(ctx as *mut &[u8]) };
+            let n = cap.min(input.len());
+            unsafe { std::ptr::copy_nonoverlapping(input.as_ptr(), buf, n) };
+            *input = &input[n..];
+            n as i64
+        }
+        let snapshot = |since, error: &mut MemvidError| {
+            let mut out = Vec::new();
+            let ctx = &mut out as *mut Vec<u8> as *mut c_void;
+            let position =
+                unsafe { memvid_snapshot_stream(primary, since, Some(collect), ctx, error) };
+            (position, out)
+        };
+        let apply = |stream: &[u8], error: &mut MemvidError| {
+            let mut input = stream;
+            let ctx = &mut input as *mut &[u8] as *mut c_void;
+            unsafe { memvid_apply_stream(replica, Some(replay), ctx, error) }
+        };
+        // Block count is the last trailer field
+        let blocks =
+            |stream: &[u8]| u64::from_le_bytes(stream[stream.len() - 8..].try_into().unwrap());
+
+        // Pending writes are committed before the full snapshot is taken
+        let (full_at, full) = snapshot(0, &mut error);
+        assert_eq!(error.code, MemvidErrorCode::Ok);
+        assert_ne!(full_at, 0);
+        assert_eq!(apply(&full, &mut error), full_at);
+        assert_eq!(unsafe { memvid_frame_count(replica, &mut error) }, 1);
+
+        let content = b"Replicated incrementally.";
+        unsafe { memvid_put_bytes(primary, content.as_ptr(), content.len(), &mut error) };
+        let (delta_at, delta) = snapshot(full_at, &mut error);
+        assert!(delta_at > full_at);
+        assert!(blocks(&delta) < blocks(&full));
+        assert_eq!(apply(&delta, &mut error), delta_at);
+        assert_eq!(unsafe { memvid_frame_count(replica, &mut error) }, 2);
+        let query = CString::new(r#"{"query": "incrementally"}"#).unwrap();
+        let ptr = unsafe { memvid_search(replica, query.as_ptr(), &mut error) };
+        let json = unsafe { std::ffi::CStr::from_ptr(ptr) }.to_str().unwrap();
+        assert!(json.contains("Replicated incrementally."));
+        unsafe { memvid_string_free(ptr) };
+
+        // The replica is no longer at the delta's base, so it is left untouched
+        assert_eq!(apply(&delta[..delta.len() - 1], &mut error), 0);
+        assert_ne!(error.code, MemvidErrorCode::Ok);
+        unsafe { memvid_error_free(&mut error) };
+        assert_eq!(apply(&delta, &mut error), 0);
+        assert_eq!(error.code, MemvidErrorCode::InvalidState);
+        unsafe { memvid_error_free(&mut error) };
+        assert_eq!(unsafe { memvid_frame_count(replica, &mut error) }, 2);
+
+        // Unknown positions fall back to a full snapshot
+        let (_, fallback) = snapshot(999, &mut error);
+        assert!(blocks(&fallback) >= blocks(&full));
+
+        unsafe { memvid_close(primary) };
+        unsafe { memvid_close(replica) };
+        let _ = std::fs::remove_file(&path);
+        let _ = std::fs::remove_file(&replica_path);
+    }
+
     #[test]
     fn test_doctor() {
         let temp_dir = std::env::temp_dir();
@@ -2,8 +2,101 @@
 
 use crate::error::MemvidError;
 use crate::handle::MemvidHandle;
-use crate::util::{cstr_to_path, set_error_null, set_ok};
+use crate::util::{cstr_to_option_string, cstr_to_path, set_error_null, set_ok};
+use serde::Deserialize;
 use std::os::raw::c_char;
+use std::path::Path;
+
+/// Page cache warming applied before the file is opened.
+#[derive(Debug, Default, Clone, Copy, Deserialize)]
+#[serde(rename_all = "lowercase")]
+pub(crate) enum ReadaheadJson {
+    /// Leave paging to the kernel
+    #[default]
+    None,
+    /// Queue kernel readahead for the whole file and return immediately
+    Async,
+    /// Fault the whole file into the page cache before returning
+    Populate,
+}
+
+/// Open options from JSON.
+#[derive(Debug, Default, Deserialize)]
+struct OpenOptionsJson {
+    #[serde(default)]
+    read_only: bool,
+    #[serde(default)]
+    readahead: ReadaheadJson,
+}
+
+/// Warm the page cache for `path`, returning the bytes hinted or faulted in.
+///
+/// Advisory only: failures are ignored (and count as 0 bytes) and the open
+/// proceeds cold. The hint applies to the file's page cache, so it benefits
+/// the descriptor that memvid-core opens afterwards.
+pub(crate) fn readahead(path: &Path, mode: ReadaheadJson) -> u64 {
+    if matches!(mode, ReadaheadJson::None) {
+        return 0;
+    }
+
+    #[cfg(unix)]
+    {
+        use std::os::unix::io::AsRawFd;
+
+        let Ok(file) = std::fs::File::open(path) else {
+            return 0;
+        };
+        let Ok(len) = file.metadata().map(|m| m.len() as usize) else {
+            return 0;
+        };
+        if len == 0 {
+            return 0;
+        }
+
+        match mode {
+            ReadaheadJson::None => 0,
+            #[cfg(any(target_os = "linux", target_os = "android", target_os = "freebsd"))]
+            ReadaheadJson::Async => {
+                let rc =
+                    unsafe { libc::posix_fadvise(file.as_raw_fd(), 0, 0, libc::POSIX_FADV_WILLNEED) };
+                if rc == 0 { len as u64 } else { 0 }
+            }
+            #[cfg(not(any(target_os = "linux", target_os = "android", target_os = "freebsd")))]
+            ReadaheadJson::Async => 0,
+            ReadaheadJson::Populate => {
+                #[cfg(any(target_os = "linux", target_os = "android"))]
+                let flags = libc::MAP_PRIVATE | libc::MAP_POPULATE;
+                #[cfg(not(any(target_os = "linux", target_os = "android")))]
+                let flags = libc::MAP_PRIVATE;
+
+                let ptr = unsafe {
+                    libc::mmap(
+                        std::ptr::null_mut(),
+                        len,
+                        libc::PROT_READ,
+                        flags,
+                        file.as_raw_fd(),
+                        0,
+                    )
+                };
+                if ptr == libc::MAP_FAILED {
+                    return 0;
+                }
+                unsafe {
+                    libc::madvise(ptr, len, libc::MADV_WILLNEED);
+                    libc::munmap(ptr, len);
+                }
+                len as u64
+            }
+        }
+    }
+
+    #[cfg(not(unix))]
+    {
+        let _ = path;
+        0
+    }
+}
 
 /// Create a new Memvid memory at the specified path.
 ///
@@ -39,7 +132,7 @@ pub unsafe extern "C" fn memvid_create(
     match memvid_core::Memvid::create(&path) {
         Ok(memvid) => {
             unsafe { set_ok(error) };
-            Box::into_raw(MemvidHandle::new(memvid))
+            Box::into_raw(MemvidHandle::writable(memvid, path))
         }
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
@@ -79,7 +172,84 @@ pub unsafe extern "C" fn memvid_open(
     match memvid_core::Memvid::open(&path) {
         Ok(memvid) => {
             unsafe { set_ok(error) };
-            Box::into_raw(MemvidHandle::new(memvid))
+            Box::into_raw(MemvidHandle::writable(memvid, path))
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+    }
+}
+
+/// Open an existing Memvid memory with options.
+///
+/// Read-only handles skip writer setup and allow searches and reads only;
+/// mutations fail with a core error. `readahead` warms the page cache so the
+/// first queries against a large file do not fault pages in one at a time.
+///
+/// # Parameters
+///
+/// - `path`: Filesystem path to existing memory (UTF-8 encoded, null-terminated)
+/// - `options_json`: JSON string with open options (NULL for defaults, same as `memvid_open`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Handle on success, NULL on failure.
+///
+/// # Options JSON Schema
+///
+/// ```json
+/// {
+///   "read_only": false,
+///   "readahead": "none"
+/// }
+/// ```
+///
+/// Readahead values: "none", "async" (kernel readahead in the background),
+/// "populate" (read the whole file into the page cache before returning)
+///
+/// # Ownership
+///
+/// Caller owns the returned handle. Must call `memvid_close()` to free.
+///
+/// # Safety
+///
+/// - `path` must be a valid null-terminated UTF-8 string or NULL
+/// - `options_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_open_with_options(
+    path: *const c_char,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidHandle {
+    let path = match unsafe { cstr_to_path(path) } {
+        Ok(p) => p,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let options = match unsafe { cstr_to_option_string(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<OpenOptionsJson>(&json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => OpenOptionsJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    readahead(&path, options.readahead);
+
+    let opened = if options.read_only {
+        memvid_core::Memvid::open_read_only(&path)
+    } else {
+        memvid_core::Memvid::open(&path)
+    };
+    match opened {
+        Ok(memvid) => {
+            unsafe { set_ok(error) };
+            Box::into_raw(if options.read_only {
+                MemvidHandle::read_only(memvid, path)
+            } else {
+                MemvidHandle::writable(memvid, path)
+            })
         }
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
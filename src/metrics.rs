@@ -0,0 +1,429 @@
+//! Per-call latency histograms and counters.
+//!
+//! Instrumented entry points time their parse, core, serialize and copy
+//! phases into lock-free log-linear histograms (one atomic counter per
+//! bucket, 8 buckets per power of two, so values are within 12.5%).
+//! Recording is off until `memvid_metrics_enable` is called; error counts
+//! by `MemvidErrorCode` are always kept.
+
+use crate::error::{MemvidError, MemvidErrorCode};
+use crate::util::{set_error_null, set_ok, string_to_cstr};
+use serde::Serialize;
+use std::os::raw::c_char;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::time::Instant;
+
+/// Instrumented entry point.
+#[derive(Debug, Clone, Copy)]
+pub(crate) enum Op {
+    Search,
+    SearchInto,
+    SearchBin,
+    SearchBatch,
+    ExecutePrepared,
+    Ask,
+    AskStream,
+    FrameById,
+    Timeline,
+    TimelineBin,
+    PutBytes,
+    PutBytesBin,
+    PutBytesWithOptions,
+    PutMany,
+    Commit,
+}
+
+const OPS: [(Op, &str); 15] = [
+    (Op::Search, "memvid_search"),
+    (Op::SearchInto, "memvid_search_into"),
+    (Op::SearchBin, "memvid_search_bin"),
+    (Op::SearchBatch, "memvid_search_batch"),
+    (Op::ExecutePrepared, "memvid_execute_prepared"),
+    (Op::Ask, "memvid_ask"),
+    (Op::AskStream, "memvid_ask_stream"),
+    (Op::FrameById, "memvid_frame_by_id"),
+    (Op::Timeline, "memvid_timeline"),
+    (Op::TimelineBin, "memvid_timeline_bin"),
+    (Op::PutBytes, "memvid_put_bytes"),
+    (Op::PutBytesBin, "memvid_put_bytes_bin"),
+    (Op::PutBytesWithOptions, "memvid_put_bytes_with_options"),
+    (Op::PutMany, "memvid_put_many"),
+    (Op::Commit, "memvid_commit"),
+];
+
+/// Timed phase of a call.
+#[derive(Debug, Clone, Copy)]
+pub(crate) enum Phase {
+    /// Argument validation and request parsing
+    Parse,
+    /// memvid-core work
+    Core,
+    /// Response serialization
+    Serialize,
+    /// Copying the response into caller-visible memory
+    Copy,
+}
+
+const PHASES: usize = 4;
+
+/// Sub-buckets per power of two.
+const SUB_BITS: u32 = 3;
+const SUB: usize = 1 << SUB_BITS;
+/// Values at or above 2^MAX_BITS ns (about 68 s) land in the last bucket.
+const MAX_BITS: u32 = 36;
+const BUCKETS: usize = (MAX_BITS - SUB_BITS + 1) as usize * SUB;
+
+fn bucket_index(ns: u64) -> usize {
+    let v = ns.min((1 << MAX_BITS) - 1);
+    if v < SUB as u64 {
+        return v as usize;
+    }
+    let shift = 63 - v.leading_zeros() - SUB_BITS;
+    (shift as usize + 1) * SUB + ((v >> shift) as usize & (SUB - 1))
+}
+
+/// Smallest value that lands in bucket `index`.
+fn bucket_floor(index: usize) -> u64 {
+    if index < SUB {
+        return index as u64;
+    }
+    let shift = index / SUB - 1;
+    ((SUB + index % SUB) as u64) << shift
+}
+
+/// Lock-free latency histogram in nanoseconds.
+struct Histogram {
+    buckets: [AtomicU64; BUCKETS],
+    sum: AtomicU64,
+    max: AtomicU64,
+}
+
+impl Histogram {
+    const fn new() -> Self {
+        Self {
+            buckets: [const { AtomicU64::new(0) }; BUCKETS],
+            sum: AtomicU64::new(0),
+            max: AtomicU64::new(0),
+        }
+    }
+
+    fn record(&self, ns: u64) {
+        self.buckets[bucket_index(ns)].fetch_add(1, Ordering::Relaxed);
+        self.sum.fetch_add(ns, Ordering::Relaxed);
+        self.max.fetch_max(ns, Ordering::Relaxed);
+    }
+
+    fn reset(&self) {
+        for bucket in &self.buckets {
+            bucket.store(0, Ordering::Relaxed);
+        }
+        self.sum.store(0, Ordering::Relaxed);
+        self.max.store(0, Ordering::Relaxed);
+    }
+
+    fn snapshot(&self) -> HistogramJson {
+        let counts: Vec<u64> = self
+            .buckets
+            .iter()
+            .map(|b| b.load(Ordering::Relaxed))
+            .collect();
+        let count: u64 = counts.iter().sum();
+        let max = self.max.load(Ordering::Relaxed);
+
+        // Report each percentile as the upper edge of its bucket, capped at max
+        let percentile = |p: f64| -> u64 {
+            if count == 0 {
+                return 0;
+            }
+            let rank = ((count as f64 * p).ceil() as u64).max(1);
+            let mut seen = 0;
+            for (i, &c) in counts.iter().enumerate() {
+                seen += c;
+                if seen >= rank {
+                    return (bucket_floor(i + 1) - 1).min(max);
+                }
+            }
+            max
+        };
+
+        HistogramJson {
+            count,
+            mean_ns: if count > 0 {
+                self.sum.load(Ordering::Relaxed) / count
+            } else {
+                0
+            },
+            p50_ns: percentile(0.50),
+            p90_ns: percentile(0.90),
+            p99_ns: percentile(0.99),
+            p999_ns: percentile(0.999),
+            max_ns: max,
+            buckets: counts
+                .iter()
+                .enumerate()
+                .filter(|&(_, &c)| c > 0)
+                .map(|(i, &c)| (bucket_floor(i), c))
+                .collect(),
+        }
+    }
+}
+
+/// Histograms and byte counters for one entry point.
+struct OpMetrics {
+    total: Histogram,
+    phases: [Histogram; PHASES],
+    bytes_in: AtomicU64,
+    bytes_out: AtomicU64,
+}
+
+impl OpMetrics {
+    const fn new() -> Self {
+        Self {
+            total: Histogram::new(),
+            phases: [const { Histogram::new() }; PHASES],
+            bytes_in: AtomicU64::new(0),
+            bytes_out: AtomicU64::new(0),
+        }
+    }
+}
+
+static ENABLED: AtomicBool = AtomicBool::new(false);
+static METRICS: [OpMetrics; OPS.len()] = [const { OpMetrics::new() }; OPS.len()];
+static ERRORS: [AtomicU64; 256] = [const { AtomicU64::new(0) }; 256];
+
+/// Count an error reported to a caller.
+pub(crate) fn count_error(code: MemvidErrorCode) {
+    ERRORS[code as usize & 0xff].fetch_add(1, Ordering::Relaxed);
+}
+
+/// Timer for one instrumented call; records the total when dropped.
+///
+/// A span started while metrics are disabled never reads the clock.
+pub(crate) struct Span {
+    op: Op,
+    /// Call start and the end of the last recorded phase
+    clock: Option<(Instant, Instant)>,
+    bytes_in: u64,
+    bytes_out: u64,
+}
+
+impl Span {
+    pub(crate) fn start(op: Op) -> Self {
+        let clock = ENABLED.load(Ordering::Relaxed).then(|| {
+            let now = Instant::now();
+            (now, now)
+        });
+        Self {
+            op,
+            clock,
+            bytes_in: 0,
+            bytes_out: 0,
+        }
+    }
+
+    /// Attribute the time since the previous phase to `phase`.
+    pub(crate) fn phase(&mut self, phase: Phase) {
+        if let Some((_, mark)) = self.clock.as_mut() {
+            let now = Instant::now();
+            let ns = now.duration_since(*mark).as_nanos() as u64;
+            METRICS[self.op as usize].phases[phase as usize].record(ns);
+            *mark = now;
+        }
+    }
+
+    pub(crate) fn bytes_in(&mut self, n: usize) {
+        self.bytes_in += n as u64;
+    }
+
+    pub(crate) fn bytes_out(&mut self, n: usize) {
+        self.bytes_out += n as u64;
+    }
+}
+
+impl Drop for Span {
+    fn drop(&mut self) {
+        if let Some((start, _)) = self.clock {
+            let metrics = &METRICS[self.op as usize];
+            metrics.total.record(start.elapsed().as_nanos() as u64);
+            metrics.bytes_in.fetch_add(self.bytes_in, Ordering::Relaxed);
+            metrics
+                .bytes_out
+                .fetch_add(self.bytes_out, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Histogram for JSON serialization.
+#[derive(Debug, Serialize)]
+struct HistogramJson {
+    count: u64,
+    mean_ns: u64,
+    p50_ns: u64,
+    p90_ns: u64,
+    p99_ns: u64,
+    p999_ns: u64,
+    max_ns: u64,
+    /// Non-empty buckets as [lower bound ns, count]
+    buckets: Vec<(u64, u64)>,
+}
+
+/// Per-entry point metrics for JSON serialization.
+#[derive(Debug, Serialize)]
+struct OpJson {
+    name: &'static str,
+    calls: u64,
+    bytes_in: u64,
+    bytes_out: u64,
+    total: HistogramJson,
+    parse: HistogramJson,
+    core: HistogramJson,
+    serialize: HistogramJson,
+    copy: HistogramJson,
+}
+
+/// Error count for JSON serialization.
+#[derive(Debug, Serialize)]
+struct ErrorCountJson {
+    code: usize,
+    count: u64,
+}
+
+/// Metrics snapshot for JSON serialization.
+#[derive(Debug, Serialize)]
+struct MetricsJson {
+    enabled: bool,
+    operations: Vec<OpJson>,
+    errors: Vec<ErrorCountJson>,
+}
+
+fn snapshot() -> MetricsJson {
+    let operations = OPS
+        .iter()
+        .map(|&(op, name)| {
+            let m = &METRICS[op as usize];
+            let total = m.total.snapshot();
+            OpJson {
+                name,
+                calls: total.count,
+                bytes_in: m.bytes_in.load(Ordering::Relaxed),
+                bytes_out: m.bytes_out.load(Ordering::Relaxed),
+                total,
+                parse: m.phases[Phase::Parse as usize].snapshot(),
+                core: m.phases[Phase::Core as usize].snapshot(),
+                serialize: m.phases[Phase::Serialize as usize].snapshot(),
+                copy: m.phases[Phase::Copy as usize].snapshot(),
+            }
+        })
+        .collect();
+    let errors = ERRORS
+        .iter()
+        .enumerate()
+        .map(|(code, c)| ErrorCountJson {
+            code,
+            count: c.load(Ordering::Relaxed),
+        })
+        .filter(|e| e.count > 0)
+        .collect();
+    MetricsJson {
+        enabled: ENABLED.load(Ordering::Relaxed),
+        operations,
+        errors,
+    }
+}
+
+/// Turn latency recording on or off.
+///
+/// Recording costs a few clock reads per instrumented call. Error counts are
+/// kept regardless.
+///
+/// # Parameters
+///
+/// - `enabled`: Non-zero to record, 0 to stop
+///
+/// # Returns
+///
+/// 1 if recording was previously enabled, 0 otherwise.
+#[unsafe(no_mangle)]
+pub extern "C" fn memvid_metrics_enable(enabled: i32) -> i32 {
+    ENABLED.swap(enabled != 0, Ordering::Relaxed) as i32
+}
+
+/// Clear all histograms, byte counters and error counts.
+#[unsafe(no_mangle)]
+pub extern "C" fn memvid_metrics_reset() {
+    for m in &METRICS {
+        m.total.reset();
+        for h in &m.phases {
+            h.reset();
+        }
+        m.bytes_in.store(0, Ordering::Relaxed);
+        m.bytes_out.store(0, Ordering::Relaxed);
+    }
+    for c in &ERRORS {
+        c.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Get process-wide call metrics.
+///
+/// Instrumented entry points are `memvid_search` (and `memvid_search_arena`),
+/// `memvid_search_into`, `memvid_search_bin`, `memvid_search_batch`,
+/// `memvid_ask` (and `memvid_ask_arena`), `memvid_frame_by_id` (and
+/// `memvid_frame_by_id_arena`), `memvid_timeline`, `memvid_timeline_bin`,
+/// `memvid_put_bytes`, `memvid_put_bytes_with_options`,
+/// `memvid_put_bytes_bin`, `memvid_put_many` and `memvid_commit`. Counters are read without locking,
+/// so a snapshot taken under load may be off by the calls in flight.
+///
+/// # Parameters
+///
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with metrics on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # JSON Schema
+///
+/// ```json
+/// {
+///   "enabled": true,
+///   "operations": [
+///     {
+///       "name": "memvid_search",
+///       "calls": 1000,
+///       "bytes_in": 42000,
+///       "bytes_out": 1800000,
+///       "total": {
+///         "count": 1000,
+///         "mean_ns": 52000,
+///         "p50_ns": 49151,
+///         "p90_ns": 61439,
+///         "p99_ns": 98303,
+///         "p999_ns": 131071,
+///         "max_ns": 140210,
+///         "buckets": [[40960, 120], [45056, 310]]
+///       },
+///       "parse": {...},
+///       "core": {...},
+///       "serialize": {...},
+///       "copy": {...}
+///     }
+///   ],
+///   "errors": [{"code": 102, "count": 3}]
+/// }
+/// ```
+///
+/// # Safety
+///
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_metrics_snapshot(error: *mut MemvidError) -> *mut c_char {
+    match serde_json::to_string(&snapshot()) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
@@ -1,22 +1,99 @@
 //! Content mutation functions (put, commit).
 
-use crate::error::MemvidError;
+use crate::dedup;
+use crate::error::{error_code_from_core, MemvidError, MemvidErrorCode};
 use crate::handle::MemvidHandle;
-use crate::util::{cstr_to_option_string, set_error, set_ok};
+use crate::metrics::{Op, Phase, Span};
+use crate::util::{cstr_to_option_str, set_error, set_ok, MemvidStr};
 use libc::size_t;
 use memvid_core::PutOptions;
 use serde::Deserialize;
-use std::os::raw::c_char;
+use std::os::raw::{c_char, c_void};
+use std::time::{Duration, Instant};
+
+/// Durability notification callback.
+///
+/// Invoked on the committing thread with the caller's context pointer and
+/// the highest sequence number that is now durable.
+pub type MemvidDurabilityCallback =
+    Option<unsafe extern "C" fn(ctx: *mut c_void, durable_seq: u64)>;
+
+/// Caller context pointer passed back to the durability callback.
+struct CallbackCtx(*mut c_void);
+
+// The context is only handed back to the caller, never dereferenced here.
+unsafe impl Send for CallbackCtx {}
+
+/// Group-commit bookkeeping kept on each handle.
+///
+/// `memvid_commit_async` requests are coalesced until the commit window
+/// elapses or enough bytes are pending, then flushed with one commit.
+#[derive(Default)]
+pub(crate) struct GroupCommit {
+    /// Maximum time a request may wait for a coalesced commit (zero commits immediately)
+    window: Duration,
+    /// Pending byte threshold that forces a commit (0 disables)
+    max_pending_bytes: u64,
+    /// Bytes put since the last commit
+    pub(crate) pending_bytes: u64,
+    /// Sequence number of the last commit request
+    requested_seq: u64,
+    /// Highest sequence number known to be durable
+    durable_seq: u64,
+    /// Arrival time of the oldest unflushed request
+    oldest_request: Option<Instant>,
+    callback: MemvidDurabilityCallback,
+    callback_ctx: Option<CallbackCtx>,
+}
+
+impl GroupCommit {
+    /// Whether outstanding requests should be flushed now.
+    fn due(&self) -> bool {
+        match self.oldest_request {
+            Some(oldest) => {
+                oldest.elapsed() >= self.window
+                    || (self.max_pending_bytes > 0 && self.pending_bytes >= self.max_pending_bytes)
+            }
+            None => false,
+        }
+    }
+}
+
+/// Commit the handle and mark every outstanding request durable.
+pub(crate) fn commit_handle(handle: &mut MemvidHandle) -> Result<(), memvid_core::MemvidError> {
+    let started = Instant::now();
+    handle.as_mut().commit()?;
+    handle.cache.invalidate();
+    let frames = handle.as_ref().frame_count();
+    handle.stats_cache.record_commit(started.elapsed(), frames);
+    dedup::save(handle);
+    handle.save_indexes();
+
+    let group = &mut handle.group_commit;
+    group.pending_bytes = 0;
+    group.oldest_request = None;
+    if group.durable_seq != group.requested_seq {
+        group.durable_seq = group.requested_seq;
+        if let Some(callback) = group.callback {
+            let ctx = group
+                .callback_ctx
+                .as_ref()
+                .map_or(std::ptr::null_mut(), |c| c.0);
+            unsafe { callback(ctx, group.durable_seq) };
+        }
+    }
+    Ok(())
+}
 
 /// JSON schema for PutOptions.
 ///
 /// This allows callers to pass options as a JSON string rather than
 /// requiring complex struct marshalling.
-#[derive(Debug, Default, Deserialize)]
-struct PutOptionsJson {
+#[derive(Debug, Clone, Default, Deserialize)]
+pub(crate) struct PutOptionsJson {
     /// Document URI
     #[serde(default)]
-    uri: Option<String>,
+    pub(crate) uri: Option<String>,
     /// Document title
     #[serde(default)]
     title: Option<String>,
@@ -25,7 +102,7 @@ struct PutOptionsJson {
     timestamp: Option<i64>,
     /// Track/collection name
     #[serde(default)]
-    track: Option<String>,
+    pub(crate) track: Option<String>,
     /// Document kind/type
     #[serde(default)]
     kind: Option<String>,
@@ -56,7 +133,7 @@ struct PutOptionsJson {
 }
 
 impl PutOptionsJson {
-    fn into_put_options(self) -> PutOptions {
+    pub(crate) fn into_put_options(self) -> PutOptions {
         let mut builder = PutOptions::builder();
 
         if let Some(uri) = self.uri {
@@ -105,6 +182,86 @@ impl PutOptionsJson {
 
         builder.build()
     }
+
+    /// Overlay per-item options on top of these (shared) options.
+    ///
+    /// Fields set in `overrides` win; collection fields (`tags`, `labels`)
+    /// are replaced rather than merged.
+    pub(crate) fn merged(&self, overrides: PutOptionsJson) -> PutOptionsJson {
+        PutOptionsJson {
+            uri: overrides.uri.or_else(|| self.uri.clone()),
+            title: overrides.title.or_else(|| self.title.clone()),
+            timestamp: overrides.timestamp.or(self.timestamp),
+            track: overrides.track.or_else(|| self.track.clone()),
+            kind: overrides.kind.or_else(|| self.kind.clone()),
+            tags: overrides.tags.or_else(|| self.tags.clone()),
+            labels: overrides.labels.or_else(|| self.labels.clone()),
+            search_text: overrides.search_text.or_else(|| self.search_text.clone()),
+            auto_tag: overrides.auto_tag.or(self.auto_tag),
+            extract_dates: overrides.extract_dates.or(self.extract_dates),
+            extract_triplets: overrides.extract_triplets.or(self.extract_triplets),
+            no_raw: overrides.no_raw.or(self.no_raw),
+            dedup: overrides.dedup.or(self.dedup),
+        }
+    }
+}
+
+/// Parse optional PutOptions JSON (NULL for defaults).
+///
+/// # Safety
+///
+/// `options_json` must be null or a valid null-terminated C string.
+pub(crate) unsafe fn parse_put_options(
+    options_json: *const c_char,
+) -> Result<PutOptions, MemvidError> {
+    match unsafe { cstr_to_option_str(options_json, "options_json") }? {
+        Some(json_str) => serde_json::from_str::<PutOptionsJson>(json_str)
+            .map(PutOptionsJson::into_put_options)
+            .map_err(MemvidError::json_parse),
+        None => Ok(PutOptions::default()),
+    }
+}
+
+/// Put content with options, accounting it against the group-commit policy.
+pub(crate) fn put_slice(
+    handle: &mut MemvidHandle,
+    data: &[u8],
+    options: PutOptions,
+) -> Result<u64, memvid_core::MemvidError> {
+    put_slice_hashed(handle, data, None, options)
+}
+
+/// Like `put_slice`, with the content hash already computed if `hash` is set.
+pub(crate) fn put_slice_hashed(
+    handle: &mut MemvidHandle,
+    data: &[u8],
+    hash: Option<dedup::ContentHash>,
+    options: PutOptions,
+) -> Result<u64, memvid_core::MemvidError> {
+    let dedup = options.dedup;
+    let frame_id = dedup::put_checked(handle, data, hash, dedup, |memvid, lookup| {
+        memvid.put_bytes_with_options(
+            data,
+            PutOptions {
+                dedup: lookup,
+                ..options
+            },
+        )
+    })?;
+    handle.group_commit.pending_bytes += data.len() as u64;
+    Ok(frame_id)
+}
+
+/// Item descriptor for `memvid_put_many`.
+#[repr(C)]
+#[derive(Debug)]
+pub struct MemvidPutItem {
+    /// Pointer to content bytes
+    pub data: *const u8,
+    /// Length of content in bytes
+    pub len: size_t,
+    /// Per-item options JSON overriding the shared options (NULL to inherit)
+    pub options_json: *const c_char,
 }
 
 /// Add content to the memory.
@@ -132,6 +289,7 @@ pub unsafe extern "C" fn memvid_put_bytes(
     len: size_t,
     error: *mut MemvidError,
 ) -> u64 {
+    let mut span = Span::start(Op::PutBytes);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
@@ -146,9 +304,16 @@ pub unsafe extern "C" fn memvid_put_bytes(
     } else {
         unsafe { std::slice::from_raw_parts(data, len) }
     };
+    span.bytes_in(len);
+    span.phase(Phase::Parse);
 
-    match handle.as_mut().put_bytes(slice) {
+    let result = dedup::put_checked(handle, slice, None, false, |memvid, _| {
+        memvid.put_bytes(slice)
+    });
+    span.phase(Phase::Core);
+    match result {
         Ok(frame_id) => {
+            handle.group_commit.pending_bytes += len as u64;
             unsafe { set_ok(error) };
             frame_id
         }
@@ -190,6 +355,9 @@ pub unsafe extern "C" fn memvid_put_bytes(
 /// }
 /// ```
 ///
+/// With `"dedup": true`, a content-hash filter saved as `<file>.dedup`
+/// skips the duplicate lookup for content that is certainly new.
+///
 /// # Safety
 ///
 /// - `handle` must be a valid handle
@@ -204,6 +372,7 @@ pub unsafe extern "C" fn memvid_put_bytes_with_options(
     options_json: *const c_char,
     error: *mut MemvidError,
 ) -> u64 {
+    let mut span = Span::start(Op::PutBytesWithOptions);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
@@ -220,16 +389,207 @@ pub unsafe extern "C" fn memvid_put_bytes_with_options(
     };
 
     // Parse options JSON
-    let options = match unsafe { cstr_to_option_string(options_json, "options_json") } {
-        Ok(Some(json_str)) => match serde_json::from_str::<PutOptionsJson>(&json_str) {
-            Ok(opts) => opts.into_put_options(),
-            Err(e) => return unsafe { set_error(error, MemvidError::json_parse(e)) },
-        },
-        Ok(None) => PutOptions::default(),
+    let options = match unsafe { parse_put_options(options_json) } {
+        Ok(o) => o,
         Err(e) => return unsafe { set_error(error, e) },
     };
+    span.bytes_in(len);
+    span.phase(Phase::Parse);
+
+    let result = put_slice(handle, slice, options);
+    span.phase(Phase::Core);
+    match result {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            frame_id
+        }
+        Err(e) => unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    }
+}
+
+/// Option flag values in `MemvidPutOptions`.
+pub const MEMVID_FLAG_DEFAULT: u8 = 0;
+pub const MEMVID_FLAG_OFF: u8 = 1;
+pub const MEMVID_FLAG_ON: u8 = 2;
+
+/// Tag key-value pair in `MemvidPutOptions`.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidTag {
+    pub key: MemvidStr,
+    pub value: MemvidStr,
+}
+
+/// Binary put options for `memvid_put_bytes_bin`.
+///
+/// Field-for-field equivalent of the PutOptions JSON. Absent strings and
+/// `MEMVID_FLAG_DEFAULT` flags leave the library default in place, so a
+/// zero-initialized struct is the same as NULL options.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct MemvidPutOptions {
+    /// Document URI
+    pub uri: MemvidStr,
+    /// Document title
+    pub title: MemvidStr,
+    /// Track/collection name
+    pub track: MemvidStr,
+    /// Document kind/type
+    pub kind: MemvidStr,
+    /// Override search text
+    pub search_text: MemvidStr,
+    /// Tags (may be NULL when `tag_count` is 0)
+    pub tags: *const MemvidTag,
+    /// Number of entries in `tags`
+    pub tag_count: size_t,
+    /// Labels (may be NULL when `label_count` is 0)
+    pub labels: *const MemvidStr,
+    /// Number of entries in `labels`
+    pub label_count: size_t,
+    /// Unix timestamp in seconds (valid when `has_timestamp` is 1)
+    pub timestamp: i64,
+    /// Whether `timestamp` is set
+    pub has_timestamp: u8,
+    /// Auto-tagging (`MEMVID_FLAG_*`)
+    pub auto_tag: u8,
+    /// Date extraction (`MEMVID_FLAG_*`)
+    pub extract_dates: u8,
+    /// Triplet extraction (`MEMVID_FLAG_*`)
+    pub extract_triplets: u8,
+    /// Skip storing raw content (`MEMVID_FLAG_*`)
+    pub no_raw: u8,
+    /// Deduplicate by hash (`MEMVID_FLAG_*`)
+    pub dedup: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 2],
+}
+
+fn flag(value: u8) -> Option<bool> {
+    match value {
+        MEMVID_FLAG_OFF => Some(false),
+        MEMVID_FLAG_ON => Some(true),
+        _ => None,
+    }
+}
+
+impl MemvidPutOptions {
+    /// Convert to the JSON options representation.
+    ///
+    /// # Safety
+    ///
+    /// Every present string and non-NULL array must be readable for its length.
+    unsafe fn to_options_json(&self) -> Result<PutOptionsJson, MemvidError> {
+        let owned = |s: &MemvidStr, name: &str| -> Result<Option<String>, MemvidError> {
+            Ok(unsafe { s.as_str(name) }?.map(str::to_owned))
+        };
+
+        let tags = if self.tag_count == 0 {
+            None
+        } else if self.tags.is_null() {
+            return Err(MemvidError::null_pointer("tags"));
+        } else {
+            let pairs = unsafe { std::slice::from_raw_parts(self.tags, self.tag_count) };
+            let mut tags = std::collections::HashMap::with_capacity(pairs.len());
+            for tag in pairs {
+                let key =
+                    owned(&tag.key, "tags")?.ok_or_else(|| MemvidError::null_pointer("tags"))?;
+                tags.insert(key, owned(&tag.value, "tags")?.unwrap_or_default());
+            }
+            Some(tags)
+        };
+
+        let labels = if self.label_count == 0 {
+            None
+        } else if self.labels.is_null() {
+            return Err(MemvidError::null_pointer("labels"));
+        } else {
+            let views = unsafe { std::slice::from_raw_parts(self.labels, self.label_count) };
+            let labels: Result<Vec<_>, _> = views
+                .iter()
+                .map(|l| owned(l, "labels").map(Option::unwrap_or_default))
+                .collect();
+            Some(labels?)
+        };
+
+        Ok(PutOptionsJson {
+            uri: owned(&self.uri, "uri")?,
+            title: owned(&self.title, "title")?,
+            timestamp: (self.has_timestamp != 0).then_some(self.timestamp),
+            track: owned(&self.track, "track")?,
+            kind: owned(&self.kind, "kind")?,
+            tags,
+            labels,
+            search_text: owned(&self.search_text, "search_text")?,
+            auto_tag: flag(self.auto_tag),
+            extract_dates: flag(self.extract_dates),
+            extract_triplets: flag(self.extract_triplets),
+            no_raw: flag(self.no_raw),
+            dedup: flag(self.dedup),
+        })
+    }
+}
+
+/// Add content with binary options.
+///
+/// The binary counterpart of `memvid_put_bytes_with_options`: options are
+/// read from a `MemvidPutOptions` struct, so no JSON is encoded or parsed.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `data`: Pointer to content bytes
+/// - `len`: Length of content in bytes
+/// - `options`: Binary put options (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Frame ID on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `data` must point to at least `len` bytes, or be NULL if `len` is 0
+/// - `options` must be a valid pointer or NULL, and its present strings and
+///   arrays must be readable for their lengths
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_bytes_bin(
+    handle: *mut MemvidHandle,
+    data: *const u8,
+    len: size_t,
+    options: *const MemvidPutOptions,
+    error: *mut MemvidError,
+) -> u64 {
+    let mut span = Span::start(Op::PutBytesBin);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if data.is_null() && len > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("data")) };
+    }
+
+    let slice = if len == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(data, len) }
+    };
+
+    let options = match unsafe { options.as_ref() } {
+        Some(o) => match unsafe { o.to_options_json() } {
+            Ok(o) => o.into_put_options(),
+            Err(e) => return unsafe { set_error(error, e) },
+        },
+        None => PutOptions::default(),
+    };
+    span.bytes_in(len);
+    span.phase(Phase::Parse);
 
-    match handle.as_mut().put_bytes_with_options(slice, options) {
+    let result = put_slice(handle, slice, options);
+    span.phase(Phase::Core);
+    match result {
         Ok(frame_id) => {
             unsafe { set_ok(error) };
             frame_id
@@ -255,12 +615,16 @@ pub unsafe extern "C" fn memvid_put_bytes_with_options(
 /// - `error` must be a valid pointer or NULL
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn memvid_commit(handle: *mut MemvidHandle, error: *mut MemvidError) -> i32 {
+    let mut span = Span::start(Op::Commit);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
     };
+    span.phase(Phase::Parse);
 
-    match handle.as_mut().commit() {
+    let result = commit_handle(handle);
+    span.phase(Phase::Core);
+    match result {
         Ok(()) => {
             unsafe { set_ok(error) };
             1
@@ -268,3 +632,359 @@ pub unsafe extern "C" fn memvid_commit(handle: *mut MemvidHandle, error: *mut Me
         Err(e) => unsafe { set_error(error, MemvidError::from_core_error(e)) },
     }
 }
+
+/// Configure group commit for `memvid_commit_async`.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `window_ms`: Maximum time a commit request may wait to be coalesced
+///   with later ones (0 commits on every request, the default)
+/// - `max_pending_bytes`: Put bytes that force a commit regardless of the
+///   window (0 disables the threshold)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_set_commit_policy(
+    handle: *mut MemvidHandle,
+    window_ms: u64,
+    max_pending_bytes: u64,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    handle.group_commit.window = Duration::from_millis(window_ms);
+    handle.group_commit.max_pending_bytes = max_pending_bytes;
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Register a callback invoked whenever commits make requests durable.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `callback`: Function called with `ctx` and the new durable sequence (NULL to clear)
+/// - `ctx`: Caller context passed back to `callback`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `callback` must be safe to call from any thread that uses the handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_set_durability_callback(
+    handle: *mut MemvidHandle,
+    callback: MemvidDurabilityCallback,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    handle.group_commit.callback = callback;
+    handle.group_commit.callback_ctx = callback.map(|_| CallbackCtx(ctx));
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Request a commit that may be coalesced with later requests.
+///
+/// The request is assigned a sequence number. Pending requests are flushed
+/// with a single commit once the oldest has waited `window_ms` or the
+/// pending put bytes reach `max_pending_bytes` (see
+/// `memvid_set_commit_policy`). The check runs on this call and on
+/// `memvid_commit_poll`; `memvid_commit_flush` and `memvid_commit` flush
+/// unconditionally. Callers learn about durability from
+/// `memvid_commit_poll` or the durability callback.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// The request's sequence number (starting at 1), 0 on failure. On a failed
+/// flush the request stays pending and is retried by the next flush.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_commit_async(
+    handle: *mut MemvidHandle,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let group = &mut handle.group_commit;
+    group.requested_seq += 1;
+    group.oldest_request.get_or_insert_with(Instant::now);
+    let seq = group.requested_seq;
+
+    if group.due() {
+        if let Err(e) = commit_handle(handle) {
+            return unsafe { set_error(error, MemvidError::from_core_error(e)) };
+        }
+    }
+
+    unsafe { set_ok(error) };
+    seq
+}
+
+/// Get the highest durable sequence number, flushing if the window elapsed.
+///
+/// Producers that stop issuing requests should call this periodically so
+/// the last coalesced requests are flushed.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Highest durable sequence number (0 if none yet). On a failed flush the
+/// previous durable sequence is returned with `error` set.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_commit_poll(
+    handle: *mut MemvidHandle,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if handle.group_commit.due() {
+        if let Err(e) = commit_handle(handle) {
+            unsafe { set_error::<()>(error, MemvidError::from_core_error(e)) };
+            return handle.group_commit.durable_seq;
+        }
+    }
+
+    unsafe { set_ok(error) };
+    handle.group_commit.durable_seq
+}
+
+/// Flush all pending commit requests now.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Highest durable sequence number on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_commit_flush(
+    handle: *mut MemvidHandle,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if handle.group_commit.oldest_request.is_some() {
+        if let Err(e) = commit_handle(handle) {
+            return unsafe { set_error(error, MemvidError::from_core_error(e)) };
+        }
+    }
+
+    unsafe { set_ok(error) };
+    handle.group_commit.durable_seq
+}
+
+/// Add a batch of documents in a single call.
+///
+/// Shared options are parsed once for the whole batch; each item may carry
+/// its own options JSON whose fields override the shared ones. A failing
+/// item does not abort the batch: its slot in `frame_ids` is set to 0 and
+/// its error code is written to `codes`.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `items`: Array of `count` item descriptors
+/// - `count`: Number of items
+/// - `shared_options_json`: JSON string with PutOptions applied to every item (NULL for defaults)
+/// - `frame_ids`: Out-array of `count` frame IDs (must not be NULL when `count > 0`)
+/// - `codes`: Out-array of `count` per-item error codes (NULL to skip)
+/// - `error`: Out-parameter for batch-level error information
+///
+/// # Returns
+///
+/// Number of items stored successfully. On a batch-level failure (invalid
+/// handle, NULL arrays, malformed shared options) nothing is stored and 0 is
+/// returned with `error` set.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `items` must point to `count` valid descriptors, each satisfying the
+///   requirements of `memvid_put_bytes_with_options`
+/// - `frame_ids` must point to space for `count` values
+/// - `codes` must point to space for `count` values or be NULL
+/// - `shared_options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_many(
+    handle: *mut MemvidHandle,
+    items: *const MemvidPutItem,
+    count: size_t,
+    shared_options_json: *const c_char,
+    frame_ids: *mut u64,
+    codes: *mut MemvidErrorCode,
+    error: *mut MemvidError,
+) -> size_t {
+    let mut span = Span::start(Op::PutMany);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if count == 0 {
+        unsafe { set_ok(error) };
+        return 0;
+    }
+    if items.is_null() {
+        return unsafe { set_error(error, MemvidError::null_pointer("items")) };
+    }
+    if frame_ids.is_null() {
+        return unsafe { set_error(error, MemvidError::null_pointer("frame_ids")) };
+    }
+
+    // Parse shared options once for the whole batch
+    let shared_json = unsafe { cstr_to_option_str(shared_options_json, "shared_options_json") };
+    let shared = match shared_json {
+        Ok(Some(json_str)) => match serde_json::from_str::<PutOptionsJson>(json_str) {
+            Ok(opts) => Some(opts),
+            Err(e) => return unsafe { set_error(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => None,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+    let shared_options = shared.clone().map(PutOptionsJson::into_put_options);
+    span.phase(Phase::Parse);
+
+    let items = unsafe { std::slice::from_raw_parts(items, count) };
+    let frame_ids = unsafe { std::slice::from_raw_parts_mut(frame_ids, count) };
+    let mut codes = if codes.is_null() {
+        None
+    } else {
+        Some(unsafe { std::slice::from_raw_parts_mut(codes, count) })
+    };
+
+    // Content is hashed for the dedup filter up front, across threads
+    let contents: Vec<&[u8]> = items
+        .iter()
+        .map(|item| {
+            if item.data.is_null() || item.len == 0 {
+                &[][..]
+            } else {
+                unsafe { std::slice::from_raw_parts(item.data, item.len) }
+            }
+        })
+        .collect();
+    let hashes = handle
+        .dedup
+        .is_usable(handle.as_ref().frame_count())
+        .then(|| dedup::content_hashes(&contents));
+    let mut stored = 0;
+    let mut stored_bytes = 0u64;
+
+    for (i, item) in items.iter().enumerate() {
+        let result = if item.data.is_null() && item.len > 0 {
+            Err(MemvidErrorCode::NullPointer)
+        } else {
+            let slice = contents[i];
+
+            let item_json = unsafe { cstr_to_option_str(item.options_json, "options_json") };
+            let options = match item_json {
+                Ok(Some(json_str)) => match serde_json::from_str::<PutOptionsJson>(json_str) {
+                    Ok(overrides) => Ok(Some(match &shared {
+                        Some(base) => base.merged(overrides).into_put_options(),
+                        None => overrides.into_put_options(),
+                    })),
+                    Err(_) => Err(MemvidErrorCode::JsonParse),
+                },
+                Ok(None) => Ok(shared_options.clone()),
+                Err(_) => Err(MemvidErrorCode::InvalidUtf8),
+            };
+
+            options.and_then(|options| {
+                let hash = hashes.as_ref().map(|h| h[i]);
+                let dedup = options.as_ref().is_some_and(|o| o.dedup);
+                dedup::put_checked(handle, slice, hash, dedup, |memvid, lookup| match options {
+                    Some(options) => memvid.put_bytes_with_options(
+                        slice,
+                        PutOptions {
+                            dedup: lookup,
+                            ..options
+                        },
+                    ),
+                    None => memvid.put_bytes(slice),
+                })
+                .map_err(|e| error_code_from_core(&e))
+            })
+        };
+
+        let code = match result {
+            Ok(frame_id) => {
+                frame_ids[i] = frame_id;
+                stored += 1;
+                stored_bytes += item.len as u64;
+                MemvidErrorCode::Ok
+            }
+            Err(code) => {
+                frame_ids[i] = 0;
+                code
+            }
+        };
+        if let Some(codes) = codes.as_deref_mut() {
+            codes[i] = code;
+        }
+    }
+
+    handle.group_commit.pending_bytes += stored_bytes;
+    span.bytes_in(items.iter().map(|item| item.len).sum());
+    // Per-item option parsing is counted with the puts it interleaves with
+    span.phase(Phase::Core);
+    unsafe { set_ok(error) };
+    stored
+}
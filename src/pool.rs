@@ -0,0 +1,368 @@
+//! Shared read-only handle pool for concurrent queries.
+
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::util::{cstr_to_path, set_error, set_error_null, set_ok};
+use std::collections::HashMap;
+use std::os::raw::c_char;
+use std::path::PathBuf;
+use std::sync::{Condvar, Mutex};
+
+/// Handle checked into the pool, tagged with the generation it was opened at.
+struct IdleReader {
+    handle: Box<MemvidHandle>,
+    generation: u64,
+}
+
+/// Mutable pool state, guarded by `MemvidReaderPool::state`.
+struct PoolState {
+    /// Readers available for checkout
+    idle: Vec<IdleReader>,
+    /// Checked-out readers: handle address -> generation
+    checked_out: HashMap<usize, u64>,
+    /// Readers opened so far (idle + checked out + being opened)
+    opened: usize,
+    /// Bumped by refresh; readers from older generations are reopened
+    generation: u64,
+}
+
+/// Pool of read-only handles over a single memory file.
+///
+/// Each view handed out by `memvid_reader_pool_acquire` is an ordinary
+/// `MemvidHandle` opened read-only, so the existing read entry points
+/// (`memvid_search`, `memvid_frame_by_id`, `memvid_timeline`, `memvid_ask`,
+/// ...) work on it unchanged. A view is owned by one thread at a time; the
+/// pool itself is thread-safe.
+///
+/// Views observe the file as of the last commit before they were opened.
+/// Call `memvid_reader_pool_refresh` after a writer commits to have views
+/// reopened (lazily, on their next checkout) at the newer snapshot.
+pub struct MemvidReaderPool {
+    path: PathBuf,
+    max_readers: usize,
+    state: Mutex<PoolState>,
+    available: Condvar,
+}
+
+impl MemvidReaderPool {
+    /// Convert a raw pointer to a shared reference.
+    ///
+    /// # Safety
+    ///
+    /// The pointer must be valid or null.
+    pub(crate) unsafe fn from_ptr<'a>(ptr: *mut MemvidReaderPool) -> Option<&'a Self> {
+        unsafe { ptr.as_ref() }
+    }
+
+    fn open_reader(&self) -> Result<Box<MemvidHandle>, MemvidError> {
+        memvid_core::Memvid::open_read_only(&self.path)
+            .map(|memvid| MemvidHandle::read_only(memvid, self.path.clone()))
+            .map_err(MemvidError::from_core_error)
+    }
+
+    fn lock(&self) -> std::sync::MutexGuard<'_, PoolState> {
+        // A panic while holding the lock cannot leave PoolState inconsistent
+        self.state.lock().unwrap_or_else(|e| e.into_inner())
+    }
+
+    /// Check out a reader, opening or reopening one as needed.
+    fn acquire(&self) -> Result<*mut MemvidHandle, MemvidError> {
+        self.acquire_with_generation().map(|(ptr, _)| ptr)
+    }
+
+    /// Check out a reader and report the snapshot generation it observes.
+    pub(crate) fn acquire_with_generation(&self) -> Result<(*mut MemvidHandle, u64), MemvidError> {
+        self.checkout(None)
+            .map(|view| view.expect("blocking checkout always yields a reader"))
+    }
+
+    /// Check out another reader at `generation` without blocking.
+    ///
+    /// Returns `None` when every reader is in use or the pool has been
+    /// refreshed past `generation`.
+    pub(crate) fn try_acquire_at(
+        &self,
+        generation: u64,
+    ) -> Result<Option<*mut MemvidHandle>, MemvidError> {
+        self.checkout(Some(generation))
+            .map(|view| view.map(|(ptr, _)| ptr))
+    }
+
+    /// Shared checkout path.
+    ///
+    /// With `want` unset, blocks until a reader is available and always
+    /// returns one. With `want` set, returns `None` instead of blocking or
+    /// handing out a reader from a different generation.
+    fn checkout(&self, want: Option<u64>) -> Result<Option<(*mut MemvidHandle, u64)>, MemvidError> {
+        let mut state = self.lock();
+        loop {
+            let generation = state.generation;
+            if want.is_some_and(|g| g != generation) {
+                return Ok(None);
+            }
+
+            if let Some(reader) = state.idle.pop() {
+                if reader.generation == generation {
+                    let ptr = Box::into_raw(reader.handle);
+                    state.checked_out.insert(ptr as usize, generation);
+                    return Ok(Some((ptr, generation)));
+                }
+
+                // Stale snapshot: reopen outside the lock
+                drop(state);
+                let reopened = self.open_reader();
+                state = self.lock();
+                return match reopened {
+                    Ok(handle) => {
+                        drop(reader);
+                        let ptr = Box::into_raw(handle);
+                        state.checked_out.insert(ptr as usize, generation);
+                        Ok(Some((ptr, generation)))
+                    }
+                    Err(e) => {
+                        state.idle.push(reader);
+                        self.available.notify_one();
+                        Err(e)
+                    }
+                };
+            }
+
+            if state.opened < self.max_readers {
+                state.opened += 1;
+                drop(state);
+                let opened = self.open_reader();
+                state = self.lock();
+                return match opened {
+                    Ok(handle) => {
+                        let ptr = Box::into_raw(handle);
+                        state.checked_out.insert(ptr as usize, generation);
+                        Ok(Some((ptr, generation)))
+                    }
+                    Err(e) => {
+                        state.opened -= 1;
+                        Err(e)
+                    }
+                };
+            }
+
+            if want.is_some() {
+                return Ok(None);
+            }
+
+            state = self
+                .available
+                .wait(state)
+                .unwrap_or_else(|e| e.into_inner());
+        }
+    }
+
+    /// Return a checked-out reader. Returns false if `view` is not ours.
+    pub(crate) fn release(&self, view: *mut MemvidHandle) -> bool {
+        let mut state = self.lock();
+        let Some(generation) = state.checked_out.remove(&(view as usize)) else {
+            return false;
+        };
+        let handle = unsafe { Box::from_raw(view) };
+        state.idle.push(IdleReader { handle, generation });
+        self.available.notify_one();
+        true
+    }
+}
+
+/// Open a pool of read-only views over an existing memory.
+///
+/// One reader is opened immediately to validate the file; the rest are opened
+/// on demand, up to `max_readers`.
+///
+/// # Parameters
+///
+/// - `path`: Filesystem path to existing memory (UTF-8 encoded, null-terminated)
+/// - `max_readers`: Maximum concurrent views (0 for the number of CPUs)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Pool on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned pool. Must call `memvid_reader_pool_close()` to free.
+///
+/// # Safety
+///
+/// - `path` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_open(
+    path: *const c_char,
+    max_readers: u32,
+    error: *mut MemvidError,
+) -> *mut MemvidReaderPool {
+    let path = match unsafe { cstr_to_path(path) } {
+        Ok(p) => p,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let max_readers = if max_readers == 0 {
+        std::thread::available_parallelism().map_or(1, |n| n.get())
+    } else {
+        max_readers as usize
+    };
+
+    let first = match memvid_core::Memvid::open_read_only(&path) {
+        Ok(memvid) => MemvidHandle::read_only(memvid, path.clone()),
+        Err(e) => return unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+    };
+
+    let pool = MemvidReaderPool {
+        path,
+        max_readers,
+        state: Mutex::new(PoolState {
+            idle: vec![IdleReader {
+                handle: first,
+                generation: 0,
+            }],
+            checked_out: HashMap::new(),
+            opened: 1,
+            generation: 0,
+        }),
+        available: Condvar::new(),
+    };
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(pool))
+}
+
+/// Check out a read-only view from the pool.
+///
+/// Blocks while all `max_readers` views are checked out.
+///
+/// # Parameters
+///
+/// - `pool`: Valid reader pool
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Read-only handle on success, NULL on failure. The handle can be passed to
+/// any read entry point; mutations fail with a core error.
+///
+/// # Ownership
+///
+/// The view belongs to the pool. Return it with `memvid_reader_pool_release()`;
+/// never pass it to `memvid_close()`.
+///
+/// # Safety
+///
+/// - `pool` must be a valid pool
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_acquire(
+    pool: *mut MemvidReaderPool,
+    error: *mut MemvidError,
+) -> *mut MemvidHandle {
+    let pool = match unsafe { MemvidReaderPool::from_ptr(pool) } {
+        Some(p) => p,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("pool")) },
+    };
+
+    match pool.acquire() {
+        Ok(view) => {
+            unsafe { set_ok(error) };
+            view
+        }
+        Err(e) => unsafe { set_error_null(error, e) },
+    }
+}
+
+/// Return a view to the pool.
+///
+/// # Parameters
+///
+/// - `pool`: Valid reader pool
+/// - `view`: View from `memvid_reader_pool_acquire()` on this pool
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 if `view` was not checked out from this pool.
+///
+/// # Safety
+///
+/// - `pool` must be a valid pool
+/// - `view` must not be used after this call
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_release(
+    pool: *mut MemvidReaderPool,
+    view: *mut MemvidHandle,
+    error: *mut MemvidError,
+) -> i32 {
+    let pool = match unsafe { MemvidReaderPool::from_ptr(pool) } {
+        Some(p) => p,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("pool")) },
+    };
+
+    if pool.release(view) {
+        unsafe { set_ok(error) };
+        1
+    } else {
+        unsafe { set_error(error, MemvidError::invalid_handle()) }
+    }
+}
+
+/// Advance the pool to the latest committed snapshot.
+///
+/// Views checked out afterwards observe all commits made before this call.
+/// Views currently checked out keep their snapshot until released; readers
+/// are reopened lazily on their next checkout.
+///
+/// # Parameters
+///
+/// - `pool`: Valid reader pool
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// The new snapshot generation (starting at 1), 0 on failure.
+///
+/// # Safety
+///
+/// - `pool` must be a valid pool
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_refresh(
+    pool: *mut MemvidReaderPool,
+    error: *mut MemvidError,
+) -> u64 {
+    let pool = match unsafe { MemvidReaderPool::from_ptr(pool) } {
+        Some(p) => p,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("pool")) },
+    };
+
+    let mut state = pool.lock();
+    state.generation += 1;
+    unsafe { set_ok(error) };
+    state.generation
+}
+
+/// Close a reader pool and all of its idle views.
+///
+/// # Parameters
+///
+/// - `pool`: Pool to close (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `pool` must be a valid pool returned by `memvid_reader_pool_open`, or NULL
+/// - All views must have been released; the pool must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_close(pool: *mut MemvidReaderPool) {
+    if pool.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(pool));
+    }
+}
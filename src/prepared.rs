@@ -0,0 +1,255 @@
+//! Prepared search queries.
+//!
+//! Dashboards run the same query shape with different parameters. A
+//! prepared query parses the request JSON once and keeps the matching set
+//! of its tag, label and kind filters. Each execution binds parameters
+//! from a `MemvidPreparedParams` struct, so nothing is parsed. When frames
+//! are appended, only the new frames are matched against the filters. The
+//! set is rebuilt from scratch only when frame IDs are reassigned, as after
+//! compaction.
+//!
+//! memvid-core takes its query as text and has no API for reusing a parsed
+//! plan or resolved terms, so the engine still tokenizes the query on each
+//! execution.
+
+use crate::arena::Output;
+use crate::error::MemvidError;
+use crate::filter::{ResolvedFilter, SearchFiltersJson};
+use crate::handle::MemvidHandle;
+use crate::metrics::{Op, Phase, Span};
+use crate::search::{search_request_to, SearchRequestJson};
+use crate::util::{cstr_to_str, set_error_null, set_ok, MemvidStr};
+use std::borrow::Cow;
+use std::os::raw::c_char;
+
+/// Parameters bound to one execution of a prepared query.
+///
+/// Absent strings, zero `top_k` and unset time bounds keep the template's
+/// values. Strings are borrowed for the duration of the call.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidPreparedParams {
+    /// Search query string
+    pub query: MemvidStr,
+    /// Filter to specific URI
+    pub uri: MemvidStr,
+    /// Filter to URI scope/prefix
+    pub scope: MemvidStr,
+    /// Pagination cursor
+    pub cursor: MemvidStr,
+    /// Maximum number of results
+    pub top_k: u64,
+    /// Timestamp lower bound, inclusive (valid when `has_since` is 1)
+    pub since: i64,
+    /// Timestamp upper bound, inclusive (valid when `has_until` is 1)
+    pub until: i64,
+    /// Whether `since` is set
+    pub has_since: u8,
+    /// Whether `until` is set
+    pub has_until: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 6],
+}
+
+/// Search request parsed once and executed many times.
+pub struct MemvidPreparedQuery {
+    template: SearchRequestJson,
+    /// The template's filters
+    filters: SearchFiltersJson,
+    /// Tag, label and kind conditions of `filters`
+    resolved: ResolvedFilter,
+}
+
+impl MemvidPreparedQuery {
+    /// Bind `params` to a copy of the template.
+    ///
+    /// # Safety
+    ///
+    /// Every present string must point to `len` readable bytes.
+    unsafe fn bind(&self, params: &MemvidPreparedParams) -> Result<SearchRequestJson, MemvidError> {
+        let bound = |s: &MemvidStr, name: &str, template: &Option<String>| {
+            unsafe { s.as_str(name) }.map(|s| s.map(str::to_owned).or_else(|| template.clone()))
+        };
+        let mut request = self.template.clone();
+        if let Some(query) = unsafe { params.query.as_str("query") }? {
+            request.query = query.to_owned();
+        }
+        request.uri = bound(&params.uri, "uri", &self.template.uri)?;
+        request.scope = bound(&params.scope, "scope", &self.template.scope)?;
+        request.cursor = bound(&params.cursor, "cursor", &self.template.cursor)?;
+        if params.top_k > 0 {
+            request.top_k = params.top_k as usize;
+        }
+        Ok(request)
+    }
+
+    /// Time bounds for this execution.
+    fn time(&self, params: &MemvidPreparedParams) -> (Option<i64>, Option<i64>) {
+        (
+            (params.has_since != 0)
+                .then_some(params.since)
+                .or(self.filters.since()),
+            (params.has_until != 0)
+                .then_some(params.until)
+                .or(self.filters.until()),
+        )
+    }
+}
+
+/// Prepare a search request for repeated execution.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle; the template's filters are resolved
+///   against it right away
+/// - `template_json`: SearchRequest JSON (see `memvid_search`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Prepared query on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned query. Must call `memvid_prepared_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `template_json` must be a valid UTF-8 string
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_prepare_search(
+    handle: *mut MemvidHandle,
+    template_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidPreparedQuery {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let parsed = unsafe { cstr_to_str(template_json, "template_json") }.and_then(|json| {
+        serde_json::from_str::<SearchRequestJson>(json).map_err(MemvidError::json_parse)
+    });
+    let mut template = match parsed {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let filters = template.filters.take().unwrap_or_default();
+    let mut prepared = MemvidPreparedQuery {
+        resolved: ResolvedFilter::new(filters.without_time()),
+        filters,
+        template,
+    };
+    let owner = handle.id;
+    prepared.resolved.refresh(owner, handle.metadata_index());
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(prepared))
+}
+
+/// Execute a prepared query with bound parameters.
+///
+/// Behaves like `memvid_search` with the template's request and the bound
+/// parameters, including the result cache, but nothing is parsed and the
+/// filter's matching set is reused. A prepared query may run on a handle
+/// other than the one it was prepared on; its matching set is then rebuilt.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `prepared`: Prepared query from `memvid_prepare_search()`
+/// - `params`: Bound parameters (NULL to run the template as is)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON SearchResponse (see `memvid_search`), NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned string. Must call `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` and `prepared` must be valid
+/// - `params` must be NULL or valid, with present strings pointing to `len`
+///   readable bytes
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_execute_prepared(
+    handle: *mut MemvidHandle,
+    prepared: *mut MemvidPreparedQuery,
+    params: *const MemvidPreparedParams,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::ExecutePrepared);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+    let prepared = match unsafe { prepared.as_mut() } {
+        Some(p) => p,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("prepared")) },
+    };
+
+    let params = unsafe { params.as_ref() }.copied().unwrap_or_default();
+    let mut request = match unsafe { prepared.bind(&params) } {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+    let (since, until) = prepared.time(&params);
+    span.phase(Phase::Parse);
+
+    let owner = handle.id;
+    let timed = since.is_some() || until.is_some();
+    let time_set = timed.then(|| {
+        handle
+            .metadata_index()
+            .matching(&SearchFiltersJson::time(since, until))
+    });
+    // The filters go on the request so cache keys tell bindings apart
+    request.filters = Some(prepared.filters.with_time(since, until));
+    let matching = if prepared.resolved.is_active() {
+        let resolved = prepared.resolved.refresh(owner, handle.metadata_index());
+        Some(match time_set {
+            Some(time_set) => Cow::Owned(resolved.intersect(&time_set)),
+            None => Cow::Borrowed(resolved),
+        })
+    } else {
+        time_set.map(Cow::Owned)
+    };
+    unsafe {
+        search_request_to(
+            handle,
+            request,
+            matching.as_deref(),
+            Output::Heap,
+            span,
+            error,
+        )
+    }
+}
+
+/// Free a prepared query.
+///
+/// # Parameters
+///
+/// - `prepared`: Prepared query to free (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `prepared` must be a valid prepared query or NULL
+/// - The query must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_prepared_free(prepared: *mut MemvidPreparedQuery) {
+    if prepared.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(prepared));
+    }
+}
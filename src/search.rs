@@ -1,31 +1,62 @@
 //! Search functions.
 
+use crate::arena::{MemvidArena, Output};
+use crate::cache::QueryKind;
 use crate::error::MemvidError;
+use crate::filter::{FrameSet, SearchFiltersJson};
 use crate::handle::MemvidHandle;
-use crate::util::{cstr_to_string, set_error_null, set_ok, string_to_cstr};
+use crate::metrics::{Op, Phase, Span};
+use crate::pool::MemvidReaderPool;
+use crate::util::{cstr_to_str, set_error, set_error_null, set_ok, string_to_cstr, MemvidStr};
+use libc::size_t;
 use serde::{Deserialize, Serialize};
+use std::collections::HashSet;
+use std::ffi::CStr;
 use std::os::raw::c_char;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+/// Filters matching at most this many frames are searched one URI at a
+/// time instead of over-fetching the unrestricted ranking
+const DIRECT_LOOKUP_FRAMES: usize = 32;
 
 /// JSON schema for SearchRequest input.
-#[derive(Debug, Deserialize)]
-struct SearchRequestJson {
+#[derive(Debug, Clone, Deserialize, Serialize)]
+pub(crate) struct SearchRequestJson {
     /// Search query string
-    query: String,
+    pub(crate) query: String,
     /// Maximum number of results (default: 10)
     #[serde(default = "default_top_k")]
-    top_k: usize,
+    pub(crate) top_k: usize,
     /// Characters of context around matches (default: 200)
     #[serde(default = "default_snippet_chars")]
-    snippet_chars: usize,
+    pub(crate) snippet_chars: usize,
     /// Filter to specific URI
     #[serde(default)]
-    uri: Option<String>,
+    pub(crate) uri: Option<String>,
     /// Filter to URI scope/prefix
     #[serde(default)]
-    scope: Option<String>,
+    pub(crate) scope: Option<String>,
     /// Pagination cursor
     #[serde(default)]
-    cursor: Option<String>,
+    pub(crate) cursor: Option<String>,
+    /// Drop hits scoring below this (hits without a score are dropped too)
+    #[serde(default)]
+    pub(crate) min_score: Option<f32>,
+    /// Return ranks, frame IDs and scores only: no snippets or context
+    #[serde(default)]
+    pub(crate) ids_only: bool,
+    /// Maximum hits the engine is asked for, including the filter over-fetch
+    #[serde(default)]
+    pub(crate) max_candidates: Option<usize>,
+    /// Time budget in microseconds, counted from the start of the call and
+    /// checked before each step that can be skipped
+    #[serde(default)]
+    pub(crate) time_budget_us: Option<u64>,
+    /// Metadata filters resolved against the handle's posting sets
+    #[serde(default)]
+    pub(crate) filters: Option<SearchFiltersJson>,
 }
 
 fn default_top_k() -> usize {
@@ -40,8 +71,11 @@ impl SearchRequestJson {
     fn into_search_request(self) -> memvid_core::SearchRequest {
         memvid_core::SearchRequest {
             query: self.query,
-            top_k: self.top_k,
-            snippet_chars: self.snippet_chars,
+            top_k: self
+                .max_candidates
+                .map_or(self.top_k, |m| m.min(self.top_k)),
+            // Snippets are not returned, so have the engine extract none
+            snippet_chars: if self.ids_only { 0 } else { self.snippet_chars },
             uri: self.uri,
             scope: self.scope,
             cursor: self.cursor,
@@ -52,50 +86,318 @@ impl SearchRequestJson {
             no_sketch: false,
         }
     }
+
+    /// Run the request on `handle`, applying filters and `min_score`.
+    ///
+    /// Returns the response with the limits used to serialize it; the time
+    /// budget starts here. Every hit the engine ranks is kept: the budget
+    /// only skips the work after it, and marks the response partial if it
+    /// did.
+    pub(crate) fn run(
+        self,
+        handle: &mut MemvidHandle,
+    ) -> Result<(memvid_core::SearchResponse, ResponseLimits), memvid_core::MemvidError> {
+        self.run_with(handle, None)
+    }
+
+    /// Run the request, taking its filter's matching set from `matching`
+    /// when given instead of resolving `filters` against the handle.
+    pub(crate) fn run_with(
+        mut self,
+        handle: &mut MemvidHandle,
+        matching: Option<&FrameSet>,
+    ) -> Result<(memvid_core::SearchResponse, ResponseLimits), memvid_core::MemvidError> {
+        let budget = Budget::start(self.time_budget_us);
+        let mut limits = ResponseLimits {
+            ids_only: self.ids_only,
+            partial: false,
+        };
+        let min_score = self.min_score;
+        let filters = self.filters.take().filter(|f| !f.is_empty());
+        let mut response = match (matching, filters) {
+            (Some(matching), _) => self.run_filtered(handle, matching, budget, &mut limits)?,
+            (None, Some(filters)) => {
+                let matching = handle.metadata_index().matching(&filters);
+                self.run_filtered(handle, &matching, budget, &mut limits)?
+            }
+            (None, None) => handle.as_mut().search(self.into_search_request())?,
+        };
+        if let Some(min_score) = min_score {
+            let offset = response.hits.first().map_or(0, |hit| hit.rank.saturating_sub(1));
+            let returned = response.hits.len();
+            // Hits are ranked by score, so the survivors keep their ranks
+            response
+                .hits
+                .retain(|hit| hit.score.is_some_and(|s| s >= min_score));
+            if response.hits.len() < returned {
+                // No hit past the first dropped one clears the cutoff either
+                response.total_hits = offset + response.hits.len();
+                response.next_cursor = None;
+                response.context = limits.context(&response.hits, budget);
+            }
+        }
+        Ok((response, limits))
+    }
+
+    /// Search keeping only hits whose frame is in `matching`.
+    ///
+    /// Small matching sets are looked up through their URIs, see
+    /// `run_direct`. Otherwise the engine is asked for enough hits to
+    /// expect `top_k` matches at the filter's selectivity, and the fetch
+    /// doubles until `top_k` matches are found, the engine runs out of
+    /// hits, or the fetch reaches `max_candidates`. An empty matching set
+    /// asks the engine for no hits.
+    /// `total_hits` becomes an upper bound: the smaller of the engine's
+    /// total and the matching set size. If the budget runs out between
+    /// fetches, the matches found so far are returned and `limits` is marked
+    /// partial.
+    ///
+    /// Filtered results come back as a single page: engine cursors page the
+    /// unfiltered ranking, so `cursor` is ignored and `next_cursor` is null.
+    fn run_filtered(
+        mut self,
+        handle: &mut MemvidHandle,
+        matching: &FrameSet,
+        budget: Budget,
+        limits: &mut ResponseLimits,
+    ) -> Result<memvid_core::SearchResponse, memvid_core::MemvidError> {
+        self.cursor = None;
+        if let Some(response) = self.run_direct(handle, matching, budget, limits)? {
+            return Ok(response);
+        }
+        let indexed = handle.metadata_index().frames().max(1) as usize;
+        let top_k = self.top_k;
+        let cap = self.max_candidates.unwrap_or(usize::MAX);
+
+        let mut fetch = if matching.is_empty() {
+            0
+        } else {
+            top_k
+                .saturating_mul(indexed.div_ceil(matching.len()))
+                .min(indexed)
+                .max(top_k)
+                .min(cap)
+        };
+        loop {
+            let mut request = self.clone().into_search_request();
+            request.top_k = fetch;
+            let mut response = handle.as_mut().search(request)?;
+            let exhausted = matching.is_empty()
+                || response.hits.len() < fetch
+                || fetch >= response.total_hits
+                || fetch >= cap;
+            response.hits.retain(|hit| matching.contains(hit.frame_id));
+            let filled = response.hits.len() >= top_k || exhausted;
+            if filled || budget.expired() {
+                limits.partial |= !filled;
+                response.hits.truncate(top_k);
+                for (i, hit) in response.hits.iter_mut().enumerate() {
+                    hit.rank = i + 1;
+                }
+                response.total_hits = response.total_hits.min(matching.len());
+                response.context = limits.context(&response.hits, budget);
+                response.next_cursor = None;
+                return Ok(response);
+            }
+            fetch = fetch.saturating_mul(2).min(response.total_hits).min(cap);
+        }
+    }
+
+    /// Search a small matching set through the URIs of its frames.
+    ///
+    /// The engine filters only by URI, so each distinct URI among the
+    /// matching frames is searched on its own, doubling the fetch until its
+    /// matching frames have all been ranked or the engine runs out of hits.
+    /// Hits are then merged by score, so the work follows the size of the
+    /// matching set rather than its share of the memory. `total_hits` is
+    /// the number of matching frames ranked.
+    ///
+    /// Returns `None`, to over-fetch instead, when the request already
+    /// restricts URIs, the set is empty or larger than
+    /// `DIRECT_LOOKUP_FRAMES`, or a matching frame has no URI.
+    fn run_direct(
+        &self,
+        handle: &mut MemvidHandle,
+        matching: &FrameSet,
+        budget: Budget,
+        limits: &mut ResponseLimits,
+    ) -> Result<Option<memvid_core::SearchResponse>, memvid_core::MemvidError> {
+        if self.uri.is_some()
+            || self.scope.is_some()
+            || matching.is_empty()
+            || matching.ids().len() > DIRECT_LOOKUP_FRAMES
+        {
+            return Ok(None);
+        }
+        // Matching frames at each URI, in order of first frame ID
+        let mut uris: Vec<(String, usize)> = Vec::new();
+        for &id in matching.ids() {
+            let Some(uri) = handle.as_mut().frame_by_id(id)?.uri else {
+                return Ok(None);
+            };
+            match uris.iter_mut().find(|(u, _)| *u == uri) {
+                Some((_, count)) => *count += 1,
+                None => uris.push((uri, 1)),
+            }
+        }
+
+        let top_k = self.top_k;
+        let cap = self.max_candidates.unwrap_or(usize::MAX);
+        let mut merged: Option<memvid_core::SearchResponse> = None;
+        let mut hits: Vec<memvid_core::SearchHit> = Vec::new();
+        'uris: for (uri, count) in uris {
+            let wanted = count.min(top_k);
+            let mut fetch = wanted.min(cap);
+            loop {
+                if merged.is_some() && budget.expired() {
+                    limits.partial = true;
+                    break 'uris;
+                }
+                let mut request = self.clone().into_search_request();
+                request.uri = Some(uri.clone());
+                request.top_k = fetch;
+                let mut response = handle.as_mut().search(request)?;
+                let exhausted =
+                    response.hits.len() < fetch || fetch >= response.total_hits || fetch >= cap;
+                let mut found = std::mem::take(&mut response.hits);
+                // A frame has a single URI, so only hits within one can repeat it
+                let mut ranked = HashSet::new();
+                found.retain(|hit| matching.contains(hit.frame_id) && ranked.insert(hit.frame_id));
+                merged.get_or_insert(response);
+                if found.len() >= wanted || exhausted {
+                    hits.extend(found);
+                    break;
+                }
+                fetch = fetch.saturating_mul(2).min(cap);
+            }
+        }
+
+        let Some(mut response) = merged else {
+            return Ok(None);
+        };
+        // Hits without a score rank last, as they do in the engine
+        hits.sort_by(|a, b| {
+            b.score
+                .partial_cmp(&a.score)
+                .unwrap_or(std::cmp::Ordering::Equal)
+        });
+        response.total_hits = hits.len();
+        hits.truncate(top_k);
+        for (i, hit) in hits.iter_mut().enumerate() {
+            hit.rank = i + 1;
+        }
+        response.hits = hits;
+        response.context = limits.context(&response.hits, budget);
+        response.next_cursor = None;
+        Ok(Some(response))
+    }
+}
+
+/// Context text for hits, one hit per paragraph.
+pub(crate) fn join_context<'a>(texts: impl Iterator<Item = &'a str>) -> String {
+    texts
+        .filter(|t| !t.is_empty())
+        .collect::<Vec<_>>()
+        .join("\n\n")
+}
+
+/// Deadline of a request's time budget.
+#[derive(Debug, Clone, Copy)]
+struct Budget(Option<Instant>);
+
+impl Budget {
+    fn start(budget_us: Option<u64>) -> Self {
+        Self(budget_us.map(|us| Instant::now() + Duration::from_micros(us)))
+    }
+
+    /// Whether the time budget has run out.
+    fn expired(self) -> bool {
+        self.0.is_some_and(|d| Instant::now() >= d)
+    }
+}
+
+/// Request options that shape the serialized response.
+#[derive(Debug, Default, Clone, Copy)]
+pub(crate) struct ResponseLimits {
+    /// Serialize ranks, frame IDs and scores only
+    ids_only: bool,
+    /// The time budget ran out before the search finished
+    partial: bool,
+}
+
+impl ResponseLimits {
+    /// Context text for `hits`, or none for `ids_only` or once the budget
+    /// has run out; the latter marks the response partial.
+    fn context(&mut self, hits: &[memvid_core::SearchHit], budget: Budget) -> String {
+        if self.ids_only {
+            return String::new();
+        }
+        if budget.expired() {
+            self.partial = true;
+            return String::new();
+        }
+        join_context(hits.iter().map(|hit| hit.text.as_str()))
+    }
+}
+
+/// Parse a search request from a C JSON string.
+///
+/// # Safety
+///
+/// `request_json` must be null or a valid null-terminated C string.
+pub(crate) unsafe fn parse_search_request(
+    request_json: *const c_char,
+    span: &mut Span,
+) -> Result<SearchRequestJson, MemvidError> {
+    let json_str = unsafe { cstr_to_str(request_json, "request_json") }?;
+    span.bytes_in(json_str.len());
+    serde_json::from_str(json_str).map_err(MemvidError::json_parse)
 }
 
 /// JSON schema for SearchResponse output.
 #[derive(Debug, Serialize)]
-struct SearchResponseJson {
+pub(crate) struct SearchResponseJson {
     /// Original query
-    query: String,
+    pub(crate) query: String,
     /// Execution time in milliseconds
-    elapsed_ms: u128,
+    pub(crate) elapsed_ms: u128,
     /// Total number of hits (may exceed returned hits due to pagination)
-    total_hits: usize,
+    pub(crate) total_hits: usize,
     /// Search hits
-    hits: Vec<SearchHitJson>,
+    pub(crate) hits: Vec<SearchHitJson>,
     /// Concatenated context from all hits
-    context: String,
+    pub(crate) context: String,
     /// Cursor for next page (null if no more results)
-    next_cursor: Option<String>,
+    pub(crate) next_cursor: Option<String>,
     /// Search engine used
-    engine: String,
+    pub(crate) engine: String,
+    /// True when the time budget ran out before the search finished
+    pub(crate) partial: bool,
 }
 
 /// JSON schema for individual search hit.
 #[derive(Debug, Serialize)]
-struct SearchHitJson {
+pub(crate) struct SearchHitJson {
     /// Result rank (1-based)
-    rank: usize,
+    pub(crate) rank: usize,
     /// Frame ID
-    frame_id: u64,
+    pub(crate) frame_id: u64,
     /// Document URI
-    uri: String,
+    pub(crate) uri: String,
     /// Document title
-    title: Option<String>,
+    pub(crate) title: Option<String>,
     /// Snippet text with context
-    text: String,
+    pub(crate) text: String,
     /// Character range in document (start, end)
-    range: (usize, usize),
+    pub(crate) range: (usize, usize),
     /// Number of keyword matches
-    matches: usize,
+    pub(crate) matches: usize,
     /// Relevance score
-    score: Option<f32>,
+    pub(crate) score: Option<f32>,
     /// Tags
-    tags: Vec<String>,
+    pub(crate) tags: Vec<String>,
     /// Labels
-    labels: Vec<String>,
+    pub(crate) labels: Vec<String>,
 }
 
 impl From<&memvid_core::SearchHit> for SearchHitJson {
@@ -121,20 +423,62 @@ impl From<&memvid_core::SearchHit> for SearchHitJson {
     }
 }
 
-impl From<&memvid_core::SearchResponse> for SearchResponseJson {
-    fn from(resp: &memvid_core::SearchResponse) -> Self {
+impl SearchHitJson {
+    /// Hit with only its rank, frame ID and scoring fields.
+    fn ids_only(hit: &memvid_core::SearchHit) -> Self {
+        Self {
+            rank: hit.rank,
+            frame_id: hit.frame_id,
+            uri: String::new(),
+            title: None,
+            text: String::new(),
+            range: hit.range,
+            matches: hit.matches,
+            score: hit.score,
+            tags: Vec::new(),
+            labels: Vec::new(),
+        }
+    }
+}
+
+impl SearchResponseJson {
+    /// Convert a response, honoring `ids_only` and carrying `partial`.
+    pub(crate) fn with_limits(resp: &memvid_core::SearchResponse, limits: ResponseLimits) -> Self {
+        let hits = resp
+            .hits
+            .iter()
+            .map(|hit| {
+                if limits.ids_only {
+                    SearchHitJson::ids_only(hit)
+                } else {
+                    SearchHitJson::from(hit)
+                }
+            })
+            .collect();
+
         Self {
             query: resp.query.clone(),
             elapsed_ms: resp.elapsed_ms,
             total_hits: resp.total_hits,
-            hits: resp.hits.iter().map(SearchHitJson::from).collect(),
-            context: resp.context.clone(),
+            hits,
+            context: if limits.ids_only {
+                String::new()
+            } else {
+                resp.context.clone()
+            },
             next_cursor: resp.next_cursor.clone(),
             engine: format!("{:?}", resp.engine),
+            partial: limits.partial,
         }
     }
 }
 
+impl From<&memvid_core::SearchResponse> for SearchResponseJson {
+    fn from(resp: &memvid_core::SearchResponse) -> Self {
+        Self::with_limits(resp, ResponseLimits::default())
+    }
+}
+
 /// Search the memory.
 ///
 /// # Parameters
@@ -160,10 +504,38 @@ impl From<&memvid_core::SearchResponse> for SearchResponseJson {
 ///   "snippet_chars": 200,
 ///   "uri": "mv2://optional/filter",
 ///   "scope": "mv2://scope/prefix",
-///   "cursor": "pagination_token"
+///   "cursor": "pagination_token",
+///   "min_score": null,
+///   "ids_only": false,
+///   "max_candidates": null,
+///   "time_budget_us": null,
+///   "filters": {
+///     "tags": ["project=alpha"],
+///     "labels": ["notes", "email"],
+///     "kind": "text",
+///     "since": 1700000000,
+///     "until": null
+///   }
 /// }
 /// ```
 ///
+/// `filters` keeps hits whose frame carries every listed tag, at least one
+/// listed label, the given kind, and a timestamp within `since`..=`until`;
+/// each condition is optional. Filters are resolved against per-handle
+/// posting sets and the engine is over-fetched to fill `top_k`, so a
+/// selective filter does not return short pages. Filtered searches return
+/// a single page: `cursor` is ignored and `next_cursor` is null.
+/// `min_score` drops hits scoring below it (and hits without a score).
+/// `ids_only` returns hits with only rank, frame ID, range, matches and
+/// score, an empty `context`, and has the engine extract no snippets.
+/// `max_candidates` caps how many hits the engine is asked for, including
+/// the over-fetch for `filters`, so a filtered search may return fewer than
+/// `top_k` hits. `time_budget_us` counts from the start of the call; the
+/// engine search itself is not interrupted and its hits are always
+/// returned. Once the budget runs out, further filter over-fetches and the
+/// rebuilt `context` are skipped and `partial` is set; partial responses
+/// are not cached.
+///
 /// # Response JSON Schema
 ///
 /// ```json
@@ -187,7 +559,8 @@ impl From<&memvid_core::SearchResponse> for SearchResponseJson {
 ///   ],
 ///   "context": "combined context text",
 ///   "next_cursor": "token_or_null",
-///   "engine": "Tantivy"
+///   "engine": "Tantivy",
+///   "partial": false
 /// }
 /// ```
 ///
@@ -202,39 +575,742 @@ pub unsafe extern "C" fn memvid_search(
     request_json: *const c_char,
     error: *mut MemvidError,
 ) -> *mut c_char {
+    unsafe { search_to(handle, request_json, Output::Heap, error) }
+}
+
+/// Search the memory, allocating the response in an arena.
+///
+/// Same as `memvid_search`, but the response string is bump-allocated in
+/// `arena` instead of the heap.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `request_json`: JSON string with SearchRequest (see `memvid_search`)
+/// - `arena`: Arena that owns the response
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with SearchResponse, NULL on failure.
+///
+/// # Ownership
+///
+/// The string belongs to `arena` and is valid until `memvid_arena_reset()` or
+/// `memvid_arena_destroy()`. Do not pass it to `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `request_json` must be a valid UTF-8 string
+/// - `arena` must be a valid arena
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_search_arena(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    arena: *mut MemvidArena,
+    error: *mut MemvidError,
+) -> *const c_char {
+    let arena = match unsafe { MemvidArena::from_ptr_mut(arena) } {
+        Some(a) => a,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("arena")) },
+    };
+    unsafe { search_to(handle, request_json, Output::Arena(arena), error) }
+}
+
+/// Run `memvid_search`, writing the response to `out`.
+///
+/// # Safety
+///
+/// Same requirements as `memvid_search`.
+unsafe fn search_to(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    out: Output,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::Search);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
     };
 
     // Parse request JSON
-    let json_str = match unsafe { cstr_to_string(request_json, "request_json") } {
-        Ok(s) => s,
+    let request = match unsafe { parse_search_request(request_json, &mut span) } {
+        Ok(r) => r,
         Err(e) => return unsafe { set_error_null(error, e) },
     };
+    span.phase(Phase::Parse);
 
-    let request: SearchRequestJson = match serde_json::from_str(&json_str) {
-        Ok(r) => r,
-        Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
-    };
+    unsafe { search_request_to(handle, request, None, out, span, error) }
+}
+
+/// Run a parsed search request, writing the response to `out`.
+///
+/// Exact repeats are served from the handle's result cache. `matching`
+/// replaces resolving the request's filters, as for
+/// `SearchRequestJson::run_with`.
+///
+/// # Safety
+///
+/// `error` must be a valid pointer or NULL.
+pub(crate) unsafe fn search_request_to(
+    handle: &mut MemvidHandle,
+    request: SearchRequestJson,
+    matching: Option<&FrameSet>,
+    mut out: Output,
+    mut span: Span,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    // Serve exact repeats from the result cache
+    let cache_key = handle.cache.key(QueryKind::Search, &request);
+    if let Some(cached) = cache_key.as_ref().and_then(|k| handle.cache.get(k)) {
+        return match out.copy(cached, &mut span) {
+            Ok(ptr) => {
+                unsafe { set_ok(error) };
+                ptr
+            }
+            Err(e) => unsafe { set_error_null(error, e) },
+        };
+    }
 
     // Perform search
-    let response = match handle.as_mut().search(request.into_search_request()) {
+    let (response, limits) = match request.run_with(handle, matching) {
         Ok(r) => r,
         Err(e) => return unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     };
+    span.phase(Phase::Core);
+    handle.hot_set.record_hits(&response);
+
+    // Serialize response to JSON; partial responses depend on timing, so
+    // they are not cached
+    let response_json = SearchResponseJson::with_limits(&response, limits);
+    match out.json(&response_json, &mut span) {
+        Ok(ptr) => {
+            if let (Some(key), false, false) = (cache_key, ptr.is_null(), response_json.partial) {
+                handle.cache.store(key, unsafe { CStr::from_ptr(ptr) });
+            }
+            unsafe { set_ok(error) };
+            ptr
+        }
+        Err(e) => unsafe { set_error_null(error, e) },
+    }
+}
 
-    // Serialize response to JSON
-    let response_json = SearchResponseJson::from(&response);
-    match serde_json::to_string(&response_json) {
+/// Parse a JSON array of search requests from a C string.
+///
+/// # Safety
+///
+/// `requests_json` must be null or a valid null-terminated C string.
+unsafe fn parse_search_batch(
+    requests_json: *const c_char,
+    span: &mut Span,
+) -> Result<Vec<SearchRequestJson>, MemvidError> {
+    let json_str = unsafe { cstr_to_str(requests_json, "requests_json") }?;
+    span.bytes_in(json_str.len());
+    serde_json::from_str(json_str).map_err(MemvidError::json_parse)
+}
+
+/// Run `requests[i]` for every index claimed from `next`, recording results by index.
+fn run_batch_worker(
+    handle: &mut MemvidHandle,
+    requests: &[Mutex<Option<SearchRequestJson>>],
+    responses: &[Mutex<Option<Result<SearchResponseJson, memvid_core::MemvidError>>>],
+    next: &AtomicUsize,
+) {
+    loop {
+        let index = next.fetch_add(1, Ordering::Relaxed);
+        let Some(slot) = requests.get(index) else {
+            return;
+        };
+        let Some(request) = slot.lock().unwrap_or_else(|e| e.into_inner()).take() else {
+            continue;
+        };
+        let result = request
+            .run(handle)
+            .map(|(r, limits)| SearchResponseJson::with_limits(&r, limits));
+        *responses[index].lock().unwrap_or_else(|e| e.into_inner()) = Some(result);
+    }
+}
+
+/// Serialize batch responses as a JSON array, failing on the first error.
+fn batch_to_cstr(
+    responses: Vec<Result<SearchResponseJson, memvid_core::MemvidError>>,
+    mut span: Span,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    span.phase(Phase::Core);
+    let responses: Vec<SearchResponseJson> = match responses.into_iter().collect() {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+    };
+    match serde_json::to_string(&responses) {
         Ok(s) => {
+            span.phase(Phase::Serialize);
+            span.bytes_out(s.len());
+            let ptr = string_to_cstr(s);
+            span.phase(Phase::Copy);
             unsafe { set_ok(error) };
-            string_to_cstr(s)
+            ptr
         }
         Err(e) => unsafe { set_error_null(error, MemvidError::json_parse(e)) },
     }
 }
 
+/// Run several searches against one handle.
+///
+/// Requests are parsed up front and run back to back against the same open
+/// index, so a batch pays the FFI and JSON overhead once instead of per query.
+/// Use `memvid_reader_pool_search_batch()` to spread a batch across cores.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `requests_json`: JSON array of SearchRequest objects (see `memvid_search`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON array of SearchResponse objects in request order, NULL on failure.
+/// The whole batch fails if any request fails.
+///
+/// # Ownership
+///
+/// Caller owns the returned string. Must call `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `requests_json` must be a valid UTF-8 string
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_search_batch(
+    handle: *mut MemvidHandle,
+    requests_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::SearchBatch);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let requests = match unsafe { parse_search_batch(requests_json, &mut span) } {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+    span.phase(Phase::Parse);
+
+    let responses = requests
+        .into_iter()
+        .map(|request| {
+            request
+                .run(handle)
+                .map(|(r, limits)| SearchResponseJson::with_limits(&r, limits))
+        })
+        .collect();
+    batch_to_cstr(responses, span, error)
+}
+
+/// Run several searches in parallel across a reader pool.
+///
+/// Checks out one view, then as many more as are idle (up to one per request
+/// and `max_readers`) without blocking, all at the same snapshot generation.
+/// Each view runs on its own thread and takes the next unclaimed request, so
+/// every response in the batch observes the same committed state.
+///
+/// # Parameters
+///
+/// - `pool`: Valid reader pool
+/// - `requests_json`: JSON array of SearchRequest objects (see `memvid_search`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON array of SearchResponse objects in request order, NULL on failure.
+/// The whole batch fails if any request fails.
+///
+/// # Ownership
+///
+/// Caller owns the returned string. Must call `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `pool` must be a valid pool
+/// - `requests_json` must be a valid UTF-8 string
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_reader_pool_search_batch(
+    pool: *mut MemvidReaderPool,
+    requests_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let mut span = Span::start(Op::SearchBatch);
+    let pool = match unsafe { MemvidReaderPool::from_ptr(pool) } {
+        Some(p) => p,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("pool")) },
+    };
+
+    let requests = match unsafe { parse_search_batch(requests_json, &mut span) } {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+    span.phase(Phase::Parse);
+    if requests.is_empty() {
+        return batch_to_cstr(Vec::new(), span, error);
+    }
+
+    let (first, generation) = match pool.acquire_with_generation() {
+        Ok(v) => v,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+    let mut views = vec![first];
+    while views.len() < requests.len() {
+        match pool.try_acquire_at(generation) {
+            Ok(Some(view)) => views.push(view),
+            // Run with the views we have rather than fail the batch
+            Ok(None) | Err(_) => break,
+        }
+    }
+
+    let count = requests.len();
+    let requests: Vec<_> = requests.into_iter().map(|r| Mutex::new(Some(r))).collect();
+    let responses: Vec<_> = (0..count).map(|_| Mutex::new(None)).collect();
+    let next = AtomicUsize::new(0);
+
+    std::thread::scope(|scope| {
+        let (local, rest) = views.split_first().expect("at least one view");
+        for &view in rest {
+            // SAFETY: each checked-out view is exclusively owned by this call
+            let handle = unsafe { &mut *view };
+            let (requests, responses, next) = (&requests, &responses, &next);
+            scope.spawn(move || run_batch_worker(handle, requests, responses, next));
+        }
+        // SAFETY: as above; the calling thread works the first view
+        run_batch_worker(unsafe { &mut **local }, &requests, &responses, &next);
+    });
+
+    for view in views {
+        pool.release(view);
+    }
+
+    let responses = responses
+        .into_iter()
+        .map(|slot| {
+            slot.into_inner()
+                .unwrap_or_else(|e| e.into_inner())
+                .expect("every request is claimed by a worker")
+        })
+        .collect();
+    batch_to_cstr(responses, span, error)
+}
+
+/// Search hit in the binary result layout.
+///
+/// String fields are stored in the caller's arena buffer and referenced by
+/// byte offset and length. Arena strings are UTF-8 and NOT null-terminated.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidSearchHit {
+    /// Frame ID
+    pub frame_id: u64,
+    /// Result rank (1-based)
+    pub rank: u64,
+    /// Character range start in document
+    pub range_start: u64,
+    /// Character range end in document
+    pub range_end: u64,
+    /// Number of keyword matches
+    pub matches: u64,
+    /// Relevance score (valid when `has_score` is 1)
+    pub score: f32,
+    /// Whether `score` is set
+    pub has_score: u8,
+    /// Whether the hit has a title (`title_len` may still be 0)
+    pub has_title: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 2],
+    /// Arena offset of the document URI
+    pub uri_offset: u64,
+    /// Length of the document URI in bytes
+    pub uri_len: u64,
+    /// Arena offset of the document title
+    pub title_offset: u64,
+    /// Length of the document title in bytes
+    pub title_len: u64,
+    /// Arena offset of the snippet text
+    pub text_offset: u64,
+    /// Length of the snippet text in bytes
+    pub text_len: u64,
+}
+
+/// Summary of a binary search result.
+///
+/// On a `BufferTooSmall` failure, `hit_count` and `arena_bytes` still report
+/// the capacities required to hold the full result.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidSearchResult {
+    /// Number of hits returned (entries required in the hits array)
+    pub hit_count: u64,
+    /// Total number of hits (may exceed returned hits due to pagination)
+    pub total_hits: u64,
+    /// Execution time in milliseconds
+    pub elapsed_ms: u64,
+    /// Bytes of string arena used (or required)
+    pub arena_bytes: u64,
+    /// Whether a next-page cursor is present
+    pub has_next_cursor: u8,
+    /// Whether the time budget ran out before the search finished
+    pub partial: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 6],
+    /// Arena offset of the next-page cursor
+    pub next_cursor_offset: u64,
+    /// Length of the next-page cursor in bytes
+    pub next_cursor_len: u64,
+}
+
+/// Search the memory, writing results into caller-owned buffers.
+///
+/// This is the allocation-free counterpart of `memvid_search`: hits are
+/// written as `MemvidSearchHit` records and their strings are packed into a
+/// single arena buffer, so no JSON is produced or parsed. With `ids_only`
+/// every hit string is empty. The time budget works as for `memvid_search`;
+/// `result->partial` reports whether it cut the search short.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `request_json`: JSON string with SearchRequest (same schema as `memvid_search`)
+/// - `hits`: Out-array for hit records (may be NULL when `hits_capacity` is 0)
+/// - `hits_capacity`: Number of entries available in `hits`
+/// - `arena`: Out-buffer for hit strings (may be NULL when `arena_capacity` is 0)
+/// - `arena_capacity`: Size of `arena` in bytes
+/// - `result`: Out-parameter for the result summary (must not be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure. If either buffer is too small the error code
+/// is `BufferTooSmall`, nothing is written to `hits` or `arena`, and
+/// `result->hit_count` / `result->arena_bytes` hold the required sizes.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `request_json` must be a valid UTF-8 string
+/// - `hits` must point to `hits_capacity` writable entries or be NULL
+/// - `arena` must point to `arena_capacity` writable bytes or be NULL
+/// - `result` must be a valid pointer
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_search_into(
+    handle: *mut MemvidHandle,
+    request_json: *const c_char,
+    hits: *mut MemvidSearchHit,
+    hits_capacity: size_t,
+    arena: *mut u8,
+    arena_capacity: size_t,
+    result: *mut MemvidSearchResult,
+    error: *mut MemvidError,
+) -> i32 {
+    let mut span = Span::start(Op::SearchInto);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let result = match unsafe { result.as_mut() } {
+        Some(r) => r,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("result")) },
+    };
+
+    let request = match unsafe { parse_search_request(request_json, &mut span) } {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+    span.phase(Phase::Parse);
+
+    let (response, limits) = match request.run(handle) {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    };
+    span.phase(Phase::Core);
+    handle.hot_set.record_hits(&response);
+
+    unsafe {
+        write_search_into(
+            &response,
+            limits,
+            hits,
+            hits_capacity,
+            arena,
+            arena_capacity,
+            result,
+            &mut span,
+            error,
+        )
+    }
+}
+
+/// URI, title and text of a hit, or empty strings for `ids_only`.
+fn hit_strings(hit: &memvid_core::SearchHit, ids_only: bool) -> (&str, Option<&str>, &str) {
+    if ids_only {
+        ("", None, "")
+    } else {
+        (&hit.uri, hit.title.as_deref(), &hit.text)
+    }
+}
+
+/// Write a search response into caller buffers in the binary result layout.
+///
+/// With `ids_only` every hit string is left empty.
+///
+/// # Safety
+///
+/// Same buffer requirements as `memvid_search_into`.
+#[allow(clippy::too_many_arguments)]
+unsafe fn write_search_into(
+    response: &memvid_core::SearchResponse,
+    limits: ResponseLimits,
+    hits: *mut MemvidSearchHit,
+    hits_capacity: size_t,
+    arena: *mut u8,
+    arena_capacity: size_t,
+    result: &mut MemvidSearchResult,
+    span: &mut Span,
+    error: *mut MemvidError,
+) -> i32 {
+    // Size the result before touching caller buffers
+    let hit_count = response.hits.len();
+    let hit_bytes: usize = response
+        .hits
+        .iter()
+        .map(|hit| {
+            let (uri, title, text) = hit_strings(hit, limits.ids_only);
+            uri.len() + title.map_or(0, str::len) + text.len()
+        })
+        .sum();
+    let cursor_bytes = response.next_cursor.as_deref().map_or(0, str::len);
+    let arena_bytes = hit_bytes + cursor_bytes;
+
+    *result = MemvidSearchResult {
+        hit_count: hit_count as u64,
+        total_hits: response.total_hits as u64,
+        elapsed_ms: response.elapsed_ms as u64,
+        arena_bytes: arena_bytes as u64,
+        has_next_cursor: response.next_cursor.is_some() as u8,
+        partial: limits.partial as u8,
+        ..Default::default()
+    };
+
+    if hit_count > hits_capacity || (hit_count > 0 && hits.is_null()) {
+        return unsafe { set_error(error, MemvidError::buffer_too_small("hits", hit_count)) };
+    }
+    if arena_bytes > arena_capacity || (arena_bytes > 0 && arena.is_null()) {
+        return unsafe { set_error(error, MemvidError::buffer_too_small("arena", arena_bytes)) };
+    }
+
+    let mut offset = 0usize;
+    let mut push = |s: &str| -> (u64, u64) {
+        let start = offset;
+        // The arena may be null when every string is empty
+        if !s.is_empty() {
+            unsafe { std::ptr::copy_nonoverlapping(s.as_ptr(), arena.add(start), s.len()) };
+        }
+        offset += s.len();
+        (start as u64, s.len() as u64)
+    };
+
+    for (i, hit) in response.hits.iter().enumerate() {
+        let (uri, title, text) = hit_strings(hit, limits.ids_only);
+        let (uri_offset, uri_len) = push(uri);
+        let (title_offset, title_len) = push(title.unwrap_or(""));
+        let (text_offset, text_len) = push(text);
+        let record = MemvidSearchHit {
+            frame_id: hit.frame_id,
+            rank: hit.rank as u64,
+            range_start: hit.range.0 as u64,
+            range_end: hit.range.1 as u64,
+            matches: hit.matches as u64,
+            score: hit.score.unwrap_or(0.0),
+            has_score: hit.score.is_some() as u8,
+            has_title: title.is_some() as u8,
+            _padding: [0; 2],
+            uri_offset,
+            uri_len,
+            title_offset,
+            title_len,
+            text_offset,
+            text_len,
+        };
+        unsafe { hits.add(i).write(record) };
+    }
+
+    if let Some(cursor) = response.next_cursor.as_deref() {
+        let (cursor_offset, cursor_len) = push(cursor);
+        result.next_cursor_offset = cursor_offset;
+        result.next_cursor_len = cursor_len;
+    }
+    span.phase(Phase::Copy);
+    span.bytes_out(arena_bytes + hit_count * std::mem::size_of::<MemvidSearchHit>());
+
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Binary search request for `memvid_search_bin`.
+///
+/// Field-for-field equivalent of the `memvid_search` request JSON. Strings
+/// are borrowed for the duration of the call; zero `top_k` and
+/// `snippet_chars` select the JSON defaults.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidSearchQuery {
+    /// Search query string (must not be absent)
+    pub query: MemvidStr,
+    /// Maximum number of results (0 for the default of 10)
+    pub top_k: u64,
+    /// Characters of context around matches (0 for the default of 200)
+    pub snippet_chars: u64,
+    /// Filter to specific URI (absent for no filter)
+    pub uri: MemvidStr,
+    /// Filter to URI scope/prefix (absent for no filter)
+    pub scope: MemvidStr,
+    /// Pagination cursor (absent for the first page)
+    pub cursor: MemvidStr,
+    /// Drop hits scoring below this (valid when has_min_score is 1)
+    pub min_score: f32,
+    /// Whether min_score is set
+    pub has_min_score: u8,
+    /// Return ranks, frame IDs and scores only (1) or full hits (0)
+    pub ids_only: u8,
+    /// Whether time_budget_us is set
+    pub has_time_budget: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 1],
+    /// Time budget in microseconds (valid when has_time_budget is 1)
+    pub time_budget_us: u64,
+    /// Maximum hits the engine is asked for, filter over-fetch included
+    /// (0 for no cap)
+    pub max_candidates: u64,
+}
+
+impl MemvidSearchQuery {
+    /// Convert to a search request, copying only the borrowed strings.
+    ///
+    /// # Safety
+    ///
+    /// Every present string must point to `len` readable bytes.
+    unsafe fn to_search_request(&self) -> Result<SearchRequestJson, MemvidError> {
+        let owned = |s: &MemvidStr, name: &str| -> Result<Option<String>, MemvidError> {
+            Ok(unsafe { s.as_str(name) }?.map(str::to_owned))
+        };
+        Ok(SearchRequestJson {
+            query: owned(&self.query, "query")?
+                .ok_or_else(|| MemvidError::null_pointer("query"))?,
+            top_k: match self.top_k {
+                0 => default_top_k(),
+                n => n as usize,
+            },
+            snippet_chars: match self.snippet_chars {
+                0 => default_snippet_chars(),
+                n => n as usize,
+            },
+            uri: owned(&self.uri, "uri")?,
+            scope: owned(&self.scope, "scope")?,
+            cursor: owned(&self.cursor, "cursor")?,
+            min_score: (self.has_min_score != 0).then_some(self.min_score),
+            ids_only: self.ids_only != 0,
+            max_candidates: (self.max_candidates != 0).then_some(self.max_candidates as usize),
+            time_budget_us: (self.has_time_budget != 0).then_some(self.time_budget_us),
+            filters: None,
+        })
+    }
+}
+
+/// Search the memory with a binary request and binary result.
+///
+/// Takes a `MemvidSearchQuery` struct instead of request JSON and writes the
+/// same layout as `memvid_search_into`, so neither direction is encoded or
+/// parsed. Hit strings are read in place from `arena`.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `query`: Binary search request (must not be NULL)
+/// - `hits`, `hits_capacity`, `arena`, `arena_capacity`, `result`: As for
+///   `memvid_search_into`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure, with the same `BufferTooSmall` sizing
+/// behaviour as `memvid_search_into`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `query` must be a valid pointer whose present strings point to `len`
+///   readable bytes
+/// - Buffer requirements are the same as `memvid_search_into`
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_search_bin(
+    handle: *mut MemvidHandle,
+    query: *const MemvidSearchQuery,
+    hits: *mut MemvidSearchHit,
+    hits_capacity: size_t,
+    arena: *mut u8,
+    arena_capacity: size_t,
+    result: *mut MemvidSearchResult,
+    error: *mut MemvidError,
+) -> i32 {
+    let mut span = Span::start(Op::SearchBin);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let result = match unsafe { result.as_mut() } {
+        Some(r) => r,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("result")) },
+    };
+
+    let request = match unsafe { query.as_ref() } {
+        Some(q) => match unsafe { q.to_search_request() } {
+            Ok(r) => r,
+            Err(e) => return unsafe { set_error(error, e) },
+        },
+        None => return unsafe { set_error(error, MemvidError::null_pointer("query")) },
+    };
+    span.bytes_in(request.query.len());
+    span.phase(Phase::Parse);
+
+    let (response, limits) = match request.run(handle) {
+        Ok(r) => r,
+        Err(e) => return unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    };
+    span.phase(Phase::Core);
+    handle.hot_set.record_hits(&response);
+
+    unsafe {
+        write_search_into(
+            &response,
+            limits,
+            hits,
+            hits_capacity,
+            arena,
+            arena_capacity,
+            result,
+            &mut span,
+            error,
+        )
+    }
+}
+
 /// Free a string returned by the FFI layer.
 ///
 /// # Safety
@@ -243,8 +1319,6 @@ pub unsafe extern "C" fn memvid_search(
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn memvid_string_free(str: *mut c_char) {
     if !str.is_null() {
-        unsafe {
-            drop(std::ffi::CString::from_raw(str));
-        }
+        unsafe { crate::arena::free_cstr(str) };
     }
 }
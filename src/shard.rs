@@ -0,0 +1,734 @@
+//! Sharded memories: one logical memory spread over several files.
+//!
+//! A shard set owns one writable handle per file. Puts are routed to a
+//! single shard by a stable hash of the frame's URI (or track), so the same
+//! key always lands on the same file across processes; searches, asks and
+//! timeline queries run on every shard in parallel and the per-shard
+//! results are merged into one response.
+//!
+//! Frame IDs returned by the set are namespaced: the shard index is stored
+//! above bit `MEMVID_SHARD_ID_SHIFT` and the shard-local frame ID below it.
+//! To read a frame by ID, split it and call the ordinary frame functions on
+//! the handle from `memvid_shard_set_shard`.
+
+use crate::ask::{
+    AskContextFragmentJson, AskRequestJson, AskResponseJson, SearchHitJson as AskHitJson,
+};
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::mutation::{commit_handle, put_slice, PutOptionsJson};
+use crate::search::{join_context, SearchHitJson, SearchRequestJson, SearchResponseJson};
+use crate::timeline::{run_timeline, TimelineEntryJson, TimelineQueryJson, TimelineResponseJson};
+use crate::util::{
+    cstr_to_option_str, cstr_to_path, cstr_to_str, set_error, set_error_null, set_ok,
+    string_to_cstr,
+};
+use libc::size_t;
+use serde::{Deserialize, Serialize};
+use std::cmp::Ordering;
+use std::os::raw::c_char;
+use std::time::Instant;
+
+/// Bit position of the shard index in a namespaced frame ID.
+pub const MEMVID_SHARD_ID_SHIFT: u32 = 48;
+
+/// Mask for the shard-local part of a namespaced frame ID.
+const LOCAL_ID_MASK: u64 = (1 << MEMVID_SHARD_ID_SHIFT) - 1;
+
+/// Largest shard count that fits above `MEMVID_SHARD_ID_SHIFT`.
+const MAX_SHARDS: usize = 1 << (64 - MEMVID_SHARD_ID_SHIFT);
+
+/// Namespace a shard-local frame ID.
+fn global_id(shard: usize, frame_id: u64) -> u64 {
+    ((shard as u64) << MEMVID_SHARD_ID_SHIFT) | (frame_id & LOCAL_ID_MASK)
+}
+
+/// 64-bit FNV-1a, used for routing because it is stable across builds.
+fn fnv1a(bytes: &[u8]) -> u64 {
+    bytes.iter().fold(0xcbf2_9ce4_8422_2325, |hash, &b| {
+        (hash ^ u64::from(b)).wrapping_mul(0x0100_0000_01b3)
+    })
+}
+
+/// Order by descending score; hits without a score sort last.
+fn by_score(a: Option<f32>, b: Option<f32>) -> Ordering {
+    let key = |s: Option<f32>| s.unwrap_or(f32::NEG_INFINITY);
+    key(b).total_cmp(&key(a))
+}
+
+/// Key used to route puts to a shard.
+#[derive(Debug, Default, Clone, Copy, Deserialize)]
+#[serde(rename_all = "lowercase")]
+enum RouteJson {
+    /// Hash of the frame URI
+    #[default]
+    Uri,
+    /// Hash of the frame track
+    Track,
+}
+
+/// Options for `memvid_shard_set_open` from JSON.
+#[derive(Debug, Default, Deserialize)]
+struct ShardSetOptionsJson {
+    /// Create shard files that do not exist yet
+    #[serde(default)]
+    create: bool,
+    /// Routing key for puts
+    #[serde(default)]
+    route: RouteJson,
+}
+
+/// Set of memory files queried and written as one memory.
+///
+/// The shard order is part of the routing and of every namespaced frame
+/// ID, so a set must always be opened with its paths in the same order.
+///
+/// # Thread Safety
+///
+/// Like `MemvidHandle`, a shard set is NOT thread-safe; it uses its own
+/// worker threads to run the shards in parallel.
+pub struct MemvidShardSet {
+    shards: Vec<Box<MemvidHandle>>,
+    route: RouteJson,
+    /// Round-robin position for puts without a routing key
+    next: usize,
+}
+
+impl MemvidShardSet {
+    /// Convert a raw pointer to a mutable reference.
+    ///
+    /// # Safety
+    ///
+    /// The pointer must be valid or null.
+    unsafe fn from_ptr_mut<'a>(ptr: *mut MemvidShardSet) -> Option<&'a mut Self> {
+        unsafe { ptr.as_mut() }
+    }
+
+    /// Pick the shard for a put.
+    fn route(&mut self, options: &PutOptionsJson) -> usize {
+        let key = match self.route {
+            RouteJson::Uri => options.uri.as_deref(),
+            RouteJson::Track => options.track.as_deref(),
+        };
+        let count = self.shards.len();
+        match key {
+            Some(key) => (fnv1a(key.as_bytes()) % count as u64) as usize,
+            None => {
+                self.next = (self.next + 1) % count;
+                self.next
+            }
+        }
+    }
+
+    /// Run `f` on every shard in parallel, returning results in shard order.
+    fn scatter<T, F>(&mut self, f: F) -> Result<Vec<T>, MemvidError>
+    where
+        T: Send,
+        F: Fn(&mut MemvidHandle) -> Result<T, memvid_core::MemvidError> + Sync,
+    {
+        if let [shard] = self.shards.as_mut_slice() {
+            return f(shard)
+                .map(|r| vec![r])
+                .map_err(MemvidError::from_core_error);
+        }
+
+        std::thread::scope(|scope| {
+            let f = &f;
+            let workers: Vec<_> = self
+                .shards
+                .iter_mut()
+                .map(|shard| scope.spawn(move || f(shard)))
+                .collect();
+            workers
+                .into_iter()
+                .map(|w| w.join().unwrap_or_else(|p| std::panic::resume_unwind(p)))
+                .collect::<Result<_, _>>()
+                .map_err(MemvidError::from_core_error)
+        })
+    }
+}
+
+/// Result entry that can be merged across shards by score.
+trait Ranked {
+    fn score(&self) -> Option<f32>;
+    fn rank(&self) -> usize;
+    fn set_rank(&mut self, rank: usize);
+    fn frame_id_mut(&mut self) -> &mut u64;
+}
+
+macro_rules! impl_ranked {
+    ($($ty:ty),*) => {$(
+        impl Ranked for $ty {
+            fn score(&self) -> Option<f32> {
+                self.score
+            }
+            fn rank(&self) -> usize {
+                self.rank
+            }
+            fn set_rank(&mut self, rank: usize) {
+                self.rank = rank;
+            }
+            fn frame_id_mut(&mut self) -> &mut u64 {
+                &mut self.frame_id
+            }
+        }
+    )*};
+}
+
+impl_ranked!(SearchHitJson, AskHitJson, AskContextFragmentJson);
+
+/// Merge per-shard results into a global top `top_k`.
+///
+/// Frame IDs are namespaced and ranks renumbered from 1. Ties keep shard
+/// order, then each shard's own ranking.
+fn merge_ranked<T: Ranked>(per_shard: Vec<Vec<T>>, top_k: usize) -> Vec<T> {
+    let mut merged: Vec<_> = per_shard
+        .into_iter()
+        .enumerate()
+        .flat_map(|(shard, entries)| {
+            entries.into_iter().map(move |mut entry| {
+                let frame_id = entry.frame_id_mut();
+                *frame_id = global_id(shard, *frame_id);
+                entry
+            })
+        })
+        .collect();
+    merged.sort_by(|a, b| by_score(a.score(), b.score()).then(a.rank().cmp(&b.rank())));
+    merged.truncate(top_k);
+    for (i, entry) in merged.iter_mut().enumerate() {
+        entry.set_rank(i + 1);
+    }
+    merged
+}
+
+/// Parse a JSON request, rejecting pagination cursors.
+///
+/// Cursors are issued per shard and cannot resume a merged result.
+///
+/// # Safety
+///
+/// `request_json` must be null or a valid null-terminated C string.
+unsafe fn parse_request<T: for<'de> Deserialize<'de>>(
+    request_json: *const c_char,
+    cursor: fn(&T) -> bool,
+) -> Result<T, MemvidError> {
+    let json_str = unsafe { cstr_to_str(request_json, "request_json") }?;
+    let request: T = serde_json::from_str(json_str).map_err(MemvidError::json_parse)?;
+    if cursor(&request) {
+        return Err(MemvidError::invalid_state(
+            "cursor pagination is not supported on shard sets",
+        ));
+    }
+    Ok(request)
+}
+
+/// Serialize a merged response and hand it to the caller.
+///
+/// # Safety
+///
+/// `error` must be a valid pointer or NULL.
+unsafe fn respond<T: Serialize>(
+    response: Result<T, MemvidError>,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    match response.and_then(|r| serde_json::to_string(&r).map_err(MemvidError::json_serialize)) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, e) },
+    }
+}
+
+/// Open a set of memory files as one sharded memory.
+///
+/// # Parameters
+///
+/// - `paths`: Array of `count` shard paths (null-terminated UTF-8)
+/// - `count`: Number of shards (1 to 65536)
+/// - `options_json`: JSON string with options (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Shard set on success, NULL on failure.
+///
+/// # Options JSON Schema
+///
+/// ```json
+/// {
+///   "create": false,
+///   "route": "uri"
+/// }
+/// ```
+///
+/// Route values: "uri" (hash of the put URI), "track" (hash of the put
+/// track). Puts without the routing key are spread round-robin.
+///
+/// # Ownership
+///
+/// Caller owns the returned set. Must call `memvid_shard_set_close()` to free.
+///
+/// # Safety
+///
+/// - `paths` must point to `count` valid null-terminated UTF-8 strings
+/// - `options_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_open(
+    paths: *const *const c_char,
+    count: size_t,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidShardSet {
+    if paths.is_null() {
+        return unsafe { set_error_null(error, MemvidError::null_pointer("paths")) };
+    }
+    if count == 0 || count > MAX_SHARDS {
+        return unsafe {
+            set_error_null(
+                error,
+                MemvidError::invalid_state("shard count must be between 1 and 65536"),
+            )
+        };
+    }
+
+    let options = match unsafe { cstr_to_option_str(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<ShardSetOptionsJson>(json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => ShardSetOptionsJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let raw_paths = unsafe { std::slice::from_raw_parts(paths, count) };
+    let mut shards = Vec::with_capacity(count);
+    for &raw in raw_paths {
+        let path = match unsafe { cstr_to_path(raw) } {
+            Ok(p) => p,
+            Err(e) => return unsafe { set_error_null(error, e) },
+        };
+        let opened = if options.create && !path.exists() {
+            memvid_core::Memvid::create(&path)
+        } else {
+            memvid_core::Memvid::open(&path)
+        };
+        match opened {
+            Ok(memvid) => shards.push(MemvidHandle::writable(memvid, path)),
+            Err(e) => return unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+        }
+    }
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(MemvidShardSet {
+        shards,
+        route: options.route,
+        next: 0,
+    }))
+}
+
+/// Borrow the handle of one shard.
+///
+/// Use it with any per-handle function, e.g. `memvid_frame_by_id` with the
+/// shard-local part of a namespaced frame ID, or `memvid_stats`.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `index`: Shard index (the position of its path at open)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Shard handle on success, NULL on failure.
+///
+/// # Ownership
+///
+/// The handle belongs to the set and is valid until
+/// `memvid_shard_set_close()`; never pass it to `memvid_close()`.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_shard(
+    set: *mut MemvidShardSet,
+    index: u32,
+    error: *mut MemvidError,
+) -> *mut MemvidHandle {
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("set")) },
+    };
+
+    match set.shards.get_mut(index as usize) {
+        Some(shard) => {
+            unsafe { set_ok(error) };
+            &mut **shard
+        }
+        None => unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    }
+}
+
+/// Add content to the shard chosen by the routing key.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `data`: Pointer to content bytes
+/// - `len`: Length of content in bytes
+/// - `options_json`: JSON string with PutOptions (NULL for defaults, see
+///   `memvid_put_bytes_with_options`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Namespaced frame ID on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `data` must point to at least `len` bytes, or be NULL if `len` is 0
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_put(
+    set: *mut MemvidShardSet,
+    data: *const u8,
+    len: size_t,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> u64 {
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("set")) },
+    };
+
+    if data.is_null() && len > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("data")) };
+    }
+
+    let slice = if len == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(data, len) }
+    };
+
+    let options = match unsafe { cstr_to_option_str(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<PutOptionsJson>(json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => PutOptionsJson::default(),
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    let shard = set.route(&options);
+    match put_slice(&mut set.shards[shard], slice, options.into_put_options()) {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            global_id(shard, frame_id)
+        }
+        Err(e) => unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    }
+}
+
+/// Commit every shard, in parallel.
+///
+/// Shards are committed independently: on failure, the shards that
+/// succeeded stay committed and the first error is reported.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_commit(
+    set: *mut MemvidShardSet,
+    error: *mut MemvidError,
+) -> i32 {
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("set")) },
+    };
+
+    match set.scatter(commit_handle) {
+        Ok(_) => {
+            unsafe { set_ok(error) };
+            1
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
+
+/// Search every shard and merge the hits by score.
+///
+/// Each shard returns its own top `top_k`, so the merged top `top_k` is
+/// exact. `context` is rebuilt from the merged hits and `total_hits` is the
+/// sum over shards. Pagination cursors are not supported.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `request_json`: JSON string with SearchRequest (see `memvid_search`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with SearchResponse (see `memvid_search`, with namespaced
+/// frame IDs) on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `request_json` must be a valid UTF-8 string
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_search(
+    set: *mut MemvidShardSet,
+    request_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let started = Instant::now();
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("set")) },
+    };
+
+    let request =
+        match unsafe { parse_request(request_json, |r: &SearchRequestJson| r.cursor.is_some()) } {
+            Ok(r) => r,
+            Err(e) => return unsafe { set_error_null(error, e) },
+        };
+    let top_k = request.top_k;
+
+    let responses = set.scatter(|shard| {
+        let (response, limits) = request.clone().run(shard)?;
+        shard.hot_set.record_hits(&response);
+        Ok(SearchResponseJson::with_limits(&response, limits))
+    });
+
+    let merged = responses.map(|responses| {
+        let query = responses[0].query.clone();
+        let engine = responses[0].engine.clone();
+        let total_hits = responses.iter().map(|r| r.total_hits).sum();
+        let partial = responses.iter().any(|r| r.partial);
+        let hits = merge_ranked(responses.into_iter().map(|r| r.hits).collect(), top_k);
+        SearchResponseJson {
+            query,
+            elapsed_ms: started.elapsed().as_millis(),
+            total_hits,
+            context: join_context(hits.iter().map(|h| h.text.as_str())),
+            hits,
+            next_cursor: None,
+            engine,
+            partial,
+        }
+    });
+    unsafe { respond(merged, error) }
+}
+
+/// Ask every shard and merge the retrieved context by score.
+///
+/// Retrieval hits and context fragments are merged into a global top
+/// `top_k` as in `memvid_shard_set_search`. When an answer is synthesized,
+/// the answer and its citations are those of the shard holding the best
+/// hit. Pagination cursors are not supported.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `request_json`: JSON string with ask parameters (see `memvid_ask`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with ask response (see `memvid_ask`, with namespaced frame
+/// IDs) on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `request_json` must be a valid null-terminated UTF-8 string
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_ask(
+    set: *mut MemvidShardSet,
+    request_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let started = Instant::now();
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("set")) },
+    };
+
+    let request =
+        match unsafe { parse_request(request_json, |r: &AskRequestJson| r.cursor.is_some()) } {
+            Ok(r) => r,
+            Err(e) => return unsafe { set_error_null(error, e) },
+        };
+    let top_k = request.top_k;
+
+    let responses = set.scatter(|shard| {
+        shard
+            .as_mut()
+            .ask(
+                request.clone().into_request(),
+                None::<&dyn memvid_core::VecEmbedder>,
+            )
+            .map(|r| AskResponseJson::from(&r))
+    });
+
+    let merged = responses.map(|mut responses| {
+        // Shard holding the best retrieval hit
+        let best = responses
+            .iter()
+            .enumerate()
+            .filter_map(|(shard, r)| r.retrieval.hits.first().map(|h| (shard, h.score)))
+            .min_by(|a, b| by_score(a.1, b.1))
+            .map_or(0, |(shard, _)| shard);
+
+        let mut hits = Vec::with_capacity(responses.len());
+        let mut fragments = Vec::with_capacity(responses.len());
+        let (mut total_hits, mut retrieval_ms, mut synthesis_ms) = (0, 0, 0);
+        for response in &mut responses {
+            total_hits += response.retrieval.total_hits;
+            retrieval_ms = retrieval_ms.max(response.stats.retrieval_ms);
+            synthesis_ms = synthesis_ms.max(response.stats.synthesis_ms);
+            hits.push(std::mem::take(&mut response.retrieval.hits));
+            fragments.push(std::mem::take(&mut response.context_fragments));
+        }
+
+        let mut merged = responses.swap_remove(best);
+        for citation in &mut merged.citations {
+            citation.frame_id = global_id(best, citation.frame_id);
+        }
+        let hits = merge_ranked(hits, top_k);
+        merged.retrieval.context = join_context(hits.iter().map(|h| h.text.as_str()));
+        merged.retrieval.hits = hits;
+        merged.retrieval.total_hits = total_hits;
+        merged.retrieval.next_cursor = None;
+        merged.context_fragments = merge_ranked(fragments, top_k);
+        merged.stats.retrieval_ms = retrieval_ms;
+        merged.stats.synthesis_ms = synthesis_ms;
+        merged.stats.latency_ms = started.elapsed().as_millis();
+        merged
+    });
+    unsafe { respond(merged, error) }
+}
+
+/// Query the timeline of every shard and merge the entries by timestamp.
+///
+/// Each shard is queried with the same bounds and limit, so the first
+/// `limit` merged entries are exact. Entries with equal timestamps keep
+/// shard order.
+///
+/// # Parameters
+///
+/// - `set`: Valid shard set
+/// - `query_json`: JSON string with query parameters (NULL for defaults,
+///   see `memvid_timeline`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with timeline entries (see `memvid_timeline`, with
+/// namespaced frame IDs) on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Safety
+///
+/// - `set` must be a valid shard set
+/// - `query_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_timeline(
+    set: *mut MemvidShardSet,
+    query_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let set = match unsafe { MemvidShardSet::from_ptr_mut(set) } {
+        Some(s) => s,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("set")) },
+    };
+
+    let query = match unsafe { cstr_to_option_str(query_json, "query_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<TimelineQueryJson>(json_str) {
+            Ok(q) => q,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => TimelineQueryJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+    let (limit, reverse) = (query.limit, query.reverse);
+
+    let entries = set.scatter(|shard| run_timeline(shard, query.clone()));
+
+    let merged = entries.map(|per_shard| {
+        let mut entries: Vec<_> = per_shard
+            .into_iter()
+            .enumerate()
+            .flat_map(|(shard, entries)| {
+                entries.into_iter().map(move |e| {
+                    let mut entry = TimelineEntryJson::from(&e);
+                    entry.frame_id = global_id(shard, entry.frame_id);
+                    for child in &mut entry.child_frames {
+                        *child = global_id(shard, *child);
+                    }
+                    entry
+                })
+            })
+            .collect();
+        if reverse {
+            entries.sort_by(|a, b| b.timestamp.cmp(&a.timestamp));
+        } else {
+            entries.sort_by_key(|e| e.timestamp);
+        }
+        if let Some(limit) = limit.filter(|&l| l > 0) {
+            entries.truncate(limit as usize);
+        }
+        TimelineResponseJson {
+            count: entries.len(),
+            entries,
+        }
+    });
+    unsafe { respond(merged, error) }
+}
+
+/// Close a shard set and all of its shard handles.
+///
+/// Uncommitted puts are not committed; call `memvid_shard_set_commit()`
+/// first.
+///
+/// # Parameters
+///
+/// - `set`: Set to close (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `set` must be a valid set returned by `memvid_shard_set_open`, or NULL
+/// - The set and its shard handles must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_shard_set_close(set: *mut MemvidShardSet) {
+    if set.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(set));
+    }
+}
@@ -0,0 +1,506 @@
+//! Snapshot streaming for replication and backups.
+//!
+//! memvid-core has no API for reading its WAL or tracking dirty segments,
+//! so snapshots are taken at the file level. `memvid_snapshot_stream`
+//! commits pending writes and streams the committed file through a writer
+//! callback in fixed-size blocks. It also keeps a manifest of block hashes
+//! for each recent stream. A later stream that names one of those positions
+//! as `since` sends only the blocks whose hash changed. `memvid_apply_stream`
+//! rebuilds the file on the replica side in a scratch file, checks it
+//! against the digests in the stream, then renames it over the replica's
+//! file and reopens it, the same way compaction swaps files.
+//!
+//! Hashing and sending happen in one pass over the file, so every stream,
+//! incremental or not, reads the whole file once while holding the handle.
+//! Writes on the handle wait for that read; only the bytes sent shrink with
+//! the delta.
+//!
+//! Block hashes and digests are `dedup::content_hash`, whose output is fixed
+//! across builds, so primary and replica may be built with different
+//! toolchains.
+//!
+//! # Stream Format
+//!
+//! All integers are little-endian. The header is the magic `MVSNAP02`
+//! followed by:
+//!
+//! | Field | Type | Meaning |
+//! |-------|------|---------|
+//! | `block_size` | u32 | Block size in bytes |
+//! | `position` | u64 | Position to pass as `since` next time |
+//! | `since` | u64 | Base position (0 for a full snapshot) |
+//! | `base_len` | u64 | File length at the base position |
+//! | `base_digest` | u64 | Digest of the file at the base position |
+//!
+//! Block records follow in ascending index order. Each is a u64 block
+//! index, a u32 byte count and the block's bytes (`block_size` bytes, or
+//! fewer for the file's last block). The records end with the index
+//! `u64::MAX`, followed by a trailer:
+//!
+//! | Field | Type | Meaning |
+//! |-------|------|---------|
+//! | `len` | u64 | File length at `position` |
+//! | `digest` | u64 | Digest of the file at `position` |
+//! | `blocks` | u64 | Number of block records sent |
+
+use crate::dedup;
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::util::{set_error, set_ok};
+use std::collections::VecDeque;
+use std::io::{Read, Seek, SeekFrom, Write};
+use std::os::raw::c_void;
+use std::path::{Path, PathBuf};
+
+/// Stream magic and format version.
+const MAGIC: &[u8; 8] = b"MVSNAP02";
+
+/// Block size for hashing and delta records.
+const BLOCK_SIZE: usize = 64 * 1024;
+
+/// Block index that ends the block records.
+const END: u64 = u64::MAX;
+
+/// Block manifests kept per handle, so that many replicas can stream
+/// incrementally from different positions.
+const MAX_MANIFESTS: usize = 8;
+
+/// Snapshot writer callback.
+///
+/// Invoked on the calling thread with the caller's context pointer and the
+/// next bytes of the stream. Return non-zero to abort the stream.
+pub type MemvidSnapshotWriteFn =
+    Option<unsafe extern "C" fn(ctx: *mut c_void, data: *const u8, len: usize) -> i32>;
+
+/// Snapshot reader callback.
+///
+/// Invoked on the calling thread to fill up to `cap` bytes of `buf` with
+/// the next bytes of the stream. Returns the number of bytes read, 0 at the
+/// end of the stream, or a negative value on error.
+pub type MemvidSnapshotReadFn =
+    Option<unsafe extern "C" fn(ctx: *mut c_void, buf: *mut u8, cap: usize) -> i64>;
+
+/// Block hashes of the file as of one stream position.
+pub(crate) struct Manifest {
+    position: u64,
+    len: u64,
+    blocks: Vec<u64>,
+}
+
+impl Manifest {
+    fn digest(&self) -> u64 {
+        digest(self.len, &self.blocks)
+    }
+}
+
+/// Stream positions handed out by a handle, newest last.
+#[derive(Default)]
+pub(crate) struct Snapshots {
+    manifests: VecDeque<Manifest>,
+    next_position: u64,
+}
+
+fn hash_block(block: &[u8]) -> u64 {
+    dedup::content_hash(block).to_u64()
+}
+
+/// Digest of a file of `len` bytes from its block hashes.
+fn digest(len: u64, blocks: &[u64]) -> u64 {
+    let mut bytes = Vec::with_capacity(8 * (blocks.len() + 1));
+    bytes.extend_from_slice(&len.to_le_bytes());
+    for block in blocks {
+        bytes.extend_from_slice(&block.to_le_bytes());
+    }
+    dedup::content_hash(&bytes).to_u64()
+}
+
+/// Read `file` block by block, handing each block to `visit`.
+fn for_each_block(
+    file: &mut std::fs::File,
+    mut visit: impl FnMut(u64, &[u8]) -> std::io::Result<()>,
+) -> std::io::Result<u64> {
+    let mut buf = vec![0u8; BLOCK_SIZE];
+    let mut index = 0;
+    let mut len = 0;
+    loop {
+        let mut filled = 0;
+        while filled < BLOCK_SIZE {
+            match file.read(&mut buf[filled..])? {
+                0 => break,
+                n => filled += n,
+            }
+        }
+        if filled == 0 {
+            return Ok(len);
+        }
+        visit(index, &buf[..filled])?;
+        index += 1;
+        len += filled as u64;
+        if filled < BLOCK_SIZE {
+            return Ok(len);
+        }
+    }
+}
+
+/// `Write` adapter over the writer callback.
+struct CallbackWriter {
+    write: unsafe extern "C" fn(ctx: *mut c_void, data: *const u8, len: usize) -> i32,
+    ctx: *mut c_void,
+}
+
+impl Write for CallbackWriter {
+    fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+        if unsafe { (self.write)(self.ctx, buf.as_ptr(), buf.len()) } != 0 {
+            return Err(std::io::Error::other("snapshot stream aborted by writer"));
+        }
+        Ok(buf.len())
+    }
+
+    fn flush(&mut self) -> std::io::Result<()> {
+        Ok(())
+    }
+}
+
+/// `Read` adapter over the reader callback.
+struct CallbackReader {
+    read: unsafe extern "C" fn(ctx: *mut c_void, buf: *mut u8, cap: usize) -> i64,
+    ctx: *mut c_void,
+}
+
+impl Read for CallbackReader {
+    fn read(&mut self, buf: &mut [u8]) -> std::io::Result<usize> {
+        match unsafe { (self.read)(self.ctx, buf.as_mut_ptr(), buf.len()) } {
+            n if n < 0 => Err(std::io::Error::other("snapshot stream read failed")),
+            n => Ok((n as usize).min(buf.len())),
+        }
+    }
+}
+
+/// Stream header fields following the magic.
+struct Header {
+    block_size: u32,
+    position: u64,
+    since: u64,
+    base_len: u64,
+    base_digest: u64,
+}
+
+impl Header {
+    fn write_to(&self, out: &mut impl Write) -> std::io::Result<()> {
+        out.write_all(MAGIC)?;
+        out.write_all(&self.block_size.to_le_bytes())?;
+        for field in [self.position, self.since, self.base_len, self.base_digest] {
+            out.write_all(&field.to_le_bytes())?;
+        }
+        Ok(())
+    }
+
+    fn read_from(input: &mut impl Read) -> Result<Self, MemvidError> {
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic).map_err(MemvidError::io)?;
+        if &magic != MAGIC {
+            return Err(MemvidError::invalid_state("not a memvid snapshot stream"));
+        }
+        let mut block_size = [0u8; 4];
+        input.read_exact(&mut block_size).map_err(MemvidError::io)?;
+        let mut fields = [0u64; 4];
+        for field in &mut fields {
+            *field = read_u64(input)?;
+        }
+        let [position, since, base_len, base_digest] = fields;
+        Ok(Self {
+            block_size: u32::from_le_bytes(block_size),
+            position,
+            since,
+            base_len,
+            base_digest,
+        })
+    }
+}
+
+fn read_u64(input: &mut impl Read) -> Result<u64, MemvidError> {
+    let mut bytes = [0u8; 8];
+    input.read_exact(&mut bytes).map_err(MemvidError::io)?;
+    Ok(u64::from_le_bytes(bytes))
+}
+
+fn read_u32(input: &mut impl Read) -> Result<u32, MemvidError> {
+    let mut bytes = [0u8; 4];
+    input.read_exact(&mut bytes).map_err(MemvidError::io)?;
+    Ok(u32::from_le_bytes(bytes))
+}
+
+/// Path of the file a handle was opened from.
+fn handle_path(handle: &MemvidHandle) -> Result<PathBuf, MemvidError> {
+    handle
+        .path
+        .clone()
+        .ok_or_else(|| MemvidError::invalid_state("handle was not opened from a file"))
+}
+
+/// Commit, then write the stream for `since` to `out`.
+fn stream(handle: &mut MemvidHandle, since: u64, out: &mut impl Write) -> Result<u64, MemvidError> {
+    let path = handle_path(handle)?;
+    if handle.writable {
+        crate::mutation::commit_handle(handle).map_err(MemvidError::from_core_error)?;
+    }
+
+    let mut file = std::fs::File::open(&path).map_err(MemvidError::io)?;
+    let snapshots = &mut handle.snapshots;
+    snapshots.next_position += 1;
+    let position = snapshots.next_position;
+    let base = (since != 0)
+        .then(|| snapshots.manifests.iter().find(|m| m.position == since))
+        .flatten();
+    let header = Header {
+        block_size: BLOCK_SIZE as u32,
+        position,
+        since: base.map_or(0, |b| b.position),
+        base_len: base.map_or(0, |b| b.len),
+        base_digest: base.map_or(0, Manifest::digest),
+    };
+    header.write_to(out).map_err(MemvidError::io)?;
+
+    // Full snapshots send every block; deltas only changed or new ones
+    let mut blocks = Vec::new();
+    let mut sent = 0u64;
+    let len = for_each_block(&mut file, |index, block| {
+        let hash = hash_block(block);
+        blocks.push(hash);
+        if base.is_some_and(|b| b.blocks.get(index as usize) == Some(&hash)) {
+            return Ok(());
+        }
+        sent += 1;
+        out.write_all(&index.to_le_bytes())?;
+        out.write_all(&(block.len() as u32).to_le_bytes())?;
+        out.write_all(block)
+    })
+    .map_err(MemvidError::io)?;
+
+    let current = Manifest {
+        position,
+        len,
+        blocks,
+    };
+    for field in [END, current.len, current.digest(), sent] {
+        out.write_all(&field.to_le_bytes())
+            .map_err(MemvidError::io)?;
+    }
+
+    if snapshots.manifests.len() == MAX_MANIFESTS {
+        snapshots.manifests.pop_front();
+    }
+    snapshots.manifests.push_back(current);
+    Ok(position)
+}
+
+fn scratch_path(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".snapshot.tmp");
+    path.with_file_name(name)
+}
+
+/// Build the file described by the stream at `scratch`.
+fn rebuild(path: &Path, scratch: &Path, input: &mut impl Read) -> Result<u64, MemvidError> {
+    let header = Header::read_from(input)?;
+    if header.block_size as usize != BLOCK_SIZE {
+        return Err(MemvidError::invalid_state(
+            "unsupported snapshot block size",
+        ));
+    }
+
+    let mut out = std::fs::File::create(scratch).map_err(MemvidError::io)?;
+    let mut blocks = Vec::new();
+    if header.since != 0 {
+        // Copy the replica's file as the base, checking it is the one the
+        // delta was computed against
+        let mut base = std::fs::File::open(path).map_err(MemvidError::io)?;
+        let base_len = for_each_block(&mut base, |_, block| {
+            blocks.push(hash_block(block));
+            out.write_all(block)
+        })
+        .map_err(MemvidError::io)?;
+        if base_len != header.base_len || digest(base_len, &blocks) != header.base_digest {
+            return Err(MemvidError::invalid_state(
+                "replica does not match the snapshot stream's base position",
+            ));
+        }
+    }
+
+    // Records ascend, and blocks past the base are all sent, so an index
+    // never skips beyond the blocks known so far
+    let mut buf = vec![0u8; BLOCK_SIZE];
+    let mut received = 0u64;
+    let mut next = 0u64;
+    loop {
+        let index = read_u64(input)?;
+        if index == END {
+            break;
+        }
+        let size = read_u32(input)? as usize;
+        if index < next || index > blocks.len() as u64 || size == 0 || size > BLOCK_SIZE {
+            return Err(MemvidError::invalid_state("snapshot block out of range"));
+        }
+        let block = &mut buf[..size];
+        input.read_exact(block).map_err(MemvidError::io)?;
+        out.seek(SeekFrom::Start(index * BLOCK_SIZE as u64))
+            .map_err(MemvidError::io)?;
+        out.write_all(block).map_err(MemvidError::io)?;
+        let hash = hash_block(block);
+        match blocks.get_mut(index as usize) {
+            Some(slot) => *slot = hash,
+            None => blocks.push(hash),
+        }
+        received += 1;
+        next = index + 1;
+    }
+
+    let len = read_u64(input)?;
+    let file_digest = read_u64(input)?;
+    let sent = read_u64(input)?;
+    blocks.resize(len.div_ceil(BLOCK_SIZE as u64) as usize, 0);
+    out.set_len(len).map_err(MemvidError::io)?;
+    if received != sent || digest(len, &blocks) != file_digest {
+        return Err(MemvidError::invalid_state(
+            "snapshot stream is incomplete or does not match its digest",
+        ));
+    }
+    out.sync_all().map_err(MemvidError::io)?;
+    Ok(header.position)
+}
+
+/// Rebuild the replica's file from `input` and reopen the handle on it.
+fn apply(handle: &mut MemvidHandle, input: &mut impl Read) -> Result<u64, MemvidError> {
+    let path = handle_path(handle)?;
+    let scratch = scratch_path(&path);
+    let rebuilt = rebuild(&path, &scratch, input);
+    let position = match rebuilt {
+        Ok(position) => position,
+        Err(e) => {
+            let _ = std::fs::remove_file(&scratch);
+            return Err(e);
+        }
+    };
+
+    std::fs::rename(&scratch, &path).map_err(MemvidError::io)?;
+    let reopened = if handle.writable {
+        memvid_core::Memvid::open(&path)
+    } else {
+        memvid_core::Memvid::open_read_only(&path)
+    };
+    drop(handle.replace_inner(reopened.map_err(MemvidError::from_core_error)?));
+    handle.cache.invalidate();
+    let frames = handle.as_ref().frame_count();
+    handle.dedup.clear(frames);
+    dedup::save(handle);
+    handle.save_indexes();
+    Ok(position)
+}
+
+/// Stream a point-in-time snapshot of a memory.
+///
+/// Pending writes are committed, then the committed file is streamed to
+/// `writer`. If `since` is a position returned by one of the handle's
+/// recent streams, only blocks that changed since then are sent; otherwise
+/// (including `since` = 0) the whole file is sent. The handle keeps the
+/// last 8 positions, so several replicas can stream incrementally.
+///
+/// Either way the whole file is read and hashed once, in the same pass that
+/// sends it; the handle is busy for that time.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle opened from a file
+/// - `since`: Position from an earlier stream, or 0 for a full snapshot
+/// - `writer`: Callback receiving the stream bytes in order
+/// - `ctx`: Context pointer passed back to `writer`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Position of this snapshot (non-zero), to pass as `since` next time;
+/// 0 on failure or if `writer` aborted.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `writer` must be safe to call with `ctx` from the calling thread
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_snapshot_stream(
+    handle: *mut MemvidHandle,
+    since: u64,
+    writer: MemvidSnapshotWriteFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+    let Some(write) = writer else {
+        return unsafe { set_error(error, MemvidError::null_pointer("writer")) };
+    };
+
+    let mut out = std::io::BufWriter::with_capacity(BLOCK_SIZE, CallbackWriter { write, ctx });
+    let result = stream(handle, since, &mut out)
+        .and_then(|position| out.flush().map(|()| position).map_err(MemvidError::io));
+    match result {
+        Ok(position) => {
+            unsafe { set_ok(error) };
+            position
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
+
+/// Apply a snapshot stream to a replica.
+///
+/// The replica's file is rebuilt in a scratch file next to it (starting
+/// from a copy of the current file for incremental streams) and verified
+/// against the stream's digests. Only then is it renamed over the original
+/// and the handle reopened. On failure the replica is left unchanged.
+/// An incremental stream fails unless the replica is at the stream's
+/// base position.
+///
+/// # Parameters
+///
+/// - `handle`: Replica handle opened from a file (uncommitted writes on it
+///   are discarded)
+/// - `reader`: Callback supplying the stream bytes in order
+/// - `ctx`: Context pointer passed back to `reader`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Position of the applied snapshot, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle, not in use by another thread
+/// - `reader` must be safe to call with `ctx` from the calling thread
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_apply_stream(
+    handle: *mut MemvidHandle,
+    reader: MemvidSnapshotReadFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+    let Some(read) = reader else {
+        return unsafe { set_error(error, MemvidError::null_pointer("reader")) };
+    };
+
+    let mut input = std::io::BufReader::with_capacity(BLOCK_SIZE, CallbackReader { read, ctx });
+    match apply(handle, &mut input) {
+        Ok(position) => {
+            unsafe { set_ok(error) };
+            position
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
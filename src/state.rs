@@ -1,14 +1,22 @@
 //! State query functions (stats, frame_count).
+//!
+//! Health checks poll these often, so core statistics are computed at most
+//! once per commit or delete and kept on the handle. Puts in between only
+//! update the frame counters, which costs no I/O.
 
 use crate::error::MemvidError;
 use crate::handle::MemvidHandle;
 use crate::util::{set_error, set_ok};
+use std::time::Duration;
+
+/// Version of the `MemvidStatsExt` layout written by this library.
+pub const MEMVID_STATS_EXT_VERSION: u32 = 2;
 
 /// Memory statistics.
 ///
 /// All fields are value types that can be safely copied.
 #[repr(C)]
-#[derive(Debug, Default)]
+#[derive(Debug, Default, Clone, Copy)]
 pub struct MemvidStats {
     /// Total number of frames
     pub frame_count: u64,
@@ -82,8 +90,120 @@ impl From<&memvid_core::Stats> for MemvidStats {
     }
 }
 
+/// Extended memory statistics, versioned by size.
+///
+/// The caller sets `struct_size` to `sizeof(MemvidStatsExt)` as compiled
+/// against; only fields that fit are written, so older callers keep
+/// working as fields are appended. New fields are only ever added at the
+/// end.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidStatsExt {
+    /// Size of the caller's struct in bytes (set by the caller)
+    pub struct_size: u32,
+    /// Layout version written (`MEMVID_STATS_EXT_VERSION`)
+    pub version: u32,
+    /// Same values as `memvid_stats`
+    pub base: MemvidStats,
+    /// Deleted frames as a fraction of all frames (0.0-1.0)
+    pub tombstone_ratio: f64,
+    /// Frames put since the last commit
+    pub pending_frames: u64,
+    /// Commits made through this handle
+    pub commit_count: u64,
+    /// Duration of the last commit in microseconds (0 before the first)
+    pub last_commit_us: u64,
+    /// Dedup puts checked against the content-hash filter (version 2)
+    pub dedup_checks: u64,
+    /// Checks the filter answered as new content without a core lookup
+    pub dedup_filtered: u64,
+    /// Checks the core confirmed as duplicates
+    pub dedup_duplicates: u64,
+    /// Fraction of checks answered by the filter (0.0-1.0)
+    pub dedup_filter_hit_rate: f64,
+    /// Fraction of new content the filter failed to rule out (0.0-1.0)
+    pub dedup_false_positive_rate: f64,
+    /// Whether the filter covers every frame (0 when the memory has frames
+    /// but no usable `.dedup` sidecar)
+    pub dedup_filter_active: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 7],
+}
+
+/// Core statistics kept on a handle between mutations.
+pub(crate) struct StatsCache {
+    /// Stats as of a cache generation, and the frame count they include
+    snapshot: Option<(u64, u64, MemvidStats)>,
+    /// Frame count after the last commit (or at open)
+    committed_frames: u64,
+    commits: u64,
+    last_commit: Duration,
+}
+
+impl StatsCache {
+    pub(crate) fn new(frames: usize) -> Self {
+        Self {
+            snapshot: None,
+            committed_frames: frames as u64,
+            commits: 0,
+            last_commit: Duration::ZERO,
+        }
+    }
+
+    /// Forget the snapshot after the file was swapped for one with
+    /// `frames` frames.
+    pub(crate) fn rebase(&mut self, frames: usize) {
+        self.snapshot = None;
+        self.committed_frames = frames as u64;
+    }
+
+    /// Frame count after the last commit (or at open).
+    pub(crate) fn committed_frames(&self) -> u64 {
+        self.committed_frames
+    }
+
+    /// Note a commit that took `elapsed`, leaving `frames` frames.
+    pub(crate) fn record_commit(&mut self, elapsed: Duration, frames: usize) {
+        self.committed_frames = frames as u64;
+        self.commits += 1;
+        self.last_commit = elapsed;
+    }
+
+    /// Current statistics, recomputed only if the generation moved.
+    ///
+    /// Commits, deletes and file swaps all advance the query cache's
+    /// generation. Frames put since the snapshot are added to its counters.
+    pub(crate) fn get(
+        &mut self,
+        handle_generation: u64,
+        memvid: &memvid_core::Memvid,
+    ) -> Result<MemvidStats, memvid_core::MemvidError> {
+        let frames = memvid.frame_count() as u64;
+        match &mut self.snapshot {
+            Some((generation, counted, stats)) if *generation == handle_generation => {
+                if frames > *counted {
+                    let added = frames - *counted;
+                    stats.frame_count += added;
+                    stats.active_frame_count += added;
+                    *counted = frames;
+                }
+                Ok(*stats)
+            }
+            _ => {
+                let stats = MemvidStats::from(&memvid.stats()?);
+                self.snapshot = Some((handle_generation, frames, stats));
+                Ok(stats)
+            }
+        }
+    }
+}
+
 /// Get memory statistics.
 ///
+/// Statistics are computed by the core at most once per commit or delete;
+/// puts in between update `frame_count` and `active_frame_count` only, so
+/// byte counts reflect the last commit until the next one.
+///
 /// # Parameters
 ///
 /// - `handle`: Valid Memvid handle
@@ -114,9 +234,9 @@ pub unsafe extern "C" fn memvid_stats(
         return unsafe { set_error(error, MemvidError::null_pointer("stats")) };
     }
 
-    match handle.as_ref().stats() {
+    match handle.stats() {
         Ok(s) => {
-            unsafe { *stats = MemvidStats::from(&s) };
+            unsafe { *stats = s };
             unsafe { set_ok(error) };
             1
         }
@@ -124,8 +244,95 @@ pub unsafe extern "C" fn memvid_stats(
     }
 }
 
+/// `part / whole`, or 0 for an empty whole.
+fn ratio(part: u64, whole: u64) -> f64 {
+    if whole == 0 {
+        0.0
+    } else {
+        part as f64 / whole as f64
+    }
+}
+
+/// Get extended memory statistics.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `stats`: Out-parameter with `struct_size` set by the caller
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure. `struct_size` smaller than the `base`
+/// fields fails with `BufferTooSmall`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `stats` must point to `struct_size` writable bytes
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_stats_ext(
+    handle: *mut MemvidHandle,
+    stats: *mut MemvidStatsExt,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if stats.is_null() {
+        return unsafe { set_error(error, MemvidError::null_pointer("stats")) };
+    }
+    let size = unsafe { (*stats).struct_size } as usize;
+    let minimum = std::mem::offset_of!(MemvidStatsExt, tombstone_ratio);
+    if size < minimum {
+        return unsafe { set_error(error, MemvidError::buffer_too_small("stats", minimum)) };
+    }
+
+    let base = match handle.stats() {
+        Ok(s) => s,
+        Err(e) => return unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    };
+    let frames = handle.as_ref().frame_count() as u64;
+    let cache = &handle.stats_cache;
+    let dedup = handle.dedup.counters;
+    let ext = MemvidStatsExt {
+        struct_size: size.min(std::mem::size_of::<MemvidStatsExt>()) as u32,
+        version: MEMVID_STATS_EXT_VERSION,
+        base,
+        tombstone_ratio: ratio(base.frame_count - base.active_frame_count, base.frame_count),
+        pending_frames: frames.saturating_sub(cache.committed_frames),
+        commit_count: cache.commits,
+        last_commit_us: cache.last_commit.as_micros() as u64,
+        dedup_checks: dedup.checks,
+        dedup_filtered: dedup.filtered,
+        dedup_duplicates: dedup.duplicates,
+        dedup_filter_hit_rate: ratio(dedup.filtered, dedup.checks),
+        dedup_false_positive_rate: ratio(
+            dedup.false_positives,
+            dedup.filtered + dedup.false_positives,
+        ),
+        dedup_filter_active: u8::from(handle.dedup.is_usable(frames as usize)),
+        _padding: [0; 7],
+    };
+    let len = ext.struct_size as usize;
+    unsafe {
+        std::ptr::copy_nonoverlapping(
+            (&ext as *const MemvidStatsExt).cast::<u8>(),
+            stats.cast::<u8>(),
+            len,
+        )
+    };
+    unsafe { set_ok(error) };
+    1
+}
+
 /// Get the number of frames in the memory.
 ///
+/// Reads the in-memory frame table; no statistics are computed.
+///
 /// # Parameters
 ///
 /// - `handle`: Valid Memvid handle
@@ -0,0 +1,515 @@
+//! Streaming and file-backed put functions.
+//!
+//! memvid-core ingests a document from one contiguous byte slice. These entry
+//! points build that slice from a file mapping instead of a heap buffer:
+//! streamed chunks, files and descriptors all go to an unlinked temporary
+//! spool file, which is then mapped, so neither the caller nor this layer has
+//! to hold the whole document in anonymous memory.
+//!
+//! Caller files are copied rather than mapped in place. A mapped file that
+//! shrinks while the core reads it, as a log does under copy-truncate
+//! rotation, raises SIGBUS; the spool is private to this process and never
+//! shrinks. The copy costs one extra pass over the file, done by the kernel
+//! where the platform allows.
+
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::mutation::{parse_put_options, put_slice};
+use crate::util::{cstr_to_path, set_error, set_error_null, set_ok};
+use libc::size_t;
+use memvid_core::PutOptions;
+use std::fs::File;
+use std::io::Write;
+use std::os::raw::c_char;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Read-only view of a whole file, mapped where the platform allows.
+enum FileBytes {
+    #[cfg(unix)]
+    Mapped {
+        ptr: *mut libc::c_void,
+        len: usize,
+    },
+    Owned(Vec<u8>),
+}
+
+impl FileBytes {
+    /// Map `file` from offset 0 to its current length.
+    fn map(file: &File) -> std::io::Result<Self> {
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|_| std::io::Error::other("file too large to map"))?;
+        if len == 0 {
+            return Ok(Self::Owned(Vec::new()));
+        }
+
+        #[cfg(unix)]
+        {
+            use std::os::unix::io::AsRawFd;
+
+            let ptr = unsafe {
+                libc::mmap(
+                    std::ptr::null_mut(),
+                    len,
+                    libc::PROT_READ,
+                    libc::MAP_PRIVATE,
+                    file.as_raw_fd(),
+                    0,
+                )
+            };
+            if ptr == libc::MAP_FAILED {
+                return Err(std::io::Error::last_os_error());
+            }
+            // Ingest reads the mapping front to back once
+            unsafe { libc::madvise(ptr, len, libc::MADV_SEQUENTIAL) };
+            Ok(Self::Mapped { ptr, len })
+        }
+
+        #[cfg(not(unix))]
+        {
+            use std::io::{Read, Seek, SeekFrom};
+
+            let mut data = Vec::with_capacity(len);
+            let mut file = file;
+            file.seek(SeekFrom::Start(0))?;
+            file.read_to_end(&mut data)?;
+            Ok(Self::Owned(data))
+        }
+    }
+
+    fn as_slice(&self) -> &[u8] {
+        match self {
+            #[cfg(unix)]
+            Self::Mapped { ptr, len } => unsafe {
+                std::slice::from_raw_parts(*ptr as *const u8, *len)
+            },
+            Self::Owned(data) => data,
+        }
+    }
+}
+
+impl Drop for FileBytes {
+    fn drop(&mut self) {
+        #[cfg(unix)]
+        if let Self::Mapped { ptr, len } = *self {
+            unsafe { libc::munmap(ptr, len) };
+        }
+    }
+}
+
+/// Reads of caller files into a spool use buffers of this size.
+#[cfg(unix)]
+const COPY_CHUNK: usize = 1 << 20;
+
+/// Anonymous spool file that is removed when dropped.
+struct Spool {
+    file: File,
+    #[cfg(not(unix))]
+    path: std::path::PathBuf,
+}
+
+impl Spool {
+    fn create() -> std::io::Result<Self> {
+        static NEXT: AtomicU64 = AtomicU64::new(0);
+        let name = format!(
+            "memvid-put-{}-{}.spool",
+            std::process::id(),
+            NEXT.fetch_add(1, Ordering::Relaxed)
+        );
+        let path = std::env::temp_dir().join(name);
+        let file = std::fs::OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create_new(true)
+            .open(&path)?;
+
+        // Unlink right away so the spool cannot outlive the process
+        #[cfg(unix)]
+        {
+            let _ = std::fs::remove_file(&path);
+            Ok(Self { file })
+        }
+        #[cfg(not(unix))]
+        Ok(Self { file, path })
+    }
+}
+
+/// Copy a regular file into a new spool, from offset 0.
+///
+/// The file's position is left where it was. A file that changes during the
+/// copy yields whatever was read; it cannot fault the later mapping.
+#[cfg(unix)]
+fn spool_file(file: &File) -> std::io::Result<Spool> {
+    use std::os::unix::fs::FileExt;
+
+    let mut spool = Spool::create()?;
+    let mut offset = 0u64;
+
+    // In-kernel copy; falls back to reads where the file systems refuse it
+    #[cfg(target_os = "linux")]
+    loop {
+        use std::os::unix::io::AsRawFd;
+
+        let mut off_in = offset as libc::loff_t;
+        let copied = unsafe {
+            libc::copy_file_range(
+                file.as_raw_fd(),
+                &mut off_in,
+                spool.file.as_raw_fd(),
+                std::ptr::null_mut(),
+                COPY_CHUNK,
+                0,
+            )
+        };
+        if copied > 0 {
+            offset += copied as u64;
+            continue;
+        }
+        if copied == 0 {
+            return Ok(spool);
+        }
+        let err = std::io::Error::last_os_error();
+        match err.raw_os_error() {
+            Some(libc::EINTR) => continue,
+            Some(libc::EXDEV | libc::ENOSYS | libc::EINVAL | libc::EOPNOTSUPP) => break,
+            _ => return Err(err),
+        }
+    }
+
+    let mut buf = vec![0u8; COPY_CHUNK];
+    loop {
+        match file.read_at(&mut buf, offset) {
+            Ok(0) => return Ok(spool),
+            Ok(n) => {
+                spool.file.write_all(&buf[..n])?;
+                offset += n as u64;
+            }
+            Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+}
+
+#[cfg(not(unix))]
+impl Drop for Spool {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_file(&self.path);
+    }
+}
+
+/// Document being written chunk by chunk.
+///
+/// Created by `memvid_put_begin`, filled by `memvid_put_write`, and consumed by
+/// `memvid_put_end` or `memvid_put_abort`. Chunks go straight to a temporary
+/// spool file, so memory use stays at the caller's chunk size.
+pub struct MemvidPutStream {
+    options: PutOptions,
+    spool: Spool,
+}
+
+/// Map a file and put it, accounting like `memvid_put_bytes_with_options`.
+///
+/// On Unix the file must be one nothing else can shrink, such as a spool.
+fn put_file(
+    handle: &mut MemvidHandle,
+    file: &File,
+    options: PutOptions,
+) -> Result<u64, MemvidError> {
+    let bytes = FileBytes::map(file).map_err(MemvidError::io)?;
+    put_slice(handle, bytes.as_slice(), options).map_err(MemvidError::from_core_error)
+}
+
+/// Begin a streaming put.
+///
+/// # Parameters
+///
+/// - `options_json`: JSON string with PutOptions (NULL for defaults; same schema
+///   as `memvid_put_bytes_with_options`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Stream on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned stream. It is freed by `memvid_put_end()` or
+/// `memvid_put_abort()`.
+///
+/// # Safety
+///
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_begin(
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidPutStream {
+    let options = match unsafe { parse_put_options(options_json) } {
+        Ok(o) => o,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let spool = match Spool::create() {
+        Ok(s) => s,
+        Err(e) => return unsafe { set_error_null(error, MemvidError::io(e)) },
+    };
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(MemvidPutStream { options, spool }))
+}
+
+/// Append a chunk to a streaming put.
+///
+/// # Parameters
+///
+/// - `stream`: Stream from `memvid_put_begin()`
+/// - `data`: Pointer to chunk bytes
+/// - `len`: Length of chunk in bytes
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure. The stream stays usable after a failed write,
+/// but the document may be incomplete; abort it unless the write is retried.
+///
+/// # Safety
+///
+/// - `stream` must be a valid stream
+/// - `data` must point to at least `len` bytes, or be NULL if `len` is 0
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_write(
+    stream: *mut MemvidPutStream,
+    data: *const u8,
+    len: size_t,
+    error: *mut MemvidError,
+) -> i32 {
+    let stream = match unsafe { stream.as_mut() } {
+        Some(s) => s,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("stream")) },
+    };
+
+    if data.is_null() && len > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("data")) };
+    }
+    if len == 0 {
+        unsafe { set_ok(error) };
+        return 1;
+    }
+
+    let chunk = unsafe { std::slice::from_raw_parts(data, len) };
+    match stream.spool.file.write_all(chunk) {
+        Ok(()) => {
+            unsafe { set_ok(error) };
+            1
+        }
+        Err(e) => unsafe { set_error(error, MemvidError::io(e)) },
+    }
+}
+
+/// Finish a streaming put and add the document to the memory.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `stream`: Stream from `memvid_put_begin()`
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Frame ID on success, 0 on failure (check error->code).
+///
+/// # Ownership
+///
+/// The stream is freed whether or not the put succeeds.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `stream` must be a valid stream and must not be used after this call
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_end(
+    handle: *mut MemvidHandle,
+    stream: *mut MemvidPutStream,
+    error: *mut MemvidError,
+) -> u64 {
+    if stream.is_null() {
+        return unsafe { set_error(error, MemvidError::null_pointer("stream")) };
+    }
+    let stream = unsafe { Box::from_raw(stream) };
+
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let MemvidPutStream { options, spool } = *stream;
+    match put_file(handle, &spool.file, options) {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            frame_id
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
+
+/// Discard a streaming put.
+///
+/// # Parameters
+///
+/// - `stream`: Stream to discard (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `stream` must be a valid stream from `memvid_put_begin`, or NULL
+/// - `stream` must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_abort(stream: *mut MemvidPutStream) {
+    if stream.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(stream));
+    }
+}
+
+/// Add the contents of a file to the memory.
+///
+/// The file is copied into an unlinked spool file, which is memory-mapped
+/// rather than read into a buffer. The file may be appended to or truncated
+/// during the call; the document is then whatever the copy read.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `path`: Path of the file to ingest (UTF-8 encoded, null-terminated)
+/// - `options_json`: JSON string with PutOptions (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Frame ID on success, 0 on failure (check error->code).
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `path` must be a valid null-terminated UTF-8 string
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_path(
+    handle: *mut MemvidHandle,
+    path: *const c_char,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let path = match unsafe { cstr_to_path(path) } {
+        Ok(p) => p,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    let options = match unsafe { parse_put_options(options_json) } {
+        Ok(o) => o,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    #[cfg(unix)]
+    let result = File::open(&path)
+        .and_then(|file| spool_file(&file))
+        .map_err(MemvidError::io)
+        .and_then(|spool| put_file(handle, &spool.file, options));
+    #[cfg(not(unix))]
+    let result = File::open(&path)
+        .map_err(MemvidError::io)
+        .and_then(|file| put_file(handle, &file, options));
+    match result {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            frame_id
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
+
+/// Add the contents of an open file descriptor to the memory.
+///
+/// Regular files are copied in full into a spool file, from offset 0
+/// regardless of the descriptor's position, which is left unchanged. Pipes
+/// and sockets are read to EOF into a spool file. Either copy uses the
+/// kernel's file-to-file copy where available, and the spool is then
+/// memory-mapped, so the source may change during the call without harm.
+/// The descriptor is not closed.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `fd`: Open, readable file descriptor
+/// - `options_json`: JSON string with PutOptions (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Frame ID on success, 0 on failure (check error->code).
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `fd` must be an open file descriptor
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[cfg(unix)]
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_fd(
+    handle: *mut MemvidHandle,
+    fd: libc::c_int,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> u64 {
+    use std::os::unix::io::FromRawFd;
+
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if fd < 0 {
+        return unsafe {
+            set_error(
+                error,
+                MemvidError::io(std::io::Error::from_raw_os_error(libc::EBADF)),
+            )
+        };
+    }
+
+    let options = match unsafe { parse_put_options(options_json) } {
+        Ok(o) => o,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    // Borrow the caller's descriptor without taking ownership of it
+    let mut file = std::mem::ManuallyDrop::new(unsafe { File::from_raw_fd(fd) });
+    let result = match file.metadata() {
+        Ok(meta) if meta.is_file() => spool_file(&file)
+            .map_err(MemvidError::io)
+            .and_then(|spool| put_file(handle, &spool.file, options)),
+        Ok(_) => Spool::create()
+            .and_then(|mut spool| std::io::copy(&mut *file, &mut spool.file).map(|_| spool))
+            .map_err(MemvidError::io)
+            .and_then(|spool| put_file(handle, &spool.file, options)),
+        Err(e) => Err(MemvidError::io(e)),
+    };
+    match result {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            frame_id
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
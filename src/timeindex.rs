@@ -0,0 +1,387 @@
+//! Time-partitioned index for narrowing timeline queries.
+//!
+//! memvid-core answers timeline queries from its own time index, which the
+//! FFI cannot change. Each handle therefore keeps frames grouped into
+//! partitions of consecutive frame IDs, with each partition's min and max
+//! timestamp. The bounds are saved next to the file on commit, as
+//! `<file>.tindex`, and extended from the frames added since, so opening a
+//! memory never scans it. A partition's sorted (timestamp, frame) entries
+//! are read with `frame_by_id` only when a query needs them, and at most
+//! `MAX_LOADED` partitions keep them; the rest stay unloaded.
+//!
+//! Before a query reaches the core, its bounds are narrowed. Partitions
+//! whose span misses the range are skipped, and a range no partition
+//! overlaps returns empty without a core call. With a limit, the far bound
+//! is pulled in to the timestamp of the last entry the limit can reach, so
+//! the core scans only that stretch of its index.
+//!
+//! The narrowed bounds must never drop an entry the core would return. Only
+//! frames known to be listed count towards a limit: active, committed, not
+//! a chunk of another frame. Counting fewer entries than the core only
+//! leaves a bound wider than needed. The index is only used while it covers
+//! every frame. A memory with no usable sidecar (created before the index
+//! existed, or committed elsewhere since) and one whose frame IDs were
+//! reassigned by compaction or a snapshot apply are indexed again from the
+//! first frame, `BUILD_STEP` frames per query or commit, and queried without
+//! narrowing until the index catches up; the next commit then saves the
+//! sidecar. Only a frame that cannot be read stops the index, until the
+//! file is next replaced.
+
+use crate::util::{sidecar_path, write_sidecar};
+use memvid_core::{FrameStatus, Memvid};
+use std::cmp::Reverse;
+use std::collections::BinaryHeap;
+use std::path::Path;
+
+/// Sidecar file suffix.
+const SIDECAR: &str = ".tindex";
+
+/// Sidecar file magic, including the format version.
+const MAGIC: &[u8; 8] = b"MVTIDX01";
+
+/// Frames per partition.
+const PARTITION_FRAMES: u64 = 4096;
+
+/// Partitions whose entries are kept in memory.
+const MAX_LOADED: usize = 64;
+
+/// Frames indexed per query or commit, so that catching up on a large
+/// memory is spread over many calls instead of stalling one.
+const BUILD_STEP: u64 = 4 * PARTITION_FRAMES;
+
+/// Larger limits are passed to the core without narrowing the far bound,
+/// which would need an entry per result in memory.
+const MAX_NARROWED_LIMIT: u64 = 1 << 16;
+
+#[derive(Debug, Clone, Copy)]
+struct Entry {
+    timestamp: i64,
+    frame_id: u64,
+    /// Active top-level frame, as listed by the core timeline
+    listed: bool,
+}
+
+/// Consecutive frame IDs with their timestamp span.
+struct Partition {
+    /// Smallest timestamp (`i64::MAX` while empty)
+    min: i64,
+    /// Largest timestamp (`i64::MIN` while empty)
+    max: i64,
+    /// Entries sorted by (timestamp, frame), when loaded
+    entries: Option<Vec<Entry>>,
+    /// Tick of the last query that used the entries
+    used: u64,
+}
+
+impl Partition {
+    fn unloaded(min: i64, max: i64) -> Self {
+        Self {
+            min,
+            max,
+            entries: None,
+            used: 0,
+        }
+    }
+
+    fn overlaps(&self, since: i64, until: i64) -> bool {
+        self.min <= until && self.max >= since
+    }
+}
+
+/// Timeline bounds after narrowing.
+pub(crate) type Bounds = (Option<i64>, Option<i64>);
+
+/// Per-handle index of frame timestamps by partition.
+pub(crate) struct TimeIndex {
+    partitions: Vec<Partition>,
+    /// Frames with an ID below this have been indexed; `None` once a frame
+    /// could not be read
+    indexed: Option<u64>,
+    /// Partitions with entries in memory
+    loaded: usize,
+    tick: u64,
+    /// Changed since it was last saved
+    dirty: bool,
+}
+
+fn entry_of(memvid: &mut Memvid, frame_id: u64) -> Option<Entry> {
+    let frame = memvid.frame_by_id(frame_id).ok()?;
+    Some(Entry {
+        timestamp: frame.timestamp,
+        frame_id,
+        listed: matches!(frame.status, FrameStatus::Active) && frame.parent_id.is_none(),
+    })
+}
+
+impl TimeIndex {
+    /// Empty index, built from the first frame as queries and commits run.
+    pub(crate) fn new() -> Self {
+        Self {
+            partitions: Vec::new(),
+            indexed: Some(0),
+            loaded: 0,
+            tick: 0,
+            dirty: false,
+        }
+    }
+
+    /// Load the partition bounds saved next to `path`, if they still
+    /// describe the file; otherwise start building them.
+    pub(crate) fn load(path: &Path, frames: usize) -> Self {
+        match Self::read_sidecar(path, frames as u64) {
+            Some(partitions) => Self {
+                partitions,
+                indexed: Some(frames as u64),
+                ..Self::new()
+            },
+            None => Self::new(),
+        }
+    }
+
+    /// Rebuild from the first frame after frame IDs were reassigned.
+    pub(crate) fn reset(&mut self) {
+        *self = Self {
+            dirty: true,
+            ..Self::new()
+        };
+    }
+
+    /// Index up to `BUILD_STEP` of the frames added since the last refresh.
+    ///
+    /// Returns whether the index covers every frame.
+    fn refresh(&mut self, memvid: &mut Memvid) -> bool {
+        let count = memvid.frame_count() as u64;
+        let stop = self
+            .indexed
+            .map_or(0, |id| id.saturating_add(BUILD_STEP).min(count));
+        while let Some(id) = self.indexed.filter(|&id| id < stop) {
+            let index = (id / PARTITION_FRAMES) as usize;
+            if index == self.partitions.len() {
+                self.partitions.push(Partition {
+                    entries: Some(Vec::new()),
+                    used: self.tick,
+                    ..Partition::unloaded(i64::MAX, i64::MIN)
+                });
+                self.loaded += 1;
+                self.evict(index);
+            }
+            let Some(entry) = entry_of(memvid, id) else {
+                // A frame the index cannot place might still be listed
+                *self = Self {
+                    indexed: None,
+                    dirty: true,
+                    ..Self::new()
+                };
+                return false;
+            };
+            self.indexed = Some(id + 1);
+            self.dirty = true;
+            let partition = &mut self.partitions[index];
+            partition.min = partition.min.min(entry.timestamp);
+            partition.max = partition.max.max(entry.timestamp);
+            // An unloaded partition reads this frame when it is next loaded
+            if let Some(entries) = partition.entries.as_mut() {
+                let at = entries.partition_point(|e| e.timestamp <= entry.timestamp);
+                entries.insert(at, entry);
+            }
+        }
+        self.indexed == Some(count)
+    }
+
+    /// Unload the least recently used partition other than `keep` while
+    /// over budget.
+    fn evict(&mut self, keep: usize) {
+        while self.loaded > MAX_LOADED {
+            let coldest = self
+                .partitions
+                .iter()
+                .enumerate()
+                .filter(|(i, p)| *i != keep && p.entries.is_some())
+                .min_by_key(|(_, p)| p.used)
+                .map(|(i, _)| i);
+            let Some(coldest) = coldest else {
+                return;
+            };
+            self.partitions[coldest].entries = None;
+            self.loaded -= 1;
+        }
+    }
+
+    /// Entries of partition `index`, loading them if needed.
+    fn entries(&mut self, memvid: &mut Memvid, index: usize) -> &[Entry] {
+        if self.partitions[index].entries.is_none() {
+            let first = index as u64 * PARTITION_FRAMES;
+            let end = (first + PARTITION_FRAMES).min(self.indexed.unwrap_or(0));
+            let mut entries: Vec<Entry> =
+                (first..end).filter_map(|id| entry_of(memvid, id)).collect();
+            entries.sort_by_key(|e| (e.timestamp, e.frame_id));
+            self.partitions[index].entries = Some(entries);
+            self.loaded += 1;
+            self.evict(index);
+        }
+        let partition = &mut self.partitions[index];
+        partition.used = self.tick;
+        partition.entries.as_deref().expect("loaded above")
+    }
+
+    /// Note that a frame was deleted and is no longer listed.
+    pub(crate) fn forget(&mut self, frame_id: u64) {
+        let index = (frame_id / PARTITION_FRAMES) as usize;
+        let entries = self
+            .partitions
+            .get_mut(index)
+            .and_then(|p| p.entries.as_mut());
+        if let Some(entry) = entries.and_then(|e| e.iter_mut().find(|e| e.frame_id == frame_id)) {
+            entry.listed = false;
+        }
+    }
+
+    /// Extend the index and write the sidecar of `path`, or remove it if
+    /// the index does not cover the memory yet.
+    pub(crate) fn save(&mut self, memvid: &mut Memvid, path: &Path) {
+        let covered = self.refresh(memvid);
+        if !self.dirty {
+            return;
+        }
+        self.dirty = false;
+        let sidecar = sidecar_path(path, SIDECAR);
+        let Some(indexed) = self.indexed.filter(|_| covered) else {
+            let _ = std::fs::remove_file(&sidecar);
+            return;
+        };
+        let Ok(len) = std::fs::metadata(path).map(|m| m.len()) else {
+            return;
+        };
+
+        let mut out = Vec::with_capacity(32 + self.partitions.len() * 16);
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&indexed.to_le_bytes());
+        out.extend_from_slice(&len.to_le_bytes());
+        out.extend_from_slice(&(self.partitions.len() as u64).to_le_bytes());
+        for partition in &self.partitions {
+            out.extend_from_slice(&partition.min.to_le_bytes());
+            out.extend_from_slice(&partition.max.to_le_bytes());
+        }
+        write_sidecar(&sidecar, &out);
+    }
+
+    /// Parse the sidecar of `path` if it covers `frames` frames of the
+    /// file at its current length.
+    fn read_sidecar(path: &Path, frames: u64) -> Option<Vec<Partition>> {
+        let bytes = std::fs::read(sidecar_path(path, SIDECAR)).ok()?;
+        let (magic, mut rest) = bytes.split_first_chunk::<8>()?;
+        if magic != MAGIC {
+            return None;
+        }
+        let mut next = || {
+            let (word, tail) = rest.split_first_chunk::<8>()?;
+            rest = tail;
+            Some(*word)
+        };
+
+        let indexed = u64::from_le_bytes(next()?);
+        let len = u64::from_le_bytes(next()?);
+        let count = u64::from_le_bytes(next()?);
+        let current = std::fs::metadata(path).ok()?.len();
+        if indexed != frames || len != current || count != frames.div_ceil(PARTITION_FRAMES) {
+            return None;
+        }
+        let partitions = (0..count)
+            .map(|_| {
+                let min = i64::from_le_bytes(next()?);
+                let max = i64::from_le_bytes(next()?);
+                Some(Partition::unloaded(min, max))
+            })
+            .collect::<Option<Vec<_>>>()?;
+        next().is_none().then_some(partitions)
+    }
+
+    /// Narrow timeline bounds, or `None` if no frame can match.
+    ///
+    /// `committed` is the number of committed frames; newer frames are not
+    /// counted towards `limit`.
+    pub(crate) fn narrow(
+        &mut self,
+        memvid: &mut Memvid,
+        committed: u64,
+        (since, until): Bounds,
+        reverse: bool,
+        limit: Option<u64>,
+    ) -> Option<Bounds> {
+        if !self.refresh(memvid) {
+            return Some((since, until));
+        }
+        self.tick += 1;
+        let lo = since.unwrap_or(i64::MIN);
+        let hi = until.unwrap_or(i64::MAX);
+        if lo > hi {
+            return None;
+        }
+
+        let mut overlapping: Vec<usize> = (0..self.partitions.len())
+            .filter(|&i| self.partitions[i].overlaps(lo, hi))
+            .collect();
+        if overlapping.is_empty() {
+            return None;
+        }
+        let span_lo = overlapping.iter().map(|&i| self.partitions[i].min).min()?;
+        let span_hi = overlapping.iter().map(|&i| self.partitions[i].max).max()?;
+        let mut bounds = (Some(lo.max(span_lo)), Some(hi.min(span_hi)));
+
+        let Some(limit) = limit.filter(|&l| l > 0 && l <= MAX_NARROWED_LIMIT) else {
+            return Some(bounds);
+        };
+        let limit = limit as usize;
+
+        // Visit partitions nearest end first; once `limit` entries are found,
+        // a partition starting past the furthest of them cannot contribute
+        if reverse {
+            overlapping.sort_by_key(|&i| Reverse(self.partitions[i].max));
+        } else {
+            overlapping.sort_by_key(|&i| self.partitions[i].min);
+        }
+        // Forward keeps the `limit` smallest timestamps (max-heap on top),
+        // reverse the largest, so the top is the limit's reach either way
+        let mut reach: BinaryHeap<i128> = BinaryHeap::with_capacity(limit + 1);
+        let key = |ts: i64| {
+            if reverse {
+                -i128::from(ts)
+            } else {
+                i128::from(ts)
+            }
+        };
+        for index in overlapping {
+            if reach.len() == limit {
+                let start = if reverse {
+                    self.partitions[index].max
+                } else {
+                    self.partitions[index].min
+                };
+                if key(start) > *reach.peek()? {
+                    break;
+                }
+            }
+            let entries = self.entries(memvid, index);
+            let from = entries.partition_point(|e| e.timestamp < lo);
+            let to = entries.partition_point(|e| e.timestamp <= hi);
+            for entry in &entries[from..to] {
+                if entry.listed && entry.frame_id < committed {
+                    reach.push(key(entry.timestamp));
+                    if reach.len() > limit {
+                        reach.pop();
+                    }
+                }
+            }
+        }
+
+        if reach.len() == limit {
+            let top = *reach.peek()?;
+            if reverse {
+                bounds.0 = i64::try_from(-top).ok();
+            } else {
+                bounds.1 = i64::try_from(top).ok();
+            }
+        }
+        Some(bounds)
+    }
+}
@@ -2,30 +2,32 @@
 
 use crate::error::MemvidError;
 use crate::handle::MemvidHandle;
-use crate::util::{cstr_to_option_string, set_error_null, set_ok, string_to_cstr};
+use crate::metrics::{Op, Phase, Span};
+use crate::util::{cstr_to_option_str, set_error, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
 use serde::{Deserialize, Serialize};
 use std::num::NonZeroU64;
 use std::os::raw::c_char;
 
 /// JSON schema for TimelineQuery.
-#[derive(Debug, Default, Deserialize)]
-struct TimelineQueryJson {
+#[derive(Debug, Default, Clone, Deserialize)]
+pub(crate) struct TimelineQueryJson {
     /// Maximum number of entries to return
     #[serde(default)]
-    limit: Option<u64>,
+    pub(crate) limit: Option<u64>,
     /// Timestamp lower bound (inclusive)
     #[serde(default)]
-    since: Option<i64>,
+    pub(crate) since: Option<i64>,
     /// Timestamp upper bound (inclusive)
     #[serde(default)]
-    until: Option<i64>,
+    pub(crate) until: Option<i64>,
     /// Return in reverse chronological order
     #[serde(default)]
-    reverse: bool,
+    pub(crate) reverse: bool,
 }
 
 impl TimelineQueryJson {
-    fn into_query(self) -> memvid_core::TimelineQuery {
+    pub(crate) fn into_query(self) -> memvid_core::TimelineQuery {
         let mut builder = memvid_core::TimelineQueryBuilder::default();
 
         if let Some(limit) = self.limit {
@@ -45,14 +47,168 @@ impl TimelineQueryJson {
     }
 }
 
+/// Run a timeline query with its bounds narrowed by the handle's time index.
+pub(crate) fn run_timeline(
+    handle: &mut MemvidHandle,
+    query: TimelineQueryJson,
+) -> Result<Vec<memvid_core::TimelineEntry>, memvid_core::MemvidError> {
+    let bounds = (query.since, query.until);
+    match handle.narrow_timeline(bounds, query.reverse, query.limit) {
+        Some((since, until)) => handle.as_mut().timeline(
+            TimelineQueryJson {
+                since,
+                until,
+                ..query
+            }
+            .into_query(),
+        ),
+        None => Ok(Vec::new()),
+    }
+}
+
+/// Default batch size for `memvid_timeline_next` when 0 is passed.
+const DEFAULT_TIMELINE_BATCH: u64 = 100;
+
+/// Entries a cursor may re-read at its boundary timestamp.
+///
+/// The core resumes a timeline by timestamp only, so a batch that starts
+/// inside a run of equal timestamps reads the run's emitted entries again.
+/// Capping that keeps each batch bounded; a cursor fails rather than walk
+/// a longer run.
+const MAX_BOUNDARY_ENTRIES: u64 = 4096;
+
+/// Cursor over the timeline, returned by `memvid_timeline_open`.
+///
+/// The cursor holds only the query bounds and its position, the
+/// (timestamp, frame ID) of the last emitted entry, so its memory is fixed
+/// no matter how large the timeline is. Entries are ordered by that pair
+/// and each batch resumes strictly after it, reading at most
+/// `MAX_BOUNDARY_ENTRIES` entries beyond the batch size.
+pub struct MemvidTimelineCursor {
+    since: Option<i64>,
+    until: Option<i64>,
+    reverse: bool,
+    /// Entries left under the query's overall limit
+    remaining: Option<u64>,
+    /// Timestamp and frame ID of the last emitted entry
+    boundary: Option<(i64, u64)>,
+    /// Entries emitted at the boundary timestamp
+    at_boundary: u64,
+    done: bool,
+}
+
+impl MemvidTimelineCursor {
+    fn new(query: TimelineQueryJson) -> Self {
+        Self {
+            since: query.since,
+            until: query.until,
+            reverse: query.reverse,
+            remaining: query.limit,
+            boundary: None,
+            at_boundary: 0,
+            done: query.limit == Some(0),
+        }
+    }
+
+    /// Whether `entry` comes after the last emitted entry.
+    fn is_after_boundary(&self, entry: &memvid_core::TimelineEntry) -> bool {
+        let key = (entry.timestamp, entry.frame_id);
+        match self.boundary {
+            None => true,
+            Some(boundary) if self.reverse => key < boundary,
+            Some(boundary) => key > boundary,
+        }
+    }
+
+    /// Fetch the next batch of at most `batch_size` entries.
+    ///
+    /// Timeline bounds are timestamps, so the engine returns the boundary
+    /// timestamp's earlier entries again; the fetch is sized to skip them,
+    /// up to `MAX_BOUNDARY_ENTRIES` of them.
+    fn next_batch(
+        &mut self,
+        handle: &mut MemvidHandle,
+        batch_size: u64,
+    ) -> Result<Vec<memvid_core::TimelineEntry>, memvid_core::MemvidError> {
+        if self.done {
+            return Ok(Vec::new());
+        }
+
+        let want = self.remaining.map_or(batch_size, |r| r.min(batch_size));
+        let mut since = self.since;
+        let mut until = self.until;
+        if let Some((timestamp, _)) = self.boundary {
+            if self.reverse {
+                until = Some(timestamp);
+            } else {
+                since = Some(timestamp);
+            }
+        }
+
+        let too_many = memvid_core::MemvidError::InvalidCursor {
+            reason: "more timeline entries share one timestamp than a cursor can skip",
+        };
+        let max_fetch = want.saturating_add(MAX_BOUNDARY_ENTRIES);
+        let mut fetch = want.saturating_add(self.at_boundary);
+        if fetch > max_fetch {
+            return Err(too_many);
+        }
+        let (batch, exhausted) = loop {
+            let query = TimelineQueryJson {
+                limit: Some(fetch),
+                since,
+                until,
+                reverse: self.reverse,
+            };
+            let fetched = run_timeline(handle, query)?;
+            let exhausted = (fetched.len() as u64) < fetch;
+            let batch: Vec<_> = fetched
+                .into_iter()
+                .filter(|e| self.is_after_boundary(e))
+                .take(want as usize)
+                .collect();
+            // Frames stored at the boundary timestamp since the last batch
+            // can leave it short; widen the fetch until it fills
+            if batch.len() as u64 == want || exhausted {
+                break (batch, exhausted);
+            }
+            // Only entries at the boundary timestamp are skipped
+            if fetch == max_fetch {
+                return Err(too_many);
+            }
+            fetch = fetch.saturating_mul(2).min(max_fetch);
+        };
+
+        if let Some(last) = batch.last() {
+            let emitted = batch
+                .iter()
+                .filter(|e| e.timestamp == last.timestamp)
+                .count() as u64;
+            if self.boundary.is_some_and(|(t, _)| t == last.timestamp) {
+                self.at_boundary += emitted;
+            } else {
+                self.at_boundary = emitted;
+            }
+            self.boundary = Some((last.timestamp, last.frame_id));
+        }
+
+        if let Some(remaining) = self.remaining.as_mut() {
+            *remaining -= batch.len() as u64;
+        }
+        self.done = exhausted || batch.is_empty() || self.remaining == Some(0);
+
+        Ok(batch)
+    }
+}
+
 /// Timeline entry for JSON serialization.
 #[derive(Debug, Serialize)]
-struct TimelineEntryJson {
-    frame_id: u64,
-    timestamp: i64,
-    preview: String,
-    uri: Option<String>,
-    child_frames: Vec<u64>,
+pub(crate) struct TimelineEntryJson {
+    pub(crate) frame_id: u64,
+    pub(crate) timestamp: i64,
+    pub(crate) preview: String,
+    pub(crate) uri: Option<String>,
+    pub(crate) child_frames: Vec<u64>,
 }
 
 impl From<&memvid_core::TimelineEntry> for TimelineEntryJson {
@@ -69,13 +225,24 @@ impl From<&memvid_core::TimelineEntry> for TimelineEntryJson {
 
 /// Timeline response for JSON serialization.
 #[derive(Debug, Serialize)]
-struct TimelineResponseJson {
+pub(crate) struct TimelineResponseJson {
+    pub(crate) entries: Vec<TimelineEntryJson>,
+    pub(crate) count: usize,
+}
+
+/// Timeline batch response for JSON serialization.
+#[derive(Debug, Serialize)]
+struct TimelineBatchJson {
     entries: Vec<TimelineEntryJson>,
     count: usize,
+    done: bool,
 }
 
 /// Query the timeline (chronological frame list).
 ///
+/// Bounds are narrowed with the handle's time index first (see
+/// `timeindex.rs`), so only partitions overlapping the range are read.
+///
 /// # Parameters
 ///
 /// - `handle`: Valid Memvid handle
@@ -126,27 +293,346 @@ pub unsafe extern "C" fn memvid_timeline(
     query_json: *const c_char,
     error: *mut MemvidError,
 ) -> *mut c_char {
+    let mut span = Span::start(Op::Timeline);
     let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
         Some(h) => h,
         None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
     };
 
     // Parse query JSON
-    let query = match unsafe { cstr_to_option_string(query_json, "query_json") } {
-        Ok(Some(json_str)) => match serde_json::from_str::<TimelineQueryJson>(&json_str) {
-            Ok(q) => q.into_query(),
+    let query = match unsafe { cstr_to_option_str(query_json, "query_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<TimelineQueryJson>(json_str) {
+            Ok(q) => {
+                span.bytes_in(json_str.len());
+                q
+            }
             Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
         },
-        Ok(None) => memvid_core::TimelineQuery::default(),
+        Ok(None) => TimelineQueryJson::default(),
         Err(e) => return unsafe { set_error_null(error, e) },
     };
+    span.phase(Phase::Parse);
 
-    match handle.as_mut().timeline(query) {
+    let result = run_timeline(handle, query);
+    span.phase(Phase::Core);
+    match result {
         Ok(entries) => {
             let response = TimelineResponseJson {
                 count: entries.len(),
                 entries: entries.iter().map(TimelineEntryJson::from).collect(),
             };
+            match serde_json::to_string(&response) {
+                Ok(json) => {
+                    span.phase(Phase::Serialize);
+                    span.bytes_out(json.len());
+                    let ptr = string_to_cstr(json);
+                    span.phase(Phase::Copy);
+                    unsafe { set_ok(error) };
+                    ptr
+                }
+                Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+            }
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
+    }
+}
+
+/// Binary timeline query for `memvid_timeline_bin`.
+///
+/// Field-for-field equivalent of the `memvid_timeline` query JSON.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidTimelineQuery {
+    /// Maximum number of entries to return (0 for no limit)
+    pub limit: u64,
+    /// Timestamp lower bound, inclusive (valid when `has_since` is 1)
+    pub since: i64,
+    /// Timestamp upper bound, inclusive (valid when `has_until` is 1)
+    pub until: i64,
+    /// Whether `since` is set
+    pub has_since: u8,
+    /// Whether `until` is set
+    pub has_until: u8,
+    /// Return in reverse chronological order
+    pub reverse: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 5],
+}
+
+impl From<&MemvidTimelineQuery> for TimelineQueryJson {
+    fn from(q: &MemvidTimelineQuery) -> Self {
+        Self {
+            limit: (q.limit > 0).then_some(q.limit),
+            since: (q.has_since != 0).then_some(q.since),
+            until: (q.has_until != 0).then_some(q.until),
+            reverse: q.reverse != 0,
+        }
+    }
+}
+
+/// Timeline entry in the binary result layout.
+///
+/// String fields are stored in the caller's arena buffer and referenced by
+/// byte offset and length. Arena strings are UTF-8 and NOT null-terminated.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidTimelineEntry {
+    /// Frame ID
+    pub frame_id: u64,
+    /// Unix timestamp (seconds)
+    pub timestamp: i64,
+    /// Number of child frames (fetch them with `memvid_timeline`)
+    pub child_count: u64,
+    /// Whether the entry has a URI
+    pub has_uri: u8,
+    /// Padding for alignment
+    pub _padding: [u8; 7],
+    /// Arena offset of the preview text
+    pub preview_offset: u64,
+    /// Length of the preview text in bytes
+    pub preview_len: u64,
+    /// Arena offset of the URI
+    pub uri_offset: u64,
+    /// Length of the URI in bytes
+    pub uri_len: u64,
+}
+
+/// Summary of a binary timeline result.
+///
+/// On a `BufferTooSmall` failure, both fields still report the capacities
+/// required to hold the full result.
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemvidTimelineResult {
+    /// Number of entries returned (entries required in the entries array)
+    pub entry_count: u64,
+    /// Bytes of string arena used (or required)
+    pub arena_bytes: u64,
+}
+
+/// Query the timeline with a binary query and binary result.
+///
+/// The binary counterpart of `memvid_timeline`: entries are written as
+/// `MemvidTimelineEntry` records with their strings packed into one arena
+/// buffer, so no JSON is produced or parsed.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `query`: Binary timeline query (NULL for defaults)
+/// - `entries`: Out-array for entry records (may be NULL when `entries_capacity` is 0)
+/// - `entries_capacity`: Number of entries available in `entries`
+/// - `arena`: Out-buffer for entry strings (may be NULL when `arena_capacity` is 0)
+/// - `arena_capacity`: Size of `arena` in bytes
+/// - `result`: Out-parameter for the result summary (must not be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure. If either buffer is too small the error code
+/// is `BufferTooSmall`, nothing is written to `entries` or `arena`, and
+/// `result` holds the required sizes.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `query` must be a valid pointer or NULL
+/// - `entries` must point to `entries_capacity` writable entries or be NULL
+/// - `arena` must point to `arena_capacity` writable bytes or be NULL
+/// - `result` must be a valid pointer
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_timeline_bin(
+    handle: *mut MemvidHandle,
+    query: *const MemvidTimelineQuery,
+    entries: *mut MemvidTimelineEntry,
+    entries_capacity: size_t,
+    arena: *mut u8,
+    arena_capacity: size_t,
+    result: *mut MemvidTimelineResult,
+    error: *mut MemvidError,
+) -> i32 {
+    let mut span = Span::start(Op::TimelineBin);
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    let result = match unsafe { result.as_mut() } {
+        Some(r) => r,
+        None => return unsafe { set_error(error, MemvidError::null_pointer("result")) },
+    };
+
+    let query = unsafe { query.as_ref() }
+        .map(TimelineQueryJson::from)
+        .unwrap_or_default();
+    span.phase(Phase::Parse);
+
+    let timeline = match run_timeline(handle, query) {
+        Ok(t) => t,
+        Err(e) => return unsafe { set_error(error, MemvidError::from_core_error(e)) },
+    };
+    span.phase(Phase::Core);
+
+    // Size the result before touching caller buffers
+    let arena_bytes: usize = timeline
+        .iter()
+        .map(|e| e.preview.len() + e.uri.as_deref().map_or(0, str::len))
+        .sum();
+    *result = MemvidTimelineResult {
+        entry_count: timeline.len() as u64,
+        arena_bytes: arena_bytes as u64,
+    };
+
+    let entry_count = timeline.len();
+    if entry_count > entries_capacity || (entry_count > 0 && entries.is_null()) {
+        return unsafe { set_error(error, MemvidError::buffer_too_small("entries", entry_count)) };
+    }
+    if arena_bytes > arena_capacity || (arena_bytes > 0 && arena.is_null()) {
+        return unsafe { set_error(error, MemvidError::buffer_too_small("arena", arena_bytes)) };
+    }
+
+    let mut offset = 0usize;
+    let mut push = |s: &str| -> (u64, u64) {
+        let start = offset;
+        // The arena may be null when every string is empty
+        if !s.is_empty() {
+            unsafe { std::ptr::copy_nonoverlapping(s.as_ptr(), arena.add(start), s.len()) };
+        }
+        offset += s.len();
+        (start as u64, s.len() as u64)
+    };
+
+    for (i, entry) in timeline.iter().enumerate() {
+        let (preview_offset, preview_len) = push(&entry.preview);
+        let (uri_offset, uri_len) = push(entry.uri.as_deref().unwrap_or(""));
+        let record = MemvidTimelineEntry {
+            frame_id: entry.frame_id,
+            timestamp: entry.timestamp,
+            child_count: entry.child_frames.len() as u64,
+            has_uri: entry.uri.is_some() as u8,
+            _padding: [0; 7],
+            preview_offset,
+            preview_len,
+            uri_offset,
+            uri_len,
+        };
+        unsafe { entries.add(i).write(record) };
+    }
+    span.phase(Phase::Copy);
+    span.bytes_out(arena_bytes + entry_count * std::mem::size_of::<MemvidTimelineEntry>());
+
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Open a streaming cursor over the timeline.
+///
+/// The cursor walks the time index lazily; each `memvid_timeline_next` call
+/// reads only the next batch, so the first entries of a very large timeline
+/// come back without materializing the rest.
+///
+/// # Parameters
+///
+/// - `query_json`: JSON string with query parameters (NULL for defaults,
+///   same schema as `memvid_timeline`; `limit` caps the total entries)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Cursor on success, NULL on failure.
+///
+/// # Ownership
+///
+/// Caller owns the returned cursor. Must call `memvid_timeline_close()` to free.
+///
+/// # Safety
+///
+/// - `query_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_timeline_open(
+    query_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut MemvidTimelineCursor {
+    let query = match unsafe { cstr_to_option_str(query_json, "query_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<TimelineQueryJson>(json_str) {
+            Ok(q) => q,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => TimelineQueryJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    unsafe { set_ok(error) };
+    Box::into_raw(Box::new(MemvidTimelineCursor::new(query)))
+}
+
+/// Fetch the next batch of timeline entries from a cursor.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle the cursor is iterating over
+/// - `cursor`: Valid timeline cursor
+/// - `batch_size`: Maximum entries to return (0 for the default of 100)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the batch on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Response JSON Schema
+///
+/// ```json
+/// {
+///   "entries": [ ... same entry schema as memvid_timeline ... ],
+///   "count": 100,
+///   "done": false
+/// }
+/// ```
+///
+/// `done` is true once the cursor is exhausted; further calls return an
+/// empty batch. A batch reads at most 4096 entries beyond `batch_size`, to
+/// skip the entries already emitted at its starting timestamp; a cursor
+/// positioned inside a longer run of equal timestamps fails with
+/// `InvalidCursor`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `cursor` must be a valid cursor
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_timeline_next(
+    handle: *mut MemvidHandle,
+    cursor: *mut MemvidTimelineCursor,
+    batch_size: u64,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let cursor = match unsafe { cursor.as_mut() } {
+        Some(c) => c,
+        None => return unsafe { set_error_null(error, MemvidError::null_pointer("cursor")) },
+    };
+
+    let batch_size = if batch_size == 0 {
+        DEFAULT_TIMELINE_BATCH
+    } else {
+        batch_size
+    };
+
+    match cursor.next_batch(handle, batch_size) {
+        Ok(entries) => {
+            let response = TimelineBatchJson {
+                count: entries.len(),
+                entries: entries.iter().map(TimelineEntryJson::from).collect(),
+                done: cursor.done,
+            };
             match serde_json::to_string(&response) {
                 Ok(json) => {
                     unsafe { set_ok(error) };
@@ -158,3 +644,24 @@ pub unsafe extern "C" fn memvid_timeline(
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
 }
+
+/// Close and free a timeline cursor.
+///
+/// # Parameters
+///
+/// - `cursor`: Cursor to close (safe to pass NULL)
+///
+/// # Safety
+///
+/// - `cursor` must be a valid cursor returned by `memvid_timeline_open`, or NULL
+/// - The cursor must not be used after this call
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_timeline_close(cursor: *mut MemvidTimelineCursor) {
+    if cursor.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(cursor));
+    }
+}
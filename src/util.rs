@@ -1,9 +1,11 @@
 //! Utility functions for FFI operations.
 
 use crate::error::MemvidError;
+use libc::size_t;
 use std::ffi::{CStr, CString};
+use std::io::Write;
 use std::os::raw::c_char;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 /// Convert a C string to a PathBuf.
 ///
@@ -69,22 +71,113 @@ pub unsafe fn cstr_to_option_string(
     }
 }
 
+/// Borrow a C string as a `&str` without copying.
+///
+/// Request parsers use this instead of `cstr_to_string` so the JSON text is
+/// parsed in place.
+///
+/// # Safety
+///
+/// The caller must ensure `ptr` is either null or points to a valid
+/// null-terminated C string that outlives the returned reference.
+pub unsafe fn cstr_to_str<'a>(
+    ptr: *const c_char,
+    param_name: &str,
+) -> Result<&'a str, MemvidError> {
+    if ptr.is_null() {
+        return Err(MemvidError::null_pointer(param_name));
+    }
+
+    let cstr = unsafe { CStr::from_ptr(ptr) };
+    cstr.to_str()
+        .map_err(|_| MemvidError::invalid_utf8(param_name))
+}
+
+/// Borrow an optional C string as an `Option<&str>` without copying.
+///
+/// # Safety
+///
+/// The caller must ensure `ptr` is either null or points to a valid
+/// null-terminated C string that outlives the returned reference.
+pub unsafe fn cstr_to_option_str<'a>(
+    ptr: *const c_char,
+    param_name: &str,
+) -> Result<Option<&'a str>, MemvidError> {
+    if ptr.is_null() {
+        return Ok(None);
+    }
+    unsafe { cstr_to_str(ptr, param_name) }.map(Some)
+}
+
+/// Length-delimited UTF-8 string passed by reference in binary requests.
+///
+/// A NULL `ptr` means the field is absent. The bytes need not be
+/// null-terminated.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct MemvidStr {
+    /// Pointer to the string bytes (NULL if absent)
+    pub ptr: *const c_char,
+    /// Length in bytes
+    pub len: size_t,
+}
+
+impl Default for MemvidStr {
+    fn default() -> Self {
+        Self {
+            ptr: std::ptr::null(),
+            len: 0,
+        }
+    }
+}
+
+impl MemvidStr {
+    /// Borrow the string, or `None` if `ptr` is NULL.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be NULL or point to at least `len` readable bytes.
+    pub unsafe fn as_str<'a>(&self, param_name: &str) -> Result<Option<&'a str>, MemvidError> {
+        if self.ptr.is_null() {
+            return Ok(None);
+        }
+        let bytes = unsafe { std::slice::from_raw_parts(self.ptr.cast::<u8>(), self.len) };
+        std::str::from_utf8(bytes)
+            .map(Some)
+            .map_err(|_| MemvidError::invalid_utf8(param_name))
+    }
+}
+
 /// Convert a Rust string to a C string, returning an owned pointer.
 ///
 /// The caller is responsible for freeing the returned pointer with `memvid_string_free`.
 /// Returns null if the string contains internal null bytes.
 pub fn string_to_cstr(s: String) -> *mut c_char {
+    if let Some(ptr) = crate::arena::hooked_cstr(s.as_bytes()) {
+        return ptr;
+    }
     CString::new(s)
         .map(CString::into_raw)
         .unwrap_or(std::ptr::null_mut())
 }
 
+/// Copy a C string into a new caller-owned C string.
+///
+/// The caller is responsible for freeing the returned pointer with `memvid_string_free`.
+pub fn cstr_copy(s: &CStr) -> *mut c_char {
+    match crate::arena::hooked_cstr(s.to_bytes()) {
+        Some(ptr) => ptr,
+        None => s.to_owned().into_raw(),
+    }
+}
+
 /// Set an error in the out-parameter and return a default value.
 ///
 /// # Safety
 ///
 /// The caller must ensure `error` is either null or a valid pointer.
 pub unsafe fn set_error<T: Default>(error: *mut MemvidError, err: MemvidError) -> T {
+    crate::metrics::count_error(err.code);
     if let Some(e) = unsafe { error.as_mut() } {
         *e = err;
     }
@@ -97,6 +190,7 @@ pub unsafe fn set_error<T: Default>(error: *mut MemvidError, err: MemvidError) -
 ///
 /// The caller must ensure `error` is either null or a valid pointer.
 pub unsafe fn set_error_null<T>(error: *mut MemvidError, err: MemvidError) -> *mut T {
+    crate::metrics::count_error(err.code);
     if let Some(e) = unsafe { error.as_mut() } {
         *e = err;
     }
@@ -113,3 +207,26 @@ pub unsafe fn set_ok(error: *mut MemvidError) {
         *e = MemvidError::ok();
     }
 }
+
+/// Path of the sidecar file with `suffix` next to the memory at `path`.
+pub(crate) fn sidecar_path(path: &Path, suffix: &str) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(suffix);
+    path.with_file_name(name)
+}
+
+/// Replace `sidecar` with `bytes` through a scratch file.
+///
+/// Sidecars only save work, so a failed write removes the sidecar and is
+/// otherwise ignored.
+pub(crate) fn write_sidecar(sidecar: &Path, bytes: &[u8]) {
+    let mut scratch = sidecar.as_os_str().to_owned();
+    scratch.push(".tmp");
+    let written = std::fs::File::create(&scratch)
+        .and_then(|mut file| file.write_all(bytes))
+        .and_then(|()| std::fs::rename(&scratch, sidecar));
+    if written.is_err() {
+        let _ = std::fs::remove_file(&scratch);
+        let _ = std::fs::remove_file(sidecar);
+    }
+}
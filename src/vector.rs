@@ -0,0 +1,344 @@
+//! Vector and hybrid search with caller-supplied embeddings.
+//!
+//! These entry points let callers that run their own embedding model use the
+//! memvid-core vector index without an embedder inside the library: frames
+//! are stored with a pre-computed embedding and queries pass the query
+//! vector directly. Nearest-neighbour search and lexical/vector fusion are
+//! done by memvid-core.
+//!
+//! Both functions are always exported; without the `vec` feature they fail
+//! with `MemvidErrorCode_VecNotEnabled`.
+
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::mutation::parse_put_options;
+use crate::util::{cstr_to_option_string, set_error, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
+use memvid_core::PutOptions;
+use serde::Deserialize;
+use std::os::raw::c_char;
+
+#[cfg(feature = "vec")]
+use crate::ask::AskResponseJson;
+#[cfg(feature = "vec")]
+use crate::dedup;
+
+/// Retrieval mode for `memvid_search_vec`.
+#[derive(Debug, Default, Deserialize)]
+#[serde(rename_all = "lowercase")]
+enum VecModeJson {
+    /// Vector similarity only
+    #[default]
+    Sem,
+    /// Vector similarity fused with lexical matches on `text`
+    Hybrid,
+}
+
+/// Filters for `memvid_search_vec` from JSON.
+///
+/// Parsed in every build so malformed filters are reported the same way.
+#[derive(Debug, Deserialize)]
+#[cfg_attr(not(feature = "vec"), allow(dead_code))]
+struct VecFiltersJson {
+    #[serde(default)]
+    mode: VecModeJson,
+    #[serde(default)]
+    text: String,
+    #[serde(default = "default_snippet_chars")]
+    snippet_chars: usize,
+    #[serde(default)]
+    uri: Option<String>,
+    #[serde(default)]
+    scope: Option<String>,
+    #[serde(default)]
+    cursor: Option<String>,
+    #[serde(default)]
+    start: Option<i64>,
+    #[serde(default)]
+    end: Option<i64>,
+    #[serde(default)]
+    as_of_frame: Option<u64>,
+    #[serde(default)]
+    as_of_ts: Option<i64>,
+}
+
+fn default_snippet_chars() -> usize {
+    200
+}
+
+#[cfg(feature = "vec")]
+impl VecFiltersJson {
+    fn into_request(self, top_k: usize) -> memvid_core::AskRequest {
+        memvid_core::AskRequest {
+            question: self.text,
+            top_k,
+            snippet_chars: self.snippet_chars,
+            uri: self.uri,
+            scope: self.scope,
+            cursor: self.cursor,
+            start: self.start,
+            end: self.end,
+            context_only: true,
+            mode: match self.mode {
+                VecModeJson::Sem => memvid_core::AskMode::Sem,
+                VecModeJson::Hybrid => memvid_core::AskMode::Hybrid,
+            },
+            as_of_frame: self.as_of_frame,
+            as_of_ts: self.as_of_ts,
+            adaptive: None,
+        }
+    }
+}
+
+/// Embedder that answers every query with the caller's vector.
+#[cfg(feature = "vec")]
+struct PrecomputedEmbedder {
+    vector: Vec<f32>,
+}
+
+#[cfg(feature = "vec")]
+impl memvid_core::VecEmbedder for PrecomputedEmbedder {
+    fn embed_query(&self, _text: &str) -> Result<Vec<f32>, memvid_core::MemvidError> {
+        Ok(self.vector.clone())
+    }
+
+    fn embedding_dimension(&self) -> usize {
+        self.vector.len()
+    }
+}
+
+/// Borrow a caller vector of `dim` floats.
+///
+/// # Safety
+///
+/// `ptr` must point to at least `dim` floats.
+unsafe fn float_slice<'a>(
+    ptr: *const f32,
+    dim: size_t,
+    param: &str,
+) -> Result<&'a [f32], MemvidError> {
+    if ptr.is_null() {
+        return Err(MemvidError::null_pointer(param));
+    }
+    Ok(unsafe { std::slice::from_raw_parts(ptr, dim) })
+}
+
+#[cfg(feature = "vec")]
+fn search_vec(
+    handle: &mut MemvidHandle,
+    query: &[f32],
+    top_k: usize,
+    filters: VecFiltersJson,
+) -> Result<String, MemvidError> {
+    let embedder = PrecomputedEmbedder {
+        vector: query.to_vec(),
+    };
+    let response = handle
+        .as_mut()
+        .ask(filters.into_request(top_k), Some(&embedder))
+        .map_err(MemvidError::from_core_error)?;
+    serde_json::to_string(&AskResponseJson::from(&response)).map_err(MemvidError::json_serialize)
+}
+
+#[cfg(not(feature = "vec"))]
+fn search_vec(
+    _handle: &mut MemvidHandle,
+    _query: &[f32],
+    _top_k: usize,
+    _filters: VecFiltersJson,
+) -> Result<String, MemvidError> {
+    Err(MemvidError::from_core_error(
+        memvid_core::MemvidError::VecNotEnabled,
+    ))
+}
+
+/// Search by a pre-computed query embedding.
+///
+/// The vector must have the dimension of the embeddings stored in the file;
+/// a mismatch fails with `MemvidErrorCode_VecDimensionMismatch`. In "hybrid"
+/// mode, vector hits are fused with lexical matches for `text`.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `query`: Pointer to `dim` query vector components
+/// - `dim`: Number of components in `query`
+/// - `top_k`: Maximum number of hits
+/// - `filters_json`: JSON string with filters (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the ask response (see `memvid_ask`) on success, NULL on
+/// failure. Hits are in `retrieval.hits`. Caller must free with
+/// `memvid_string_free()`.
+///
+/// # Filters JSON Schema
+///
+/// ```json
+/// {
+///   "mode": "sem",
+///   "text": "lexical query for hybrid mode",
+///   "snippet_chars": 200,
+///   "uri": null,
+///   "scope": null,
+///   "cursor": null,
+///   "start": null,
+///   "end": null,
+///   "as_of_frame": null,
+///   "as_of_ts": null
+/// }
+/// ```
+///
+/// Mode values: "sem", "hybrid" (default: "sem")
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `query` must point to at least `dim` floats
+/// - `filters_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_search_vec(
+    handle: *mut MemvidHandle,
+    query: *const f32,
+    dim: size_t,
+    top_k: size_t,
+    filters_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let query = match unsafe { float_slice(query, dim, "query") } {
+        Ok(q) => q,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let json_str = match unsafe { cstr_to_option_string(filters_json, "filters_json") } {
+        Ok(s) => s,
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let filters: VecFiltersJson = match serde_json::from_str(json_str.as_deref().unwrap_or("{}")) {
+        Ok(f) => f,
+        Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+    };
+
+    match search_vec(handle, query, top_k, filters) {
+        Ok(json) => {
+            let out = string_to_cstr(json);
+            unsafe { set_ok(error) };
+            out
+        }
+        Err(e) => unsafe { set_error_null(error, e) },
+    }
+}
+
+#[cfg(feature = "vec")]
+fn put_embedding(
+    handle: &mut MemvidHandle,
+    data: &[u8],
+    embedding: &[f32],
+    options: PutOptions,
+) -> Result<u64, MemvidError> {
+    let dedup = options.dedup;
+    let frame_id = dedup::put_checked(handle, data, None, dedup, |memvid, lookup| {
+        memvid.put_with_embedding_and_options(
+            data,
+            embedding.to_vec(),
+            PutOptions {
+                dedup: lookup,
+                ..options
+            },
+        )
+    })
+    .map_err(MemvidError::from_core_error)?;
+    handle.group_commit.pending_bytes += data.len() as u64;
+    Ok(frame_id)
+}
+
+#[cfg(not(feature = "vec"))]
+fn put_embedding(
+    _handle: &mut MemvidHandle,
+    _data: &[u8],
+    _embedding: &[f32],
+    _options: PutOptions,
+) -> Result<u64, MemvidError> {
+    Err(MemvidError::from_core_error(
+        memvid_core::MemvidError::VecNotEnabled,
+    ))
+}
+
+/// Add content with a pre-computed embedding.
+///
+/// The embedding is stored in the vector index as-is, so it must come from
+/// the same model (and dimension) as the other embeddings in the file.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `data`: Pointer to content bytes
+/// - `len`: Length of content in bytes
+/// - `embedding`: Pointer to `dim` embedding components
+/// - `dim`: Number of components in `embedding`
+/// - `options_json`: JSON string with PutOptions (NULL for defaults, see
+///   `memvid_put_bytes_with_options`)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// Frame ID on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `data` must point to at least `len` bytes, or be NULL if `len` is 0
+/// - `embedding` must point to at least `dim` floats
+/// - `options_json` must be a valid UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_put_bytes_with_embedding(
+    handle: *mut MemvidHandle,
+    data: *const u8,
+    len: size_t,
+    embedding: *const f32,
+    dim: size_t,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> u64 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    if data.is_null() && len > 0 {
+        return unsafe { set_error(error, MemvidError::null_pointer("data")) };
+    }
+
+    let slice = if len == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(data, len) }
+    };
+
+    let embedding = match unsafe { float_slice(embedding, dim, "embedding") } {
+        Ok(e) => e,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    let options = match unsafe { parse_put_options(options_json) } {
+        Ok(o) => o,
+        Err(e) => return unsafe { set_error(error, e) },
+    };
+
+    match put_embedding(handle, slice, embedding, options) {
+        Ok(frame_id) => {
+            unsafe { set_ok(error) };
+            frame_id
+        }
+        Err(e) => unsafe { set_error(error, e) },
+    }
+}
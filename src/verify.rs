@@ -1,9 +1,14 @@
 //! File verification functions.
 
-use crate::error::MemvidError;
-use crate::util::{cstr_to_path, set_error_null, set_ok, string_to_cstr};
-use serde::Serialize;
-use std::os::raw::c_char;
+use crate::error::{error_code_from_core, MemvidError, MemvidErrorCode};
+use crate::util::{cstr_to_option_str, cstr_to_path, set_error_null, set_ok, string_to_cstr};
+use libc::size_t;
+use serde::{Deserialize, Serialize};
+use std::ffi::CString;
+use std::os::raw::{c_char, c_void};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::mpsc;
+use std::time::{Instant, UNIX_EPOCH};
 
 /// Verification status for JSON serialization.
 #[derive(Debug, Serialize)]
@@ -129,3 +134,385 @@ pub unsafe extern "C" fn memvid_verify(
         Err(e) => unsafe { set_error_null(error, MemvidError::from_core_error(e)) },
     }
 }
+
+/// Per-file status values passed to `MemvidVerifyProgressFn`.
+pub const MEMVID_VERIFY_PASSED: i32 = 0;
+pub const MEMVID_VERIFY_FAILED: i32 = 1;
+pub const MEMVID_VERIFY_SKIPPED: i32 = 2;
+pub const MEMVID_VERIFY_ERROR: i32 = 3;
+
+/// Verification progress callback.
+///
+/// Invoked on the calling thread once per file as results arrive, with the
+/// caller's context pointer, the file path, the number of files finished so
+/// far, the total, and a `MEMVID_VERIFY_*` status. Returning non-zero cancels
+/// the files that have not started yet.
+pub type MemvidVerifyProgressFn = Option<
+    unsafe extern "C" fn(
+        ctx: *mut c_void,
+        path: *const c_char,
+        done: size_t,
+        total: size_t,
+        status: i32,
+    ) -> i32,
+>;
+
+/// Options for `memvid_verify_many` from JSON.
+#[derive(Debug, Default, Deserialize)]
+struct VerifyManyOptionsJson {
+    /// Perform deep verification
+    #[serde(default)]
+    deep: bool,
+    /// Worker threads (0 for one per core)
+    #[serde(default)]
+    threads: usize,
+    /// Checkpoint from a previous run; matching files are skipped
+    #[serde(default)]
+    checkpoint: Option<VerifyCheckpointJson>,
+}
+
+/// Files known to have passed verification, keyed by path and fingerprint.
+#[derive(Debug, Default, Serialize, Deserialize)]
+struct VerifyCheckpointJson {
+    #[serde(default)]
+    files: Vec<VerifiedFileJson>,
+}
+
+/// Fingerprint of a file at the time it passed verification.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+struct VerifiedFileJson {
+    path: String,
+    len: u64,
+    modified_ns: u64,
+    deep: bool,
+}
+
+impl VerifiedFileJson {
+    /// Whether this entry vouches for `current` under the requested depth.
+    fn covers(&self, current: &VerifiedFileJson) -> bool {
+        self.path == current.path
+            && self.len == current.len
+            && self.modified_ns == current.modified_ns
+            && (self.deep || !current.deep)
+    }
+}
+
+/// Fingerprint a file from its metadata.
+fn fingerprint(path: &str, deep: bool) -> std::io::Result<VerifiedFileJson> {
+    let meta = std::fs::metadata(path)?;
+    let modified_ns = meta
+        .modified()?
+        .duration_since(UNIX_EPOCH)
+        .map_or(0, |d| d.as_nanos() as u64);
+    Ok(VerifiedFileJson {
+        path: path.to_string(),
+        len: meta.len(),
+        modified_ns,
+        deep,
+    })
+}
+
+/// File error for JSON serialization.
+#[derive(Debug, Serialize)]
+struct FileErrorJson {
+    code: i32,
+    message: String,
+}
+
+/// Per-file result of `memvid_verify_many`.
+#[derive(Debug, Serialize)]
+struct VerifyFileResultJson {
+    path: String,
+    status: &'static str,
+    report: Option<VerificationReportJson>,
+    error: Option<FileErrorJson>,
+}
+
+impl VerifyFileResultJson {
+    fn new(path: &str, status: &'static str) -> Self {
+        Self {
+            path: path.to_string(),
+            status,
+            report: None,
+            error: None,
+        }
+    }
+
+    fn error(path: &str, code: i32, message: String) -> Self {
+        Self {
+            error: Some(FileErrorJson { code, message }),
+            ..Self::new(path, "error")
+        }
+    }
+
+    fn progress_status(&self) -> i32 {
+        match self.status {
+            "passed" => MEMVID_VERIFY_PASSED,
+            "failed" => MEMVID_VERIFY_FAILED,
+            "skipped" => MEMVID_VERIFY_SKIPPED,
+            _ => MEMVID_VERIFY_ERROR,
+        }
+    }
+}
+
+/// Verify one file with the core verifier.
+fn verify_file(path: &str, deep: bool) -> VerifyFileResultJson {
+    match memvid_core::Memvid::verify(path, deep) {
+        Ok(report) => {
+            let status = match report.overall_status {
+                memvid_core::VerificationStatus::Failed => "failed",
+                _ => "passed",
+            };
+            VerifyFileResultJson {
+                report: Some(VerificationReportJson::from(&report)),
+                ..VerifyFileResultJson::new(path, status)
+            }
+        }
+        Err(e) => VerifyFileResultJson::error(path, error_code_from_core(&e) as i32, e.to_string()),
+    }
+}
+
+/// Batch verification report for JSON serialization.
+#[derive(Debug, Serialize)]
+struct VerifyManyReportJson {
+    files: Vec<VerifyFileResultJson>,
+    passed: usize,
+    failed: usize,
+    skipped: usize,
+    errors: usize,
+    cancelled: bool,
+    elapsed_ms: u128,
+    checkpoint: VerifyCheckpointJson,
+}
+
+/// Invoke the progress callback; returns true if the caller asked to cancel.
+fn report_progress(
+    callback: MemvidVerifyProgressFn,
+    ctx: *mut c_void,
+    result: &VerifyFileResultJson,
+    done: usize,
+    total: usize,
+) -> bool {
+    let Some(callback) = callback else {
+        return false;
+    };
+    let path = CString::new(result.path.as_str()).unwrap_or_default();
+    unsafe { callback(ctx, path.as_ptr(), done, total, result.progress_status()) != 0 }
+}
+
+/// Verify several files in parallel, skipping files unchanged since a checkpoint.
+///
+/// Each file is verified by one worker thread; files whose size and
+/// modification time match a checkpoint entry (verified at least as deeply)
+/// are reported as "skipped" without being opened. The returned report
+/// carries a new checkpoint to pass to the next run, so an interrupted or
+/// cancelled run resumes with the files it had not finished, and a periodic
+/// run only re-verifies files written since.
+///
+/// # Parameters
+///
+/// - `paths`: Array of `count` paths to .mv2 files (null-terminated UTF-8)
+/// - `count`: Number of paths
+/// - `options_json`: JSON string with options (NULL for defaults)
+/// - `progress`: Progress callback (NULL for none)
+/// - `ctx`: Context pointer passed to `progress` (may be NULL)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the batch report on success, NULL on failure. A file
+/// that fails verification or cannot be read does not fail the call; it is
+/// reported with status "failed" or "error".
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Options JSON Schema
+///
+/// ```json
+/// {
+///   "deep": false,
+///   "threads": 0,
+///   "checkpoint": { "files": [ ... from a previous report ... ] }
+/// }
+/// ```
+///
+/// # Response JSON Schema
+///
+/// ```json
+/// {
+///   "files": [
+///     {
+///       "path": "/path/to/file.mv2",
+///       "status": "passed",
+///       "report": { ... same as memvid_verify ... },
+///       "error": null
+///     }
+///   ],
+///   "passed": 1,
+///   "failed": 0,
+///   "skipped": 0,
+///   "errors": 0,
+///   "cancelled": false,
+///   "elapsed_ms": 42,
+///   "checkpoint": {
+///     "files": [
+///       {"path": "/path/to/file.mv2", "len": 4096, "modified_ns": 1700000000000000000, "deep": false}
+///     ]
+///   }
+/// }
+/// ```
+///
+/// Status values: "passed", "failed", "skipped", "error", "cancelled"
+///
+/// # Safety
+///
+/// - `paths` must point to `count` valid null-terminated UTF-8 strings
+/// - `options_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `progress` must be safe to call with `ctx` from the calling thread
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_verify_many(
+    paths: *const *const c_char,
+    count: size_t,
+    options_json: *const c_char,
+    progress: MemvidVerifyProgressFn,
+    ctx: *mut c_void,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let started = Instant::now();
+    if paths.is_null() && count > 0 {
+        return unsafe { set_error_null(error, MemvidError::null_pointer("paths")) };
+    }
+
+    let options = match unsafe { cstr_to_option_str(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<VerifyManyOptionsJson>(json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => VerifyManyOptionsJson::default(),
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let raw_paths = if count == 0 {
+        &[][..]
+    } else {
+        unsafe { std::slice::from_raw_parts(paths, count) }
+    };
+    let mut files = Vec::with_capacity(count);
+    for &raw in raw_paths {
+        match unsafe { cstr_to_path(raw) } {
+            Ok(p) => files.push(p.to_string_lossy().into_owned()),
+            Err(e) => return unsafe { set_error_null(error, e) },
+        }
+    }
+
+    let previous = options.checkpoint.unwrap_or_default().files;
+    let mut results: Vec<Option<VerifyFileResultJson>> = (0..count).map(|_| None).collect();
+    // Checkpoint entries for the files that pass or are skipped in this run
+    let mut verified: Vec<Option<VerifiedFileJson>> = vec![None; count];
+    let mut work = Vec::new();
+    for (i, path) in files.iter().enumerate() {
+        match fingerprint(path, options.deep) {
+            Ok(current) => match previous.iter().find(|p| p.covers(&current)) {
+                Some(entry) => {
+                    results[i] = Some(VerifyFileResultJson::new(path, "skipped"));
+                    verified[i] = Some(entry.clone());
+                }
+                None => {
+                    work.push(i);
+                    verified[i] = Some(current);
+                }
+            },
+            Err(e) => {
+                let message = format!("I/O error: {e}");
+                results[i] = Some(VerifyFileResultJson::error(
+                    path,
+                    MemvidErrorCode::Io as i32,
+                    message,
+                ));
+            }
+        }
+    }
+
+    // Report files settled without verification first
+    let mut done = 0;
+    let cancel = AtomicBool::new(false);
+    for result in results.iter().flatten() {
+        done += 1;
+        if report_progress(progress, ctx, result, done, count) {
+            cancel.store(true, Ordering::Relaxed);
+        }
+    }
+
+    let threads = match options.threads {
+        0 => std::thread::available_parallelism().map_or(1, |n| n.get()),
+        n => n,
+    }
+    .min(work.len());
+    let next = AtomicUsize::new(0);
+    let deep = options.deep;
+
+    std::thread::scope(|scope| {
+        let (tx, rx) = mpsc::channel();
+        for _ in 0..threads {
+            let (tx, work, files, next, cancel) = (tx.clone(), &work, &files, &next, &cancel);
+            scope.spawn(move || {
+                while !cancel.load(Ordering::Relaxed) {
+                    let Some(&i) = work.get(next.fetch_add(1, Ordering::Relaxed)) else {
+                        break;
+                    };
+                    if tx.send((i, verify_file(&files[i], deep))).is_err() {
+                        break;
+                    }
+                }
+            });
+        }
+        drop(tx);
+
+        // Callbacks run here so the caller never sees a worker thread
+        for (i, result) in rx {
+            done += 1;
+            if report_progress(progress, ctx, &result, done, count) {
+                cancel.store(true, Ordering::Relaxed);
+            }
+            results[i] = Some(result);
+        }
+    });
+
+    let cancelled = cancel.load(Ordering::Relaxed);
+    let files: Vec<_> = results
+        .into_iter()
+        .zip(&files)
+        .map(|(r, path)| r.unwrap_or_else(|| VerifyFileResultJson::new(path, "cancelled")))
+        .collect();
+
+    // Keep entries for other files, refresh the ones that passed now
+    let mut checkpoint: Vec<VerifiedFileJson> = previous
+        .into_iter()
+        .filter(|p| !files.iter().any(|f| f.path == p.path))
+        .collect();
+    for (file, entry) in files.iter().zip(verified) {
+        if let (Some(entry), "passed" | "skipped") = (entry, file.status) {
+            checkpoint.push(entry);
+        }
+    }
+
+    let count_status = |status: &str| files.iter().filter(|f| f.status == status).count();
+    let report = VerifyManyReportJson {
+        passed: count_status("passed"),
+        failed: count_status("failed"),
+        skipped: count_status("skipped"),
+        errors: count_status("error"),
+        cancelled,
+        elapsed_ms: started.elapsed().as_millis(),
+        checkpoint: VerifyCheckpointJson { files: checkpoint },
+        files,
+    };
+
+    match serde_json::to_string(&report) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
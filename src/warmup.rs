@@ -0,0 +1,438 @@
+//! Page cache warmup and hot-set tracking.
+//!
+//! `memvid_warmup` pre-faults a memory file after a deploy or rotation so
+//! the first queries do not pay for cold pages: the whole file is hinted
+//! (or faulted in) with the same readahead modes as
+//! `memvid_open_with_options`, and chosen frames are read on background
+//! threads through read-only views, which pulls their payload and index
+//! pages into the shared page cache.
+//!
+//! The hot set is an optional, bounded count of the frames returned by
+//! searches and frame lookups on a handle. Exported from a warm process, it
+//! is the frame list to warm in the next one.
+
+use crate::error::MemvidError;
+use crate::handle::MemvidHandle;
+use crate::lifecycle::{readahead, ReadaheadJson};
+use crate::util::{cstr_to_option_str, set_error, set_error_null, set_ok, string_to_cstr};
+use serde::{Deserialize, Serialize};
+use std::collections::{BTreeSet, HashMap};
+use std::os::raw::c_char;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::time::Instant;
+
+/// Bounded frame hit counter kept on each handle (disabled by default).
+///
+/// Counts follow the space-saving algorithm: when the set is full, a hit on
+/// an untracked frame replaces the frame with the lowest count and inherits
+/// that count plus one. Every frame hit more than `hits / capacity` times
+/// is tracked, one-off hits only ever displace the coldest entry, and each
+/// hit costs O(log capacity).
+#[derive(Default)]
+pub(crate) struct HotSet {
+    capacity: usize,
+    counts: HashMap<u64, u32>,
+    /// `(count, frame_id)` of every tracked frame, coldest first
+    by_count: BTreeSet<(u32, u64)>,
+}
+
+impl HotSet {
+    /// Count a hit on `frame_id`.
+    pub(crate) fn record(&mut self, frame_id: u64) {
+        if self.capacity == 0 {
+            return;
+        }
+        let count = match self.counts.get(&frame_id) {
+            Some(&count) => {
+                self.by_count.remove(&(count, frame_id));
+                count
+            }
+            None if self.counts.len() >= self.capacity => {
+                let (count, coldest) = self.by_count.pop_first().expect("set is full");
+                self.counts.remove(&coldest);
+                count
+            }
+            None => 0,
+        };
+        let count = count.saturating_add(1);
+        self.counts.insert(frame_id, count);
+        self.by_count.insert((count, frame_id));
+    }
+
+    /// Count a hit on every frame in a search response.
+    pub(crate) fn record_hits(&mut self, response: &memvid_core::SearchResponse) {
+        for hit in &response.hits {
+            self.record(hit.frame_id);
+        }
+    }
+
+    fn configure(&mut self, capacity: usize) {
+        self.capacity = capacity;
+        while self.counts.len() > capacity {
+            let (_, coldest) = self.by_count.pop_first().expect("counts are indexed");
+            self.counts.remove(&coldest);
+        }
+        if capacity == 0 {
+            self.counts = HashMap::new();
+        }
+    }
+
+    /// Frames by descending hit count (ties by frame ID).
+    fn top(&self, limit: usize) -> Vec<HotFrameJson> {
+        let mut frames: Vec<_> = self
+            .counts
+            .iter()
+            .map(|(&frame_id, &hits)| HotFrameJson { frame_id, hits })
+            .collect();
+        frames.sort_unstable_by(|a, b| b.hits.cmp(&a.hits).then(a.frame_id.cmp(&b.frame_id)));
+        frames.truncate(limit);
+        frames
+    }
+}
+
+/// Hot frame for JSON serialization.
+#[derive(Debug, Serialize, Deserialize)]
+struct HotFrameJson {
+    frame_id: u64,
+    #[serde(default)]
+    hits: u32,
+}
+
+/// Exported hot set.
+#[derive(Debug, Default, Serialize, Deserialize)]
+struct HotSetJson {
+    #[serde(default)]
+    frames: Vec<HotFrameJson>,
+}
+
+fn default_file_mode() -> ReadaheadJson {
+    ReadaheadJson::Async
+}
+
+fn default_wait() -> bool {
+    true
+}
+
+/// Options for `memvid_warmup` from JSON.
+#[derive(Debug, Default, Deserialize)]
+struct WarmupOptionsJson {
+    /// Readahead for the whole file
+    #[serde(default = "default_file_mode")]
+    file: ReadaheadJson,
+    /// Frames to read
+    #[serde(default)]
+    frame_ids: Vec<u64>,
+    /// Frames to read, by URI
+    #[serde(default)]
+    uris: Vec<String>,
+    /// Hot set from `memvid_hot_set_export` (its frames are read too)
+    #[serde(default)]
+    hot_set: Option<HotSetJson>,
+    /// Worker threads for frame reads (0 for one per core)
+    #[serde(default)]
+    threads: usize,
+    /// Wait for the warmup to finish before returning
+    #[serde(default = "default_wait")]
+    wait: bool,
+}
+
+/// Frame to read during warmup.
+#[derive(Debug, Clone)]
+enum Target {
+    Id(u64),
+    Uri(String),
+}
+
+/// Warmup counters, shared with the worker threads.
+#[derive(Default)]
+struct Progress {
+    file_bytes: AtomicU64,
+    frames_warmed: AtomicU64,
+    frame_bytes: AtomicU64,
+    frames_missing: AtomicU64,
+}
+
+/// Warmup report for JSON serialization.
+#[derive(Debug, Serialize)]
+struct WarmupReportJson {
+    file_bytes: u64,
+    frames_requested: usize,
+    frames_warmed: u64,
+    frame_bytes: u64,
+    frames_missing: u64,
+    pending: bool,
+    elapsed_ms: u128,
+}
+
+/// Read one frame's payload on a read-only view.
+fn warm_frame(memvid: &mut memvid_core::Memvid, target: &Target, progress: &Progress) {
+    let frame_id = match target {
+        Target::Id(id) => Ok(*id),
+        Target::Uri(uri) => memvid.frame_by_uri(uri).map(|f| f.id),
+    };
+    match frame_id.and_then(|id| memvid.frame_text_by_id(id)) {
+        Ok(text) => {
+            progress.frames_warmed.fetch_add(1, Ordering::Relaxed);
+            progress
+                .frame_bytes
+                .fetch_add(text.len() as u64, Ordering::Relaxed);
+        }
+        Err(_) => {
+            progress.frames_missing.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Run the warmup: file readahead on one thread, frame reads on the rest.
+fn run(
+    path: PathBuf,
+    file: ReadaheadJson,
+    targets: Vec<Target>,
+    threads: usize,
+    progress: &Progress,
+) {
+    let next = AtomicUsize::new(0);
+    std::thread::scope(|scope| {
+        scope.spawn(|| {
+            let bytes = readahead(&path, file);
+            progress.file_bytes.store(bytes, Ordering::Relaxed);
+        });
+        for _ in 0..threads.min(targets.len()) {
+            let (path, targets, next) = (&path, &targets, &next);
+            scope.spawn(move || {
+                let Ok(mut memvid) = memvid_core::Memvid::open_read_only(path) else {
+                    return;
+                };
+                while let Some(target) = targets.get(next.fetch_add(1, Ordering::Relaxed)) {
+                    warm_frame(&mut memvid, target, progress);
+                }
+            });
+        }
+    });
+}
+
+/// Pre-fault a memory file and chosen frames into the page cache.
+///
+/// The whole file gets the `file` readahead ("async" queues kernel
+/// readahead, "populate" faults every page in, "none" skips it). memvid-core
+/// does not expose where each index lives in the file, so index segments
+/// are warmed as part of the file; the sizes in `memvid_stats` bound the
+/// cost. Frames listed by ID, URI or hot set are read on `threads` workers,
+/// each with its own read-only view, so the handle itself is not used by
+/// another thread.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle opened from a file
+/// - `options_json`: JSON string with options (NULL for defaults)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the warmup report on success, NULL on failure.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Options JSON Schema
+///
+/// ```json
+/// {
+///   "file": "async",
+///   "frame_ids": [1, 2, 3],
+///   "uris": ["mv2://docs/readme"],
+///   "hot_set": { "frames": [ ... from memvid_hot_set_export ... ] },
+///   "threads": 0,
+///   "wait": true
+/// }
+/// ```
+///
+/// Frames must be committed to be visible to the read-only views. With
+/// `wait` false the call returns at once with `pending` true and zero
+/// counters; the warmup continues on detached threads.
+///
+/// # Response JSON Schema
+///
+/// ```json
+/// {
+///   "file_bytes": 1048576,
+///   "frames_requested": 3,
+///   "frames_warmed": 3,
+///   "frame_bytes": 5120,
+///   "frames_missing": 0,
+///   "pending": false,
+///   "elapsed_ms": 4
+/// }
+/// ```
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `options_json` must be a valid null-terminated UTF-8 string or NULL
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_warmup(
+    handle: *mut MemvidHandle,
+    options_json: *const c_char,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let started = Instant::now();
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let options = match unsafe { cstr_to_option_str(options_json, "options_json") } {
+        Ok(Some(json_str)) => match serde_json::from_str::<WarmupOptionsJson>(json_str) {
+            Ok(o) => o,
+            Err(e) => return unsafe { set_error_null(error, MemvidError::json_parse(e)) },
+        },
+        Ok(None) => WarmupOptionsJson {
+            file: default_file_mode(),
+            wait: default_wait(),
+            ..Default::default()
+        },
+        Err(e) => return unsafe { set_error_null(error, e) },
+    };
+
+    let Some(path) = handle.path.clone() else {
+        return unsafe {
+            set_error_null(
+                error,
+                MemvidError::invalid_state("handle was not opened from a file"),
+            )
+        };
+    };
+
+    let hot = options.hot_set.unwrap_or_default().frames;
+    let targets: Vec<Target> = options
+        .frame_ids
+        .into_iter()
+        .chain(hot.into_iter().map(|f| f.frame_id))
+        .map(Target::Id)
+        .chain(options.uris.into_iter().map(Target::Uri))
+        .collect();
+    let frames_requested = targets.len();
+    let threads = match options.threads {
+        0 => std::thread::available_parallelism().map_or(1, |n| n.get()),
+        n => n,
+    };
+
+    let progress = Progress::default();
+    if options.wait {
+        run(path, options.file, targets, threads, &progress);
+    } else {
+        let file = options.file;
+        let spawned = std::thread::Builder::new()
+            .name("memvid-warmup".into())
+            .spawn(move || run(path, file, targets, threads, &Progress::default()));
+        if let Err(e) = spawned {
+            return unsafe { set_error_null(error, MemvidError::io(e)) };
+        }
+    }
+
+    let report = WarmupReportJson {
+        file_bytes: progress.file_bytes.load(Ordering::Relaxed),
+        frames_requested,
+        frames_warmed: progress.frames_warmed.load(Ordering::Relaxed),
+        frame_bytes: progress.frame_bytes.load(Ordering::Relaxed),
+        frames_missing: progress.frames_missing.load(Ordering::Relaxed),
+        pending: !options.wait,
+        elapsed_ms: started.elapsed().as_millis(),
+    };
+    match serde_json::to_string(&report) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}
+
+/// Start, resize or stop hot-set tracking on a handle.
+///
+/// While enabled, every frame returned by `memvid_search` (and its arena,
+/// `_into` and `_bin` variants) and `memvid_frame_by_id` is counted.
+/// Responses served from the query cache are not counted.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `capacity`: Maximum frames tracked (0 disables tracking and clears the set)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// 1 on success, 0 on failure.
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_hot_set_configure(
+    handle: *mut MemvidHandle,
+    capacity: usize,
+    error: *mut MemvidError,
+) -> i32 {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error(error, MemvidError::invalid_handle()) },
+    };
+
+    handle.hot_set.configure(capacity);
+    unsafe { set_ok(error) };
+    1
+}
+
+/// Export the hottest frames seen on a handle.
+///
+/// # Parameters
+///
+/// - `handle`: Valid Memvid handle
+/// - `limit`: Maximum frames to export (0 for all tracked frames)
+/// - `error`: Out-parameter for error information
+///
+/// # Returns
+///
+/// JSON string with the hot set on success, NULL on failure. Pass it back
+/// as the `hot_set` option of `memvid_warmup`.
+/// Caller must free with `memvid_string_free()`.
+///
+/// # Response JSON Schema
+///
+/// ```json
+/// {
+///   "frames": [
+///     {"frame_id": 7, "hits": 120},
+///     {"frame_id": 3, "hits": 45}
+///   ]
+/// }
+/// ```
+///
+/// # Safety
+///
+/// - `handle` must be a valid handle
+/// - `error` must be a valid pointer or NULL
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn memvid_hot_set_export(
+    handle: *mut MemvidHandle,
+    limit: usize,
+    error: *mut MemvidError,
+) -> *mut c_char {
+    let handle = match unsafe { MemvidHandle::from_ptr_mut(handle) } {
+        Some(h) => h,
+        None => return unsafe { set_error_null(error, MemvidError::invalid_handle()) },
+    };
+
+    let limit = if limit == 0 { usize::MAX } else { limit };
+    let hot_set = HotSetJson {
+        frames: handle.hot_set.top(limit),
+    };
+    match serde_json::to_string(&hot_set) {
+        Ok(json) => {
+            unsafe { set_ok(error) };
+            string_to_cstr(json)
+        }
+        Err(e) => unsafe { set_error_null(error, MemvidError::json_serialize(e)) },
+    }
+}